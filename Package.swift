@@ -13,6 +13,7 @@ var targets: [PackageDescription.Target] = [
     .target(name: "CLoobeeCore", dependencies: []),
     .target(name: "LoobeeCore", dependencies: ["CLoobeeCore"]),
     .target(name: "LoobeeHttp", dependencies: ["LoobeeCore"]),
+    .target(name: "LoobeeBenchmarks", dependencies: ["CLoobeeCore", "LoobeeCore", "LoobeeHttp"]),
     .testTarget(name: "LoobeeCoreTests", dependencies: ["LoobeeCore"]),
     .testTarget(name: "LoobeeHttpTests", dependencies: ["LoobeeHttp"]),
 ]
@@ -0,0 +1,166 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#include "bit_ops.h"
+
+#if defined(__x86_64__)
+#   include <immintrin.h>
+#endif
+
+#define LOOBEE_BIT_OPS_SCALAR_BINARY(name, op) /*
+*/   void c_loobee_core_bit_ops_##name##_scalar( /*
+*/       uint64_t *_Nonnull dst, /*
+*/       const uint64_t *_Nonnull lhs, /*
+*/       const uint64_t *_Nonnull rhs, /*
+*/       size_t count /*
+*/   ) { /*
+*/       for (size_t i = 0; i < count; ++i) { /*
+*/           dst[i] = lhs[i] op rhs[i]; /*
+*/       } /*
+*/   }
+
+LOOBEE_BIT_OPS_SCALAR_BINARY(and, &)
+LOOBEE_BIT_OPS_SCALAR_BINARY(or, |)
+LOOBEE_BIT_OPS_SCALAR_BINARY(xor, ^)
+
+#undef LOOBEE_BIT_OPS_SCALAR_BINARY
+
+void c_loobee_core_bit_ops_not_scalar(uint64_t *_Nonnull dst, const uint64_t *_Nonnull src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = ~src[i];
+    }
+}
+
+/// SWAR popcount, the baseline x86-64 has no `popcnt` instruction.
+static __inline__ __attribute__((__always_inline__))
+uint64_t c_loobee_core_bit_ops_popcount_word(uint64_t word) {
+    word -= (word >> 1) & 0x5555555555555555ULL;
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (word * 0x0101010101010101ULL) >> 56;
+}
+
+size_t c_loobee_core_bit_ops_popcount_scalar(const uint64_t *_Nonnull words, size_t count) {
+    size_t result = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        result += (size_t)c_loobee_core_bit_ops_popcount_word(words[i]);
+    }
+
+    return result;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("popcnt")))
+size_t c_loobee_core_bit_ops_popcount_popcnt(const uint64_t *_Nonnull words, size_t count) {
+    // Independent accumulators hide the latency of `popcnt`.
+    uint64_t result0 = 0;
+    uint64_t result1 = 0;
+    uint64_t result2 = 0;
+    uint64_t result3 = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        result0 += (uint64_t)_mm_popcnt_u64(words[i]);
+        result1 += (uint64_t)_mm_popcnt_u64(words[i + 1]);
+        result2 += (uint64_t)_mm_popcnt_u64(words[i + 2]);
+        result3 += (uint64_t)_mm_popcnt_u64(words[i + 3]);
+    }
+    for (; i < count; ++i) {
+        result0 += (uint64_t)_mm_popcnt_u64(words[i]);
+    }
+
+    return (size_t)(result0 + result1 + result2 + result3);
+}
+
+#define LOOBEE_BIT_OPS_AVX2_BINARY(name, intrinsic, op) /*
+*/   __attribute__((target("avx2"))) /*
+*/   void c_loobee_core_bit_ops_##name##_avx2( /*
+*/       uint64_t *_Nonnull dst, /*
+*/       const uint64_t *_Nonnull lhs, /*
+*/       const uint64_t *_Nonnull rhs, /*
+*/       size_t count /*
+*/   ) { /*
+*/       size_t i = 0; /*
+*/       for (; i + 4 <= count; i += 4) { /*
+*/           __m256i left = _mm256_loadu_si256((const __m256i *)(lhs + i)); /*
+*/           __m256i right = _mm256_loadu_si256((const __m256i *)(rhs + i)); /*
+*/           _mm256_storeu_si256((__m256i *)(dst + i), intrinsic(left, right)); /*
+*/       } /*
+*/       for (; i < count; ++i) { /*
+*/           dst[i] = lhs[i] op rhs[i]; /*
+*/       } /*
+*/   }
+
+LOOBEE_BIT_OPS_AVX2_BINARY(and, _mm256_and_si256, &)
+LOOBEE_BIT_OPS_AVX2_BINARY(or, _mm256_or_si256, |)
+LOOBEE_BIT_OPS_AVX2_BINARY(xor, _mm256_xor_si256, ^)
+
+#undef LOOBEE_BIT_OPS_AVX2_BINARY
+
+__attribute__((target("avx2")))
+void c_loobee_core_bit_ops_not_avx2(uint64_t *_Nonnull dst, const uint64_t *_Nonnull src, size_t count) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(value, ones));
+    }
+    for (; i < count; ++i) {
+        dst[i] = ~src[i];
+    }
+}
+
+/// Counts bits of each byte with a nibble lookup table (`vpshufb`) and sums the bytes
+/// of each 64-bit lane with `vpsadbw`.
+///
+/// [Details](https://arxiv.org/abs/1611.07612)
+__attribute__((target("avx2")))
+static __inline__ __m256i c_loobee_core_bit_ops_popcount_bytes_avx2(__m256i value) {
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+
+    __m256i low = _mm256_and_si256(value, lowMask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowMask);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t c_loobee_core_bit_ops_popcount_avx2(const uint64_t *_Nonnull words, size_t count) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    // Byte counters of 8 vectors are at most 64, so they are summed before `vpsadbw`.
+    for (; i + 32 <= count; i += 32) {
+        __m256i bytes = _mm256_setzero_si256();
+        for (size_t j = 0; j < 32; j += 4) {
+            __m256i value = _mm256_loadu_si256((const __m256i *)(words + i + j));
+            bytes = _mm256_add_epi8(bytes, c_loobee_core_bit_ops_popcount_bytes_avx2(value));
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(words + i));
+        __m256i bytes = c_loobee_core_bit_ops_popcount_bytes_avx2(value);
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+
+    uint64_t result = (uint64_t)_mm256_extract_epi64(total, 0) + (uint64_t)_mm256_extract_epi64(total, 1)
+        + (uint64_t)_mm256_extract_epi64(total, 2) + (uint64_t)_mm256_extract_epi64(total, 3);
+    for (; i < count; ++i) {
+        result += (uint64_t)_mm_popcnt_u64(words[i]);
+    }
+
+    return (size_t)result;
+}
+
+#endif
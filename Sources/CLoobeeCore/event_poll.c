@@ -0,0 +1,91 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if defined(__linux__)
+
+#define _GNU_SOURCE
+
+#include "event_poll.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+int32_t c_loobee_core_event_poll_create(void) {
+    int poll = epoll_create1(EPOLL_CLOEXEC);
+
+    return poll < 0 ? -errno : poll;
+}
+
+int32_t c_loobee_core_event_poll_add(int32_t poll, int32_t fd, uint32_t events, uint64_t data) {
+    struct epoll_event event;
+    event.events = events | EPOLLET;
+    event.data.u64 = data;
+
+    return epoll_ctl(poll, EPOLL_CTL_ADD, fd, &event) < 0 ? -errno : 0;
+}
+
+int32_t c_loobee_core_event_poll_remove(int32_t poll, int32_t fd) {
+    // A non-null event for kernels before 2.6.9.
+    struct epoll_event event = {0};
+
+    return epoll_ctl(poll, EPOLL_CTL_DEL, fd, &event) < 0 ? -errno : 0;
+}
+
+int32_t c_loobee_core_event_poll_wait(
+    int32_t poll,
+    c_loobee_core_event_poll_event_t *_Nonnull events,
+    int32_t count,
+    int32_t timeout
+) {
+    struct epoll_event buffer[C_LOOBEE_CORE_EVENT_POLL_BATCH_SIZE];
+    if (count > C_LOOBEE_CORE_EVENT_POLL_BATCH_SIZE) {
+        count = C_LOOBEE_CORE_EVENT_POLL_BATCH_SIZE;
+    }
+
+    int result = epoll_wait(poll, buffer, count, timeout);
+    if (result < 0) {
+        return errno == EINTR ? 0 : -errno;
+    }
+
+    for (int i = 0; i < result; ++i) {
+        events[i].events = buffer[i].events;
+        events[i].data = buffer[i].data.u64;
+    }
+
+    return result;
+}
+
+int32_t c_loobee_core_event_poll_create_wakeup(void) {
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    return fd < 0 ? -errno : fd;
+}
+
+int32_t c_loobee_core_event_poll_wakeup(int32_t fd) {
+    // EAGAIN means the counter is full, so the descriptor is readable anyway.
+    return eventfd_write(fd, 1) < 0 && errno != EAGAIN ? -errno : 0;
+}
+
+int32_t c_loobee_core_event_poll_drain_wakeup(int32_t fd) {
+    eventfd_t value;
+
+    return eventfd_read(fd, &value) < 0 && errno != EAGAIN ? -errno : 0;
+}
+
+int32_t c_loobee_core_event_poll_pin_thread(int32_t processor) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(processor, &set);
+
+    return -pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+#endif
@@ -11,6 +11,18 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <assert.h>
+#include <limits.h>
+
+#if defined(__linux__)
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#elif defined(__APPLE__)
+extern int __ulock_wait(uint32_t operation, void *address, uint64_t value, uint32_t timeout);
+extern int __ulock_wake(uint32_t operation, void *address, uint64_t wakeValue);
+#   define LOOBEE_ULOCK_COMPARE_AND_WAIT 1
+#   define LOOBEE_ULOCK_WAKE_ALL 0x00000100
+#endif
 
 #define SWIFT_ENUM(args...) enum { args }
 
@@ -214,6 +226,95 @@ typedef SWIFT_ENUM(
 */                                    ) { /*
 */       return __atomic_xor_fetch(self, op, order); /*
 */   }
+// =====================================================================================================================
+/// func CLoobeeCoreAtomicThreadFence
+static __inline__ __attribute__((__always_inline__))
+__attribute((swift_name("CLoobeeCoreAtomicThreadFence(order:)")))
+void c_loobee_core_atomic_thread_fence(c_loobee_core_atomic_order_t order) {
+    __atomic_thread_fence(order);
+}
+
+// =====================================================================================================================
+/// struct CLoobeeCoreAtomicUInt128
+typedef struct c_loobee_core_atomic_uint128 {
+    uint64_t low;
+    uint64_t high;
+} c_loobee_core_atomic_uint128_t __attribute((swift_name("CLoobeeCoreAtomicUInt128")));
+
+/// func CLoobeeCoreAtomicUInt128_compareExchange
+///
+/// Sequentially consistent double-width compare and exchange.
+/// `self` must be aligned to 16 bytes, on x86-64 the processor must support `cmpxchg16b`.
+static __inline__ __attribute__((__always_inline__))
+__attribute((swift_name("CLoobeeCoreAtomicUInt128_compareExchange(_:expected:desired:)")))
+bool c_loobee_core_atomic_uint128_compare_exchange(
+                                   volatile c_loobee_core_atomic_uint128_t *_Nonnull self,
+                                   c_loobee_core_atomic_uint128_t *_Nonnull expected,
+                                   c_loobee_core_atomic_uint128_t desired
+                                   ) {
+#if defined(__x86_64__)
+    bool result;
+    __asm__ __volatile__(
+        "lock cmpxchg16b %1\n\t"
+        "sete %0"
+        : "=q"(result), "+m"(*self), "+a"(expected->low), "+d"(expected->high)
+        : "b"(desired.low), "c"(desired.high)
+        : "cc", "memory"
+    );
+    return result;
+#else
+    return __atomic_compare_exchange(
+        (volatile unsigned __int128 *)self,
+        (unsigned __int128 *)expected,
+        (unsigned __int128 *)&desired,
+        false,
+        __ATOMIC_SEQ_CST,
+        __ATOMIC_SEQ_CST
+    );
+#endif
+}
+
+// =====================================================================================================================
+/// func CLoobeeCoreAtomic#TYPE#_wait
+/// func CLoobeeCoreAtomic#TYPE#_notify
+#define LOOBEE_ATOMIC_WAIT(id, cType, swiftType) /*
+*/   static __inline__ __attribute__((__always_inline__)) /*
+*/   __attribute((swift_name("CLoobeeCoreAtomic"#swiftType"_wait(_:expected:)"))) /*
+*/   void c_loobee_core_atomic_##id##_wait( /*
+*/                                    volatile cType *_Nonnull self, /*
+*/                                    cType expected /*
+*/                                    ) { /*
+*/       LOOBEE_ATOMIC_WAIT_IMPL(self, expected) /*
+*/   } /*
+*/   static __inline__ __attribute__((__always_inline__)) /*
+*/   __attribute((swift_name("CLoobeeCoreAtomic"#swiftType"_notify(_:all:)"))) /*
+*/   void c_loobee_core_atomic_##id##_notify( /*
+*/                                    volatile cType *_Nonnull self, /*
+*/                                    bool all /*
+*/                                    ) { /*
+*/       LOOBEE_ATOMIC_NOTIFY_IMPL(self, all) /*
+*/   }
+
+#if defined(__linux__)
+#   define LOOBEE_ATOMIC_WAIT_IMPL(address, expected) /*
+*/       syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#   define LOOBEE_ATOMIC_NOTIFY_IMPL(address, all) /*
+*/       syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+#elif defined(__APPLE__)
+#   define LOOBEE_ATOMIC_WAIT_IMPL(address, expected) /*
+*/       __ulock_wait(LOOBEE_ULOCK_COMPARE_AND_WAIT, (void *)address, (uint32_t)expected, 0);
+#   define LOOBEE_ATOMIC_NOTIFY_IMPL(address, all) /*
+*/       __ulock_wake(LOOBEE_ULOCK_COMPARE_AND_WAIT | (all ? LOOBEE_ULOCK_WAKE_ALL : 0), (void *)address, 0);
+#else
+#   error Is not supported.
+#endif
+
+LOOBEE_ATOMIC_WAIT(uint32, uint32_t, UInt32)
+LOOBEE_ATOMIC_WAIT(int32, int32_t, Int32)
+
+#undef LOOBEE_ATOMIC_WAIT_IMPL
+#undef LOOBEE_ATOMIC_NOTIFY_IMPL
+
 // =====================================================================================================================
 LOOBEE_ATOMIC_IS_LOCK_FREE(bool, bool, Bool)
 LOOBEE_ATOMIC_STORE(bool, bool, Bool)
@@ -250,3 +351,4 @@ LOOBEE_ATOMIC_SCALAR(int, long int, Int)
 #undef LOOBEE_ATOMIC_MATH
 #undef LOOBEE_ATOMIC_BIT
 #undef LOOBEE_ATOMIC_SCALAR
+#undef LOOBEE_ATOMIC_WAIT
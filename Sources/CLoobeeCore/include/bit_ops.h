@@ -0,0 +1,60 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Bulk operations on arrays of 64-bit words, used by `DynamicBitSet`. Each kernel has the scalar
+/// implementation and SIMD ones for x86-64, the selection is made in Swift by `CpuDispatch`.
+/// `dst` can be equal to any of the operands, but must not partially overlap them.
+
+/// func CLoobeeCoreBitOps_and#KERNEL#
+/// func CLoobeeCoreBitOps_or#KERNEL#
+/// func CLoobeeCoreBitOps_xor#KERNEL#
+///
+/// Computes `dst[i] = lhs[i] OP rhs[i]` for `count` words.
+#define LOOBEE_BIT_OPS_BINARY(name, id, swiftName, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreBitOps_"#swiftName#swiftId"(_:_:_:_:)"))) /*
+*/   void c_loobee_core_bit_ops_##name##_##id( /*
+*/                                     uint64_t *_Nonnull dst, /*
+*/                                     const uint64_t *_Nonnull lhs, /*
+*/                                     const uint64_t *_Nonnull rhs, /*
+*/                                     size_t count);
+
+/// func CLoobeeCoreBitOps_not#KERNEL#
+///
+/// Computes `dst[i] = ~src[i]` for `count` words.
+#define LOOBEE_BIT_OPS_NOT(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreBitOps_not"#swiftId"(_:_:_:)"))) /*
+*/   void c_loobee_core_bit_ops_not_##id(uint64_t *_Nonnull dst, const uint64_t *_Nonnull src, size_t count);
+
+/// func CLoobeeCoreBitOps_popcount#KERNEL#
+///
+/// Returns the number of set bits in `count` words.
+#define LOOBEE_BIT_OPS_POPCOUNT(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreBitOps_popcount"#swiftId"(_:_:)"))) /*
+*/   size_t c_loobee_core_bit_ops_popcount_##id(const uint64_t *_Nonnull words, size_t count);
+
+#define LOOBEE_BIT_OPS_KERNEL(id, swiftId) /*
+*/   LOOBEE_BIT_OPS_BINARY(and, id, and, swiftId) /*
+*/   LOOBEE_BIT_OPS_BINARY(or, id, or, swiftId) /*
+*/   LOOBEE_BIT_OPS_BINARY(xor, id, xor, swiftId) /*
+*/   LOOBEE_BIT_OPS_NOT(id, swiftId) /*
+*/   LOOBEE_BIT_OPS_POPCOUNT(id, swiftId)
+
+    LOOBEE_BIT_OPS_KERNEL(scalar, Scalar)
+#if defined(__x86_64__)
+    LOOBEE_BIT_OPS_POPCOUNT(popcnt, Popcnt)
+    LOOBEE_BIT_OPS_KERNEL(avx2, Avx2)
+#endif
+
+#undef LOOBEE_BIT_OPS_BINARY
+#undef LOOBEE_BIT_OPS_NOT
+#undef LOOBEE_BIT_OPS_POPCOUNT
+#undef LOOBEE_BIT_OPS_KERNEL
@@ -19,12 +19,20 @@ typedef struct c_loobee_core_cpu_id {
     uint32_t f7b;
     // Extended features.
     uint32_t f7c;
+    // Extended features.
+    uint32_t f7d;
+    // AMD extended features (leaf 0x80000001).
+    uint32_t f81c;
+    // AMD extended features (leaf 0x80000001).
+    uint32_t f81d;
+    // State components enabled by the OS (XCR0), 0 if `xgetbv` is not supported.
+    uint64_t xcr0;
 } c_loobee_core_cpu_id_t __attribute((swift_name("CLoobeeCoreCpuId")));
 
 static __inline__ __attribute__((__always_inline__))
 __attribute((swift_name("CLoobeeCoreCpuId.current()")))
 c_loobee_core_cpu_id_t c_loobee_core_cpu_id_current(void) {
-    c_loobee_core_cpu_id_t cpu_id = {0, 0, 0, 0};
+    c_loobee_core_cpu_id_t cpu_id = {0, 0, 0, 0, 0, 0, 0, 0};
 
 #if defined(__x86_64__) || defined(__i386__)
     uint32_t n;
@@ -38,7 +46,23 @@ c_loobee_core_cpu_id_t c_loobee_core_cpu_id_current(void) {
 
     if (n >= 7) {
         uint32_t f7a;
-        __asm__("cpuid" : "=a"(f7a), "=b"(cpu_id.f7b), "=c"(cpu_id.f7c) : "a"(7), "c"(0) : "edx");
+        __asm__("cpuid" : "=a"(f7a), "=b"(cpu_id.f7b), "=c"(cpu_id.f7c), "=d"(cpu_id.f7d) : "a"(7), "c"(0));
+    }
+
+    uint32_t extendedN;
+    __asm__("cpuid" : "=a"(extendedN) : "a"(0x80000000U) : "ebx", "ecx", "edx");
+
+    if (extendedN >= 0x80000001U) {
+        uint32_t f81a;
+        __asm__("cpuid" : "=a"(f81a), "=c"(cpu_id.f81c), "=d"(cpu_id.f81d) : "a"(0x80000001U) : "ebx");
+    }
+
+    // OSXSAVE: the OS uses XSAVE and `xgetbv` is available.
+    if ((cpu_id.f1c & (1U << 27)) != 0) {
+        uint32_t low;
+        uint32_t high;
+        __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+        cpu_id.xcr0 = ((uint64_t)high << 32) | low;
     }
 #else
 #   error Is not supported.
@@ -147,6 +171,67 @@ c_loobee_core_cpu_id_t c_loobee_core_cpu_id_current(void) {
 #define LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(name, bit) LOOBEE_CPU_ID_HAS_FN(name, f7c, bit)
     LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Prefetchwt1, 0)
     LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512vbmi, 1)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Umip, 2)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Pku, 3)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Ospke, 4)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Waitpkg, 5)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512vbmi2, 6)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Gfni, 8)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Vaes, 9)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Vpclmulqdq, 10)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512vnni, 11)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512bitalg, 12)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512vpopcntdq, 14)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Rdpid, 22)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Cldemote, 25)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Movdiri, 27)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Movdir64b, 28)
+#undef LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP
+
+#define LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(name, bit) LOOBEE_CPU_ID_HAS_FN(name, f7d, bit)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx5124vnniw, 2)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx5124fmaps, 3)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Fsrm, 4)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512vp2intersect, 8)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(MdClear, 10)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Serialize, 14)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Hybrid, 15)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Avx512fp16, 23)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Ibrs, 26)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Stibp, 27)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Ssbd, 31)
 #undef LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP
 
+#define LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(name, bit) LOOBEE_CPU_ID_HAS_FN(name, f81c, bit)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(LahfLm, 0)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Lzcnt, 5)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Sse4a, 6)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Prefetchw, 8)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Xop, 11)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Fma4, 16)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Tbm, 21)
+#undef LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP
+
+#define LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(name, bit) LOOBEE_CPU_ID_HAS_FN(name, f81d, bit)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Syscall, 11)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Nx, 20)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Pdpe1gb, 26)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Rdtscp, 27)
+    LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP(Lm, 29)
+#undef LOOBEE_CPU_ID_HAS_FN_REGISTER_GROUP
+
+// OS support of the register state, from XCR0.
+#define LOOBEE_CPU_ID_HAS_FN_OS_STATE(name, mask) /*
+*/    static __inline__ __attribute__((__always_inline__)) /*
+*/    __attribute((swift_name("CLoobeeCoreCpuId.hasOs"#name"State(self:)"))) /*
+*/    bool c_loobee_core_cpu_id_os_##name##_state(const c_loobee_core_cpu_id_t *_Nonnull self) { /*
+*/        return (self->xcr0 & (mask)) == (mask); /*
+*/    }
+
+    // XMM and YMM registers.
+    LOOBEE_CPU_ID_HAS_FN_OS_STATE(Avx, 0x06U)
+    // XMM, YMM, opmask, ZMM0-15 upper halves and ZMM16-31 registers.
+    LOOBEE_CPU_ID_HAS_FN_OS_STATE(Avx512, 0xE6U)
+#undef LOOBEE_CPU_ID_HAS_FN_OS_STATE
+
 #undef LOOBEE_CPU_ID_HAS_FN
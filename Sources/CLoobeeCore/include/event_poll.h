@@ -0,0 +1,77 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__linux__)
+
+/// Edge-triggered `epoll` with plain structures.
+///
+/// `struct epoll_event` is packed on x86-64 and can not be used from Swift, so events are copied
+/// into `c_loobee_core_event_poll_event_t`. Flags are the same as in `epoll`. All functions return
+/// a negative `errno` on failure.
+
+/// Data can be read or the peer is closed.
+#define C_LOOBEE_CORE_EVENT_POLL_READABLE 0x001U
+/// Data can be written.
+#define C_LOOBEE_CORE_EVENT_POLL_WRITABLE 0x004U
+/// Error of the descriptor, is always reported.
+#define C_LOOBEE_CORE_EVENT_POLL_ERROR 0x008U
+/// Hang up, is always reported.
+#define C_LOOBEE_CORE_EVENT_POLL_HANG_UP 0x010U
+/// The peer shut down the writing half.
+#define C_LOOBEE_CORE_EVENT_POLL_READ_HANG_UP 0x2000U
+
+/// Maximum number of events returned by one `c_loobee_core_event_poll_wait`.
+#define C_LOOBEE_CORE_EVENT_POLL_BATCH_SIZE 256
+
+typedef struct c_loobee_core_event_poll_event {
+    uint32_t events;
+    uint64_t data;
+} c_loobee_core_event_poll_event_t __attribute((swift_name("CLoobeeCoreEventPollEvent")));
+
+/// Creates an `epoll` descriptor.
+__attribute((swift_name("CLoobeeCoreEventPoll_create()")))
+int32_t c_loobee_core_event_poll_create(void);
+
+/// Registers the descriptor in edge-triggered mode, `data` is returned with its events.
+__attribute((swift_name("CLoobeeCoreEventPoll_add(_:_:_:_:)")))
+int32_t c_loobee_core_event_poll_add(int32_t poll, int32_t fd, uint32_t events, uint64_t data);
+
+/// Removes the descriptor.
+__attribute((swift_name("CLoobeeCoreEventPoll_remove(_:_:)")))
+int32_t c_loobee_core_event_poll_remove(int32_t poll, int32_t fd);
+
+/// Waits up to `timeout` milliseconds (-1 is infinite), returns the number of events.
+/// `count` is limited by `C_LOOBEE_CORE_EVENT_POLL_BATCH_SIZE`, interrupts return 0.
+__attribute((swift_name("CLoobeeCoreEventPoll_wait(_:_:_:_:)")))
+int32_t c_loobee_core_event_poll_wait(
+    int32_t poll,
+    c_loobee_core_event_poll_event_t *_Nonnull events,
+    int32_t count,
+    int32_t timeout
+);
+
+/// Creates a non-blocking `eventfd` used to wake up a waiting loop.
+__attribute((swift_name("CLoobeeCoreEventPoll_createWakeup()")))
+int32_t c_loobee_core_event_poll_create_wakeup(void);
+
+/// Makes the wakeup descriptor readable.
+__attribute((swift_name("CLoobeeCoreEventPoll_wakeup(_:)")))
+int32_t c_loobee_core_event_poll_wakeup(int32_t fd);
+
+/// Resets the wakeup descriptor.
+__attribute((swift_name("CLoobeeCoreEventPoll_drainWakeup(_:)")))
+int32_t c_loobee_core_event_poll_drain_wakeup(int32_t fd);
+
+/// Binds the calling thread to the processor.
+__attribute((swift_name("CLoobeeCoreEventPoll_pinThread(toProcessor:)")))
+int32_t c_loobee_core_event_poll_pin_thread(int32_t processor);
+
+#endif
@@ -0,0 +1,28 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+
+/// NUMA placement of mapped memory without `libnuma`. Nodes are limited to 64.
+
+/// Places the pages of the range on the nodes of the mask: on the first free node of the mask,
+/// or interleaved over the nodes if `isInterleaved` is true. Must be called before the pages
+/// are touched. Returns a negative `errno` on failure.
+__attribute((swift_name("CLoobeeCoreMemory_bind(_:_:_:isInterleaved:)")))
+int32_t c_loobee_core_memory_bind(void *_Nonnull address, size_t length, uint64_t nodeMask, bool isInterleaved);
+
+/// Returns the number of NUMA nodes (the highest node number plus one), 1 if it is unknown.
+__attribute((swift_name("CLoobeeCoreMemory_nodeCount()")))
+int32_t c_loobee_core_memory_node_count(void);
+
+#endif
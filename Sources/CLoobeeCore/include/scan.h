@@ -0,0 +1,67 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Scanning kernels. Each kernel has the scalar implementation and SIMD ones for x86-64,
+/// the selection is made in Swift by `CpuDispatch`. All implementations return identical results.
+
+/// func CLoobeeCoreScan_findByte#KERNEL#
+///
+/// Returns the index of the first `byte` in `data`, or `count` if there is no such byte.
+#define LOOBEE_SCAN_FIND_BYTE(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreScan_findByte"#swiftId"(_:_:_:)"))) /*
+*/   size_t c_loobee_core_scan_find_byte_##id(const void *_Nonnull data, size_t count, uint8_t byte);
+
+/// func CLoobeeCoreScan_asciiCaseInsensitiveEqual#KERNEL#
+///
+/// Returns true if the buffers are equal after mapping of ASCII `A-Z` to `a-z`.
+#define LOOBEE_SCAN_ASCII_CASE_INSENSITIVE_EQUAL(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreScan_asciiCaseInsensitiveEqual"#swiftId"(_:_:_:)"))) /*
+*/   bool c_loobee_core_scan_ascii_case_insensitive_equal_##id( /*
+*/                                     const void *_Nonnull lhs, /*
+*/                                     const void *_Nonnull rhs, /*
+*/                                     size_t count);
+
+/// func CLoobeeCoreScan_firstSetBit#KERNEL#
+///
+/// Returns the index of the lowest set bit in `count` words, or `count * 64` if all bits are zero.
+#define LOOBEE_SCAN_FIRST_SET_BIT(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreScan_firstSetBit"#swiftId"(_:_:)"))) /*
+*/   size_t c_loobee_core_scan_first_set_bit_##id(const uint64_t *_Nonnull words, size_t count);
+
+/// func CLoobeeCoreScan_findControl#KERNEL#
+///
+/// Returns the index of the first ASCII control character except HTAB (`0x00-0x08`, `0x0A-0x1F`, `0x7F`)
+/// in `data`, or `count` if there is no such character. Used to find line ends and invalid characters
+/// of HTTP messages in one pass.
+#define LOOBEE_SCAN_FIND_CONTROL(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreScan_findControl"#swiftId"(_:_:)"))) /*
+*/   size_t c_loobee_core_scan_find_control_##id(const void *_Nonnull data, size_t count);
+
+    LOOBEE_SCAN_FIND_BYTE(scalar, Scalar)
+    LOOBEE_SCAN_ASCII_CASE_INSENSITIVE_EQUAL(scalar, Scalar)
+    LOOBEE_SCAN_FIRST_SET_BIT(scalar, Scalar)
+    LOOBEE_SCAN_FIND_CONTROL(scalar, Scalar)
+#if defined(__x86_64__)
+    LOOBEE_SCAN_FIND_BYTE(sse2, Sse2)
+    LOOBEE_SCAN_FIND_BYTE(avx2, Avx2)
+    LOOBEE_SCAN_ASCII_CASE_INSENSITIVE_EQUAL(sse2, Sse2)
+    LOOBEE_SCAN_ASCII_CASE_INSENSITIVE_EQUAL(avx2, Avx2)
+    LOOBEE_SCAN_FIRST_SET_BIT(avx2, Avx2)
+    LOOBEE_SCAN_FIND_CONTROL(sse42, Sse42)
+    LOOBEE_SCAN_FIND_CONTROL(avx2, Avx2)
+#endif
+
+#undef LOOBEE_SCAN_FIND_BYTE
+#undef LOOBEE_SCAN_ASCII_CASE_INSENSITIVE_EQUAL
+#undef LOOBEE_SCAN_FIRST_SET_BIT
+#undef LOOBEE_SCAN_FIND_CONTROL
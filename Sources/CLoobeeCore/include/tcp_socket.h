@@ -0,0 +1,56 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#if defined(__linux__)
+
+/// Non-blocking IPv4 TCP sockets. All functions return a negative `errno` on failure.
+
+/// Maximum number of buffers passed to one `c_loobee_core_socket_write_vector`.
+#define C_LOOBEE_CORE_SOCKET_MAX_VECTOR_COUNT 64
+
+/// Creates a listening socket bound to `host:port`. With `reusePort` sockets of several threads
+/// can be bound to the same port, and the kernel distributes connections between them.
+__attribute((swift_name("CLoobeeCoreSocket_listen(_:_:_:_:)")))
+int32_t c_loobee_core_socket_listen(const char *_Nonnull host, uint16_t port, int32_t backlog, bool reusePort);
+
+/// Starts a connection to `host:port`, the socket becomes writable when it is established.
+__attribute((swift_name("CLoobeeCoreSocket_connect(_:_:)")))
+int32_t c_loobee_core_socket_connect(const char *_Nonnull host, uint16_t port);
+
+/// Accepts a connection as a non-blocking socket with `TCP_NODELAY`, `-EAGAIN` if there is none.
+__attribute((swift_name("CLoobeeCoreSocket_accept(_:)")))
+int32_t c_loobee_core_socket_accept(int32_t fd);
+
+/// Returns the local port of the socket.
+__attribute((swift_name("CLoobeeCoreSocket_localPort(_:)")))
+int32_t c_loobee_core_socket_local_port(int32_t fd);
+
+/// Returns the pending error of the socket (`SO_ERROR`) as a negative `errno`, 0 if there is none.
+__attribute((swift_name("CLoobeeCoreSocket_pendingError(_:)")))
+int32_t c_loobee_core_socket_pending_error(int32_t fd);
+
+/// Reads up to `count` bytes, returns 0 if the peer is closed.
+__attribute((swift_name("CLoobeeCoreSocket_read(_:_:_:)")))
+ssize_t c_loobee_core_socket_read(int32_t fd, void *_Nonnull buffer, size_t count);
+
+/// Writes the buffers with one system call, `count` is limited by `C_LOOBEE_CORE_SOCKET_MAX_VECTOR_COUNT`.
+__attribute((swift_name("CLoobeeCoreSocket_writeVector(_:_:_:)")))
+ssize_t c_loobee_core_socket_write_vector(int32_t fd, const struct iovec *_Nonnull vector, int32_t count);
+
+/// Closes the socket.
+__attribute((swift_name("CLoobeeCoreSocket_close(_:)")))
+void c_loobee_core_socket_close(int32_t fd);
+
+#endif
@@ -0,0 +1,28 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stdint.h>
+
+/// Reads the time stamp counter after all previous instructions are completed.
+///
+/// `lfence` keeps `rdtsc` from being executed ahead of the measured code. The counter ticks
+/// at a constant rate on processors with the invariant TSC (CPUID 0x80000007, EDX bit 8).
+static __inline__ __attribute__((__always_inline__))
+__attribute((swift_name("CLoobeeCoreReadTimestampCounter()")))
+uint64_t c_loobee_core_read_timestamp_counter(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t low;
+    uint32_t high;
+    __asm__ __volatile__("lfence\n\trdtsc" : "=a"(low), "=d"(high) : : "memory");
+
+    return ((uint64_t)high << 32) | low;
+#else
+#   error Is not supported.
+#endif
+}
@@ -0,0 +1,62 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/// Accumulators of the wide hash: 8 lanes of 64 bits, one 64-byte stripe of input is mixed per step.
+///
+/// For each lane `i` of the stripe: `acc[i ^ 1] += data[i]`,
+/// `acc[i] += lo32(data[i] ^ keys[i]) * hi32(data[i] ^ keys[i])`.
+/// Scrambling: `acc[i] = (acc[i] ^ (acc[i] >> 47) ^ keys[8 + i]) * 0x9E3779B1`.
+///
+/// All kernels produce identical results, the SIMD ones process 2 (SSE2) or 4 (AVX2) lanes at once.
+/// `data` can be unaligned, `keys` contains at least 16 values.
+
+/// func CLoobeeCoreWideHash_accumulate#KERNEL#
+/// func CLoobeeCoreWideHash_scramble#KERNEL#
+#define LOOBEE_WIDE_HASH_KERNEL(id, swiftId) /*
+*/   __attribute((swift_name("CLoobeeCoreWideHash_accumulate"#swiftId"(_:_:_:_:)"))) /*
+*/   void c_loobee_core_wide_hash_accumulate_##id( /*
+*/                                     uint64_t *_Nonnull acc, /*
+*/                                     const void *_Nonnull data, /*
+*/                                     size_t stripes, /*
+*/                                     const uint64_t *_Nonnull keys); /*
+*/   __attribute((swift_name("CLoobeeCoreWideHash_scramble"#swiftId"(_:_:)"))) /*
+*/   void c_loobee_core_wide_hash_scramble_##id(uint64_t *_Nonnull acc, const uint64_t *_Nonnull keys);
+
+    LOOBEE_WIDE_HASH_KERNEL(scalar, Scalar)
+#if defined(__x86_64__)
+    LOOBEE_WIDE_HASH_KERNEL(sse2, Sse2)
+    LOOBEE_WIDE_HASH_KERNEL(avx2, Avx2)
+#endif
+#undef LOOBEE_WIDE_HASH_KERNEL
+
+/// func CLoobeeCoreWideHash_read64
+///
+/// Unaligned load of 8 bytes in the native byte order.
+static __inline__ __attribute__((__always_inline__))
+__attribute((swift_name("CLoobeeCoreWideHash_read64(_:)")))
+uint64_t c_loobee_core_wide_hash_read64(const void *_Nonnull data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// func CLoobeeCoreWideHash_read32
+///
+/// Unaligned load of 4 bytes in the native byte order.
+static __inline__ __attribute__((__always_inline__))
+__attribute((swift_name("CLoobeeCoreWideHash_read32(_:)")))
+uint32_t c_loobee_core_wide_hash_read32(const void *_Nonnull data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
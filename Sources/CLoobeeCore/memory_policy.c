@@ -0,0 +1,50 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if defined(__linux__)
+
+#define _GNU_SOURCE
+
+#include "memory_policy.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Values of `linux/mempolicy.h`.
+#define C_LOOBEE_CORE_MPOL_BIND 2
+#define C_LOOBEE_CORE_MPOL_INTERLEAVE 3
+
+#define C_LOOBEE_CORE_MAX_NODE_COUNT 64
+
+int32_t c_loobee_core_memory_bind(void *_Nonnull address, size_t length, uint64_t nodeMask, bool isInterleaved) {
+    unsigned long mask = (unsigned long)nodeMask;
+    int mode = isInterleaved ? C_LOOBEE_CORE_MPOL_INTERLEAVE : C_LOOBEE_CORE_MPOL_BIND;
+
+    // The kernel reads `maxnode - 1` bits.
+    long result = syscall(SYS_mbind, address, length, mode, &mask, C_LOOBEE_CORE_MAX_NODE_COUNT + 1, 0);
+
+    return result < 0 ? -errno : 0;
+}
+
+int32_t c_loobee_core_memory_node_count(void) {
+    int32_t count = 1;
+    char path[64];
+
+    // Numbers of nodes can have gaps.
+    for (int32_t node = 1; node < C_LOOBEE_CORE_MAX_NODE_COUNT; ++node) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", node);
+        if (access(path, F_OK) == 0) {
+            count = node + 1;
+        }
+    }
+
+    return count;
+}
+
+#endif
@@ -0,0 +1,231 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#include "scan.h"
+
+#if defined(__x86_64__)
+#   include <immintrin.h>
+#endif
+
+static __inline__ __attribute__((__always_inline__))
+uint8_t c_loobee_core_scan_ascii_to_lower(uint8_t byte) {
+    return (uint8_t)(byte - 'A') < 26 ? (uint8_t)(byte | 0x20) : byte;
+}
+
+size_t c_loobee_core_scan_find_byte_scalar(const void *_Nonnull data, size_t count, uint8_t byte) {
+    const uint8_t *input = (const uint8_t *)data;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (input[i] == byte) {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+bool c_loobee_core_scan_ascii_case_insensitive_equal_scalar(
+    const void *_Nonnull lhs,
+    const void *_Nonnull rhs,
+    size_t count
+) {
+    const uint8_t *left = (const uint8_t *)lhs;
+    const uint8_t *right = (const uint8_t *)rhs;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (c_loobee_core_scan_ascii_to_lower(left[i]) != c_loobee_core_scan_ascii_to_lower(right[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t c_loobee_core_scan_first_set_bit_scalar(const uint64_t *_Nonnull words, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (words[i] != 0) {
+            return i * 64 + (size_t)__builtin_ctzll(words[i]);
+        }
+    }
+
+    return count * 64;
+}
+
+static __inline__ __attribute__((__always_inline__))
+bool c_loobee_core_scan_is_control(uint8_t byte) {
+    return (byte < 0x20 && byte != '\t') || byte == 0x7F;
+}
+
+size_t c_loobee_core_scan_find_control_scalar(const void *_Nonnull data, size_t count) {
+    const uint8_t *input = (const uint8_t *)data;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (c_loobee_core_scan_is_control(input[i])) {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse2")))
+size_t c_loobee_core_scan_find_byte_sse2(const void *_Nonnull data, size_t count, uint8_t byte) {
+    const uint8_t *input = (const uint8_t *)data;
+    const __m128i needle = _mm_set1_epi8((char)byte);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(input + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    return i + c_loobee_core_scan_find_byte_scalar(input + i, count - i, byte);
+}
+
+__attribute__((target("avx2,bmi")))
+size_t c_loobee_core_scan_find_byte_avx2(const void *_Nonnull data, size_t count, uint8_t byte) {
+    const uint8_t *input = (const uint8_t *)data;
+    const __m256i needle = _mm256_set1_epi8((char)byte);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(input + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    return i + c_loobee_core_scan_find_byte_sse2(input + i, count - i, byte);
+}
+
+/// Maps `A-Z` to `a-z`: `byte + 63` is in [-128, -103] as a signed byte only for `A-Z`.
+__attribute__((target("sse2")))
+static __inline__ __m128i c_loobee_core_scan_ascii_to_lower_sse2(__m128i value) {
+    __m128i shifted = _mm_add_epi8(value, _mm_set1_epi8(63));
+    __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(-102), shifted);
+    return _mm_or_si128(value, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2")))
+static __inline__ __m256i c_loobee_core_scan_ascii_to_lower_avx2(__m256i value) {
+    __m256i shifted = _mm256_add_epi8(value, _mm256_set1_epi8(63));
+    __m256i isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(-102), shifted);
+    return _mm256_or_si256(value, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("sse2")))
+bool c_loobee_core_scan_ascii_case_insensitive_equal_sse2(
+    const void *_Nonnull lhs,
+    const void *_Nonnull rhs,
+    size_t count
+) {
+    const uint8_t *left = (const uint8_t *)lhs;
+    const uint8_t *right = (const uint8_t *)rhs;
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i leftChunk = c_loobee_core_scan_ascii_to_lower_sse2(_mm_loadu_si128((const __m128i *)(left + i)));
+        __m128i rightChunk = c_loobee_core_scan_ascii_to_lower_sse2(_mm_loadu_si128((const __m128i *)(right + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(leftChunk, rightChunk)) != 0xFFFF) {
+            return false;
+        }
+    }
+
+    return c_loobee_core_scan_ascii_case_insensitive_equal_scalar(left + i, right + i, count - i);
+}
+
+__attribute__((target("avx2")))
+bool c_loobee_core_scan_ascii_case_insensitive_equal_avx2(
+    const void *_Nonnull lhs,
+    const void *_Nonnull rhs,
+    size_t count
+) {
+    const uint8_t *left = (const uint8_t *)lhs;
+    const uint8_t *right = (const uint8_t *)rhs;
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i leftChunk = c_loobee_core_scan_ascii_to_lower_avx2(_mm256_loadu_si256((const __m256i *)(left + i)));
+        __m256i rightChunk = c_loobee_core_scan_ascii_to_lower_avx2(_mm256_loadu_si256((const __m256i *)(right + i)));
+        if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(leftChunk, rightChunk)) != 0xFFFFFFFFU) {
+            return false;
+        }
+    }
+
+    return c_loobee_core_scan_ascii_case_insensitive_equal_sse2(left + i, right + i, count - i);
+}
+
+__attribute__((target("avx2,bmi")))
+size_t c_loobee_core_scan_first_set_bit_avx2(const uint64_t *_Nonnull words, size_t count) {
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(words + i));
+        if (!_mm256_testz_si256(chunk, chunk)) {
+            break;
+        }
+    }
+
+    for (; i < count; ++i) {
+        if (words[i] != 0) {
+            return i * 64 + (size_t)_tzcnt_u64(words[i]);
+        }
+    }
+
+    return count * 64;
+}
+
+/// Uses `pcmpestri` in the ranges mode, as in [picohttpparser](https://github.com/h2o/picohttpparser).
+__attribute__((target("sse4.2")))
+size_t c_loobee_core_scan_find_control_sse42(const void *_Nonnull data, size_t count) {
+    static const char rangesData[16] = "\000\010\012\037\177\177";
+    const __m128i ranges = _mm_loadu_si128((const __m128i *)rangesData);
+    const uint8_t *input = (const uint8_t *)data;
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(input + i));
+        int index = _mm_cmpestri(ranges, 6, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (index != 16) {
+            return i + (size_t)index;
+        }
+    }
+
+    return i + c_loobee_core_scan_find_control_scalar(input + i, count - i);
+}
+
+__attribute__((target("avx2,bmi")))
+size_t c_loobee_core_scan_find_control_avx2(const void *_Nonnull data, size_t count) {
+    const __m256i maxControl = _mm256_set1_epi8(0x1F);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i del = _mm256_set1_epi8(0x7F);
+    const uint8_t *input = (const uint8_t *)data;
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(input + i));
+        __m256i isLow = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, maxControl), chunk);
+        __m256i isControl = _mm256_or_si256(
+            _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, tab), isLow),
+            _mm256_cmpeq_epi8(chunk, del)
+        );
+        unsigned mask = (unsigned)_mm256_movemask_epi8(isControl);
+        if (mask != 0) {
+            return i + (size_t)_tzcnt_u32(mask);
+        }
+    }
+
+    return i + c_loobee_core_scan_find_control_sse42(input + i, count - i);
+}
+
+#endif
@@ -0,0 +1,142 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if defined(__linux__)
+
+#define _GNU_SOURCE
+
+#include "tcp_socket.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int c_loobee_core_socket_address(const char *_Nonnull host, uint16_t port, struct sockaddr_in *address) {
+    address->sin_family = AF_INET;
+    address->sin_port = htons(port);
+
+    return inet_pton(AF_INET, host, &address->sin_addr) == 1 ? 0 : -EINVAL;
+}
+
+static int32_t c_loobee_core_socket_fail(int fd) {
+    int code = errno;
+    close(fd);
+
+    return -code;
+}
+
+int32_t c_loobee_core_socket_listen(const char *_Nonnull host, uint16_t port, int32_t backlog, bool reusePort) {
+    struct sockaddr_in address = {0};
+    if (c_loobee_core_socket_address(host, port, &address) < 0) {
+        return -EINVAL;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    int one = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0
+        || (reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0)
+        || bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0
+        || listen(fd, backlog) < 0) {
+        return c_loobee_core_socket_fail(fd);
+    }
+
+    return fd;
+}
+
+int32_t c_loobee_core_socket_connect(const char *_Nonnull host, uint16_t port) {
+    struct sockaddr_in address = {0};
+    if (c_loobee_core_socket_address(host, port, &address) < 0) {
+        return -EINVAL;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    int one = 1;
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+        return c_loobee_core_socket_fail(fd);
+    }
+
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0 && errno != EINPROGRESS) {
+        return c_loobee_core_socket_fail(fd);
+    }
+
+    return fd;
+}
+
+int32_t c_loobee_core_socket_accept(int32_t fd) {
+    int connection = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (connection < 0) {
+        return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+    }
+
+    int one = 1;
+    if (setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+        return c_loobee_core_socket_fail(connection);
+    }
+
+    return connection;
+}
+
+int32_t c_loobee_core_socket_local_port(int32_t fd) {
+    struct sockaddr_in address = {0};
+    socklen_t length = sizeof(address);
+
+    return getsockname(fd, (struct sockaddr *)&address, &length) < 0 ? -errno : ntohs(address.sin_port);
+}
+
+int32_t c_loobee_core_socket_pending_error(int32_t fd) {
+    int code = 0;
+    socklen_t length = sizeof(code);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &code, &length) < 0) {
+        return -errno;
+    }
+
+    return -code;
+}
+
+ssize_t c_loobee_core_socket_read(int32_t fd, void *_Nonnull buffer, size_t count) {
+    ssize_t result;
+    do {
+        result = read(fd, buffer, count);
+    } while (result < 0 && errno == EINTR);
+
+    return result < 0 ? (errno == EWOULDBLOCK ? -EAGAIN : -errno) : result;
+}
+
+ssize_t c_loobee_core_socket_write_vector(int32_t fd, const struct iovec *_Nonnull vector, int32_t count) {
+    if (count > C_LOOBEE_CORE_SOCKET_MAX_VECTOR_COUNT) {
+        count = C_LOOBEE_CORE_SOCKET_MAX_VECTOR_COUNT;
+    }
+
+    // `sendmsg` instead of `writev` to suppress SIGPIPE on closed connections.
+    struct msghdr message = {0};
+    message.msg_iov = (struct iovec *)vector;
+    message.msg_iovlen = (size_t)count;
+
+    ssize_t result;
+    do {
+        result = sendmsg(fd, &message, MSG_NOSIGNAL);
+    } while (result < 0 && errno == EINTR);
+
+    return result < 0 ? (errno == EWOULDBLOCK ? -EAGAIN : -errno) : result;
+}
+
+void c_loobee_core_socket_close(int32_t fd) {
+    close(fd);
+}
+
+#endif
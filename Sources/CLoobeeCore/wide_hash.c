@@ -0,0 +1,143 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#include "wide_hash.h"
+
+#if defined(__x86_64__)
+#   include <immintrin.h>
+#endif
+
+#define LOOBEE_WIDE_HASH_STRIPE_SIZE 64
+#define LOOBEE_WIDE_HASH_PRIME32 0x9E3779B1U
+
+void c_loobee_core_wide_hash_accumulate_scalar(
+    uint64_t *_Nonnull acc,
+    const void *_Nonnull data,
+    size_t stripes,
+    const uint64_t *_Nonnull keys
+) {
+    const unsigned char *input = (const unsigned char *)data;
+
+    for (size_t stripe = 0; stripe < stripes; ++stripe, input += LOOBEE_WIDE_HASH_STRIPE_SIZE) {
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t value = c_loobee_core_wide_hash_read64(input + 8 * i);
+            uint64_t key = value ^ keys[i];
+
+            acc[i ^ 1] += value;
+            acc[i] += (key & 0xFFFFFFFFU) * (key >> 32);
+        }
+    }
+}
+
+void c_loobee_core_wide_hash_scramble_scalar(uint64_t *_Nonnull acc, const uint64_t *_Nonnull keys) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t value = acc[i];
+        value ^= value >> 47;
+        value ^= keys[8 + i];
+        acc[i] = value * LOOBEE_WIDE_HASH_PRIME32;
+    }
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse2")))
+void c_loobee_core_wide_hash_accumulate_sse2(
+    uint64_t *_Nonnull acc,
+    const void *_Nonnull data,
+    size_t stripes,
+    const uint64_t *_Nonnull keys
+) {
+    const unsigned char *input = (const unsigned char *)data;
+    __m128i lanes[4];
+    __m128i keyLanes[4];
+
+    for (size_t i = 0; i < 4; ++i) {
+        lanes[i] = _mm_loadu_si128((const __m128i *)(acc + 2 * i));
+        keyLanes[i] = _mm_loadu_si128((const __m128i *)(keys + 2 * i));
+    }
+
+    for (size_t stripe = 0; stripe < stripes; ++stripe, input += LOOBEE_WIDE_HASH_STRIPE_SIZE) {
+        for (size_t i = 0; i < 4; ++i) {
+            __m128i value = _mm_loadu_si128((const __m128i *)(input + 16 * i));
+            __m128i key = _mm_xor_si128(value, keyLanes[i]);
+            __m128i keyHigh = _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i product = _mm_mul_epu32(key, keyHigh);
+            __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+            lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        _mm_storeu_si128((__m128i *)(acc + 2 * i), lanes[i]);
+    }
+}
+
+__attribute__((target("sse2")))
+void c_loobee_core_wide_hash_scramble_sse2(uint64_t *_Nonnull acc, const uint64_t *_Nonnull keys) {
+    const __m128i prime = _mm_set1_epi32((int)LOOBEE_WIDE_HASH_PRIME32);
+
+    for (size_t i = 0; i < 4; ++i) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(acc + 2 * i));
+        value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+        value = _mm_xor_si128(value, _mm_loadu_si128((const __m128i *)(keys + 8 + 2 * i)));
+
+        __m128i low = _mm_mul_epu32(value, prime);
+        __m128i high = _mm_mul_epu32(_mm_srli_epi64(value, 32), prime);
+        _mm_storeu_si128((__m128i *)(acc + 2 * i), _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+    }
+}
+
+__attribute__((target("avx2")))
+void c_loobee_core_wide_hash_accumulate_avx2(
+    uint64_t *_Nonnull acc,
+    const void *_Nonnull data,
+    size_t stripes,
+    const uint64_t *_Nonnull keys
+) {
+    const unsigned char *input = (const unsigned char *)data;
+    __m256i lanes[2];
+    __m256i keyLanes[2];
+
+    for (size_t i = 0; i < 2; ++i) {
+        lanes[i] = _mm256_loadu_si256((const __m256i *)(acc + 4 * i));
+        keyLanes[i] = _mm256_loadu_si256((const __m256i *)(keys + 4 * i));
+    }
+
+    for (size_t stripe = 0; stripe < stripes; ++stripe, input += LOOBEE_WIDE_HASH_STRIPE_SIZE) {
+        for (size_t i = 0; i < 2; ++i) {
+            __m256i value = _mm256_loadu_si256((const __m256i *)(input + 32 * i));
+            __m256i key = _mm256_xor_si256(value, keyLanes[i]);
+            __m256i keyHigh = _mm256_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m256i product = _mm256_mul_epu32(key, keyHigh);
+            __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+            lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+        }
+    }
+
+    for (size_t i = 0; i < 2; ++i) {
+        _mm256_storeu_si256((__m256i *)(acc + 4 * i), lanes[i]);
+    }
+}
+
+__attribute__((target("avx2")))
+void c_loobee_core_wide_hash_scramble_avx2(uint64_t *_Nonnull acc, const uint64_t *_Nonnull keys) {
+    const __m256i prime = _mm256_set1_epi32((int)LOOBEE_WIDE_HASH_PRIME32);
+
+    for (size_t i = 0; i < 2; ++i) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(acc + 4 * i));
+        value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+        value = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i *)(keys + 8 + 4 * i)));
+
+        __m256i low = _mm256_mul_epu32(value, prime);
+        __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+        _mm256_storeu_si256((__m256i *)(acc + 4 * i), _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+    }
+}
+
+#endif
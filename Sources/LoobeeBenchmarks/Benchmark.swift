@@ -0,0 +1,53 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Measured piece of work.
+///
+///     Benchmark(name: "hash.fnv64.4096", unit: .bytes, amount: 4096) {
+///         blackHole(fnv64(buffer))
+///     }
+internal struct Benchmark {
+    /// What `amount` counts.
+    internal enum Unit: String, Codable {
+        case operations
+        case bytes
+    }
+
+    /// Unique name, groups are separated by dots.
+    internal let name: String
+
+    internal let unit: Unit
+
+    /// The number of operations or bytes processed by one call of `body`.
+    internal let amount: Int
+
+    /// Executes the work once, the runner repeats it to get samples of a measurable duration.
+    internal let body: () -> Void
+
+    /// Releases resources of the benchmark, called after the last sample.
+    internal let tearDown: () -> Void
+
+    internal init(
+        name: String,
+        unit: Unit = .operations,
+        amount: Int,
+        tearDown: @escaping () -> Void = {},
+        body: @escaping () -> Void
+    ) {
+        self.name = name
+        self.unit = unit
+        self.amount = amount
+        self.tearDown = tearDown
+        self.body = body
+    }
+}
+
+/// Keeps the value alive, so the optimizer cannot remove the computation of it.
+@inline(never)
+@_optimize(none)
+internal func blackHole<T>(_ value: T) {
+}
@@ -0,0 +1,33 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Sources of time for samples: the monotonic clock for durations and the time stamp counter
+/// for cycles.
+internal enum BenchmarkClock {
+    /// Nanoseconds of the monotonic clock.
+    @inline(__always)
+    internal static func nanoseconds() -> UInt64 {
+        var time = timespec()
+        clock_gettime(CLOCK_MONOTONIC, &time)
+
+        return UInt64(time.tv_sec) &* 1_000_000_000 &+ UInt64(time.tv_nsec)
+    }
+
+    /// Ticks of the time stamp counter.
+    @inline(__always)
+    internal static func cycles() -> UInt64 {
+        return CLoobeeCoreReadTimestampCounter()
+    }
+}
@@ -0,0 +1,72 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import Foundation
+import LoobeeCore
+
+/// Results of a run with the description of the machine, stored as JSON.
+internal struct BenchmarkReport: Codable {
+    internal let cpuFeatureLevel: String
+    internal let processorCount: Int
+    internal let results: [BenchmarkResult]
+
+    internal init(results: [BenchmarkResult]) {
+        self.cpuFeatureLevel = Environment.current.cpuFeatureLevel.name
+        self.processorCount = NativeThread.processorCount
+        self.results = results
+    }
+
+    internal static func read(from path: String) throws -> BenchmarkReport {
+        let data = try Data(contentsOf: URL(fileURLWithPath: path))
+
+        return try JSONDecoder().decode(BenchmarkReport.self, from: data)
+    }
+
+    internal func write(to path: String) throws {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = .prettyPrinted
+
+        try encoder.encode(self).write(to: URL(fileURLWithPath: path))
+    }
+
+    /// Compares the median time per unit of benchmarks that are present in both reports.
+    internal func compare(with baseline: BenchmarkReport) -> [BenchmarkComparison] {
+        var baselineResults: [String: BenchmarkResult] = [:]
+        for result in baseline.results {
+            baselineResults[result.name] = result
+        }
+
+        return self.results.compactMap { result in
+            baselineResults[result.name].map {
+                BenchmarkComparison(
+                    name: result.name,
+                    baselineNanoseconds: $0.nanosecondsPerUnit,
+                    currentNanoseconds: result.nanosecondsPerUnit
+                )
+            }
+        }
+    }
+}
+
+/// Change of the median time per unit of a benchmark.
+internal struct BenchmarkComparison {
+    internal let name: String
+    internal let baselineNanoseconds: Double
+    internal let currentNanoseconds: Double
+
+    /// Relative change of the time, positive values are slowdowns.
+    internal var change: Double {
+        return self.currentNanoseconds / self.baselineNanoseconds - 1
+    }
+
+    /// Returns true if the benchmark is slower than the baseline by more than the threshold.
+    ///
+    /// - Parameter threshold: Allowed relative slowdown, e.g. `0.1` for 10%.
+    internal func isRegression(threshold: Double) -> Bool {
+        return self.change > threshold
+    }
+}
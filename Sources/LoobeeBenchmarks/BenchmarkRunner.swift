@@ -0,0 +1,106 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Result of a benchmark, durations are per sample.
+internal struct BenchmarkResult: Codable {
+    internal let name: String
+    internal let unit: Benchmark.Unit
+
+    /// The number of operations or bytes processed by one sample.
+    internal let amount: Int
+
+    internal let samples: Int
+    internal let medianNanoseconds: Double
+    internal let p99Nanoseconds: Double
+    internal let minimumNanoseconds: Double
+
+    /// Median duration of one operation or byte.
+    internal let nanosecondsPerUnit: Double
+
+    /// Median number of time stamp counter ticks of one operation or byte.
+    internal let cyclesPerUnit: Double
+
+    /// Operations or bytes per second of the median sample.
+    internal let unitsPerSecond: Double
+}
+
+/// Runs benchmarks: calibrates the number of calls per sample, warms up and takes samples.
+internal struct BenchmarkRunner {
+    /// The number of samples that are not recorded.
+    internal let warmupIterations: Int
+
+    /// The number of recorded samples.
+    internal let iterations: Int
+
+    /// Samples are extended by repeating the body until they take at least this time.
+    internal let minimumSampleNanoseconds: UInt64
+
+    internal init(warmupIterations: Int = 5, iterations: Int = 30, minimumSampleNanoseconds: UInt64 = 1_000_000) {
+        assert(iterations > 0, "BenchmarkRunner: Iterations must be greater than 0.")
+
+        self.warmupIterations = warmupIterations
+        self.iterations = iterations
+        self.minimumSampleNanoseconds = minimumSampleNanoseconds
+    }
+
+    internal func run(_ benchmark: Benchmark) -> BenchmarkResult {
+        var repeats = 1
+        while true {
+            let duration = self.sample(benchmark, repeats: repeats).nanoseconds
+            if duration >= self.minimumSampleNanoseconds || repeats >= 1 << 30 {
+                break
+            }
+
+            // Grows by the ratio at most 10 times per step, the first calls can be slow.
+            let ratio = Double(self.minimumSampleNanoseconds) / Double(max(duration, 1))
+            repeats = Int(Double(repeats) * min(max(ratio * 1.2, 2), 10))
+        }
+
+        for _ in 0..<self.warmupIterations {
+            _ = self.sample(benchmark, repeats: repeats)
+        }
+
+        var durations: [UInt64] = []
+        var cycles: [UInt64] = []
+        for _ in 0..<self.iterations {
+            let sample = self.sample(benchmark, repeats: repeats)
+            durations.append(sample.nanoseconds)
+            cycles.append(sample.cycles)
+        }
+        durations.sort()
+        cycles.sort()
+
+        let amount = benchmark.amount * repeats
+        let median = Double(durations[durations.count / 2])
+
+        return BenchmarkResult(
+            name: benchmark.name,
+            unit: benchmark.unit,
+            amount: amount,
+            samples: self.iterations,
+            medianNanoseconds: median,
+            p99Nanoseconds: Double(durations[min(durations.count - 1, durations.count * 99 / 100)]),
+            minimumNanoseconds: Double(durations[0]),
+            nanosecondsPerUnit: median / Double(amount),
+            cyclesPerUnit: Double(cycles[cycles.count / 2]) / Double(amount),
+            unitsPerSecond: Double(amount) * 1e9 / max(median, 1)
+        )
+    }
+
+    private func sample(_ benchmark: Benchmark, repeats: Int) -> (nanoseconds: UInt64, cycles: UInt64) {
+        let body = benchmark.body
+        let startCycles = BenchmarkClock.cycles()
+        let start = BenchmarkClock.nanoseconds()
+        for _ in 0..<repeats {
+            body()
+        }
+        let end = BenchmarkClock.nanoseconds()
+        let endCycles = BenchmarkClock.cycles()
+
+        return (end - start, endCycles &- startCycles)
+    }
+}
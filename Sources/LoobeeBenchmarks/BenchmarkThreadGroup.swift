@@ -0,0 +1,88 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Threads that execute the body at once on each `run()`, for contended benchmarks.
+///
+/// Threads are started by the first `run()` and wait for the next one on a futex, so samples
+/// do not include the creation of threads.
+internal final class BenchmarkThreadGroup {
+    internal let count: Int
+
+    private let body: (Int) -> Void
+    private let generation = Atomic<UInt32>(0)
+    private let remaining = Atomic<Int>(0)
+    private let isStopped = Atomic<Bool>(false)
+    private var threads: [NativeThread] = []
+
+    /// - Parameter count: The number of threads.
+    /// - Parameter body:  Work of a thread, receives the index of the thread.
+    internal init(count: Int, body: @escaping (Int) -> Void) {
+        assert(count > 0, "BenchmarkThreadGroup: Count must be greater than 0.")
+
+        self.count = count
+        self.body = body
+    }
+
+    deinit {
+        self.stop()
+    }
+
+    /// Executes the body on all threads, returns when all threads have finished.
+    internal func run() {
+        if self.threads.isEmpty {
+            self.threads = (0..<self.count).map { self.start(index: $0) }
+        }
+
+        self.remaining.store(self.count, withOrder: .release)
+        _ = self.generation.fetchAndAdd(1, withOrder: .acqRel)
+        self.generation.notifyAll()
+
+        while self.remaining.load(withOrder: .acquire) != 0 {
+            NativeThread.yield()
+        }
+    }
+
+    /// Stops and joins the threads.
+    internal func stop() {
+        self.isStopped.store(true, withOrder: .seqCst)
+        _ = self.generation.fetchAndAdd(1, withOrder: .seqCst)
+        self.generation.notifyAll()
+
+        for thread in self.threads {
+            thread.join()
+        }
+        self.threads.removeAll()
+        self.isStopped.store(false, withOrder: .seqCst)
+    }
+
+    private func start(index: Int) -> NativeThread {
+        let body = self.body
+        let generation = self.generation
+        let remaining = self.remaining
+        let isStopped = self.isStopped
+        // Loaded before the thread starts, so the next `run()` is not missed.
+        var seen = generation.load(withOrder: .acquire)
+
+        return NativeThread {
+            while true {
+                while generation.load(withOrder: .acquire) == seen {
+                    generation.wait(expected: seen)
+                }
+                seen = generation.load(withOrder: .acquire)
+
+                if isStopped.load(withOrder: .seqCst) {
+                    return
+                }
+
+                body(index)
+                _ = remaining.fetchAndSub(1, withOrder: .acqRel)
+            }
+        }
+    }
+}
@@ -0,0 +1,282 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+import LoobeeHttp
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Protocol of a load test.
+internal enum LoadTestMode: String {
+    /// Persistent connections: each sends `LoadTest.echoRequestsPerConnection` messages one after another
+    /// and reconnects.
+    case echo
+
+    /// A connection per request: the server parses the request, responds and closes the connection.
+    case http
+}
+
+/// Result of a load test.
+internal struct LoadTestResult {
+    /// Duration of the test.
+    internal let seconds: Double
+
+    /// Number of connections that got all responses.
+    internal let connectionCount: Int
+
+    internal let requestCount: Int
+
+    /// Number of connections that failed or were closed before a response.
+    internal let errorCount: Int
+
+    /// Sorted durations of requests in nanoseconds.
+    internal let latencies: [UInt64]
+
+    internal var connectionsPerSecond: Double {
+        return Double(self.connectionCount) / self.seconds
+    }
+
+    internal var requestsPerSecond: Double {
+        return Double(self.requestCount) / self.seconds
+    }
+
+    /// Returns the latency of the fraction of requests, e.g. 0.99 for p99.
+    internal func latency(percentile: Double) -> UInt64 {
+        if self.latencies.isEmpty {
+            return 0
+        }
+
+        return self.latencies[min(self.latencies.count - 1, Int(Double(self.latencies.count) * percentile))]
+    }
+}
+
+#if os(Linux)
+
+/// Server handler of the echo test.
+private final class LoadTestEchoHandler: TcpConnectionHandler {
+    func connection(_ connection: TcpConnection, didRead buffer: IOBuffer) {
+        connection.write(buffer)
+    }
+
+    func connectionDidClose(_ connection: TcpConnection, error: SocketError?) {
+    }
+}
+
+/// Server handler of the HTTP test.
+private final class LoadTestHttpHandler: TcpConnectionHandler {
+    private var parser = HttpRequestParser()
+    private var received: [UInt8] = []
+    private var isResponded = false
+
+    func connection(_ connection: TcpConnection, didRead buffer: IOBuffer) {
+        self.received.append(contentsOf: buffer.bytes)
+        buffer.release()
+        if self.isResponded {
+            return
+        }
+
+        let result = self.received.withUnsafeBytes { bytes in
+            self.parser.parse(bytes)
+        }
+        switch result {
+        case .incomplete:
+            return
+        case .complete:
+            LoadTest.httpResponse.withUnsafeBytes { connection.write($0) }
+        case .invalid:
+            LoadTest.httpBadRequest.withUnsafeBytes { connection.write($0) }
+        }
+
+        self.isResponded = true
+        connection.close()
+    }
+
+    func connectionDidClose(_ connection: TcpConnection, error: SocketError?) {
+    }
+}
+
+/// One client connection of the test, reconnects until the test is stopped.
+/// Works on its loop only, the results are read after the loop is shut down.
+private final class LoadTestClient: TcpConnectionHandler {
+    let loop: EventLoop
+
+    private unowned let test: LoadTest
+
+    private var requestStart: UInt64 = 0
+    private var responseCount = 0
+
+    /// Number of received bytes of the current response.
+    private var receivedCount = 0
+
+    private(set) var latencies: [UInt64] = []
+    private(set) var connectionCount = 0
+    private(set) var errorCount = 0
+
+    init(test: LoadTest, loop: EventLoop) {
+        self.test = test
+        self.loop = loop
+    }
+
+    func start() {
+        self.responseCount = 0
+        let connection = TcpConnection.connect(to: "127.0.0.1", port: self.test.port, on: self.loop, handler: self)
+        // The first request includes the connect.
+        self.send(on: connection)
+    }
+
+    func connection(_ connection: TcpConnection, didRead buffer: IOBuffer) {
+        self.receivedCount += buffer.count
+        buffer.release()
+        if self.receivedCount < self.test.response.count {
+            return
+        }
+
+        self.latencies.append(BenchmarkClock.nanoseconds() - self.requestStart)
+        self.responseCount += 1
+
+        // The HTTP server closes the connection after the response.
+        if self.test.mode == .echo {
+            if self.responseCount < LoadTest.echoRequestsPerConnection && !self.test.isStopped.load() {
+                self.send(on: connection)
+            } else {
+                connection.close()
+            }
+        }
+    }
+
+    func connectionDidClose(_ connection: TcpConnection, error: SocketError?) {
+        if error != nil || self.responseCount == 0 {
+            self.errorCount += 1
+        } else {
+            self.connectionCount += 1
+        }
+
+        if self.test.isStopped.load() {
+            _ = self.test.activeClientCount.fetchAndSub(1)
+            return
+        }
+
+        // Through the loop, so a connection that fails immediately does not recurse.
+        self.loop.add(self.start)
+    }
+
+    private func send(on connection: TcpConnection) {
+        self.receivedCount = 0
+        self.requestStart = BenchmarkClock.nanoseconds()
+        self.test.request.withUnsafeBytes { connection.write($0) }
+    }
+}
+
+/// Closed-loop load test of `EventLoop` over loopback: every client connection sends a request
+/// after the response to the previous one.
+///
+///     let test = LoadTest(mode: .http, connectionCount: 64, serverLoopCount: 4, clientLoopCount: 4)
+///     let result = test.run(for: 5)
+///     print(result.connectionsPerSecond, result.latency(percentile: 0.99))
+internal final class LoadTest {
+    internal static let echoRequestsPerConnection = 100
+
+    internal static let httpResponse = Array(
+        "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nOK".utf8
+    )
+
+    internal static let httpBadRequest = Array(
+        "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n".utf8
+    )
+
+    internal let mode: LoadTestMode
+    internal let connectionCount: Int
+    internal let serverLoopCount: Int
+    internal let clientLoopCount: Int
+
+    /// The request of a client and the expected response.
+    internal let request: [UInt8]
+    internal let response: [UInt8]
+
+    internal private(set) var port = 0
+    internal let isStopped = Atomic<Bool>(false)
+    internal let activeClientCount = Atomic<Int>(0)
+
+    internal init(mode: LoadTestMode, connectionCount: Int, serverLoopCount: Int, clientLoopCount: Int) {
+        self.mode = mode
+        self.connectionCount = connectionCount
+        self.serverLoopCount = serverLoopCount
+        self.clientLoopCount = clientLoopCount
+
+        switch mode {
+        case .echo:
+            let message = (0..<64).map { UInt8(truncatingIfNeeded: $0) }
+            self.request = message
+            self.response = message
+        case .http:
+            self.request = Array((
+                "GET /load-test HTTP/1.1\r\n" +
+                "Host: 127.0.0.1\r\n" +
+                "User-Agent: LoobeeBenchmarks\r\n" +
+                "Accept: */*\r\n" +
+                "\r\n"
+            ).utf8)
+            self.response = LoadTest.httpResponse
+        }
+    }
+
+    /// Runs the test, blocks for about `seconds`.
+    internal func run(for seconds: Double) -> LoadTestResult {
+        // Server loops are bound to the first processors, client loops are not bound.
+        let serverGroup = EventLoopGroup(loopCount: self.serverLoopCount, isPinned: true)
+        let clientGroup = EventLoopGroup(loopCount: self.clientLoopCount, isPinned: false)
+        let mode = self.mode
+        let server = TcpServer(group: serverGroup) { () -> TcpConnectionHandler in
+            if mode == .echo {
+                return LoadTestEchoHandler()
+            }
+
+            return LoadTestHttpHandler()
+        }
+        if let error = server.start(port: 0) {
+            fatalError("LoadTest: Cannot start the server. \(error)")
+        }
+        self.port = server.port
+
+        let clients = (0..<self.connectionCount).map { _ in
+            LoadTestClient(test: self, loop: clientGroup.next())
+        }
+        self.activeClientCount.store(clients.count)
+
+        let start = BenchmarkClock.nanoseconds()
+        for client in clients {
+            client.loop.add(client.start)
+        }
+        usleep(useconds_t(seconds * 1e6))
+        self.isStopped.store(true)
+
+        // Clients stop after the current responses, the wait is limited if the server hangs.
+        let deadline = BenchmarkClock.nanoseconds() + 5_000_000_000
+        while self.activeClientCount.load() > 0 && BenchmarkClock.nanoseconds() < deadline {
+            usleep(1000)
+        }
+        let elapsed = Double(BenchmarkClock.nanoseconds() - start) / 1e9
+
+        server.stop()
+        clientGroup.shutdown()
+        serverGroup.shutdown()
+
+        return LoadTestResult(
+            seconds: elapsed,
+            connectionCount: clients.reduce(0) { $0 + $1.connectionCount },
+            requestCount: clients.reduce(0) { $0 + $1.latencies.count },
+            errorCount: clients.reduce(0) { $0 + $1.errorCount },
+            latencies: clients.flatMap { $0.latencies }.sorted()
+        )
+    }
+}
+
+#endif
@@ -0,0 +1,59 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Allocation and deallocation of small objects.
+internal enum AllocatorBenchmarks {
+    private typealias Object = (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64)
+
+    private static let operationCount = 1024
+
+    internal static func make() -> [Benchmark] {
+        let count = AllocatorBenchmarks.operationCount
+        let pointers = UnsafeMutablePointer<UnsafeMutablePointer<Object>>.allocate(capacity: count)
+
+        let system = SystemAllocator<Object>()
+        let aligned = AlignedSystemAllocator<Object>()
+        let pool = PoolAllocator<Object>()
+        let arena = MemoryArena()
+
+        return [
+            Benchmark(name: "allocator.system.64", amount: count, tearDown: pointers.deallocate) {
+                for index in 0..<count {
+                    pointers[index] = system.allocate(count: 1)
+                }
+                for index in 0..<count {
+                    system.deallocate(pointers[index])
+                }
+            },
+            Benchmark(name: "allocator.alignedSystem.64", amount: count) {
+                for index in 0..<count {
+                    pointers[index] = aligned.allocate(count: 1, alignment: .custom(size: 64))
+                }
+                for index in 0..<count {
+                    aligned.deallocate(pointers[index])
+                }
+            },
+            Benchmark(name: "allocator.pool.64", amount: count) {
+                for index in 0..<count {
+                    pointers[index] = pool.allocate(count: 1)
+                }
+                for index in 0..<count {
+                    pool.deallocate(pointers[index])
+                }
+            },
+            Benchmark(name: "allocator.memoryArena.64", amount: count) {
+                for index in 0..<count {
+                    pointers[index] = arena.allocate(count: 1)
+                }
+                blackHole(pointers)
+                arena.reset()
+            },
+        ]
+    }
+}
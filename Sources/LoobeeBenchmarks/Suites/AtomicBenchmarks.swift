@@ -0,0 +1,106 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Atomic operations on one thread and from many threads at once.
+internal enum AtomicBenchmarks {
+    /// Operations of one thread in one call of the body.
+    private static let operationCount = 100_000
+
+    internal static func make(threadCount: Int) -> [Benchmark] {
+        let count = AtomicBenchmarks.operationCount
+        let counter = Atomic<UInt64>(0)
+
+        var benchmarks = [
+            Benchmark(name: "atomic.uint64.load", amount: count) {
+                var sum: UInt64 = 0
+                for _ in 0..<count {
+                    sum = sum &+ counter.load(withOrder: .acquire)
+                }
+                blackHole(sum)
+            },
+            Benchmark(name: "atomic.uint64.fetchAndAdd", amount: count) {
+                for _ in 0..<count {
+                    _ = counter.fetchAndAdd(1, withOrder: .relaxed)
+                }
+            },
+            Benchmark(name: "atomic.uint64.compareAndExchange", amount: count) {
+                for _ in 0..<count {
+                    AtomicBenchmarks.increment(counter)
+                }
+            },
+        ]
+
+        benchmarks += AtomicBenchmarks.makeContended(threadCount: threadCount)
+        return benchmarks
+    }
+
+    /// All threads change one counter or each thread changes its own counter on a separate cache line.
+    private static func makeContended(threadCount: Int) -> [Benchmark] {
+        let count = AtomicBenchmarks.operationCount
+        let shared = Atomic<UInt64>(0)
+
+        let stride = 64 / MemoryLayout<UInt64>.stride
+        let shardCount = threadCount * stride
+        let shards = AlignedSystemAllocator<UInt64>().allocate(count: shardCount, alignment: .custom(size: 64))
+        shards.initialize(repeating: 0, count: shardCount)
+
+        let sharedAdd = BenchmarkThreadGroup(count: threadCount) { _ in
+            for _ in 0..<count {
+                _ = shared.fetchAndAdd(1, withOrder: .relaxed)
+            }
+        }
+        let sharedCompareAndExchange = BenchmarkThreadGroup(count: threadCount) { _ in
+            for _ in 0..<count {
+                AtomicBenchmarks.increment(shared)
+            }
+        }
+        let shardedAdd = BenchmarkThreadGroup(count: threadCount) { index in
+            let shard = shards + index * stride
+            for _ in 0..<count {
+                _ = shard.pointee.atomicFetchAndAdd(1, withOrder: .relaxed)
+            }
+        }
+
+        let releaseShards = {
+            shardedAdd.stop()
+            AlignedSystemAllocator<UInt64>().deallocate(shards)
+        }
+
+        let suffix = "\(threadCount)threads"
+        let amount = threadCount * count
+
+        return [
+            Benchmark(name: "atomic.uint64.fetchAndAdd.shared.\(suffix)", amount: amount, tearDown: sharedAdd.stop) {
+                sharedAdd.run()
+            },
+            Benchmark(
+                name: "atomic.uint64.compareAndExchange.shared.\(suffix)",
+                amount: amount,
+                tearDown: sharedCompareAndExchange.stop
+            ) {
+                sharedCompareAndExchange.run()
+            },
+            Benchmark(name: "atomic.uint64.fetchAndAdd.sharded.\(suffix)", amount: amount, tearDown: releaseShards) {
+                shardedAdd.run()
+            },
+        ]
+    }
+
+    /// Increments the counter with a compare-and-exchange loop.
+    @inline(__always)
+    private static func increment(_ counter: Atomic<UInt64>) {
+        var expected = counter.load(withOrder: .relaxed)
+        while true {
+            let desired = expected &+ 1
+            if counter.compareAndExchangeWeak(expected: &expected, desired: desired, withOrder: .relaxed) {
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+private final class AtomicBoxBenchmarkPayload {
+    let value: Int
+
+    init(_ value: Int) {
+        self.value = value
+    }
+}
+
+/// Reads of a shared object from many threads at once: `AtomicBox` without retaining the object,
+/// with retaining it, and the baseline of a mutex.
+internal enum AtomicBoxBenchmarks {
+    /// Reads of one thread in one call of the body.
+    private static let readCount = 100_000
+
+    internal static func make(threadCount: Int) -> [Benchmark] {
+        let count = AtomicBoxBenchmarks.readCount
+        let box = AtomicBox(object: AtomicBoxBenchmarkPayload(1))
+        let mutex = Mutex()
+        let object = AtomicBoxBenchmarkPayload(1)
+
+        let read = BenchmarkThreadGroup(count: threadCount) { _ in
+            var sum = 0
+            for _ in 0..<count {
+                sum &+= box.read { $0.value }
+            }
+            blackHole(sum)
+        }
+        let load = BenchmarkThreadGroup(count: threadCount) { _ in
+            var sum = 0
+            for _ in 0..<count {
+                sum &+= box.load().value
+            }
+            blackHole(sum)
+        }
+        let locked = BenchmarkThreadGroup(count: threadCount) { _ in
+            var sum = 0
+            for _ in 0..<count {
+                sum &+= mutex.synchronized { object.value }
+            }
+            blackHole(sum)
+        }
+
+        let suffix = "\(threadCount)threads"
+        let amount = threadCount * count
+
+        return [
+            Benchmark(name: "atomicBox.read.\(suffix)", amount: amount, tearDown: read.stop) {
+                read.run()
+            },
+            Benchmark(name: "atomicBox.load.\(suffix)", amount: amount, tearDown: load.stop) {
+                load.run()
+            },
+            Benchmark(name: "atomicBox.mutex.\(suffix)", amount: amount, tearDown: locked.stop) {
+                locked.run()
+            },
+        ]
+    }
+}
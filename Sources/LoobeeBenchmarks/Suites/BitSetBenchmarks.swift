@@ -0,0 +1,83 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Operations of fixed, dynamic and atomic bitsets.
+internal enum BitSetBenchmarks {
+    private static let operationCount = 1024
+    private static let bitCount = 1 << 20
+
+    internal static func make() -> [Benchmark] {
+        let count = BitSetBenchmarks.operationCount
+        let bitCount = BitSetBenchmarks.bitCount
+
+        var lhs = DynamicBitSet(count: bitCount)
+        var rhs = DynamicBitSet(count: bitCount)
+        for index in stride(from: 0, to: bitCount, by: 3) {
+            lhs[index] = .one
+        }
+        for index in stride(from: 0, to: bitCount, by: 5) {
+            rhs[index] = .one
+        }
+        // The same words as an array of fixed bitsets, the baseline of the bulk operations.
+        let lhsWords = lhs.withUnsafeWords { $0.map { BitSet<UInt64>($0) } }
+        let rhsWords = rhs.withUnsafeWords { $0.map { BitSet<UInt64>($0) } }
+        let rankIndex = lhs.makeRankIndex()
+        let atomic = AtomicDynamicBitSet(count: bitCount)
+
+        return [
+            Benchmark(name: "bitset.uint64.setAndTest", amount: count) {
+                var bitset = BitSet<UInt64>()
+                var sum = 0
+                for index in 0..<count {
+                    let position = UInt64(truncatingIfNeeded: index & 63)
+                    bitset[position] = bitset[position] == .one ? .zero : .one
+                    sum &+= bitset.nonzeroBitCount
+                }
+                blackHole(sum)
+            },
+            Benchmark(name: "bitset.dynamic.and.nonzeroBitCount", unit: .bytes, amount: bitCount / 8) {
+                blackHole((lhs & rhs).nonzeroBitCount)
+            },
+            Benchmark(name: "bitset.dynamic.nonzeroBitCount", unit: .bytes, amount: bitCount / 8) {
+                blackHole(lhs.nonzeroBitCount)
+            },
+            Benchmark(name: "bitset.uint64Array.and.nonzeroBitCount", unit: .bytes, amount: bitCount / 8) {
+                var sum = 0
+                for index in 0..<lhsWords.count {
+                    sum &+= (lhsWords[index] & rhsWords[index]).nonzeroBitCount
+                }
+                blackHole(sum)
+            },
+            Benchmark(name: "bitset.uint64Array.nonzeroBitCount", unit: .bytes, amount: bitCount / 8) {
+                blackHole(lhsWords.reduce(0) { $0 &+ $1.nonzeroBitCount })
+            },
+            Benchmark(name: "bitset.dynamic.rank", amount: count) {
+                var sum = 0
+                for index in 0..<count {
+                    sum &+= rankIndex.rank(index &* 1021 % bitCount)
+                }
+                blackHole(sum)
+            },
+            Benchmark(name: "bitset.dynamic.select", amount: count) {
+                var sum = 0
+                for index in 0..<count {
+                    sum &+= rankIndex.select(index &* 331 % rankIndex.nonzeroBitCount) ?? 0
+                }
+                blackHole(sum)
+            },
+            Benchmark(name: "bitset.atomicDynamic.claimZeroBit.reset", amount: count) {
+                for _ in 0..<count {
+                    if let position = atomic.claimZeroBit() {
+                        atomic.reset(position)
+                    }
+                }
+            },
+        ]
+    }
+}
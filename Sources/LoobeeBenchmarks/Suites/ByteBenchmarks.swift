@@ -0,0 +1,36 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Scans of 1 MiB buffers where the match is the last element.
+internal enum ByteBenchmarks {
+    private static let byteCount = 1 << 20
+
+    internal static func make() -> [Benchmark] {
+        let byteCount = ByteBenchmarks.byteCount
+
+        let words = UnsafeMutableBufferPointer<UInt64>.allocate(capacity: byteCount / 8)
+        words.initialize(repeating: 0)
+        words[words.count - 1] = 1
+        let wordBuffer = UnsafeBufferPointer(words)
+
+        let bytes = UnsafeMutableRawBufferPointer.allocate(byteCount: byteCount, alignment: 64)
+        bytes.initializeMemory(as: UInt8.self, repeating: 1)
+        bytes[byteCount - 1] = 0
+        let byteBuffer = UnsafeRawBufferPointer(bytes)
+
+        return [
+            Benchmark(name: "byte.bitScan.firstSetBit", unit: .bytes, amount: byteCount, tearDown: words.deallocate) {
+                blackHole(BitScan.firstSetBit(in: wordBuffer))
+            },
+            Benchmark(name: "byte.byteSearch.firstIndex", unit: .bytes, amount: byteCount, tearDown: bytes.deallocate) {
+                blackHole(ByteSearch.firstIndex(of: 0, in: byteBuffer))
+            },
+        ]
+    }
+}
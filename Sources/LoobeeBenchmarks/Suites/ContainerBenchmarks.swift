@@ -0,0 +1,140 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+private final class ContainerBenchmarkNode: IntrusiveSListNode {
+    var nextNode: ContainerBenchmarkNode?
+}
+
+/// Lock-free intrusive containers from many threads at once and the baselines of an array
+/// protected by a mutex.
+internal enum ContainerBenchmarks {
+    /// Operations of one thread in one call of the body.
+    private static let operationCount = 10_000
+
+    internal static func make(threadCount: Int) -> [Benchmark] {
+        return ContainerBenchmarks.makeStack(threadCount: threadCount)
+            + ContainerBenchmarks.makeQueue(threadCount: threadCount)
+    }
+
+    /// Each thread pops a node and pushes it back, the stack holds one node per thread.
+    private static func makeStack(threadCount: Int) -> [Benchmark] {
+        let count = ContainerBenchmarks.operationCount
+        let stack = IntrusiveAtomicStack<ContainerBenchmarkNode>()
+        let mutex = Mutex()
+        var elements: [ContainerBenchmarkNode] = []
+        for _ in 0..<threadCount {
+            stack.push(ContainerBenchmarkNode())
+            elements.append(ContainerBenchmarkNode())
+        }
+
+        let lockFree = BenchmarkThreadGroup(count: threadCount) { _ in
+            for _ in 0..<count {
+                if let node = stack.pop() {
+                    stack.push(node)
+                }
+            }
+        }
+        let locked = BenchmarkThreadGroup(count: threadCount) { _ in
+            for _ in 0..<count {
+                if let node = mutex.synchronized({ elements.popLast() }) {
+                    mutex.synchronized {
+                        elements.append(node)
+                    }
+                }
+            }
+        }
+
+        let suffix = "\(threadCount)threads"
+        let amount = threadCount * count
+
+        return [
+            Benchmark(
+                name: "container.intrusiveAtomicStack.popPush.\(suffix)",
+                amount: amount,
+                tearDown: lockFree.stop
+            ) {
+                lockFree.run()
+            },
+            Benchmark(name: "container.lockedArray.popPush.\(suffix)", amount: amount, tearDown: locked.stop) {
+                locked.run()
+            },
+        ]
+    }
+
+    /// The last thread of the group pops the nodes pushed by the other threads.
+    private static func makeQueue(threadCount: Int) -> [Benchmark] {
+        let count = ContainerBenchmarks.operationCount
+        let total = threadCount * count
+        let nodes = (0..<threadCount).map { _ in
+            (0..<count).map { _ in ContainerBenchmarkNode() }
+        }
+
+        let queue = IntrusiveMPSCQueue<ContainerBenchmarkNode>()
+        let lockFree = BenchmarkThreadGroup(count: threadCount + 1) { index in
+            guard index == threadCount else {
+                for node in nodes[index] {
+                    queue.push(node)
+                }
+                return
+            }
+
+            var popped = 0
+            while popped < total {
+                if queue.pop() != nil {
+                    popped += 1
+                }
+            }
+        }
+
+        let mutex = Mutex()
+        var elements: [ContainerBenchmarkNode] = []
+        var head = 0
+        let locked = BenchmarkThreadGroup(count: threadCount + 1) { index in
+            guard index == threadCount else {
+                for node in nodes[index] {
+                    mutex.synchronized {
+                        elements.append(node)
+                    }
+                }
+                return
+            }
+
+            var popped = 0
+            while popped < total {
+                let isPopped = mutex.synchronized { () -> Bool in
+                    guard head < elements.count else {
+                        return false
+                    }
+
+                    head += 1
+                    if head == elements.count {
+                        elements.removeAll(keepingCapacity: true)
+                        head = 0
+                    }
+
+                    return true
+                }
+                if isPopped {
+                    popped += 1
+                }
+            }
+        }
+
+        let suffix = "\(threadCount)producers"
+
+        return [
+            Benchmark(name: "container.intrusiveMPSCQueue.\(suffix)", amount: total, tearDown: lockFree.stop) {
+                lockFree.run()
+            },
+            Benchmark(name: "container.lockedQueue.\(suffix)", amount: total, tearDown: locked.stop) {
+                locked.run()
+            },
+        ]
+    }
+}
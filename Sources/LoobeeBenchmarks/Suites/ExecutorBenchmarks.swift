@@ -0,0 +1,171 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Executor that is stopped after the benchmarks.
+private protocol BenchmarkExecutor: Executor {
+    func shutdown()
+}
+
+extension ThreadPoolExecutor: BenchmarkExecutor {
+}
+
+/// Baseline of `ThreadPoolExecutor`: workers share one queue protected by a mutex.
+private final class LockedQueueExecutor: BenchmarkExecutor {
+    private let mutex = Mutex()
+    private let condition = Condition()
+    private var queue: [() -> Void] = []
+    private var head = 0
+    private var isShutdown = false
+    private var threads: [NativeThread] = []
+
+    init(threadCount: Count = NativeThread.processorCount) {
+        self.threads = (0..<threadCount).map { _ in
+            NativeThread { [unowned(unsafe) self] in
+                self.run()
+            }
+        }
+    }
+
+    func add(_ function: @escaping () -> Void, withPriority priority: ExecutorPriority) {
+        self.mutex.synchronized {
+            self.queue.append(function)
+            self.condition.signal()
+        }
+    }
+
+    func shutdown() {
+        self.mutex.synchronized {
+            self.isShutdown = true
+            self.condition.broadcast()
+        }
+
+        for thread in self.threads {
+            thread.join()
+        }
+        self.threads.removeAll()
+    }
+
+    private func run() {
+        while true {
+            self.mutex.lock()
+            while self.head == self.queue.count && !self.isShutdown {
+                self.condition.wait(self.mutex)
+            }
+
+            if self.head == self.queue.count {
+                self.mutex.unlock()
+                return
+            }
+
+            let function = self.queue[self.head]
+            self.head += 1
+            if self.head == self.queue.count {
+                self.queue.removeAll(keepingCapacity: true)
+                self.head = 0
+            }
+            self.mutex.unlock()
+
+            function()
+        }
+    }
+}
+
+/// Executor of a benchmark, is created by the first call, so filtered out benchmarks start no threads.
+private final class ExecutorBenchmarkPool<E: BenchmarkExecutor> {
+    private let make: () -> E
+    private var storage: E?
+
+    init(_ make: @escaping () -> E) {
+        self.make = make
+    }
+
+    var executor: E {
+        if let executor = self.storage {
+            return executor
+        }
+
+        let executor = self.make()
+        self.storage = executor
+
+        return executor
+    }
+
+    func shutdown() {
+        self.storage?.shutdown()
+        self.storage = nil
+    }
+}
+
+/// Scheduling of `ThreadPoolExecutor` and of the locked queue baseline.
+internal enum ExecutorBenchmarks {
+    /// Tasks in one call of the body.
+    private static let taskCount = 1000
+
+    /// Depth of the binary tree of tasks that add their children from workers.
+    private static let fanOutDepth = 10
+
+    internal static func make() -> [Benchmark] {
+        return ExecutorBenchmarks.make(name: "threadPool", ExecutorBenchmarkPool { ThreadPoolExecutor() })
+            + ExecutorBenchmarks.make(name: "lockedQueue", ExecutorBenchmarkPool { LockedQueueExecutor() })
+    }
+
+    private static func make<E: BenchmarkExecutor>(name: String, _ pool: ExecutorBenchmarkPool<E>) -> [Benchmark] {
+        let count = ExecutorBenchmarks.taskCount
+        let fanOutCount = (1 << (ExecutorBenchmarks.fanOutDepth + 1)) - 1
+        let counter = Atomic<Int>(0)
+
+        return [
+            // Each task is added after the previous one has run, so workers are often parked:
+            // the time from `add` to the start of the task, including the wakeup.
+            Benchmark(name: "executor.\(name).roundTrip", amount: count, tearDown: pool.shutdown) {
+                let executor = pool.executor
+                for _ in 0..<count {
+                    let target = counter.load(withOrder: .relaxed) + 1
+                    executor.add {
+                        _ = counter.fetchAndAdd(1, withOrder: .release)
+                    }
+                    ExecutorBenchmarks.wait(until: counter, reaches: target)
+                }
+            },
+            Benchmark(name: "executor.\(name).throughput", amount: count) {
+                let executor = pool.executor
+                let target = counter.load(withOrder: .relaxed) + count
+                for _ in 0..<count {
+                    executor.add {
+                        _ = counter.fetchAndAdd(1, withOrder: .release)
+                    }
+                }
+                ExecutorBenchmarks.wait(until: counter, reaches: target)
+            },
+            Benchmark(name: "executor.\(name).fanOut", amount: fanOutCount) {
+                let executor = pool.executor
+                let target = counter.load(withOrder: .relaxed) + fanOutCount
+                executor.add {
+                    ExecutorBenchmarks.spawn(on: executor, depth: ExecutorBenchmarks.fanOutDepth, counter: counter)
+                }
+                ExecutorBenchmarks.wait(until: counter, reaches: target)
+            },
+        ]
+    }
+
+    /// Counts the task and adds its two children from the worker.
+    private static func spawn<E: Executor>(on executor: E, depth: Int, counter: Atomic<Int>) {
+        _ = counter.fetchAndAdd(1, withOrder: .release)
+        if depth > 0 {
+            executor.add { ExecutorBenchmarks.spawn(on: executor, depth: depth - 1, counter: counter) }
+            executor.add { ExecutorBenchmarks.spawn(on: executor, depth: depth - 1, counter: counter) }
+        }
+    }
+
+    private static func wait(until counter: Atomic<Int>, reaches value: Int) {
+        while counter.load(withOrder: .acquire) < value {
+            NativeThread.yield()
+        }
+    }
+}
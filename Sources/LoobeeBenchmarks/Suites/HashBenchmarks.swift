@@ -0,0 +1,38 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Hash functions over buffers of different sizes.
+internal enum HashBenchmarks {
+    private static let sizes = [16, 256, 4096, 1 << 20]
+
+    internal static func make() -> [Benchmark] {
+        return HashBenchmarks.sizes.flatMap { size -> [Benchmark] in
+            let storage = UnsafeMutableRawBufferPointer.allocate(byteCount: size, alignment: 64)
+            for index in 0..<size {
+                storage[index] = UInt8(truncatingIfNeeded: index &* 131 &+ 7)
+            }
+            let buffer = UnsafeRawBufferPointer(storage)
+
+            return [
+                Benchmark(name: "hash.fnv64.\(size)", unit: .bytes, amount: size, tearDown: storage.deallocate) {
+                    blackHole(fnv64(buffer))
+                },
+                Benchmark(name: "hash.fnva64.\(size)", unit: .bytes, amount: size) {
+                    blackHole(fnva64(buffer))
+                },
+                Benchmark(name: "hash.wideHash64.\(size)", unit: .bytes, amount: size) {
+                    blackHole(wideHash64(buffer))
+                },
+                Benchmark(name: "hash.wideHash128.\(size)", unit: .bytes, amount: size) {
+                    blackHole(wideHash128(buffer))
+                },
+            ]
+        }
+    }
+}
@@ -0,0 +1,111 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeHttp
+
+/// HPACK encoding and decoding of the headers of a recorded page load, one connection per call.
+internal enum HpackBenchmarks {
+    private typealias Headers = [(name: String, value: String)]
+
+    private static let requestHeaders: Headers = [
+        (":authority", "www.example.com"),
+        ("user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/72.0.3626.109"),
+        ("accept-language", "en-US,en;q=0.9"),
+        ("accept-encoding", "gzip, deflate, br"),
+        ("cookie", "session=0f3a9c2e7b5d4e61a8c3; theme=dark; _ga=GA1.2.1234567890.1550000000; _gid=GA1.2.98765"),
+    ]
+
+    private static let responseHeaders: Headers = [
+        ("server", "nginx/1.15.8"),
+        ("date", "Mon, 18 Feb 2019 10:24:31 GMT"),
+        ("strict-transport-security", "max-age=31536000; includeSubDomains"),
+        ("x-content-type-options", "nosniff"),
+    ]
+
+    private static let corpus: [Headers] = [
+        HpackBenchmarks.request("/", accept: "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"),
+        HpackBenchmarks.response("text/html; charset=utf-8", length: "48213", cache: "no-cache", [
+            ("set-cookie", "session=0f3a9c2e7b5d4e61a8c3; Path=/; Secure; HttpOnly; SameSite=Lax"),
+            ("content-security-policy", "default-src 'self'; img-src 'self' https://cdn.example.com"),
+        ]),
+        HpackBenchmarks.request("/static/css/main.3f9c2e81.css", accept: "text/css,*/*;q=0.1"),
+        HpackBenchmarks.response("text/css", length: "18230", cache: "public, max-age=31536000, immutable", [
+            ("etag", "\"5c6a8f2e-4736\""),
+        ]),
+        HpackBenchmarks.request("/static/js/vendor.7b5d4e61.js", accept: "*/*"),
+        HpackBenchmarks.response("application/javascript", length: "254871", cache: "public, max-age=31536000", [
+            ("etag", "\"5c6a8f2e-3e397\""),
+        ]),
+        HpackBenchmarks.request("/static/js/app.a8c39f02.js", accept: "*/*"),
+        HpackBenchmarks.response("application/javascript", length: "73104", cache: "public, max-age=31536000", [
+            ("etag", "\"5c6a8f2e-11d90\""),
+        ]),
+        HpackBenchmarks.request("/images/logo.svg", accept: "image/webp,image/apng,image/*,*/*;q=0.8"),
+        HpackBenchmarks.response("image/svg+xml", length: "3120", cache: "public, max-age=86400", []),
+        HpackBenchmarks.request("/api/v1/user/profile?fields=name,avatar", accept: "application/json"),
+        HpackBenchmarks.response("application/json", length: "412", cache: "private, no-store", [
+            ("vary", "Accept-Encoding, Authorization"),
+            ("x-request-id", "7f9c1e0a-8d3b-4c6e-9a2f-1b5d7e3c9a04"),
+        ]),
+    ]
+
+    internal static func make() -> [Benchmark] {
+        let corpus = HpackBenchmarks.corpus
+        let rawCount = corpus.reduce(0) { count, headers in
+            headers.reduce(count) { $0 + $1.name.utf8.count + $1.value.utf8.count }
+        }
+
+        let encoder = HpackEncoder()
+        let blocks = corpus.map { headers -> [UInt8] in
+            var block: [UInt8] = []
+            for header in headers {
+                encoder.encode(name: header.name, value: header.value, into: &block)
+            }
+            return block
+        }
+
+        return [
+            Benchmark(name: "hpack.encode.corpus", unit: .bytes, amount: rawCount) {
+                let encoder = HpackEncoder()
+                var block: [UInt8] = []
+                block.reserveCapacity(4096)
+                for headers in corpus {
+                    block.removeAll(keepingCapacity: true)
+                    for header in headers {
+                        encoder.encode(name: header.name, value: header.value, into: &block)
+                    }
+                }
+                blackHole(block)
+            },
+            Benchmark(name: "hpack.decode.corpus", unit: .bytes, amount: rawCount) {
+                let decoder = HpackDecoder()
+                for block in blocks {
+                    blackHole(block.withUnsafeBytes { decoder.decode($0) })
+                }
+                blackHole(decoder.headers.count)
+            },
+        ]
+    }
+
+    private static func request(_ path: String, accept: String) -> Headers {
+        let pseudoHeaders: Headers = [(":method", "GET"), (":scheme", "https"), (":path", path)]
+
+        return pseudoHeaders + HpackBenchmarks.requestHeaders + [("accept", accept)]
+    }
+
+    private static func response(_ type: String, length: String, cache: String, _ headers: Headers) -> Headers {
+        let entityHeaders: Headers = [
+            (":status", "200"),
+            ("content-type", type),
+            ("content-length", length),
+            ("cache-control", cache),
+            ("content-encoding", "br"),
+        ]
+
+        return entityHeaders + HpackBenchmarks.responseHeaders + headers
+    }
+}
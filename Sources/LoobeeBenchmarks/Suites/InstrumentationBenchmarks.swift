@@ -0,0 +1,56 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Overhead of instrumentation on a hot path of one `fetchAndAdd`.
+///
+/// Without `LOOBEE_INSTRUMENTATION` all variants must match the baseline. The overhead is measured
+/// by comparing reports of both builds:
+///
+///     make bench BENCH_ARGS="--filter instrumentation --output off.json"
+///     make bench INSTRUMENTATION=1 BENCH_ARGS="--filter instrumentation --baseline off.json"
+internal enum InstrumentationBenchmarks {
+    /// Operations in one call of the body.
+    private static let operationCount = 100_000
+
+    private static let counter = InstrumentationCounter(name: "benchmark.fetchAndAdd")
+    private static let histogram = InstrumentationHistogram(name: "benchmark.fetchAndAdd")
+
+    internal static func make() -> [Benchmark] {
+        let count = InstrumentationBenchmarks.operationCount
+        let value = Atomic<UInt64>(0)
+
+        return [
+            Benchmark(name: "instrumentation.fetchAndAdd", amount: count) {
+                for _ in 0..<count {
+                    _ = value.fetchAndAdd(1, withOrder: .relaxed)
+                }
+            },
+            Benchmark(name: "instrumentation.fetchAndAdd.counter", amount: count) {
+                for _ in 0..<count {
+                    _ = value.fetchAndAdd(1, withOrder: .relaxed)
+                    InstrumentationBenchmarks.counter.increment()
+                }
+            },
+            Benchmark(name: "instrumentation.fetchAndAdd.histogram", amount: count) {
+                for _ in 0..<count {
+                    InstrumentationBenchmarks.histogram.measure {
+                        _ = value.fetchAndAdd(1, withOrder: .relaxed)
+                    }
+                }
+            },
+            Benchmark(name: "instrumentation.fetchAndAdd.span", amount: count) {
+                for _ in 0..<count {
+                    Instrumentation.span("benchmark.fetchAndAdd") {
+                        _ = value.fetchAndAdd(1, withOrder: .relaxed)
+                    }
+                }
+            },
+        ]
+    }
+}
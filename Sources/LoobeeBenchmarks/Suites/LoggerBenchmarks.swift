@@ -0,0 +1,111 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Loggers of a benchmark, are created by the first call, so filtered out benchmarks start no threads.
+private final class LoggerBenchmarkOutput {
+    private var devNull: Int32 = -1
+    private var asyncLogger: AsyncLogger?
+    private var synchronousLogger: SynchronousLogger?
+
+    private var fileDescriptor: Int32 {
+        if self.devNull < 0 {
+            self.devNull = open("/dev/null", O_WRONLY)
+        }
+
+        return self.devNull
+    }
+
+    var async: AsyncLogger {
+        if let logger = self.asyncLogger {
+            return logger
+        }
+
+        let logger = AsyncLogger(fileDescriptor: self.fileDescriptor, capacity: 1 << 16, overflowPolicy: .block)
+        self.asyncLogger = logger
+
+        return logger
+    }
+
+    var synchronous: SynchronousLogger {
+        if let logger = self.synchronousLogger {
+            return logger
+        }
+
+        let logger = SynchronousLogger(fileDescriptor: self.fileDescriptor)
+        self.synchronousLogger = logger
+
+        return logger
+    }
+
+    func release() {
+        self.asyncLogger?.shutdown()
+        self.asyncLogger = nil
+        self.synchronousLogger = nil
+        if self.devNull >= 0 {
+            close(self.devNull)
+            self.devNull = -1
+        }
+    }
+}
+
+/// Latency of the caller of a logger, the output is written to `/dev/null`.
+internal enum LoggerBenchmarks {
+    /// Records of one thread in one call of the body.
+    private static let recordCount = 1000
+
+    private static let template = LogTemplate("Record {producer} {index}")
+
+    internal static func make(threadCount: Int) -> [Benchmark] {
+        let count = LoggerBenchmarks.recordCount
+        let output = LoggerBenchmarkOutput()
+
+        let contended = BenchmarkThreadGroup(count: threadCount) { thread in
+            let logger = output.async
+            for index in 0..<count {
+                logger.log(.info, LoggerBenchmarks.template, .int(thread), .int(index))
+            }
+        }
+        let release = {
+            contended.stop()
+            output.release()
+        }
+
+        return [
+            Benchmark(name: "logger.async.template", amount: count, tearDown: release) {
+                let logger = output.async
+                for index in 0..<count {
+                    logger.log(.info, LoggerBenchmarks.template, .int(0), .int(index))
+                }
+            },
+            Benchmark(name: "logger.async.message", amount: count) {
+                let logger = output.async
+                for index in 0..<count {
+                    logger.info("Record {index}", context: ["index": String(index)])
+                }
+            },
+            Benchmark(name: "logger.synchronous.message", amount: count) {
+                let logger = output.synchronous
+                for index in 0..<count {
+                    logger.info("Record {index}", context: ["index": String(index)])
+                }
+            },
+            Benchmark(name: "logger.async.template.\(threadCount)threads", amount: threadCount * count) {
+                // The logger is created on this thread, not concurrently by the group.
+                _ = output.async
+                contended.run()
+            },
+        ]
+    }
+}
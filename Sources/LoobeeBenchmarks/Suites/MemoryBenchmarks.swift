@@ -0,0 +1,81 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Buffer of a benchmark, is allocated by the first call, so filtered out benchmarks take no memory.
+private final class MemoryBenchmarkBuffer {
+    private let allocator: AlignedSystemAllocator<UInt64>
+    private let count: Count
+    private var storage: UnsafeMutablePointer<UInt64>?
+
+    init(count: Count, policy: MemoryPolicy) {
+        self.allocator = AlignedSystemAllocator(policy: policy)
+        self.count = count
+    }
+
+    var pointer: UnsafeMutablePointer<UInt64> {
+        if let storage = self.storage {
+            return storage
+        }
+
+        let storage = self.allocator.allocate(count: self.count, alignment: .page)
+        for index in 0..<self.count {
+            storage[index] = UInt64(index)
+        }
+        self.storage = storage
+
+        return storage
+    }
+
+    func release() {
+        if let storage = self.storage {
+            self.allocator.deallocate(storage, count: self.count)
+            self.storage = nil
+        }
+    }
+}
+
+/// Random reads over a buffer much bigger than the reach of the TLB with small and huge pages.
+internal enum MemoryBenchmarks {
+    private static let accessCount = 16 * 1024
+
+    /// 128 MiB.
+    private static let elementBits = 24
+
+    internal static func make() -> [Benchmark] {
+        let policies: [(String, MemoryPolicy)] = [
+            ("system", MemoryPolicy(isPrefaulted: true, access: .random)),
+            ("transparentHuge", MemoryPolicy(pageSize: .transparentHuge, isPrefaulted: true, access: .random)),
+            ("huge", MemoryPolicy(pageSize: .huge, isPrefaulted: true, access: .random)),
+        ]
+
+        return policies.map { name, policy -> Benchmark in
+            let buffer = MemoryBenchmarkBuffer(count: 1 << MemoryBenchmarks.elementBits, policy: policy)
+
+            return Benchmark(
+                name: "memory.randomRead.128M.\(name)",
+                amount: MemoryBenchmarks.accessCount,
+                tearDown: buffer.release
+            ) {
+                MemoryBenchmarks.randomRead(buffer.pointer)
+            }
+        }
+    }
+
+    /// Each index depends on the previously read value, so reads are not overlapped and
+    /// the latency of TLB misses is measured.
+    @inline(__always)
+    private static func randomRead(_ pointer: UnsafeMutablePointer<UInt64>) {
+        let shift = UInt64(64 - MemoryBenchmarks.elementBits)
+        var index = 0
+        for step in 0..<UInt64(MemoryBenchmarks.accessCount) {
+            index = Int(truncatingIfNeeded: ((pointer[index] &+ step) &* 0x9E37_79B9_7F4A_7C15) >> shift)
+        }
+        blackHole(index)
+    }
+}
@@ -0,0 +1,27 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Comparison of strings.
+internal enum StringBenchmarks {
+    internal static func make() -> [Benchmark] {
+        let shortLhs = "Content-Length"
+        let shortRhs = "content-length"
+        let longLhs = String(repeating: "Accept-Encoding, ", count: 64)
+        let longRhs = longLhs.uppercased()
+
+        return [
+            Benchmark(name: "string.caseInsensitiveASCIICompare.short", unit: .bytes, amount: shortLhs.utf8.count) {
+                blackHole(shortLhs.caseInsensitiveASCIICompare(shortRhs))
+            },
+            Benchmark(name: "string.caseInsensitiveASCIICompare.long", unit: .bytes, amount: longLhs.utf8.count) {
+                blackHole(longLhs.caseInsensitiveASCIICompare(longRhs))
+            },
+        ]
+    }
+}
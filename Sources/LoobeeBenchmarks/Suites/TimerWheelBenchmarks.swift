@@ -0,0 +1,34 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Timers of the event loop that are cancelled before they expire, e.g. timeouts of requests.
+internal enum TimerWheelBenchmarks {
+    /// Timers in one call of the body.
+    private static let timerCount = 10_000
+
+    internal static func make() -> [Benchmark] {
+        let count = TimerWheelBenchmarks.timerCount
+        let wheel = TimerWheel(tickDuration: 1, now: 0)
+        var handles: [TimerWheel.Handle] = []
+        handles.reserveCapacity(count)
+
+        return [
+            Benchmark(name: "timerWheel.scheduleAndCancel", amount: count) {
+                for index in 0..<count {
+                    handles.append(wheel.schedule(at: UInt64(index &* 97 % 1_000_000)) {
+                    })
+                }
+                for handle in handles {
+                    wheel.cancel(handle)
+                }
+                handles.removeAll(keepingCapacity: true)
+            },
+        ]
+    }
+}
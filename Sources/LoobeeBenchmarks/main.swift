@@ -0,0 +1,269 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import Foundation
+import LoobeeCore
+
+/// Usage: LoobeeBenchmarks [options]
+///
+///     --list                 Print names of benchmarks and exit.
+///     --filter <substring>   Run only benchmarks whose name contains the substring.
+///     --warmup <count>       Number of warmup samples (5).
+///     --iterations <count>   Number of recorded samples (30).
+///     --threads <count>      Number of threads of contended benchmarks (number of processors).
+///     --output <path>        Write the report as JSON.
+///     --baseline <path>      Compare with a stored report, exit with 1 if a benchmark is slower.
+///     --threshold <ratio>    Allowed relative slowdown for `--baseline` (0.1).
+///     --load-test <mode>     Run the loopback load test of the event loop instead, `echo` or `http` (Linux only).
+///                            Half of `--threads` loops serve, the rest run the clients.
+///     --connections <count>  Number of client connections of the load test (64).
+///     --duration <seconds>   Duration of the load test (5).
+private struct Options {
+    var isList = false
+    var filter: String?
+    var warmupIterations = 5
+    var iterations = 30
+    var threadCount = NativeThread.processorCount
+    var outputPath: String?
+    var baselinePath: String?
+    var threshold = 0.1
+    var loadTestMode: LoadTestMode?
+    var connectionCount = 64
+    var duration = 5.0
+
+    init(arguments: [String]) {
+        var iterator = arguments.makeIterator()
+        while let argument = iterator.next() {
+            if argument == "--list" {
+                self.isList = true
+                continue
+            }
+
+            guard let value = iterator.next() else {
+                Options.fail("Missing value of \(argument)")
+            }
+
+            switch argument {
+            case "--filter":
+                self.filter = value
+            case "--warmup":
+                self.warmupIterations = Options.parse(value, of: argument)
+            case "--iterations":
+                self.iterations = Options.parse(value, of: argument)
+            case "--threads":
+                self.threadCount = Options.parse(value, of: argument)
+            case "--output":
+                self.outputPath = value
+            case "--baseline":
+                self.baselinePath = value
+            case "--threshold":
+                self.threshold = Options.parse(value, of: argument)
+            case "--load-test":
+                guard let mode = LoadTestMode(rawValue: value) else {
+                    Options.fail("Invalid value of \(argument): \(value)")
+                }
+                self.loadTestMode = mode
+            case "--connections":
+                self.connectionCount = Options.parse(value, of: argument)
+            case "--duration":
+                self.duration = Options.parse(value, of: argument)
+            default:
+                Options.fail("Unknown option \(argument)")
+            }
+        }
+
+        if self.iterations < 1 || self.warmupIterations < 0 || self.threadCount < 1 || self.connectionCount < 1 {
+            Options.fail("Counts must be positive")
+        }
+        if self.duration <= 0 {
+            Options.fail("Duration must be positive")
+        }
+    }
+
+    private static func parse<T: LosslessStringConvertible>(_ value: String, of argument: String) -> T {
+        guard let result = T(value) else {
+            Options.fail("Invalid value of \(argument): \(value)")
+        }
+
+        return result
+    }
+
+    static func fail(_ message: String) -> Never {
+        FileHandle.standardError.write("LoobeeBenchmarks: \(message)\n".data(using: .utf8)!)
+        exit(2)
+    }
+}
+
+private func format(_ value: Double, _ digits: Int = 2) -> String {
+    return String(format: "%.\(digits)f", value)
+}
+
+private func pad(_ string: String, _ width: Int) -> String {
+    return string.count >= width ? string : string + String(repeating: " ", count: width - string.count)
+}
+
+private func formatRate(_ result: BenchmarkResult) -> String {
+    if result.unit == .bytes {
+        return format(result.unitsPerSecond / Double(1 << 30)) + " GiB/s"
+    }
+
+    return format(result.unitsPerSecond / 1e6) + " Mops/s"
+}
+
+private func makeBenchmarks(options: Options) -> [Benchmark] {
+    return AtomicBenchmarks.make(threadCount: options.threadCount)
+        + AtomicBoxBenchmarks.make(threadCount: options.threadCount)
+        + ContainerBenchmarks.make(threadCount: options.threadCount)
+        + HashBenchmarks.make()
+        + StringBenchmarks.make()
+        + BitSetBenchmarks.make()
+        + ByteBenchmarks.make()
+        + AllocatorBenchmarks.make()
+        + ExecutorBenchmarks.make()
+        + TimerWheelBenchmarks.make()
+        + LoggerBenchmarks.make(threadCount: options.threadCount)
+        + MemoryBenchmarks.make()
+        + HttpBenchmarks.make()
+        + HpackBenchmarks.make()
+        + InstrumentationBenchmarks.make()
+}
+
+private func run(_ benchmarks: [Benchmark], options: Options, nameWidth: Int) -> [BenchmarkResult] {
+    let runner = BenchmarkRunner(warmupIterations: options.warmupIterations, iterations: options.iterations)
+
+    print(
+        "CPU feature level: \(Environment.current.cpuFeatureLevel.name),",
+        "processors: \(NativeThread.processorCount),",
+        "instrumentation: \(Instrumentation.isEnabled ? "on" : "off")"
+    )
+    print(pad("benchmark", nameWidth), "   ns/unit   cycles/unit    median ns       p99 ns   rate")
+
+    return benchmarks.map { benchmark -> BenchmarkResult in
+        let result = runner.run(benchmark)
+        print(
+            pad(result.name, nameWidth),
+            pad(format(result.nanosecondsPerUnit, 3), 12),
+            pad(format(result.cyclesPerUnit, 3), 12),
+            pad(format(result.medianNanoseconds, 0), 12),
+            pad(format(result.p99Nanoseconds, 0), 12),
+            formatRate(result)
+        )
+
+        return result
+    }
+}
+
+/// Prints the changes and returns the number of regressions.
+private func compare(_ report: BenchmarkReport, with path: String, options: Options, nameWidth: Int) -> Int {
+    let baseline: BenchmarkReport
+    do {
+        baseline = try BenchmarkReport.read(from: path)
+    } catch {
+        Options.fail("Cannot read \(path): \(error)")
+    }
+
+    let comparisons = report.compare(with: baseline)
+    var regressionCount = 0
+
+    print("\nCompared with \(path) (threshold \(format(options.threshold * 100, 0))%):")
+    for comparison in comparisons {
+        let isRegression = comparison.isRegression(threshold: options.threshold)
+        if isRegression {
+            regressionCount += 1
+        }
+
+        let sign = comparison.change >= 0 ? "+" : ""
+        print(
+            pad(comparison.name, nameWidth),
+            pad(sign + format(comparison.change * 100, 1) + "%", 10),
+            isRegression ? "REGRESSION" : ""
+        )
+    }
+
+    if regressionCount > 0 {
+        print("\(regressionCount) of \(comparisons.count) benchmarks are slower than the baseline.")
+    }
+
+    return regressionCount
+}
+
+/// Prints the result of the load test, exits with 1 if connections failed.
+private func runLoadTest(_ mode: LoadTestMode, options: Options) -> Int32 {
+    #if os(Linux)
+    let serverLoopCount = max(1, options.threadCount / 2)
+    let clientLoopCount = max(1, options.threadCount - serverLoopCount)
+    print(
+        "Load test: \(mode.rawValue), connections: \(options.connectionCount),",
+        "server loops: \(serverLoopCount), client loops: \(clientLoopCount)"
+    )
+
+    let test = LoadTest(
+        mode: mode,
+        connectionCount: options.connectionCount,
+        serverLoopCount: serverLoopCount,
+        clientLoopCount: clientLoopCount
+    )
+    let result = test.run(for: options.duration)
+
+    print(pad("connections/s", 16), format(result.connectionsPerSecond, 0))
+    print(pad("requests/s", 16), format(result.requestsPerSecond, 0))
+    print(pad("errors", 16), result.errorCount)
+    for (name, percentile) in [("p50", 0.5), ("p90", 0.9), ("p99", 0.99), ("p99.9", 0.999)] {
+        print(pad("latency \(name) us", 16), format(Double(result.latency(percentile: percentile)) / 1e3, 1))
+    }
+
+    return result.errorCount > 0 ? 1 : 0
+    #else
+    Options.fail("Load test requires Linux")
+    #endif
+}
+
+private func runBenchmarks() -> Int32 {
+    let options = Options(arguments: Array(CommandLine.arguments.dropFirst()))
+    if let mode = options.loadTestMode {
+        return runLoadTest(mode, options: options)
+    }
+
+    let benchmarks = makeBenchmarks(options: options)
+    // Benchmarks of one suite can share resources, so they are released after all runs.
+    defer {
+        for benchmark in benchmarks {
+            benchmark.tearDown()
+        }
+    }
+
+    let selected = benchmarks.filter { benchmark in
+        options.filter.map { benchmark.name.contains($0) } ?? true
+    }
+
+    if options.isList {
+        for benchmark in selected {
+            print(benchmark.name)
+        }
+
+        return 0
+    }
+
+    let nameWidth = selected.map { $0.name.count }.max() ?? 0
+    let report = BenchmarkReport(results: run(selected, options: options, nameWidth: nameWidth))
+
+    if let path = options.outputPath {
+        do {
+            try report.write(to: path)
+        } catch {
+            Options.fail("Cannot write \(path): \(error)")
+        }
+    }
+
+    if let path = options.baselinePath, compare(report, with: path, options: options, nameWidth: nameWidth) > 0 {
+        return 1
+    }
+
+    return 0
+}
+
+exit(runBenchmarks())
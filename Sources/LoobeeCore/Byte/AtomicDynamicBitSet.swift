@@ -0,0 +1,146 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Represents a fixed-size sequence of bits that can be changed by many threads at once.
+///
+/// Each change is one atomic `fetchAndBitOr`/`fetchAndBitAnd` on a word, so threads can claim
+/// and release slots without locks:
+///
+///     let slots = AtomicDynamicBitSet(count: 1 << 20)
+///     if let slot = slots.claimZeroBit(hint: threadIndex << 12) {
+///         // The slot belongs to the current thread.
+///         slots.reset(slot)
+///     }
+///
+/// - SeeAlso: `DynamicBitSet`.
+public final class AtomicDynamicBitSet {
+    /// The number of bits.
+    public let count: Int
+
+    /// Words aligned to the cache line, bits after the last one are always zero.
+    @usableFromInline internal let words: UnsafeMutablePointer<UInt64>
+
+    @usableFromInline internal let wordCount: Int
+
+    /// Creates a new instance with `count` bits set to zero.
+    public init(count: Int) {
+        assert(count >= 0, "AtomicDynamicBitSet: Count must be non-negative.")
+
+        self.count = count
+        self.wordCount = (count + 63) >> 6
+
+        let capacity = max(self.wordCount, 1)
+        self.words = AlignedSystemAllocator<UInt64>().allocate(count: capacity, alignment: .custom(size: 64))
+        self.words.initialize(repeating: 0, count: capacity)
+    }
+
+    /// Creates a new instance with bits of the bitset.
+    public convenience init(_ bitset: DynamicBitSet) {
+        self.init(count: bitset.count)
+        bitset.withUnsafeWords { self.words.assign(from: $0.baseAddress!, count: $0.count) }
+    }
+
+    deinit {
+        AlignedSystemAllocator<UInt64>().deallocate(self.words)
+    }
+
+    /// Returns the value of the bit.
+    ///
+    /// - Precondition: `position` must be in `0..<count`.
+    @inlinable
+    public subscript(position: Int) -> Bit {
+        assert(position >= 0 && position < self.count, "AtomicDynamicBitSet: Bad bit position.")
+
+        let word = self.words[position >> 6].atomicLoad(withOrder: .acquire)
+
+        return (word >> UInt64(position & 63)) & 1 == 1 ? .one : .zero
+    }
+
+    /// Sets the bit to `.one`.
+    ///
+    /// - Returns: The previous value of the bit.
+    @inlinable
+    @discardableResult
+    public func set(_ position: Int, withOrder order: AtomicOrder = .acqRel) -> Bit {
+        assert(position >= 0 && position < self.count, "AtomicDynamicBitSet: Bad bit position.")
+
+        let mask: UInt64 = 1 << UInt64(position & 63)
+        let previous = self.words[position >> 6].atomicFetchAndBitOr(mask, withOrder: order)
+
+        return previous & mask != 0 ? .one : .zero
+    }
+
+    /// Sets the bit to `.zero`.
+    ///
+    /// - Returns: The previous value of the bit.
+    @inlinable
+    @discardableResult
+    public func reset(_ position: Int, withOrder order: AtomicOrder = .acqRel) -> Bit {
+        assert(position >= 0 && position < self.count, "AtomicDynamicBitSet: Bad bit position.")
+
+        let mask: UInt64 = 1 << UInt64(position & 63)
+        let previous = self.words[position >> 6].atomicFetchAndBitAnd(~mask, withOrder: order)
+
+        return previous & mask != 0 ? .one : .zero
+    }
+
+    /// Finds a zero bit and sets it to `.one`, no other thread can claim the same bit
+    /// until it is reset.
+    ///
+    /// The search starts from the word that contains `hint` and wraps around, so threads
+    /// with different hints do not contend for the same words. The hint can be any value,
+    /// it is wrapped around the bitset.
+    ///
+    /// - Returns: The position of the claimed bit or nil if all bits are set.
+    public func claimZeroBit(hint: Int = 0) -> Int? {
+        guard self.wordCount > 0 else {
+            return nil
+        }
+
+        let usedBits = self.count & 63
+        let lastWordMask: UInt64 = usedBits == 0 ? ~0 : (1 << UInt64(usedBits)) &- 1
+        // Any hint is valid, including negative ones, e.g. hashes.
+        let hintWordIndex = (hint >> 6) % self.wordCount
+        let firstWordIndex = hintWordIndex < 0 ? hintWordIndex + self.wordCount : hintWordIndex
+
+        for step in 0..<self.wordCount {
+            let wordIndex = (firstWordIndex + step) % self.wordCount
+            // Bits after the end of the bitset are treated as set.
+            let padding = wordIndex == self.wordCount - 1 ? ~lastWordMask : 0
+
+            var word = self.words[wordIndex].atomicLoad(withOrder: .relaxed) | padding
+            while word != ~0 {
+                let mask = ~word & (word &+ 1)
+                let previous = self.words[wordIndex].atomicFetchAndBitOr(mask, withOrder: .acqRel)
+                if previous & mask == 0 {
+                    return wordIndex << 6 + mask.trailingZeroBitCount
+                }
+
+                // Another thread has claimed the bit.
+                word = previous | padding
+            }
+        }
+
+        return nil
+    }
+
+    /// The number of non zero bits. Concurrent changes can be partially visible.
+    public var nonzeroBitCount: Int {
+        return self.snapshot().nonzeroBitCount
+    }
+
+    /// Returns a copy of the bits. Each word is loaded atomically, concurrent changes of different
+    /// words can be partially visible.
+    public func snapshot() -> DynamicBitSet {
+        let result = DynamicBitSet(count: self.count)
+        for wordIndex in 0..<self.wordCount {
+            result.storage.words[wordIndex] = self.words[wordIndex].atomicLoad(withOrder: .acquire)
+        }
+
+        return result
+    }
+}
@@ -0,0 +1,53 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+/// Search of set bits in bitmaps with SIMD kernels selected by `CpuDispatch`.
+///
+/// Bit `i` is bit `i % 64` of the word `i / 64`.
+public enum BitScan {
+    @usableFromInline
+    internal typealias FirstSetBit = @convention(c) (UnsafePointer<UInt64>, Int) -> Int
+
+    @usableFromInline
+    internal static let firstSetBitDispatch: CpuDispatch<FirstSetBit> = {
+        #if arch(x86_64)
+        return CpuDispatch([
+            (.baseline, CLoobeeCoreScan_firstSetBitScalar),
+            (.avx2, CLoobeeCoreScan_firstSetBitAvx2),
+        ])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreScan_firstSetBitScalar)])
+        #endif
+    }()
+
+    /// Returns the index of the lowest set bit at or after `start`.
+    ///
+    ///     let index = BitScan.firstSetBit(in: words, from: 10)
+    ///
+    /// - Returns: The index or nil if there is no set bit.
+    @inlinable
+    public static func firstSetBit(in words: UnsafeBufferPointer<UInt64>, from start: Int = 0) -> Int? {
+        assert(start >= 0, "BitScan: Start must be non-negative.")
+
+        let wordIndex = start >> 6
+        guard let base = words.baseAddress, wordIndex < words.count else {
+            return nil
+        }
+
+        let firstWord = words[wordIndex] & (UInt64.max << UInt64(start & 63))
+        if firstWord != 0 {
+            return wordIndex << 6 + firstWord.trailingZeroBitCount
+        }
+
+        let restCount = words.count - wordIndex - 1
+        let index = BitScan.firstSetBitDispatch.kernel(base + wordIndex + 1, restCount)
+
+        return index < restCount << 6 ? (wordIndex + 1) << 6 + index : nil
+    }
+}
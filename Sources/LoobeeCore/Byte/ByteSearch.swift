@@ -0,0 +1,106 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+/// Byte search and comparison with SIMD kernels selected by `CpuDispatch`.
+public enum ByteSearch {
+    @usableFromInline
+    internal typealias FindByte = @convention(c) (UnsafeRawPointer, Int, UInt8) -> Int
+
+    @usableFromInline
+    internal typealias AsciiCaseInsensitiveEqual = @convention(c) (UnsafeRawPointer, UnsafeRawPointer, Int) -> Bool
+
+    @usableFromInline
+    internal static let findByteDispatch: CpuDispatch<FindByte> = {
+        #if arch(x86_64)
+        return CpuDispatch([
+            (.baseline, CLoobeeCoreScan_findByteSse2),
+            (.avx2, CLoobeeCoreScan_findByteAvx2),
+        ])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreScan_findByteScalar)])
+        #endif
+    }()
+
+    @usableFromInline
+    internal static let asciiCaseInsensitiveEqualDispatch: CpuDispatch<AsciiCaseInsensitiveEqual> = {
+        #if arch(x86_64)
+        return CpuDispatch([
+            (.baseline, CLoobeeCoreScan_asciiCaseInsensitiveEqualSse2),
+            (.avx2, CLoobeeCoreScan_asciiCaseInsensitiveEqualAvx2),
+        ])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreScan_asciiCaseInsensitiveEqualScalar)])
+        #endif
+    }()
+
+    @usableFromInline
+    internal typealias FindControl = @convention(c) (UnsafeRawPointer, Int) -> Int
+
+    @usableFromInline
+    internal static let findControlDispatch: CpuDispatch<FindControl> = {
+        #if arch(x86_64)
+        return CpuDispatch([
+            (.baseline, CLoobeeCoreScan_findControlScalar),
+            (.sse42, CLoobeeCoreScan_findControlSse42),
+            (.avx2, CLoobeeCoreScan_findControlAvx2),
+        ])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreScan_findControlScalar)])
+        #endif
+    }()
+
+    /// Returns the index of the first occurrence of `byte` in the buffer (`memchr`).
+    ///
+    ///     let index = ByteSearch.firstIndex(of: UInt8(ascii: "\r"), in: buffer)
+    ///
+    /// - Returns: The index or nil if there is no such byte.
+    @inlinable
+    public static func firstIndex(of byte: UInt8, in buffer: UnsafeRawBufferPointer) -> Int? {
+        guard let base = buffer.baseAddress else {
+            return nil
+        }
+
+        let index = ByteSearch.findByteDispatch.kernel(base, buffer.count, byte)
+
+        return index < buffer.count ? index : nil
+    }
+
+    /// Returns the index of the first ASCII control character except HTAB (`0x00-0x08`, `0x0A-0x1F`, `0x7F`).
+    ///
+    /// Finds line ends (`\r`, `\n`) and characters that are not allowed in text protocols in one pass:
+    ///
+    ///     let index = ByteSearch.firstControlCharacter(in: line)
+    ///
+    /// - Returns: The index or nil if there is no such character.
+    @inlinable
+    public static func firstControlCharacter(in buffer: UnsafeRawBufferPointer) -> Int? {
+        guard let base = buffer.baseAddress else {
+            return nil
+        }
+
+        let index = ByteSearch.findControlDispatch.kernel(base, buffer.count)
+
+        return index < buffer.count ? index : nil
+    }
+
+    /// Compares the buffers, while ignoring differences in case of ASCII letters.
+    /// Other bytes, including non-ASCII ones, are compared as is.
+    @inlinable
+    public static func asciiCaseInsensitiveEqual(_ lhs: UnsafeRawBufferPointer, _ rhs: UnsafeRawBufferPointer) -> Bool {
+        guard lhs.count == rhs.count else {
+            return false
+        }
+
+        guard let lhsBase = lhs.baseAddress, let rhsBase = rhs.baseAddress else {
+            return true
+        }
+
+        return ByteSearch.asciiCaseInsensitiveEqualDispatch.kernel(lhsBase, rhsBase, lhs.count)
+    }
+}
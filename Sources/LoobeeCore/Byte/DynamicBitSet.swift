@@ -0,0 +1,454 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Heap storage of `DynamicBitSet`, shared between copies until one of them is mutated.
+@usableFromInline
+internal final class DynamicBitSetStorage {
+    /// Words aligned to the cache line, bits after the last one are always zero.
+    @usableFromInline internal let words: UnsafeMutablePointer<UInt64>
+
+    @usableFromInline internal let wordCount: Int
+
+    @usableFromInline
+    internal init(wordCount: Int) {
+        self.wordCount = wordCount
+        self.words = AlignedSystemAllocator<UInt64>().allocate(count: max(wordCount, 1), alignment: .custom(size: 64))
+        self.words.initialize(repeating: 0, count: max(wordCount, 1))
+    }
+
+    deinit {
+        AlignedSystemAllocator<UInt64>().deallocate(self.words)
+    }
+
+    @usableFromInline
+    internal func copy() -> DynamicBitSetStorage {
+        let result = DynamicBitSetStorage(wordCount: self.wordCount)
+        result.words.assign(from: self.words, count: self.wordCount)
+
+        return result
+    }
+}
+
+/// Represents a sequence of bits with the size set at runtime, e.g. millions of bits for slot
+/// allocation or ID sets.
+///
+/// Has the API of `BitSet` and bulk operations (`&`, `|`, `^`, `~`, `nonzeroBitCount`) executed by
+/// AVX2/POPCNT kernels selected by `CpuDispatch`. The storage is copied on write.
+///
+///     var free = DynamicBitSet(count: 1_000_000)
+///     free[42] = .one
+///     let used = ~free
+///     print(used.nonzeroBitCount) // 999999
+///
+/// - SeeAlso: `DynamicBitSet.RankIndex` for rank/select, `AtomicDynamicBitSet` for the lock-free variant.
+@_fixed_layout
+public struct DynamicBitSet {
+    ///
+    @usableFromInline internal var storage: DynamicBitSetStorage
+
+    /// The number of bits.
+    public let count: Int
+
+    /// Creates a new instance with `count` bits set to `value`.
+    public init(count: Int, repeating value: Bit = .zero) {
+        assert(count >= 0, "DynamicBitSet: Count must be non-negative.")
+
+        self.count = count
+        self.storage = DynamicBitSetStorage(wordCount: (count + 63) >> 6)
+        if value == .one {
+            self.set()
+        }
+    }
+}
+
+extension DynamicBitSet {
+    @usableFromInline
+    internal typealias BinaryKernel = @convention(c) (
+        UnsafeMutablePointer<UInt64>,
+        UnsafePointer<UInt64>,
+        UnsafePointer<UInt64>,
+        Int
+    ) -> Void
+
+    @usableFromInline
+    internal typealias NotKernel = @convention(c) (UnsafeMutablePointer<UInt64>, UnsafePointer<UInt64>, Int) -> Void
+
+    @usableFromInline
+    internal typealias PopcountKernel = @convention(c) (UnsafePointer<UInt64>, Int) -> Int
+
+    @usableFromInline
+    internal static let andDispatch: CpuDispatch<BinaryKernel> = {
+        #if arch(x86_64)
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_andScalar), (.avx2, CLoobeeCoreBitOps_andAvx2)])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_andScalar)])
+        #endif
+    }()
+
+    @usableFromInline
+    internal static let orDispatch: CpuDispatch<BinaryKernel> = {
+        #if arch(x86_64)
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_orScalar), (.avx2, CLoobeeCoreBitOps_orAvx2)])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_orScalar)])
+        #endif
+    }()
+
+    @usableFromInline
+    internal static let xorDispatch: CpuDispatch<BinaryKernel> = {
+        #if arch(x86_64)
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_xorScalar), (.avx2, CLoobeeCoreBitOps_xorAvx2)])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_xorScalar)])
+        #endif
+    }()
+
+    @usableFromInline
+    internal static let notDispatch: CpuDispatch<NotKernel> = {
+        #if arch(x86_64)
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_notScalar), (.avx2, CLoobeeCoreBitOps_notAvx2)])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_notScalar)])
+        #endif
+    }()
+
+    @usableFromInline
+    internal static let popcountDispatch: CpuDispatch<PopcountKernel> = {
+        #if arch(x86_64)
+        return CpuDispatch([
+            (.baseline, CLoobeeCoreBitOps_popcountScalar),
+            (.sse42, CLoobeeCoreBitOps_popcountPopcnt),
+            (.avx2, CLoobeeCoreBitOps_popcountAvx2),
+        ])
+        #else
+        return CpuDispatch([(.baseline, CLoobeeCoreBitOps_popcountScalar)])
+        #endif
+    }()
+}
+
+extension DynamicBitSet {
+    /// The number of 64-bit words of the storage.
+    @inlinable public var wordCount: Int {
+        return self.storage.wordCount
+    }
+
+    /// The number of non zero bits.
+    ///
+    ///     var bitset = DynamicBitSet(count: 1000)
+    ///     bitset[1] = .one
+    ///     bitset[999] = .one
+    ///     print(bitset.nonzeroBitCount == 2) // true
+    @inlinable public var nonzeroBitCount: Int {
+        return DynamicBitSet.popcountDispatch.kernel(self.storage.words, self.wordCount)
+    }
+
+    /// Returns true if all bits are set to true, otherwise false.
+    @inlinable public var isAllOnes: Bool {
+        return self.nonzeroBitCount == self.count
+    }
+
+    /// Returns true if all bits are set to false, otherwise false.
+    @inlinable public var isAllZeros: Bool {
+        return self.firstSetBit() == nil
+    }
+
+    /// Returns true if any bit is set to true, otherwise false.
+    @inlinable public var isAnyOnes: Bool {
+        return self.firstSetBit() != nil
+    }
+
+    /// Mask of the used bits of the last word.
+    @usableFromInline internal var lastWordMask: UInt64 {
+        let usedBits = self.count & 63
+        return usedBits == 0 ? ~0 : (1 << UInt64(usedBits)) &- 1
+    }
+
+    /// Access to a specific bit.
+    @inlinable
+    public subscript(position: Int) -> Bit {
+        /// Returns the value of the requested bit.
+        ///
+        ///     var bitset = DynamicBitSet(count: 100)
+        ///     bitset[70] = .one
+        ///     print(bitset[70] == .one) // true
+        ///     print(bitset[71] == .zero) // true
+        ///
+        /// If position is out of bounds:
+        ///   - Debug mode: fatalError
+        ///   - Release mode: undefined behavior
+        ///
+        /// Use `test()` as safe variant.
+        get {
+            if !_isFastAssertConfiguration() && (position < 0 || position >= self.count) {
+                fatalError("DynamicBitSet: Bad bit position: \(position)")
+            }
+
+            return (self.storage.words[position >> 6] >> UInt64(position & 63)) & 1 == 1 ? .one : .zero
+        }
+        /// Set value to a specific bit.
+        set {
+            var reference: BitReference<UInt64> = self[position]
+            reference.value = newValue
+        }
+    }
+
+    /// Access to reference on a specific bit.
+    ///
+    /// - Note: The reference is valid until the next copy or mutation of the bitset.
+    @inlinable
+    public subscript(position: Int) -> BitReference<UInt64> {
+        /// Returns the reference on the requested bit.
+        ///
+        /// If position is out of bounds:
+        ///   - Debug mode: fatalError
+        ///   - Release mode: undefined behavior
+        mutating get {
+            if !_isFastAssertConfiguration() && (position < 0 || position >= self.count) {
+                fatalError("DynamicBitSet: Bad bit position: \(position)")
+            }
+
+            self.makeUnique()
+
+            return BitReference(pointer: self.storage.words + (position >> 6), bit: UInt64(position & 63))
+        }
+    }
+
+    /// Performs a bounds check and returns nil if position does not correspond to a valid position in the bitset.
+    @inlinable
+    public func test(_ position: Int) -> Bit? {
+        guard position >= 0 && position < self.count else {
+            return nil
+        }
+
+        return self[position]
+    }
+
+    /// Sets all bits to `.one`.
+    public mutating func set() {
+        self.makeUnique()
+
+        guard self.wordCount > 0 else {
+            return
+        }
+
+        self.storage.words.assign(repeating: ~0, count: self.wordCount)
+        self.storage.words[self.wordCount - 1] = self.lastWordMask
+    }
+
+    /// Sets all bits to `.zero`.
+    public mutating func reset() {
+        self.makeUnique()
+        self.storage.words.assign(repeating: 0, count: self.wordCount)
+    }
+
+    /// Returns the index of the first set bit at or after `start`.
+    ///
+    ///     var bitset = DynamicBitSet(count: 1000)
+    ///     bitset[700] = .one
+    ///     print(bitset.firstSetBit() == 700) // true
+    ///     print(bitset.firstSetBit(from: 701) == nil) // true
+    ///
+    /// - Returns: The index or nil if there is no set bit.
+    @inlinable
+    public func firstSetBit(from start: Int = 0) -> Int? {
+        guard start < self.count else {
+            return nil
+        }
+
+        return self.withUnsafeWords { BitScan.firstSetBit(in: $0, from: start) }
+    }
+
+    /// Calls `body` with the words of the bitset.
+    @inlinable
+    public func withUnsafeWords<R>(_ body: (UnsafeBufferPointer<UInt64>) throws -> R) rethrows -> R {
+        return try body(UnsafeBufferPointer(start: self.storage.words, count: self.wordCount))
+    }
+
+    /// Copies the storage if it is shared with other bitsets.
+    @inlinable
+    internal mutating func makeUnique() {
+        if !isKnownUniquelyReferenced(&self.storage) {
+            self.storage = self.storage.copy()
+        }
+    }
+}
+
+extension DynamicBitSet {
+    /// Indices of the set bits in ascending order.
+    ///
+    ///     for index in bitset.setBitIndices {
+    ///         print(index)
+    ///     }
+    @inlinable public var setBitIndices: SetBitIndices {
+        return SetBitIndices(bitset: self)
+    }
+
+    /// Sequence of the indices of set bits, scans a word at once.
+    @_fixed_layout
+    public struct SetBitIndices: Sequence, IteratorProtocol {
+        ///
+        @usableFromInline internal let bitset: DynamicBitSet
+
+        /// Unvisited bits of the current word.
+        @usableFromInline internal var word: UInt64
+
+        @usableFromInline internal var wordIndex: Int = 0
+
+        @usableFromInline
+        internal init(bitset: DynamicBitSet) {
+            self.bitset = bitset
+            self.word = bitset.wordCount > 0 ? bitset.storage.words[0] : 0
+        }
+
+        @inlinable
+        public mutating func next() -> Int? {
+            while self.word == 0 {
+                self.wordIndex += 1
+                guard self.wordIndex < self.bitset.wordCount else {
+                    self.wordIndex = self.bitset.wordCount
+                    return nil
+                }
+
+                self.word = self.bitset.storage.words[self.wordIndex]
+            }
+
+            let result = self.wordIndex << 6 + self.word.trailingZeroBitCount
+            self.word &= self.word &- 1
+
+            return result
+        }
+    }
+}
+
+extension DynamicBitSet {
+    /// Stores the result of performing a bitwise AND operation on the two
+    /// given bitsets in the left-hand-side variable.
+    ///
+    /// - Precondition: The bitsets must have the same count.
+    @inlinable
+    public static func &= (_ lhs: inout DynamicBitSet, _ rhs: DynamicBitSet) {
+        lhs.formInPlace(rhs, DynamicBitSet.andDispatch.kernel)
+    }
+
+    /// Returns the result of performing a bitwise AND operation on the two
+    /// given bitsets.
+    ///
+    /// - Precondition: The bitsets must have the same count.
+    @inlinable
+    public static func & (_ lhs: DynamicBitSet, _ rhs: DynamicBitSet) -> DynamicBitSet {
+        return lhs.combined(rhs, DynamicBitSet.andDispatch.kernel)
+    }
+
+    /// Stores the result of performing a bitwise OR operation on the two
+    /// given bitsets in the left-hand-side variable.
+    ///
+    /// - Precondition: The bitsets must have the same count.
+    @inlinable
+    public static func |= (_ lhs: inout DynamicBitSet, _ rhs: DynamicBitSet) {
+        lhs.formInPlace(rhs, DynamicBitSet.orDispatch.kernel)
+    }
+
+    /// Returns the result of performing a bitwise OR operation on the two
+    /// given bitsets.
+    ///
+    /// - Precondition: The bitsets must have the same count.
+    @inlinable
+    public static func | (_ lhs: DynamicBitSet, _ rhs: DynamicBitSet) -> DynamicBitSet {
+        return lhs.combined(rhs, DynamicBitSet.orDispatch.kernel)
+    }
+
+    /// Stores the result of performing a bitwise XOR operation on the two
+    /// given bitsets in the left-hand-side variable.
+    ///
+    /// - Precondition: The bitsets must have the same count.
+    @inlinable
+    public static func ^= (_ lhs: inout DynamicBitSet, _ rhs: DynamicBitSet) {
+        lhs.formInPlace(rhs, DynamicBitSet.xorDispatch.kernel)
+    }
+
+    /// Returns the result of performing a bitwise XOR operation on the two
+    /// given bitsets.
+    ///
+    /// - Precondition: The bitsets must have the same count.
+    @inlinable
+    public static func ^ (_ lhs: DynamicBitSet, _ rhs: DynamicBitSet) -> DynamicBitSet {
+        return lhs.combined(rhs, DynamicBitSet.xorDispatch.kernel)
+    }
+
+    /// Returns a value in which all the bits are flipped.
+    ///
+    ///     let bitset = DynamicBitSet(count: 100)
+    ///     print((~bitset).isAllOnes) // true
+    @inlinable
+    public static prefix func ~ (bitset: DynamicBitSet) -> DynamicBitSet {
+        var result = bitset
+        result.storage = DynamicBitSetStorage(wordCount: bitset.wordCount)
+
+        DynamicBitSet.notDispatch.kernel(result.storage.words, bitset.storage.words, bitset.wordCount)
+        if bitset.wordCount > 0 {
+            result.storage.words[bitset.wordCount - 1] &= bitset.lastWordMask
+        }
+
+        return result
+    }
+
+    @inlinable
+    internal mutating func formInPlace(_ other: DynamicBitSet, _ kernel: BinaryKernel) {
+        guard self.count == other.count else {
+            fatalError("DynamicBitSet: Counts are different: \(self.count) and \(other.count).")
+        }
+
+        self.makeUnique()
+        kernel(self.storage.words, self.storage.words, other.storage.words, self.wordCount)
+    }
+
+    @inlinable
+    internal func combined(_ other: DynamicBitSet, _ kernel: BinaryKernel) -> DynamicBitSet {
+        guard self.count == other.count else {
+            fatalError("DynamicBitSet: Counts are different: \(self.count) and \(other.count).")
+        }
+
+        var result = self
+        result.storage = DynamicBitSetStorage(wordCount: self.wordCount)
+        kernel(result.storage.words, self.storage.words, other.storage.words, self.wordCount)
+
+        return result
+    }
+}
+
+extension DynamicBitSet: Equatable {
+    @inlinable
+    public static func == (lhs: DynamicBitSet, rhs: DynamicBitSet) -> Bool {
+        if lhs.count != rhs.count {
+            return false
+        }
+
+        return lhs.storage === rhs.storage
+            || memcmp(lhs.storage.words, rhs.storage.words, lhs.wordCount * MemoryLayout<UInt64>.stride) == 0
+    }
+}
+
+extension DynamicBitSet: Hashable {
+    public func hash(into hasher: inout Hasher) {
+        hasher.combine(self.count)
+        hasher.combine(self.withUnsafeWords { wideHash64(UnsafeRawBufferPointer($0)) })
+    }
+}
+
+extension DynamicBitSet: CustomDebugStringConvertible {
+    public var debugDescription: String {
+        return "DynamicBitSet(count: \(self.count), nonzeroBitCount: \(self.nonzeroBitCount))"
+    }
+}
@@ -0,0 +1,193 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+extension DynamicBitSet {
+    /// Index for the rank (number of set bits before a position) and select (position of the set bit
+    /// with the given rank) queries over a snapshot of the bitset.
+    ///
+    /// The layout is rank9: for each block of 512 bits the index stores the number of set bits before
+    /// the block and the 9-bit counts before each word of the block packed in one word, so `rank(_:)`
+    /// reads two words of the index and one word of the bitset. `select(_:)` starts from the block
+    /// sampled for each 512 set bits and finds the block by binary search between two samples.
+    /// The index takes 25% of the size of the bitset.
+    ///
+    ///     let index = bitset.makeRankIndex()
+    ///     print(index.rank(100)) // The number of set bits in 0..<100.
+    ///     print(index.select(0) == bitset.firstSetBit()) // true
+    ///
+    /// [Details](https://vigna.di.unimi.it/ftp/papers/Broadword.pdf)
+    ///
+    /// - Note: The index keeps a copy of the bitset, so it is not affected by later mutations.
+    @_fixed_layout
+    public struct RankIndex {
+        /// The bitset snapshot.
+        public let bitset: DynamicBitSet
+
+        /// Pairs of the number of set bits before the block and the packed counts inside the block.
+        /// The last pair holds the total number of set bits.
+        @usableFromInline internal let blocks: [UInt64]
+
+        /// Block that contains the set bit with rank `i * samplingRate`.
+        @usableFromInline internal let samples: [Int]
+
+        /// The number of set bits.
+        public let nonzeroBitCount: Int
+
+        @usableFromInline internal static var wordsPerBlock: Int {
+            return 8
+        }
+
+        @usableFromInline internal static var samplingRate: Int {
+            return 512
+        }
+
+        public init(_ bitset: DynamicBitSet) {
+            let wordsPerBlock = RankIndex.wordsPerBlock
+            let blockCount = (bitset.wordCount + wordsPerBlock - 1) / wordsPerBlock
+
+            var blocks = [UInt64](repeating: 0, count: 2 * (blockCount + 1))
+            var samples: [Int] = []
+            var total = 0
+
+            bitset.withUnsafeWords { words in
+                for block in 0..<blockCount {
+                    blocks[2 * block] = UInt64(total)
+
+                    var inner = 0
+                    var packed: UInt64 = 0
+                    for subIndex in 0..<wordsPerBlock {
+                        if subIndex > 0 {
+                            packed |= UInt64(inner) << UInt64(9 * (subIndex - 1))
+                        }
+
+                        // Words after the end of the bitset are counted as zeros.
+                        let wordIndex = block * wordsPerBlock + subIndex
+                        if wordIndex < words.count {
+                            inner += words[wordIndex].nonzeroBitCount
+                        }
+                    }
+                    blocks[2 * block + 1] = packed
+
+                    while samples.count * RankIndex.samplingRate < total + inner {
+                        samples.append(block)
+                    }
+                    total += inner
+                }
+            }
+            blocks[2 * blockCount] = UInt64(total)
+
+            self.bitset = bitset
+            self.blocks = blocks
+            self.samples = samples
+            self.nonzeroBitCount = total
+        }
+
+        /// Returns the number of set bits before `position`.
+        ///
+        /// - Complexity: O(1).
+        ///
+        /// - Precondition: `position` must be in `0...bitset.count`.
+        @inlinable
+        public func rank(_ position: Int) -> Int {
+            assert(position >= 0 && position <= self.bitset.count, "RankIndex: Bad bit position.")
+
+            if position == self.bitset.count {
+                return self.nonzeroBitCount
+            }
+
+            let wordIndex = position >> 6
+            let block = wordIndex >> 3
+            let mask: UInt64 = (1 << UInt64(position & 63)) &- 1
+            let word = self.bitset.storage.words[wordIndex] & mask
+
+            return Int(self.blocks[2 * block]) + self.innerRank(block: block, subIndex: wordIndex & 7)
+                + word.nonzeroBitCount
+        }
+
+        /// Returns the position of the set bit with the given rank, i.e. the number of set bits before it.
+        ///
+        ///     print(index.select(index.rank(position)) == position) // true, if the bit at `position` is set.
+        ///
+        /// - Complexity: O(1) for uniformly distributed bits, O(log n) in the worst case.
+        ///
+        /// - Returns: The position or nil if `rank` is not less than `nonzeroBitCount`.
+        @inlinable
+        public func select(_ rank: Int) -> Int? {
+            guard rank >= 0 && rank < self.nonzeroBitCount else {
+                return nil
+            }
+
+            // The first block, such that the number of set bits before the next block is greater than rank.
+            let sample = rank / RankIndex.samplingRate
+            var low = self.samples[sample]
+            var high = sample + 1 < self.samples.count ? self.samples[sample + 1] : self.blocks.count / 2 - 1
+            while low < high {
+                let middle = (low + high) / 2
+                if Int(self.blocks[2 * (middle + 1)]) > rank {
+                    high = middle
+                } else {
+                    low = middle + 1
+                }
+            }
+
+            let remaining = rank - Int(self.blocks[2 * low])
+            var subIndex = 0
+            while subIndex + 1 < RankIndex.wordsPerBlock
+                && self.innerRank(block: low, subIndex: subIndex + 1) <= remaining {
+                subIndex += 1
+            }
+
+            let wordIndex = low * RankIndex.wordsPerBlock + subIndex
+            let word = self.bitset.storage.words[wordIndex]
+
+            return wordIndex << 6 + RankIndex.select(word, remaining - self.innerRank(block: low, subIndex: subIndex))
+        }
+
+        /// Returns the number of set bits in the block before the word `subIndex`.
+        @inlinable
+        @inline(__always)
+        internal func innerRank(block: Int, subIndex: Int) -> Int {
+            if subIndex == 0 {
+                return 0
+            }
+
+            return Int((self.blocks[2 * block + 1] >> UInt64(9 * (subIndex - 1))) & 0x1FF)
+        }
+
+        /// Returns the position of the set bit with the given rank in the word.
+        @inlinable
+        internal static func select(_ word: UInt64, _ rank: Int) -> Int {
+            var word = word
+            var rank = rank
+            var offset = 0
+
+            while true {
+                let byteCount = (word & 0xFF).nonzeroBitCount
+                if rank < byteCount {
+                    break
+                }
+
+                rank -= byteCount
+                word >>= 8
+                offset += 8
+            }
+
+            for _ in 0..<rank {
+                word &= word &- 1
+            }
+
+            return offset + word.trailingZeroBitCount
+        }
+    }
+
+    /// Returns the rank/select index of the current state of the bitset.
+    ///
+    /// - Complexity: O(n).
+    public func makeRankIndex() -> RankIndex {
+        return RankIndex(self)
+    }
+}
@@ -0,0 +1,171 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Intrusive lock-free LIFO stack (Treiber stack).
+///
+/// Any thread can push and pop nodes. The stack links nodes by their `nextNode` and does not
+/// allocate memory. To prevent the ABA problem the head address is tagged by a counter in the
+/// upper 16 bits, which are not used by user space addresses with 4-level paging.
+///
+///     let stack = IntrusiveAtomicStack<Node>()
+///     stack.push(Node())
+///     let node = stack.pop()
+///
+/// - Note: The stack retains nodes while they are contained in it.
+/// - Precondition: `nextNode` of nodes must be a stored property without observers.
+/// - Precondition: A popped node must stay alive while other threads can pop from the stack,
+///                 as they can read its link, e.g. nodes are reused from a pool.
+/// - Precondition: Node addresses must fit in 48 bits. With 5-level paging (LA57) the kernel hands out
+///                 higher addresses only to mappings that request them, a node above is a fatal error.
+public final class IntrusiveAtomicStack<T> where T: IntrusiveSListNode {
+    /// Tagged address of the top node.
+    @usableFromInline internal var head: UInt = 0
+
+    @usableFromInline internal static var tagShift: UInt {
+        return 48
+    }
+
+    @usableFromInline internal static var addressMask: UInt {
+        return (1 << IntrusiveAtomicStack.tagShift) - 1
+    }
+
+    public init() {
+        assert(MemoryLayout<UInt>.size == 8, "IntrusiveAtomicStack: Only 64-bit platforms are supported.")
+    }
+
+    deinit {
+        while self.pop() != nil {
+        }
+    }
+
+    /// Returns true if the stack is empty.
+    @inlinable
+    public var isEmpty: Bool {
+        return self.head.atomicLoad(withOrder: .acquire) & IntrusiveAtomicStack.addressMask == 0
+    }
+
+    /// Pushes the node to the top of the stack.
+    ///
+    /// - Precondition: `node` must not be contained in a list.
+    @inlinable
+    public func push(_ node: T) {
+        assert(node.nextNode == nil, "IntrusiveAtomicStack: Node is already linked.")
+
+        let address = UInt(bitPattern: Unmanaged.passRetained(node).toOpaque())
+        self.link(first: address, last: node)
+    }
+
+    /// Pushes all nodes of the list to the top of the stack with one atomic operation.
+    /// The first node of the list becomes the top.
+    public func push(contentsOf list: inout IntrusiveSList<T>) {
+        guard let chain = list.takeChain() else {
+            return
+        }
+
+        self.link(first: UInt(bitPattern: chain.first.toOpaque()), last: chain.last.takeUnretainedValue())
+    }
+
+    /// Removes the top node.
+    ///
+    /// - Returns: The top node or nil if the stack is empty.
+    @inlinable
+    public func pop() -> T? {
+        var head = self.head.atomicLoad(withOrder: .acquire)
+
+        while true {
+            let address = head & IntrusiveAtomicStack.addressMask
+            if address == 0 {
+                return nil
+            }
+
+            let node = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: address)!)
+            let next = IntrusiveAtomicStack.loadNext(of: node)
+
+            let isPopped = self.head.atomicCompareAndExchangeWeak(
+                expected: &head,
+                desired: next | IntrusiveAtomicStack.nextTag(of: head),
+                successOrder: .acquire,
+                failureOrder: .acquire
+            )
+            if isPopped {
+                let result = node.takeRetainedValue()
+                result.withNextNodeAddress { $0.pointee.atomicStore(0, withOrder: .relaxed) }
+
+                return result
+            }
+        }
+    }
+
+    /// Removes all nodes with one atomic operation.
+    ///
+    /// - Complexity: O(n), the chain is walked to find the last node.
+    ///
+    /// - Returns: The list of removed nodes in the order they would be popped.
+    public func popAll() -> IntrusiveSList<T> {
+        var head = self.head.atomicLoad(withOrder: .relaxed)
+        while !self.head.atomicCompareAndExchangeWeak(
+            expected: &head,
+            desired: IntrusiveAtomicStack.nextTag(of: head),
+            successOrder: .acquire,
+            failureOrder: .relaxed
+        ) {
+        }
+
+        let first = head & IntrusiveAtomicStack.addressMask
+        if first == 0 {
+            return IntrusiveSList(mode: .linear)
+        }
+
+        var last = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: first)!)
+        while true {
+            let next = IntrusiveAtomicStack.loadNext(of: last)
+            if next == 0 {
+                break
+            }
+            last = Unmanaged.fromOpaque(UnsafeRawPointer(bitPattern: next)!)
+        }
+
+        return IntrusiveSList(
+            mode: .linear,
+            first: Unmanaged.fromOpaque(UnsafeRawPointer(bitPattern: first)!),
+            last: last
+        )
+    }
+
+    /// Links the chain of retained nodes to the top.
+    @usableFromInline
+    internal func link(first: UInt, last: T) {
+        precondition(
+            first & ~IntrusiveAtomicStack.addressMask == 0,
+            "IntrusiveAtomicStack: Address uses the tag bits, addresses above 48 bits are not supported."
+        )
+
+        var head = self.head.atomicLoad(withOrder: .relaxed)
+        repeat {
+            last.withNextNodeAddress {
+                $0.pointee.atomicStore(head & IntrusiveAtomicStack.addressMask, withOrder: .relaxed)
+            }
+        } while !self.head.atomicCompareAndExchangeWeak(
+            expected: &head,
+            desired: first | IntrusiveAtomicStack.nextTag(of: head),
+            successOrder: .release,
+            failureOrder: .relaxed
+        )
+    }
+
+    @inlinable
+    @inline(__always)
+    internal static func loadNext(of node: Unmanaged<T>) -> UInt {
+        return node.takeUnretainedValue().withNextNodeAddress { $0.pointee.atomicLoad(withOrder: .relaxed) }
+    }
+
+    @inlinable
+    @inline(__always)
+    internal static func nextTag(of head: UInt) -> UInt {
+        return ((head &>> IntrusiveAtomicStack.tagShift) &+ 1) &<< IntrusiveAtomicStack.tagShift
+    }
+}
@@ -12,8 +12,206 @@ public protocol IntrusiveListNode: class {
 }
 
 /// Intrusive doubly-linked list.
+///
+/// The list retains its nodes, links are stored in the nodes, so no memory is allocated.
+/// All operations except `forEach(_:)` are O(1), including removal of any node.
+///
+///     final class Node: IntrusiveListNode {
+///         var nextNode: Node?
+///         var prevNode: Node?
+///     }
+///
+///     var list = IntrusiveList<Node>()
+///     let node = Node()
+///     list.pushBack(node)
+///     list.remove(node)
+///
+/// - Note: A node can be contained only in one list.
 public struct IntrusiveList<T>: Moveonly where T: IntrusiveListNode {
+    @usableFromInline internal var firstNode: T?
+
+    @usableFromInline internal var lastNode: Unmanaged<T>?
+
+    public init() {
+    }
+
     public func _deinit() {
+        self.unlinkAll()
+    }
+
+    ///
+    @inlinable
+    public var isEmpty: Bool {
+        return self.firstNode == nil
+    }
+
+    ///
+    @inlinable
+    public var first: T? {
+        return self.firstNode
+    }
+
+    ///
+    @inlinable
+    public var last: T? {
+        return self.lastNode?.takeUnretainedValue()
+    }
+
+    /// Inserts the node at the beginning of the list.
+    ///
+    /// - Precondition: `node` must not be contained in a list.
+    public mutating func pushFront(_ node: T) {
+        assert(node.nextNode == nil && node.prevNode == nil, "IntrusiveList: Node is already linked.")
+
+        if let first = self.firstNode {
+            first.prevNode = node
+            node.nextNode = first
+        } else {
+            self.lastNode = Unmanaged.passUnretained(node)
+        }
+        self.firstNode = node
+    }
+
+    /// Inserts the node at the end of the list.
+    ///
+    /// - Precondition: `node` must not be contained in a list.
+    public mutating func pushBack(_ node: T) {
+        assert(node.nextNode == nil && node.prevNode == nil, "IntrusiveList: Node is already linked.")
+
+        if let last = self.lastNode?.takeUnretainedValue() {
+            last.nextNode = node
+            node.prevNode = last
+        } else {
+            self.firstNode = node
+        }
+        self.lastNode = Unmanaged.passUnretained(node)
+    }
+
+    /// Removes and returns the first node.
+    ///
+    /// - Returns: The first node or nil if the list is empty.
+    public mutating func popFront() -> T? {
+        guard let first = self.firstNode else {
+            return nil
+        }
+
+        self.remove(first)
+
+        return first
+    }
+
+    /// Removes and returns the last node.
+    ///
+    /// - Returns: The last node or nil if the list is empty.
+    public mutating func popBack() -> T? {
+        guard let last = self.lastNode?.takeUnretainedValue() else {
+            return nil
+        }
+
+        self.remove(last)
+
+        return last
+    }
+
+    /// Inserts the node after the node of this list.
+    ///
+    /// - Precondition: `node` must not be contained in a list, `existing` must be contained in this list.
+    public mutating func insert(_ node: T, after existing: T) {
+        assert(node.nextNode == nil && node.prevNode == nil, "IntrusiveList: Node is already linked.")
+
+        if let next = existing.nextNode {
+            next.prevNode = node
+            node.nextNode = next
+        } else {
+            self.lastNode = Unmanaged.passUnretained(node)
+        }
+        existing.nextNode = node
+        node.prevNode = existing
+    }
+
+    /// Inserts the node before the node of this list.
+    ///
+    /// - Precondition: `node` must not be contained in a list, `existing` must be contained in this list.
+    public mutating func insert(_ node: T, before existing: T) {
+        assert(node.nextNode == nil && node.prevNode == nil, "IntrusiveList: Node is already linked.")
+
+        if let prev = existing.prevNode {
+            prev.nextNode = node
+            node.prevNode = prev
+        } else {
+            self.firstNode = node
+        }
+        existing.prevNode = node
+        node.nextNode = existing
+    }
+
+    /// Removes the node from the list.
+    ///
+    /// - Precondition: `node` must be contained in this list.
+    public mutating func remove(_ node: T) {
+        let prev = node.prevNode
+        let next = node.nextNode
+
+        if let prev = prev {
+            prev.nextNode = next
+        } else {
+            assert(node === self.firstNode, "IntrusiveList: Node is not contained in the list.")
+            self.firstNode = next
+        }
+
+        if let next = next {
+            next.prevNode = prev
+        } else {
+            self.lastNode = prev.map { Unmanaged.passUnretained($0) }
+        }
+
+        node.nextNode = nil
+        node.prevNode = nil
+    }
+
+    /// Moves all nodes of `other` to the end of this list.
+    public mutating func append(contentsOf other: inout IntrusiveList<T>) {
+        guard let otherFirst = other.firstNode else {
+            return
+        }
+
+        if let last = self.lastNode?.takeUnretainedValue() {
+            last.nextNode = otherFirst
+            otherFirst.prevNode = last
+        } else {
+            self.firstNode = otherFirst
+        }
+        self.lastNode = other.lastNode
+
+        other.firstNode = nil
+        other.lastNode = nil
+    }
+
+    /// Removes all nodes.
+    public mutating func removeAll() {
+        self.unlinkAll()
+        self.firstNode = nil
+        self.lastNode = nil
+    }
+
+    /// Calls `body` on each node from the first to the last.
+    ///
+    /// - Note: `body` must not modify the list.
+    public func forEach(_ body: (T) throws -> Void) rethrows {
+        var node = self.firstNode
+        while let current = node {
+            try body(current)
+            node = current.nextNode
+        }
+    }
 
+    /// Breaks all links iteratively, so releasing of a long chain does not overflow the stack.
+    private func unlinkAll() {
+        var node = self.firstNode
+        while let current = node {
+            node = current.nextNode
+            current.nextNode = nil
+            current.prevNode = nil
+        }
     }
 }
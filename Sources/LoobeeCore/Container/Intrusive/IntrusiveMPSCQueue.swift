@@ -0,0 +1,188 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Intrusive multi-producer single-consumer FIFO queue.
+///
+/// Any thread can push nodes with one atomic exchange, only one thread at a time can pop them.
+/// The queue links nodes by their `nextNode` and does not allocate memory.
+///
+/// The algorithm is a variant of the Vyukov queue without a stub node: the producer exchanges
+/// the tail and then links the previous tail (or the head, if the queue was empty) to the node.
+/// Between these two steps the node is not visible to the consumer, so `pop()` waits for the
+/// link if the queue is not empty.
+///
+///     let queue = IntrusiveMPSCQueue<Node>()
+///     queue.push(Node())        // Any thread.
+///     let node = queue.pop()    // Consumer thread.
+///
+/// [Details](http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue)
+///
+/// - Note: The queue retains nodes while they are contained in it.
+/// - Precondition: `nextNode` of nodes must be a stored property without observers.
+public final class IntrusiveMPSCQueue<T> where T: IntrusiveSListNode {
+    /// `head` and `tail` are placed on separate cache lines.
+    @usableFromInline internal let indices: UnsafeMutablePointer<UInt>
+
+    @usableFromInline internal static var tailOffset: Int {
+        return 64 / MemoryLayout<UInt>.stride
+    }
+
+    public init() {
+        let count = 2 * IntrusiveMPSCQueue.tailOffset
+
+        self.indices = AlignedSystemAllocator<UInt>().allocate(count: count, alignment: .custom(size: 64))
+        self.indices.initialize(repeating: 0, count: count)
+    }
+
+    deinit {
+        while self.pop() != nil {
+        }
+
+        AlignedSystemAllocator<UInt>().deallocate(self.indices)
+    }
+
+    /// Address of the first node, written by the consumer and by the producer that pushes
+    /// into the empty queue.
+    @usableFromInline internal var head: UnsafeMutablePointer<UInt> {
+        @inline(__always)
+        get {
+            return self.indices
+        }
+    }
+
+    /// Address of the last node, 0 if the queue is empty.
+    @usableFromInline internal var tail: UnsafeMutablePointer<UInt> {
+        @inline(__always)
+        get {
+            return self.indices + IntrusiveMPSCQueue.tailOffset
+        }
+    }
+
+    /// Returns true if the queue is empty. If the result is `false`, `pop()` returns the node.
+    @inlinable
+    public var isEmpty: Bool {
+        return self.tail.pointee.atomicLoad(withOrder: .acquire) == 0
+    }
+
+    /// Pushes the node to the end of the queue. Can be called from any thread.
+    ///
+    /// - Precondition: `node` must not be contained in a list.
+    @inlinable
+    public func push(_ node: T) {
+        assert(node.nextNode == nil, "IntrusiveMPSCQueue: Node is already linked.")
+
+        let address = UInt(bitPattern: Unmanaged.passRetained(node).toOpaque())
+        self.link(first: address, last: address)
+    }
+
+    /// Pushes all nodes of the list to the end of the queue with one atomic operation.
+    /// Can be called from any thread.
+    public func push(contentsOf list: inout IntrusiveSList<T>) {
+        guard let chain = list.takeChain() else {
+            return
+        }
+
+        self.link(
+            first: UInt(bitPattern: chain.first.toOpaque()),
+            last: UInt(bitPattern: chain.last.toOpaque())
+        )
+    }
+
+    /// Removes the first node. Can be called only by the consumer.
+    ///
+    /// - Returns: The first node or nil if the queue is empty.
+    @inlinable
+    public func pop() -> T? {
+        if self.isEmpty {
+            return nil
+        }
+
+        let address = self.waitForLink(self.head)
+        let node = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: address)!)
+
+        let next = node.takeUnretainedValue().withNextNodeAddress {
+            $0.pointee.atomicLoad(withOrder: .acquire)
+        }
+        if next != 0 {
+            self.head.pointee.atomicStore(next, withOrder: .relaxed)
+        } else {
+            self.head.pointee.atomicStore(0, withOrder: .relaxed)
+
+            var expected = address
+            let isLast = self.tail.pointee.atomicCompareAndExchangeStrong(
+                expected: &expected,
+                desired: 0,
+                successOrder: .acqRel,
+                failureOrder: .relaxed
+            )
+            if !isLast {
+                // A producer has exchanged the tail but has not linked the node yet.
+                let next = node.takeUnretainedValue().withNextNodeAddress { self.waitForLink($0) }
+                self.head.pointee.atomicStore(next, withOrder: .relaxed)
+            }
+        }
+
+        let result = node.takeRetainedValue()
+        result.withNextNodeAddress { $0.pointee.atomicStore(0, withOrder: .relaxed) }
+
+        return result
+    }
+
+    /// Removes all nodes with one atomic operation. Can be called only by the consumer.
+    ///
+    /// - Complexity: O(n), the chain is walked to wait for the links of concurrent producers.
+    ///
+    /// - Returns: The list of removed nodes in the order they were pushed.
+    public func popAll() -> IntrusiveSList<T> {
+        if self.isEmpty {
+            return IntrusiveSList(mode: .linear)
+        }
+
+        let first = self.waitForLink(self.head)
+        self.head.pointee.atomicStore(0, withOrder: .relaxed)
+        let last = self.tail.pointee.atomicExchange(newValue: 0, withOrder: .acqRel)
+
+        var address = first
+        while address != last {
+            let node = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: address)!).takeUnretainedValue()
+            address = node.withNextNodeAddress { self.waitForLink($0) }
+        }
+
+        return IntrusiveSList(
+            mode: .linear,
+            first: Unmanaged.fromOpaque(UnsafeRawPointer(bitPattern: first)!),
+            last: Unmanaged.fromOpaque(UnsafeRawPointer(bitPattern: last)!)
+        )
+    }
+
+    /// Appends the chain of retained nodes linked by `nextNode`.
+    @usableFromInline
+    internal func link(first: UInt, last: UInt) {
+        let previous = self.tail.pointee.atomicExchange(newValue: last, withOrder: .acqRel)
+
+        if previous == 0 {
+            self.head.pointee.atomicStore(first, withOrder: .release)
+        } else {
+            Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: previous)!)
+                .takeUnretainedValue()
+                .withNextNodeAddress { $0.pointee.atomicStore(first, withOrder: .release) }
+        }
+    }
+
+    /// Waits until a producer writes the link and returns it.
+    @usableFromInline
+    internal func waitForLink(_ link: UnsafeMutablePointer<UInt>) -> UInt {
+        while true {
+            let address = link.pointee.atomicLoad(withOrder: .acquire)
+            if _fastPath(address != 0) {
+                return address
+            }
+
+            NativeThread.yield()
+        }
+    }
+}
@@ -10,21 +10,256 @@ public protocol IntrusiveSListNode: class {
     var nextNode : Self? { get set }
 }
 
+extension IntrusiveSListNode {
+    /// Calls `body` with the storage of `nextNode` viewed as an address, nil is 0.
+    ///
+    /// Used by the lock-free containers, which keep links of their nodes unretained
+    /// and access them atomically.
+    ///
+    /// - Precondition: `nextNode` must be a stored property without observers.
+    @inlinable
+    @inline(__always)
+    internal func withNextNodeAddress<R>(_ body: (UnsafeMutablePointer<UInt>) -> R) -> R {
+        return withUnsafeMutablePointer(to: &self.nextNode) { pointer in
+            return body(UnsafeMutableRawPointer(pointer).assumingMemoryBound(to: UInt.self))
+        }
+    }
+}
+
 /// Intrusive singly-linked list.
+///
+/// The list retains its nodes, links are stored in the nodes, so no memory is allocated.
+/// All operations except `forEach(_:)` are O(1).
+///
+///     final class Node: IntrusiveSListNode {
+///         var nextNode: Node?
+///     }
+///
+///     var list = IntrusiveSList<Node>(mode: .linear)
+///     list.pushBack(Node())
+///     let node = list.popFront()
+///
+/// - Note: A node can be contained only in one list.
 public struct IntrusiveSList<T>: Moveonly where T: IntrusiveSListNode {
     ///
     public enum Mode {
+        /// The last node is linked to the first one.
         case circular
+        /// The last node is linked to nil.
         case linear
     }
 
     internal let mode: Mode
 
+    @usableFromInline internal var firstNode: T?
+
+    @usableFromInline internal var lastNode: Unmanaged<T>?
+
     public init(mode: Mode) {
         self.mode = mode
     }
 
+    /// Creates the list from the chain of nodes linked by strong references.
+    ///
+    /// - Parameter first: The first node of the chain, retained.
+    /// - Parameter last:  The last node of the chain, its `nextNode` is nil.
+    internal init(mode: Mode, first: Unmanaged<T>, last: Unmanaged<T>) {
+        self.mode = mode
+        self.firstNode = first.takeRetainedValue()
+        self.lastNode = last
+        self.linkLastToFirst()
+    }
+
     public func _deinit() {
+        self.unlinkAll()
+    }
+
+    ///
+    @inlinable
+    public var isEmpty: Bool {
+        return self.firstNode == nil
+    }
+
+    ///
+    @inlinable
+    public var first: T? {
+        return self.firstNode
+    }
+
+    ///
+    @inlinable
+    public var last: T? {
+        return self.lastNode?.takeUnretainedValue()
+    }
+
+    /// Inserts the node at the beginning of the list.
+    ///
+    /// - Precondition: `node` must not be contained in a list.
+    public mutating func pushFront(_ node: T) {
+        assert(node.nextNode == nil, "IntrusiveSList: Node is already linked.")
+
+        node.nextNode = self.firstNode
+        self.firstNode = node
+        if self.lastNode == nil {
+            self.lastNode = Unmanaged.passUnretained(node)
+        }
+
+        self.linkLastToFirst()
+    }
+
+    /// Inserts the node at the end of the list.
+    ///
+    /// - Precondition: `node` must not be contained in a list.
+    public mutating func pushBack(_ node: T) {
+        assert(node.nextNode == nil, "IntrusiveSList: Node is already linked.")
+
+        if let last = self.lastNode {
+            last.takeUnretainedValue().nextNode = node
+        } else {
+            self.firstNode = node
+        }
+        self.lastNode = Unmanaged.passUnretained(node)
+
+        self.linkLastToFirst()
+    }
+
+    /// Removes and returns the first node.
+    ///
+    /// - Returns: The first node or nil if the list is empty.
+    public mutating func popFront() -> T? {
+        guard let first = self.firstNode else {
+            return nil
+        }
+
+        if first === self.lastNode?.takeUnretainedValue() {
+            self.firstNode = nil
+            self.lastNode = nil
+        } else {
+            self.firstNode = first.nextNode
+            self.linkLastToFirst()
+        }
+        first.nextNode = nil
+
+        return first
+    }
+
+    /// Inserts the node after the node of this list.
+    ///
+    /// - Precondition: `node` must not be contained in a list, `existing` must be contained in this list.
+    public mutating func insert(_ node: T, after existing: T) {
+        assert(node.nextNode == nil, "IntrusiveSList: Node is already linked.")
+
+        node.nextNode = existing.nextNode
+        existing.nextNode = node
+        if existing === self.lastNode?.takeUnretainedValue() {
+            self.lastNode = Unmanaged.passUnretained(node)
+        }
+    }
+
+    /// Removes the node that follows the node of this list.
+    ///
+    /// - Precondition: `existing` must be contained in this list.
+    ///
+    /// - Returns: The removed node or nil if `existing` is the last node of the linear list.
+    public mutating func remove(after existing: T) -> T? {
+        guard let node = existing.nextNode else {
+            return nil
+        }
+
+        if node === self.firstNode {
+            return self.popFront()
+        }
+
+        existing.nextNode = node.nextNode
+        node.nextNode = nil
+        if node === self.lastNode?.takeUnretainedValue() {
+            self.lastNode = Unmanaged.passUnretained(existing)
+        }
+
+        return node
+    }
+
+    /// Moves all nodes of `other` to the end of this list.
+    public mutating func append(contentsOf other: inout IntrusiveSList<T>) {
+        guard let chain = other.takeChain() else {
+            return
+        }
+
+        if let last = self.lastNode {
+            last.takeUnretainedValue().nextNode = chain.first.takeRetainedValue()
+        } else {
+            self.firstNode = chain.first.takeRetainedValue()
+        }
+        self.lastNode = chain.last
+
+        self.linkLastToFirst()
+    }
+
+    /// Moves the first node to the end of the list.
+    public mutating func rotate() {
+        if let first = self.popFront() {
+            self.pushBack(first)
+        }
+    }
+
+    /// Removes all nodes.
+    public mutating func removeAll() {
+        self.unlinkAll()
+        self.firstNode = nil
+        self.lastNode = nil
+    }
+
+    /// Calls `body` on each node from the first to the last.
+    ///
+    /// - Note: `body` must not modify the list.
+    public func forEach(_ body: (T) throws -> Void) rethrows {
+        var node = self.firstNode
+        while let current = node {
+            try body(current)
+
+            if current === self.lastNode?.takeUnretainedValue() {
+                return
+            }
+            node = current.nextNode
+        }
+    }
+
+    /// Removes all nodes and returns them as a linear chain linked by strong references.
+    ///
+    /// - Returns: The retained first node and the unretained last one, or nil if the list is empty.
+    internal mutating func takeChain() -> (first: Unmanaged<T>, last: Unmanaged<T>)? {
+        guard let first = self.firstNode, let last = self.lastNode else {
+            return nil
+        }
+
+        if self.mode == .circular {
+            last.takeUnretainedValue().nextNode = nil
+        }
+        self.firstNode = nil
+        self.lastNode = nil
+
+        return (Unmanaged.passRetained(first), last)
+    }
+
+    @inline(__always)
+    private func linkLastToFirst() {
+        if self.mode == .circular, let last = self.lastNode {
+            last.takeUnretainedValue().nextNode = self.firstNode
+        }
+    }
+
+    /// Breaks all links iteratively, so releasing of a long chain does not overflow the stack.
+    private func unlinkAll() {
+        guard let last = self.lastNode else {
+            return
+        }
+
+        last.takeUnretainedValue().nextNode = nil
 
+        var node = self.firstNode
+        while let current = node {
+            node = current.nextNode
+            current.nextNode = nil
+        }
     }
 }
@@ -0,0 +1,69 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Selects the best implementation of a kernel for the processor once.
+///
+/// Implementations are registered for the lowest `CpuFeatureLevel` they require, the one
+/// with the highest level not above `Environment.current.cpuFeatureLevel` is selected.
+/// Kept in a `static let`, the selection happens at the first use.
+///
+///     static let find = CpuDispatch<(UnsafeRawPointer, Int, UInt8) -> Int>([
+///         (.baseline, findScalar),
+///         (.avx2, findAvx2),
+///     ])
+///
+///     let index = find.kernel(pointer, count, byte)
+///
+/// To test all implementations use `kernel(for:)` with `supportedLevels`. To force the
+/// baseline implementations set the `LOOBEE_CPU_FEATURE_LEVEL=baseline` environment variable.
+public struct CpuDispatch<Kernel> {
+    /// Implementations ordered by level.
+    public let implementations: [(level: CpuFeatureLevel, kernel: Kernel)]
+
+    /// The level of the selected implementation.
+    public let level: CpuFeatureLevel
+
+    /// The selected implementation.
+    public let kernel: Kernel
+
+    /// - Parameter implementations: Implementations with the levels they require,
+    ///                              one of them must be `.baseline`.
+    public init(_ implementations: [(level: CpuFeatureLevel, kernel: Kernel)]) {
+        self.init(implementations, maxLevel: Environment.current.cpuFeatureLevel)
+    }
+
+    /// - Parameter implementations: Implementations with the levels they require,
+    ///                              one of them must be `.baseline`.
+    /// - Parameter maxLevel:        The highest level that can be selected.
+    public init(_ implementations: [(level: CpuFeatureLevel, kernel: Kernel)], maxLevel: CpuFeatureLevel) {
+        assert(
+            implementations.contains { $0.level == .baseline },
+            "CpuDispatch: Baseline implementation is required."
+        )
+
+        let sorted = implementations.sorted { $0.level < $1.level }
+        guard let selected = sorted.last(where: { $0.level <= maxLevel }) else {
+            fatalError("CpuDispatch: Baseline implementation is required.")
+        }
+
+        self.implementations = sorted
+        self.level = selected.level
+        self.kernel = selected.kernel
+    }
+
+    /// Levels of implementations that can run on the processor.
+    public var supportedLevels: [CpuFeatureLevel] {
+        let maxLevel = Environment.current.cpuFeatureLevel
+
+        return self.implementations.map { $0.level }.filter { $0 <= maxLevel }
+    }
+
+    /// Returns the implementation that is selected for `level`.
+    public func kernel(for level: CpuFeatureLevel) -> Kernel {
+        return CpuDispatch(self.implementations, maxLevel: level).kernel
+    }
+}
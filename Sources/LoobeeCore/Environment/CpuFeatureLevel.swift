@@ -0,0 +1,76 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Instruction set level of the processor, used to select kernels by `CpuDispatch`.
+///
+/// Each level includes the previous ones. AVX levels are detected only if the OS saves
+/// the corresponding registers on context switches (XCR0).
+public enum CpuFeatureLevel: Int, CaseIterable {
+    /// x86-64 with SSE2, or any other architecture.
+    case baseline = 0
+    /// SSE3, SSSE3, SSE4.1, SSE4.2, POPCNT and CX16 (x86-64-v2).
+    case sse42
+    /// AVX, AVX2, BMI1, BMI2, FMA, LZCNT, MOVBE and F16C (x86-64-v3).
+    case avx2
+    /// AVX-512 F, BW, CD, DQ and VL (x86-64-v4).
+    case avx512
+
+    /// Name of the environment variable that lowers the detected level, e.g. `LOOBEE_CPU_FEATURE_LEVEL=baseline`.
+    public static let environmentVariable = "LOOBEE_CPU_FEATURE_LEVEL"
+
+    /// Returns the highest level supported by the processor and the OS.
+    public init(cpuId: CpuId) {
+        let isSse42 = cpuId.hasSse3() && cpuId.hasSsse3() && cpuId.hasSse41() && cpuId.hasSse42()
+            && cpuId.hasPopcnt() && cpuId.hasCx16()
+        guard isSse42 else {
+            self = .baseline
+            return
+        }
+
+        let isAvx2 = cpuId.hasAvx() && cpuId.hasAvx2() && cpuId.hasBmi1() && cpuId.hasBmi2()
+            && cpuId.hasFma() && cpuId.hasLzcnt() && cpuId.hasMovbe() && cpuId.hasF16c()
+            && cpuId.hasOsxsave() && cpuId.hasOsAvxState()
+        guard isAvx2 else {
+            self = .sse42
+            return
+        }
+
+        let isAvx512 = cpuId.hasAvx512f() && cpuId.hasAvx512bw() && cpuId.hasAvx512cd()
+            && cpuId.hasAvx512dq() && cpuId.hasAvx512vl() && cpuId.hasOsAvx512State()
+
+        self = isAvx512 ? .avx512 : .avx2
+    }
+
+    /// Creates the level from its name, e.g. `avx2`.
+    public init?(name: String) {
+        guard let level = CpuFeatureLevel.allCases.first(where: { $0.name == name }) else {
+            return nil
+        }
+
+        self = level
+    }
+
+    ///
+    public var name: String {
+        switch self {
+        case .baseline:
+            return "baseline"
+        case .sse42:
+            return "sse42"
+        case .avx2:
+            return "avx2"
+        case .avx512:
+            return "avx512"
+        }
+    }
+}
+
+extension CpuFeatureLevel: Comparable {
+    public static func < (lhs: CpuFeatureLevel, rhs: CpuFeatureLevel) -> Bool {
+        return lhs.rawValue < rhs.rawValue
+    }
+}
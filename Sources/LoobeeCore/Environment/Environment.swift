@@ -5,14 +5,37 @@
 // For the full copyright and license information, please view the LICENSE
 // file that was distributed with this source code.
 
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
 /// Provides information about the current environment.
 public class Environment {
     ///
     public static let current = Environment()
 
     private init() {
+        let cpuId = CpuId.current()
+        var cpuFeatureLevel = CpuFeatureLevel(cpuId: cpuId)
+
+        if let name = getenv(CpuFeatureLevel.environmentVariable) {
+            guard let level = CpuFeatureLevel(name: String(cString: name)) else {
+                fatalError("Environment: Unknown value of \(CpuFeatureLevel.environmentVariable).")
+            }
+
+            cpuFeatureLevel = min(cpuFeatureLevel, level)
+        }
+
+        self.cpuId = cpuId
+        self.cpuFeatureLevel = cpuFeatureLevel
     }
 
     /// Returns discover details of the processor.
-    public let cpuId = CpuId.current()
+    public let cpuId: CpuId
+
+    /// Instruction set level used to select kernels. The level detected from `cpuId`
+    /// can be lowered by the `LOOBEE_CPU_FEATURE_LEVEL` environment variable.
+    public let cpuFeatureLevel: CpuFeatureLevel
 }
@@ -0,0 +1,391 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(Linux)
+
+import CLoobeeCore
+import Glibc
+
+/// Source of events registered in an `EventLoop`.
+internal protocol EventLoopSource: class {
+    /// Called on the loop thread with the flags of `CLoobeeCoreEventPollEvent`.
+    func handle(events: UInt32)
+
+    /// Closes the source immediately, called on the loop thread when the loop is shut down.
+    func terminate()
+}
+
+/// Value of `ThreadSpecific`, refers to the loop of the thread.
+internal final class EventLoopThreadContext: ThreadSpecificValue {
+    internal unowned(unsafe) let loop: EventLoop
+
+    internal init(loop: EventLoop) {
+        self.loop = loop
+    }
+}
+
+/// Event loop of one thread over edge-triggered `epoll`.
+///
+/// An iteration waits for events, dispatches them to sockets, runs the added functions, expires
+/// the timers and then flushes the writes queued during the iteration: all buffers written
+/// to a connection in one iteration are sent by one `sendmsg` call. Functions added from other
+/// threads are passed through a locked queue and an `eventfd` that wakes the loop, functions
+/// added from the loop thread are queued without synchronization.
+///
+/// The loop is an `Executor`, so it can run callbacks of connections, or the callbacks can be
+/// passed to another executor to keep CPU-heavy work away from the I/O thread.
+///
+///     let loop = EventLoop(processor: 0)
+///     loop.add {
+///         loop.schedule(after: 100_000_000) {
+///             print("100 ms later")
+///         }
+///     }
+///     loop.shutdown()
+///
+/// - Note: The loop must be shut down before it is released.
+public final class EventLoop: Executor {
+    /// Number of reads of a connection per iteration, after it the other connections are served first.
+    internal static let readLimit = 16
+
+    /// `epoll` data of the wakeup descriptor, the data of sockets is the generation and the descriptor.
+    private static let wakeupData = UInt64.max
+
+    private static let currentContext = ThreadSpecific<EventLoopThreadContext>()
+
+    /// The processor to which the thread of the loop is bound, nil if it is not bound.
+    public let processor: Int?
+
+    /// Pool of buffers for reads and writes.
+    public let bufferPool: IOBufferPool
+
+    /// Reusable space for the buffers of one `sendmsg`.
+    internal let vector: UnsafeMutablePointer<iovec>
+
+    private let poll: Int32
+    private let wakeup: Int32
+
+    /// Sources by descriptors.
+    private var sources: [EventLoopSource?] = []
+
+    /// Generations of descriptors, events of closed sources whose descriptors are reused are ignored.
+    private var generations: [UInt32] = []
+
+    private let injectionMutex = Mutex()
+    private var injectedTasks: [() -> Void] = []
+    private var tasks: [() -> Void] = []
+    private var runningTasks: [() -> Void] = []
+
+    private let timers: TimerWheel
+
+    /// Connections that reached `readLimit`.
+    private var pendingReads: [TcpConnection] = []
+    private var readingConnections: [TcpConnection] = []
+
+    /// Connections with writes of this iteration.
+    private var pendingFlushes: [TcpConnection] = []
+    private var flushingConnections: [TcpConnection] = []
+
+    /// Buffer for the next read, keeps a buffer when a read returns no data.
+    private var spareBuffer: IOBuffer?
+
+    private var isRunning = true
+    private var context: EventLoopThreadContext?
+    private var thread: NativeThread?
+
+    /// Creates the loop and starts its thread.
+    ///
+    /// - Parameter processor:  The processor to which the thread is bound.
+    /// - Parameter bufferPool: Pool of buffers for reads and writes, can be shared by loops.
+    public init(processor: Int? = nil, bufferPool: IOBufferPool = IOBufferPool()) {
+        let poll = CLoobeeCoreEventPoll_create()
+        if _slowPath(poll < 0) {
+            fatalError("EventLoop: Cannot create epoll. Code: \(-poll)")
+        }
+
+        let wakeup = CLoobeeCoreEventPoll_createWakeup()
+        if _slowPath(wakeup < 0) {
+            fatalError("EventLoop: Cannot create eventfd. Code: \(-wakeup)")
+        }
+
+        let resultCode = CLoobeeCoreEventPoll_add(poll, wakeup, C_LOOBEE_CORE_EVENT_POLL_READABLE, EventLoop.wakeupData)
+        if _slowPath(resultCode < 0) {
+            fatalError("EventLoop: Cannot register eventfd. Code: \(-resultCode)")
+        }
+
+        self.processor = processor
+        self.bufferPool = bufferPool
+        self.vector = UnsafeMutablePointer<iovec>.allocate(capacity: Int(C_LOOBEE_CORE_SOCKET_MAX_VECTOR_COUNT))
+        self.poll = poll
+        self.wakeup = wakeup
+        self.timers = TimerWheel(now: EventLoop.now())
+
+        self.context = EventLoopThreadContext(loop: self)
+        self.thread = NativeThread { [unowned(unsafe) self] in
+            self.run()
+        }
+    }
+
+    deinit {
+        self.shutdown()
+        self.spareBuffer?.release()
+        self.vector.deallocate()
+        close(self.wakeup)
+        close(self.poll)
+    }
+
+    /// The loop of the current thread.
+    public static var current: EventLoop? {
+        return EventLoop.currentContext.value?.loop
+    }
+
+    /// Whether the current thread is the thread of the loop.
+    public var isInLoop: Bool {
+        return EventLoop.currentContext.unmanagedValue?.takeUnretainedValue().loop === self
+    }
+
+    /// Adds the function to be run on the loop thread. The loop has one priority.
+    public func add(_ function: @escaping () -> Void, withPriority priority: ExecutorPriority) {
+        if self.isInLoop {
+            self.tasks.append(function)
+            return
+        }
+
+        let isFirst = self.injectionMutex.synchronized { () -> Bool in
+            self.injectedTasks.append(function)
+            return self.injectedTasks.count == 1
+        }
+
+        // The loop takes the queue after it drains the eventfd, so only the first function wakes it.
+        if isFirst {
+            _ = CLoobeeCoreEventPoll_wakeup(self.wakeup)
+        }
+    }
+
+    /// Schedules the callback to be called on the loop thread after `delay` nanoseconds,
+    /// with the precision of 1 ms.
+    ///
+    /// - Precondition: Must be called on the loop thread.
+    @discardableResult
+    public func schedule(after delay: UInt64, _ callback: @escaping () -> Void) -> TimerWheel.Handle {
+        assert(self.isInLoop, "EventLoop: Timers must be scheduled on the loop thread.")
+
+        return self.timers.schedule(at: EventLoop.now() + delay, callback)
+    }
+
+    /// Cancels the timer.
+    ///
+    /// - Precondition: Must be called on the loop thread.
+    /// - Returns: `false` if the timer has already expired or is cancelled.
+    @discardableResult
+    public func cancel(_ timer: TimerWheel.Handle) -> Bool {
+        assert(self.isInLoop, "EventLoop: Timers must be cancelled on the loop thread.")
+
+        return self.timers.cancel(timer)
+    }
+
+    /// Closes all sockets of the loop and stops its thread. Blocks until the thread exits.
+    /// Functions added after it are not run.
+    ///
+    /// - Precondition: Must not be called from the loop thread.
+    public func shutdown() {
+        assert(!self.isInLoop, "EventLoop: Loop must not be shut down from its own thread.")
+
+        guard let thread = self.thread else {
+            return
+        }
+
+        self.add { [unowned(unsafe) self] in
+            self.isRunning = false
+        }
+        thread.join()
+        self.thread = nil
+    }
+
+    /// Registers the source for the events.
+    ///
+    /// - Returns: nil on success.
+    internal func register(_ source: EventLoopSource, descriptor: Int32, events: UInt32) -> SocketError? {
+        let index = Int(descriptor)
+        if index >= self.sources.count {
+            let count = max(index + 1, self.sources.count * 2)
+            self.sources.append(contentsOf: repeatElement(nil, count: count - self.sources.count))
+            self.generations.append(contentsOf: repeatElement(0, count: count - self.generations.count))
+        }
+
+        let data = UInt64(self.generations[index]) << 32 | UInt64(UInt32(bitPattern: descriptor))
+        let resultCode = CLoobeeCoreEventPoll_add(self.poll, descriptor, events, data)
+        if resultCode < 0 {
+            return SocketError(code: -resultCode)
+        }
+
+        self.sources[index] = source
+
+        return nil
+    }
+
+    /// Removes the source of the descriptor, must be called before the descriptor is closed.
+    internal func deregister(descriptor: Int32) {
+        let index = Int(descriptor)
+        _ = CLoobeeCoreEventPoll_remove(self.poll, descriptor)
+        self.sources[index] = nil
+        self.generations[index] &+= 1
+    }
+
+    /// Reading of the connection is continued in the next iteration.
+    internal func scheduleRead(_ connection: TcpConnection) {
+        self.pendingReads.append(connection)
+    }
+
+    /// Queued writes of the connection are sent at the end of the iteration.
+    internal func scheduleFlush(_ connection: TcpConnection) {
+        self.pendingFlushes.append(connection)
+    }
+
+    /// Returns a buffer for a read.
+    @inline(__always)
+    internal func takeBuffer() -> IOBuffer {
+        if let buffer = self.spareBuffer {
+            self.spareBuffer = nil
+            return buffer
+        }
+
+        return self.bufferPool.allocate()
+    }
+
+    /// Keeps the buffer of a read that returned no data for the next read.
+    @inline(__always)
+    internal func returnBuffer(_ buffer: IOBuffer) {
+        if self.spareBuffer == nil {
+            self.spareBuffer = buffer
+        } else {
+            buffer.release()
+        }
+    }
+
+    /// Nanoseconds of the monotonic clock.
+    internal static func now() -> UInt64 {
+        var time = timespec()
+        clock_gettime(CLOCK_MONOTONIC, &time)
+
+        return UInt64(time.tv_sec) &* 1_000_000_000 &+ UInt64(time.tv_nsec)
+    }
+
+    private func run() {
+        EventLoop.currentContext.value = self.context
+        defer {
+            EventLoop.currentContext.value = nil
+        }
+
+        // Binding fails if the processor is not allowed for the process, then the loop is not bound.
+        if let processor = self.processor {
+            _ = CLoobeeCoreEventPoll_pinThread(toProcessor: Int32(processor))
+        }
+
+        let batchSize = C_LOOBEE_CORE_EVENT_POLL_BATCH_SIZE
+        let events = UnsafeMutablePointer<CLoobeeCoreEventPollEvent>.allocate(capacity: Int(batchSize))
+        defer {
+            events.deallocate()
+        }
+
+        while self.isRunning {
+            let count = CLoobeeCoreEventPoll_wait(self.poll, events, batchSize, self.pollTimeout())
+            if _slowPath(count < 0) {
+                fatalError("EventLoop: Cannot wait for events. Code: \(-count)")
+            }
+
+            for index in 0..<Int(count) {
+                self.dispatch(events[index])
+            }
+
+            self.continueReads()
+            self.runTasks()
+            self.timers.advance(to: EventLoop.now())
+            self.flush()
+        }
+
+        for source in self.sources {
+            source?.terminate()
+        }
+    }
+
+    /// Milliseconds to wait for events: 0 if there is work, -1 if there are no timers.
+    private func pollTimeout() -> Int32 {
+        if !self.tasks.isEmpty || !self.pendingReads.isEmpty || !self.pendingFlushes.isEmpty {
+            return 0
+        }
+
+        guard let expiration = self.timers.nextExpiration else {
+            return -1
+        }
+
+        let now = EventLoop.now()
+        if expiration <= now {
+            return 0
+        }
+
+        return Int32(min((expiration - now + 999_999) / 1_000_000, UInt64(Int32.max)))
+    }
+
+    @inline(__always)
+    private func dispatch(_ event: CLoobeeCoreEventPollEvent) {
+        if event.data == EventLoop.wakeupData {
+            _ = CLoobeeCoreEventPoll_drainWakeup(self.wakeup)
+            self.injectionMutex.synchronized {
+                self.tasks.append(contentsOf: self.injectedTasks)
+                self.injectedTasks.removeAll(keepingCapacity: true)
+            }
+
+            return
+        }
+
+        let index = Int(truncatingIfNeeded: event.data & 0xFFFF_FFFF)
+        let generation = UInt32(truncatingIfNeeded: event.data >> 32)
+        if self.generations[index] == generation, let source = self.sources[index] {
+            source.handle(events: event.events)
+        }
+    }
+
+    private func continueReads() {
+        if self.pendingReads.isEmpty {
+            return
+        }
+
+        swap(&self.pendingReads, &self.readingConnections)
+        for connection in self.readingConnections {
+            connection.continueReading()
+        }
+        self.readingConnections.removeAll(keepingCapacity: true)
+    }
+
+    /// Runs the functions added before the call, functions added by them are run in the next iteration.
+    private func runTasks() {
+        if self.tasks.isEmpty {
+            return
+        }
+
+        swap(&self.tasks, &self.runningTasks)
+        for task in self.runningTasks {
+            task()
+        }
+        self.runningTasks.removeAll(keepingCapacity: true)
+    }
+
+    private func flush() {
+        if self.pendingFlushes.isEmpty {
+            return
+        }
+
+        swap(&self.pendingFlushes, &self.flushingConnections)
+        for connection in self.flushingConnections {
+            connection.flushQueuedWrites()
+        }
+        self.flushingConnections.removeAll(keepingCapacity: true)
+    }
+}
+
+#endif
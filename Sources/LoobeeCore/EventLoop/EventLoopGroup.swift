@@ -0,0 +1,66 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(Linux)
+
+/// Event loops of several threads, by default one loop per processor with the thread bound to it.
+///
+///     let group = EventLoopGroup()
+///     let server = TcpServer(group: group) {
+///         HttpHandler()
+///     }
+///     server.start(port: 8080)
+///     // ...
+///     server.stop()
+///     group.shutdown()
+public final class EventLoopGroup {
+    public let loops: [EventLoop]
+
+    /// The buffers of all loops.
+    public let bufferPool: IOBufferPool
+
+    private var nextIndex = 0
+
+    /// Creates the loops and starts their threads.
+    ///
+    /// - Parameter loopCount:  Number of loops.
+    /// - Parameter isPinned:   Bind the thread of loop `n` to processor `n % processorCount`.
+    /// - Parameter bufferSize: Capacity of the buffers of reads and writes.
+    public init(loopCount: Count = NativeThread.processorCount, isPinned: Bool = true, bufferSize: Int = 16 * 1024) {
+        assert(loopCount > 0, "EventLoopGroup: Loop count must be greater than 0.")
+
+        let processorCount = NativeThread.processorCount
+        let bufferPool = IOBufferPool(bufferSize: bufferSize)
+
+        self.bufferPool = bufferPool
+        self.loops = (0..<loopCount).map { index in
+            EventLoop(processor: isPinned ? index % processorCount : nil, bufferPool: bufferPool)
+        }
+    }
+
+    deinit {
+        self.shutdown()
+    }
+
+    /// Returns the loops in turn, for connections that are not accepted by a `TcpServer`.
+    public func next() -> EventLoop {
+        let index = UInt(bitPattern: self.nextIndex.atomicFetchAndAdd(1, withOrder: .relaxed))
+
+        return self.loops[Int(index % UInt(self.loops.count))]
+    }
+
+    /// Shuts down all loops.
+    ///
+    /// - Precondition: Must not be called from a loop of the group.
+    public func shutdown() {
+        for loop in self.loops {
+            loop.shutdown()
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,114 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Fixed-size buffer of an `IOBufferPool`, the unit of reads and writes of sockets.
+///
+/// The buffer is not reference counted: it has one owner, that passes it on or returns it
+/// to the pool by `release()`.
+@_fixed_layout
+public struct IOBuffer {
+    /// Start of the memory of the buffer.
+    public let base: UnsafeMutableRawPointer
+
+    /// Number of bytes of the memory.
+    public let capacity: Int
+
+    /// Number of bytes with data, from the start of the buffer.
+    public var count: Int
+
+    @usableFromInline internal unowned(unsafe) let pool: IOBufferPool
+
+    @inlinable
+    internal init(base: UnsafeMutableRawPointer, capacity: Int, pool: IOBufferPool) {
+        self.base = base
+        self.capacity = capacity
+        self.count = 0
+        self.pool = pool
+    }
+
+    /// The data of the buffer.
+    @inlinable
+    public var bytes: UnsafeRawBufferPointer {
+        return UnsafeRawBufferPointer(start: self.base, count: self.count)
+    }
+
+    /// Returns the buffer to its pool. Can be called from any thread.
+    @inlinable
+    public func release() {
+        self.pool.allocator.deallocate(self.base.assumingMemoryBound(to: UInt8.self))
+    }
+}
+
+/// Pool of `IOBuffer`s, based on `PoolAllocator`.
+///
+/// Buffers are allocated and released by the threads of event loops without locks, a buffer
+/// released by another thread (e.g. by a worker of an executor) returns to the owning slab
+/// with a single CAS.
+///
+///     let pool = IOBufferPool(bufferSize: 16 * 1024)
+///     var buffer = pool.allocate()
+///     buffer.count = read(fd, buffer.base, buffer.capacity)
+///     buffer.release()
+///
+/// - Note: The pool must outlive its buffers.
+public final class IOBufferPool {
+    /// Capacity of the buffers.
+    public let bufferSize: Int
+
+    @usableFromInline internal let allocator: PoolAllocator<UInt8>
+
+    /// - Parameter bufferSize: Capacity of the buffers.
+    public init(bufferSize: Int = 16 * 1024) {
+        assert(bufferSize > 0, "IOBufferPool: Buffer size must be greater than 0.")
+
+        // At least 8 buffers per slab.
+        var slabSize = 64 * 1024
+        while slabSize - PoolSlab.headerSize < bufferSize * 8 {
+            slabSize <<= 1
+        }
+
+        self.bufferSize = bufferSize
+        self.allocator = PoolAllocator<UInt8>(slotCapacity: bufferSize, slabSize: slabSize)
+    }
+
+    /// Returns an empty buffer.
+    @inlinable
+    public func allocate() -> IOBuffer {
+        return IOBuffer(
+            base: UnsafeMutableRawPointer(self.allocator.allocate(count: self.bufferSize)),
+            capacity: self.bufferSize,
+            pool: self
+        )
+    }
+
+    /// Copies the bytes into new buffers, `bufferSize` bytes per buffer.
+    public func copy(_ bytes: UnsafeRawBufferPointer) -> [IOBuffer] {
+        guard let base = bytes.baseAddress else {
+            return []
+        }
+
+        var buffers: [IOBuffer] = []
+        buffers.reserveCapacity((bytes.count + self.bufferSize - 1) / self.bufferSize)
+
+        var offset = 0
+        while offset < bytes.count {
+            var buffer = self.allocate()
+            buffer.count = min(self.bufferSize, bytes.count - offset)
+            memcpy(buffer.base, base + offset, buffer.count)
+            buffers.append(buffer)
+            offset += buffer.count
+        }
+
+        return buffers
+    }
+}
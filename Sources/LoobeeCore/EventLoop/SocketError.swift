@@ -0,0 +1,26 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Error of a system call on a socket.
+public struct SocketError: Equatable, CustomStringConvertible {
+    /// The `errno` code.
+    public let code: Int32
+
+    public init(code: Int32) {
+        self.code = code
+    }
+
+    public var description: String {
+        return "SocketError: \(String(cString: strerror(self.code))) (\(self.code))"
+    }
+}
@@ -0,0 +1,415 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(Linux)
+
+import CLoobeeCore
+import Glibc
+
+/// Callbacks of a `TcpConnection`, are called by the executor of the connection one after another.
+public protocol TcpConnectionHandler: class {
+    /// The connection is accepted or established.
+    func connectionDidOpen(_ connection: TcpConnection)
+
+    /// Data is received. The handler owns the buffer and must release it.
+    func connection(_ connection: TcpConnection, didRead buffer: IOBuffer)
+
+    /// The connection is closed by any side, `error` is nil if it is closed normally.
+    /// No callbacks follow.
+    func connectionDidClose(_ connection: TcpConnection, error: SocketError?)
+}
+
+extension TcpConnectionHandler {
+    public func connectionDidOpen(_ connection: TcpConnection) {
+    }
+}
+
+/// Non-blocking TCP connection of an `EventLoop`.
+///
+/// Reads go to buffers of the pool of the loop and are passed to the handler without copying.
+/// Writes can be made from any thread: buffers are queued and sent at the end of the loop iteration,
+/// all buffers queued in one iteration are sent by one `sendmsg` call.
+///
+/// Callbacks are passed to the executor of the connection. If it is the loop, they are called
+/// directly; otherwise they are queued in the connection and run by one function of the executor
+/// at a time, so they are never concurrent and keep the order of the events.
+///
+///     final class Echo: TcpConnectionHandler {
+///         func connection(_ connection: TcpConnection, didRead buffer: IOBuffer) {
+///             connection.write(buffer)
+///         }
+///
+///         func connectionDidClose(_ connection: TcpConnection, error: SocketError?) {
+///         }
+///     }
+///
+///     let connection = TcpConnection.connect(to: "127.0.0.1", port: 8080, on: loop, handler: Echo())
+///
+/// - Note: When the peer shuts down its writing half, the connection is closed.
+public final class TcpConnection: EventLoopSource {
+    private enum Event {
+        case open
+        case read(IOBuffer)
+        case close(SocketError?)
+    }
+
+    /// The loop of the socket.
+    public let loop: EventLoop
+
+    /// The executor of the callbacks.
+    public let executor: Executor
+
+    private let isLoopExecutor: Bool
+    private var handler: TcpConnectionHandler?
+
+    /// The socket, or a negative `errno` if it is not created.
+    private let descriptor: Int32
+
+    // The state is changed only on the loop thread.
+    private var isRegistered = false
+    private var isConnected: Bool
+    private var isClosing = false
+    private var isClosed = false
+    private var isReadScheduled = false
+    private var isFlushScheduled = false
+
+    private var writeQueue: [IOBuffer] = []
+
+    /// Number of sent bytes of the first buffer of `writeQueue`.
+    private var writeOffset = 0
+
+    /// Events for an executor other than the loop.
+    private let inboxMutex = Mutex()
+    private var inbox: [Event] = []
+    private var isInboxScheduled = false
+
+    internal init(
+        loop: EventLoop,
+        descriptor: Int32,
+        isConnected: Bool,
+        executor: Executor?,
+        handler: TcpConnectionHandler
+    ) {
+        let executor = executor ?? loop
+
+        self.loop = loop
+        self.descriptor = descriptor
+        self.isConnected = isConnected
+        self.executor = executor
+        self.isLoopExecutor = executor === loop
+        self.handler = handler
+    }
+
+    /// Starts a connection to `host:port`, the handler is notified when it is established or failed.
+    ///
+    /// - Parameter host:     IPv4 address.
+    /// - Parameter port:     Port.
+    /// - Parameter loop:     The loop of the socket.
+    /// - Parameter executor: The executor of the callbacks, the loop by default.
+    /// - Parameter handler:  Callbacks of the connection.
+    @discardableResult
+    public static func connect(
+        to host: String,
+        port: Int,
+        on loop: EventLoop,
+        executor: Executor? = nil,
+        handler: TcpConnectionHandler
+    ) -> TcpConnection {
+        let connection = TcpConnection(
+            loop: loop,
+            descriptor: CLoobeeCoreSocket_connect(host, UInt16(truncatingIfNeeded: port)),
+            isConnected: false,
+            executor: executor,
+            handler: handler
+        )
+
+        if loop.isInLoop {
+            connection.open()
+        } else {
+            loop.add(connection.open)
+        }
+
+        return connection
+    }
+
+    /// Queues the buffer to be sent, the connection becomes the owner of the buffer.
+    /// Can be called from any thread.
+    public func write(_ buffer: IOBuffer) {
+        if self.loop.isInLoop {
+            self.enqueue(buffer)
+        } else {
+            self.loop.add {
+                self.enqueue(buffer)
+            }
+        }
+    }
+
+    /// Copies the bytes to buffers of the pool and queues them to be sent. Can be called from any thread.
+    public func write(_ bytes: UnsafeRawBufferPointer) {
+        let buffers = self.loop.bufferPool.copy(bytes)
+        if self.loop.isInLoop {
+            buffers.forEach(self.enqueue)
+        } else {
+            self.loop.add {
+                buffers.forEach(self.enqueue)
+            }
+        }
+    }
+
+    /// Closes the connection after the queued writes are sent. Can be called from any thread.
+    public func close() {
+        if self.loop.isInLoop {
+            self.closeAfterWrites()
+        } else {
+            self.loop.add(self.closeAfterWrites)
+        }
+    }
+
+    /// Registers the socket in the loop.
+    internal func open() {
+        if self.descriptor < 0 {
+            self.close(with: SocketError(code: -self.descriptor))
+            return
+        }
+
+        let events = C_LOOBEE_CORE_EVENT_POLL_READABLE
+            | C_LOOBEE_CORE_EVENT_POLL_WRITABLE
+            | C_LOOBEE_CORE_EVENT_POLL_READ_HANG_UP
+        if let error = self.loop.register(self, descriptor: self.descriptor, events: events) {
+            self.close(with: error)
+            return
+        }
+
+        self.isRegistered = true
+        if self.isConnected {
+            self.deliver(.open)
+        }
+    }
+
+    internal func handle(events: UInt32) {
+        if events & C_LOOBEE_CORE_EVENT_POLL_ERROR != 0 || !self.isConnected {
+            let resultCode = CLoobeeCoreSocket_pendingError(self.descriptor)
+            if resultCode < 0 {
+                self.close(with: SocketError(code: -resultCode))
+                return
+            }
+        }
+
+        if !self.isConnected {
+            self.isConnected = true
+            self.deliver(.open)
+        }
+
+        if events & C_LOOBEE_CORE_EVENT_POLL_WRITABLE != 0 {
+            self.flush()
+        }
+
+        let hangUpEvents = C_LOOBEE_CORE_EVENT_POLL_HANG_UP | C_LOOBEE_CORE_EVENT_POLL_READ_HANG_UP
+        if events & (C_LOOBEE_CORE_EVENT_POLL_READABLE | hangUpEvents) != 0 {
+            self.read(isHangUp: events & hangUpEvents != 0)
+        }
+    }
+
+    internal func terminate() {
+        self.close(with: nil)
+    }
+
+    /// Continues reading after `EventLoop.readLimit` reads.
+    internal func continueReading() {
+        self.isReadScheduled = false
+        self.read(isHangUp: true)
+    }
+
+    /// Sends the writes queued in this iteration.
+    internal func flushQueuedWrites() {
+        self.isFlushScheduled = false
+        self.flush()
+    }
+
+    /// Reads until the socket is drained, since the edge-triggered loop does not report it again.
+    /// A short read means that the socket is drained, unless the peer is closed and the end is pending.
+    private func read(isHangUp: Bool) {
+        var readCount = 0
+        while !self.isClosed {
+            if readCount == EventLoop.readLimit {
+                if !self.isReadScheduled {
+                    self.isReadScheduled = true
+                    self.loop.scheduleRead(self)
+                }
+                return
+            }
+
+            var buffer = self.loop.takeBuffer()
+            let result = CLoobeeCoreSocket_read(self.descriptor, buffer.base, buffer.capacity)
+            if result > 0 {
+                buffer.count = result
+                readCount += 1
+                self.deliver(.read(buffer))
+
+                if result < buffer.capacity && !isHangUp {
+                    return
+                }
+                continue
+            }
+
+            self.loop.returnBuffer(buffer)
+            if result == 0 {
+                self.close(with: nil)
+            } else if result != -Int(EAGAIN) {
+                self.close(with: SocketError(code: Int32(-result)))
+            }
+            return
+        }
+    }
+
+    private func enqueue(_ buffer: IOBuffer) {
+        if self.isClosed || self.isClosing || buffer.count == 0 {
+            buffer.release()
+            return
+        }
+
+        self.writeQueue.append(buffer)
+        if !self.isFlushScheduled {
+            self.isFlushScheduled = true
+            self.loop.scheduleFlush(self)
+        }
+    }
+
+    /// Sends the queued buffers until the socket is full.
+    private func flush() {
+        guard self.isConnected && !self.isClosed else {
+            return
+        }
+
+        let maxCount = Int(C_LOOBEE_CORE_SOCKET_MAX_VECTOR_COUNT)
+        while !self.writeQueue.isEmpty {
+            let count = min(self.writeQueue.count, maxCount)
+            for index in 0..<count {
+                let buffer = self.writeQueue[index]
+                let offset = index == 0 ? self.writeOffset : 0
+                self.loop.vector[index] = iovec(iov_base: buffer.base + offset, iov_len: buffer.count - offset)
+            }
+
+            let result = CLoobeeCoreSocket_writeVector(self.descriptor, self.loop.vector, Int32(count))
+            if result == -Int(EAGAIN) {
+                // The loop reports when the socket becomes writable.
+                return
+            }
+            if result < 0 {
+                self.close(with: SocketError(code: Int32(-result)))
+                return
+            }
+
+            self.consume(result)
+        }
+
+        if self.isClosing {
+            self.close(with: nil)
+        }
+    }
+
+    /// Releases the sent buffers.
+    private func consume(_ sentCount: Int) {
+        var remaining = self.writeOffset + sentCount
+        var completedCount = 0
+        while completedCount < self.writeQueue.count && remaining >= self.writeQueue[completedCount].count {
+            remaining -= self.writeQueue[completedCount].count
+            self.writeQueue[completedCount].release()
+            completedCount += 1
+        }
+
+        self.writeQueue.removeFirst(completedCount)
+        self.writeOffset = remaining
+    }
+
+    private func closeAfterWrites() {
+        if self.writeQueue.isEmpty {
+            self.close(with: nil)
+        } else {
+            self.isClosing = true
+        }
+    }
+
+    private func close(with error: SocketError?) {
+        if self.isClosed {
+            return
+        }
+
+        self.isClosed = true
+        if self.isRegistered {
+            self.loop.deregister(descriptor: self.descriptor)
+        }
+        if self.descriptor >= 0 {
+            CLoobeeCoreSocket_close(self.descriptor)
+        }
+
+        for buffer in self.writeQueue {
+            buffer.release()
+        }
+        self.writeQueue.removeAll()
+        self.deliver(.close(error))
+    }
+
+    private func deliver(_ event: Event) {
+        if self.isLoopExecutor {
+            self.call(event)
+            return
+        }
+
+        let isFirst = self.inboxMutex.synchronized { () -> Bool in
+            self.inbox.append(event)
+            if self.isInboxScheduled {
+                return false
+            }
+
+            self.isInboxScheduled = true
+            return true
+        }
+
+        if isFirst {
+            self.executor.add(self.drainInbox)
+        }
+    }
+
+    /// Calls the handler for the queued events, on the executor.
+    private func drainInbox() {
+        var events: [Event] = []
+        while true {
+            self.inboxMutex.synchronized {
+                swap(&events, &self.inbox)
+                self.isInboxScheduled = !events.isEmpty
+            }
+
+            if events.isEmpty {
+                return
+            }
+
+            for event in events {
+                self.call(event)
+            }
+            events.removeAll(keepingCapacity: true)
+        }
+    }
+
+    private func call(_ event: Event) {
+        switch event {
+        case .open:
+            self.handler?.connectionDidOpen(self)
+        case .read(let buffer):
+            if let handler = self.handler {
+                handler.connection(self, didRead: buffer)
+            } else {
+                buffer.release()
+            }
+        case .close(let error):
+            self.handler?.connectionDidClose(self, error: error)
+            self.handler = nil
+        }
+    }
+}
+
+#endif
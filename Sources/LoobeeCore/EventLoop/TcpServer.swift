@@ -0,0 +1,158 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(Linux)
+
+import CLoobeeCore
+import Glibc
+
+/// Listening socket of one loop.
+internal final class TcpListener: EventLoopSource {
+    internal let loop: EventLoop
+
+    private let descriptor: Int32
+    private let executor: Executor?
+    private let makeHandler: () -> TcpConnectionHandler
+    private var isClosed = false
+
+    internal init(
+        loop: EventLoop,
+        descriptor: Int32,
+        executor: Executor?,
+        makeHandler: @escaping () -> TcpConnectionHandler
+    ) {
+        self.loop = loop
+        self.descriptor = descriptor
+        self.executor = executor
+        self.makeHandler = makeHandler
+    }
+
+    internal func open() {
+        let events = C_LOOBEE_CORE_EVENT_POLL_READABLE
+        if let error = self.loop.register(self, descriptor: self.descriptor, events: events) {
+            fatalError("TcpListener: Cannot register socket. Code: \(error.code)")
+        }
+    }
+
+    /// Accepts all pending connections.
+    ///
+    /// If the limit of descriptors is reached, the rest of connections waits until the next one arrives.
+    internal func handle(events: UInt32) {
+        while !self.isClosed {
+            let descriptor = CLoobeeCoreSocket_accept(self.descriptor)
+            if descriptor < 0 {
+                if descriptor == -ECONNABORTED {
+                    continue
+                }
+                return
+            }
+
+            let connection = TcpConnection(
+                loop: self.loop,
+                descriptor: descriptor,
+                isConnected: true,
+                executor: self.executor,
+                handler: self.makeHandler()
+            )
+            connection.open()
+        }
+    }
+
+    internal func terminate() {
+        if self.isClosed {
+            return
+        }
+
+        self.isClosed = true
+        self.loop.deregister(descriptor: self.descriptor)
+        CLoobeeCoreSocket_close(self.descriptor)
+    }
+}
+
+/// TCP server over an `EventLoopGroup`.
+///
+/// Each loop has its own listening socket bound with `SO_REUSEPORT`, so the kernel distributes
+/// new connections between the loops and accepts never contend. A connection stays in the loop
+/// that accepted it.
+///
+///     let server = TcpServer(group: group, executor: workers) {
+///         HttpHandler()
+///     }
+///     if let error = server.start(port: 8080) {
+///         print(error)
+///     }
+public final class TcpServer {
+    public let group: EventLoopGroup
+
+    /// The executor of the callbacks of connections, nil for the loops of the connections.
+    public let executor: Executor?
+
+    /// The bound port, is known after `start`.
+    public private(set) var port = 0
+
+    private let makeHandler: () -> TcpConnectionHandler
+    private var listeners: [TcpListener] = []
+
+    /// - Parameter group:       The loops of the server.
+    /// - Parameter executor:    The executor of the callbacks of connections, nil for the loops of the connections.
+    /// - Parameter makeHandler: Creates the handler of an accepted connection, is called on its loop.
+    public init(group: EventLoopGroup, executor: Executor? = nil, makeHandler: @escaping () -> TcpConnectionHandler) {
+        self.group = group
+        self.executor = executor
+        self.makeHandler = makeHandler
+    }
+
+    /// Starts listening on each loop of the group.
+    ///
+    /// - Parameter host:    IPv4 address.
+    /// - Parameter port:    Port, 0 to bind any free port.
+    /// - Parameter backlog: Length of the queue of pending connections of each loop.
+    ///
+    /// - Returns: nil on success.
+    @discardableResult
+    public func start(host: String = "127.0.0.1", port: Int, backlog: Int = 1024) -> SocketError? {
+        assert(self.listeners.isEmpty, "TcpServer: Server is already started.")
+
+        var boundPort = port
+        var descriptors: [Int32] = []
+        for _ in self.group.loops {
+            let descriptor = CLoobeeCoreSocket_listen(host, UInt16(truncatingIfNeeded: boundPort), Int32(backlog), true)
+            if descriptor < 0 {
+                for descriptor in descriptors {
+                    CLoobeeCoreSocket_close(descriptor)
+                }
+                return SocketError(code: -descriptor)
+            }
+
+            if boundPort == 0 {
+                boundPort = Int(CLoobeeCoreSocket_localPort(descriptor))
+            }
+            descriptors.append(descriptor)
+        }
+
+        self.port = boundPort
+        self.listeners = zip(self.group.loops, descriptors).map { loop, descriptor in
+            TcpListener(loop: loop, descriptor: descriptor, executor: self.executor, makeHandler: self.makeHandler)
+        }
+
+        for listener in self.listeners {
+            listener.loop.add(listener.open)
+        }
+
+        return nil
+    }
+
+    /// Closes the listening sockets, accepted connections stay open.
+    public func stop() {
+        for listener in self.listeners {
+            listener.loop.add(listener.terminate)
+        }
+        self.listeners.removeAll()
+    }
+}
+
+#endif
@@ -0,0 +1,298 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Hierarchical timer wheel: 4 levels of 64 slots, a slot of level `n` covers `64^n` ticks.
+///
+/// A timer is placed into the level of the highest 6-bit group in which its expiration tick differs
+/// from the current tick. When the current tick crosses a slot of an upper level, the timers of that
+/// slot are moved to the lower levels, and the timers of the current slot of level 0 expire.
+/// Scheduling and cancellation are O(1), timers live in a reused array of nodes linked by indices,
+/// so a timer allocates only its callback. Timers beyond the range of the wheel (`64^4` ticks) wait
+/// in the next slot of level 3 and are placed again when it is reached.
+///
+///     let wheel = TimerWheel(tickDuration: 1_000_000, now: now)
+///     let timer = wheel.schedule(at: now + 5_000_000) {
+///         print("Timeout")
+///     }
+///     wheel.advance(to: later)
+///     wheel.cancel(timer)
+///
+/// Times are nanoseconds of any monotonic clock. A timer never expires before its deadline,
+/// and expires at most one tick after it.
+///
+/// - Note: The wheel is not thread-safe.
+public final class TimerWheel {
+    /// Scheduled timer.
+    public struct Handle: Equatable {
+        internal let index: Int32
+        internal let generation: UInt32
+    }
+
+    private struct Node {
+        var expiration: UInt64 = 0
+        var generation: UInt32 = 0
+        /// Index of the slot in `heads`, -1 if the node is free.
+        var slot: Int32 = -1
+        var previous: Int32 = -1
+        /// Next node of the slot or of the list of free nodes.
+        var next: Int32 = -1
+        var callback: (() -> Void)?
+    }
+
+    private static let levelCount = 4
+    private static let slotBits = 6
+    private static let slotMask = 63
+
+    /// Duration of a tick, in nanoseconds.
+    public let tickDuration: UInt64
+
+    /// Number of scheduled timers.
+    public private(set) var count = 0
+
+    /// The last processed tick.
+    private var currentTick: UInt64
+
+    private var nodes: [Node] = []
+    private var freeHead: Int32 = -1
+
+    /// First nodes of the slots, `levelCount * 64` lists.
+    private var heads: [Int32]
+
+    /// Bit `n` of element `level` is set if slot `n` of the level is not empty.
+    private var occupancy: [UInt64]
+
+    /// Callbacks of expired timers, are called after all ticks are processed.
+    private var expired: [() -> Void] = []
+
+    /// - Parameter tickDuration: Duration of a tick, in nanoseconds.
+    /// - Parameter now:          The current time, in nanoseconds.
+    public init(tickDuration: UInt64 = 1_000_000, now: UInt64) {
+        assert(tickDuration > 0, "TimerWheel: Tick duration must be greater than 0.")
+
+        self.tickDuration = tickDuration
+        self.currentTick = now / tickDuration
+        self.heads = Array(repeating: -1, count: TimerWheel.levelCount << TimerWheel.slotBits)
+        self.occupancy = Array(repeating: 0, count: TimerWheel.levelCount)
+    }
+
+    /// Time when `advance(to:)` must be called next, nil if there are no timers.
+    ///
+    /// The time is not later than the nearest deadline rounded up to a tick, but can be earlier
+    /// when timers of an upper level are moved to the lower ones.
+    public var nextExpiration: UInt64? {
+        if self.count == 0 {
+            return nil
+        }
+
+        return self.nextEventTick() * self.tickDuration
+    }
+
+    /// Schedules `callback` to be called by `advance(to:)` at or after `deadline`.
+    @discardableResult
+    public func schedule(at deadline: UInt64, _ callback: @escaping () -> Void) -> Handle {
+        let index = self.allocateNode()
+        let expiration = deadline / self.tickDuration + (deadline % self.tickDuration == 0 ? 0 : 1)
+
+        self.nodes[index].expiration = max(expiration, self.currentTick + 1)
+        self.nodes[index].callback = callback
+        self.link(index)
+        self.count += 1
+
+        return Handle(index: Int32(index), generation: self.nodes[index].generation)
+    }
+
+    /// Cancels the timer.
+    ///
+    /// - Returns: `false` if the timer has already expired or is cancelled.
+    @discardableResult
+    public func cancel(_ handle: Handle) -> Bool {
+        let index = Int(handle.index)
+        guard index < self.nodes.count,
+            self.nodes[index].generation == handle.generation,
+            self.nodes[index].slot >= 0 else {
+            return false
+        }
+
+        self.unlink(index)
+        self.freeNode(index)
+        self.count -= 1
+
+        return true
+    }
+
+    /// Processes the ticks up to `now` and calls the callbacks of the expired timers
+    /// in the order of expiration.
+    ///
+    /// - Returns: The number of expired timers.
+    @discardableResult
+    public func advance(to now: UInt64) -> Int {
+        let targetTick = now / self.tickDuration
+
+        while self.currentTick < targetTick {
+            if self.count == 0 {
+                self.currentTick = targetTick
+                break
+            }
+
+            // Ticks without timers of level 0 and without cascades are skipped.
+            let skippedTick = min(targetTick, self.nextEventTick()) - 1
+            if skippedTick > self.currentTick {
+                self.currentTick = skippedTick
+            }
+            self.currentTick += 1
+
+            var level = TimerWheel.levelCount - 1
+            while level > 0 {
+                let shift = TimerWheel.slotBits * level
+                if self.currentTick & ((1 << shift) - 1) == 0 {
+                    let slot = Int(truncatingIfNeeded: self.currentTick >> shift) & TimerWheel.slotMask
+                    self.cascade(level: level, slot: slot)
+                }
+                level -= 1
+            }
+
+            self.expire(slot: Int(truncatingIfNeeded: self.currentTick) & TimerWheel.slotMask)
+        }
+
+        let expiredCount = self.expired.count
+        if expiredCount > 0 {
+            for callback in self.expired {
+                callback()
+            }
+            self.expired.removeAll(keepingCapacity: true)
+        }
+
+        return expiredCount
+    }
+
+    /// The next tick at which timers expire or are cascaded.
+    ///
+    /// Slots of an upper level are reached after all slots of the lower levels, and occupied slots
+    /// of a level are always ahead of its current slot, except the slot of far timers.
+    private func nextEventTick() -> UInt64 {
+        for level in 0..<TimerWheel.levelCount {
+            let shift = TimerWheel.slotBits * level
+            let slot = Int(truncatingIfNeeded: self.currentTick >> shift) & TimerWheel.slotMask
+            if slot == TimerWheel.slotMask {
+                continue
+            }
+
+            let pending = self.occupancy[level] & (~0 << (slot + 1))
+            if pending != 0 {
+                let rotationShift = shift + TimerWheel.slotBits
+
+                return (self.currentTick >> rotationShift) << rotationShift
+                    | UInt64(pending.trailingZeroBitCount) << shift
+            }
+        }
+
+        let wheelShift = TimerWheel.slotBits * TimerWheel.levelCount
+
+        return ((self.currentTick >> wheelShift) + 1) << wheelShift
+    }
+
+    private func link(_ index: Int) {
+        let expiration = self.nodes[index].expiration
+        let difference = expiration ^ self.currentTick
+
+        var level = 0
+        var slot = Int(truncatingIfNeeded: expiration) & TimerWheel.slotMask
+        if difference != 0 {
+            level = (63 - difference.leadingZeroBitCount) / TimerWheel.slotBits
+            if level < TimerWheel.levelCount {
+                slot = Int(truncatingIfNeeded: expiration >> (TimerWheel.slotBits * level)) & TimerWheel.slotMask
+            } else {
+                // The next slot of the last level, the timer is placed again when it is reached.
+                level = TimerWheel.levelCount - 1
+                let shift = TimerWheel.slotBits * level
+                slot = (Int(truncatingIfNeeded: self.currentTick >> shift) &+ 1) & TimerWheel.slotMask
+            }
+        }
+
+        let slotIndex = level << TimerWheel.slotBits | slot
+        let head = self.heads[slotIndex]
+        self.nodes[index].slot = Int32(slotIndex)
+        self.nodes[index].previous = -1
+        self.nodes[index].next = head
+        if head >= 0 {
+            self.nodes[Int(head)].previous = Int32(index)
+        }
+        self.heads[slotIndex] = Int32(index)
+        self.occupancy[level] |= 1 << slot
+    }
+
+    private func unlink(_ index: Int) {
+        let slotIndex = Int(self.nodes[index].slot)
+        let previous = self.nodes[index].previous
+        let next = self.nodes[index].next
+
+        if previous >= 0 {
+            self.nodes[Int(previous)].next = next
+        } else {
+            self.heads[slotIndex] = next
+            if next < 0 {
+                self.occupancy[slotIndex >> TimerWheel.slotBits] &= ~(1 << (slotIndex & TimerWheel.slotMask))
+            }
+        }
+        if next >= 0 {
+            self.nodes[Int(next)].previous = previous
+        }
+    }
+
+    /// Detaches the list of the slot and returns its first node.
+    private func detach(level: Int, slot: Int) -> Int32 {
+        let slotIndex = level << TimerWheel.slotBits | slot
+        let head = self.heads[slotIndex]
+        self.heads[slotIndex] = -1
+        self.occupancy[level] &= ~(1 << slot)
+
+        return head
+    }
+
+    /// Moves the timers of the slot of an upper level to lower levels.
+    private func cascade(level: Int, slot: Int) {
+        var index = self.detach(level: level, slot: slot)
+        while index >= 0 {
+            let next = self.nodes[Int(index)].next
+            self.link(Int(index))
+            index = next
+        }
+    }
+
+    private func expire(slot: Int) {
+        var index = self.detach(level: 0, slot: slot)
+        while index >= 0 {
+            let next = self.nodes[Int(index)].next
+            if let callback = self.nodes[Int(index)].callback {
+                self.expired.append(callback)
+            }
+            self.freeNode(Int(index))
+            self.count -= 1
+            index = next
+        }
+    }
+
+    private func allocateNode() -> Int {
+        if self.freeHead < 0 {
+            self.nodes.append(Node())
+            return self.nodes.count - 1
+        }
+
+        let index = Int(self.freeHead)
+        self.freeHead = self.nodes[index].next
+
+        return index
+    }
+
+    private func freeNode(_ index: Int) {
+        self.nodes[index].generation &+= 1
+        self.nodes[index].slot = -1
+        self.nodes[index].callback = nil
+        self.nodes[index].next = self.freeHead
+        self.freeHead = Int32(index)
+    }
+}
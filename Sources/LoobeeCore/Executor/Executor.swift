@@ -13,25 +13,51 @@ public enum ExecutorPriority {
     case custom(value: Int8)
 }
 
+extension ExecutorPriority {
+    /// Numeric value of the priority, where 0 is the medium priority.
+    public var value: Int8 {
+        switch self {
+        case .low:
+            return -127
+        case .medium:
+            return 0
+        case .high:
+            return 127
+        case .custom(let value):
+            return value
+        }
+    }
+
+    /// Maps the priority to the range `0..<numPriorities`, where 0 is the lowest priority.
+    public func index(numPriorities: UInt8) -> Int {
+        assert(numPriorities > 0, "ExecutorPriority: Number of priorities must be greater than 0.")
+
+        let value = max(Int(self.value), -127) + 127
+        return value * (Int(numPriorities) - 1) / 254
+    }
+}
+
 /// An Executor accepts units of work with add(), which should be threadsafe.
 public protocol Executor: class {
     var numPriorities: UInt8 { get }
 
     /// Enqueue a function to executed by this executor. This and all
     /// variants must be threadsafe.
-    func add(_: () -> Void)
+    func add(_: @escaping () -> Void)
 
     /// Enqueue a function with a given priority, where 0 is the medium priority
     /// This is up to the implementation to enforce
-    func add(_: () -> Void, withPriority: ExecutorPriority)
+    func add(_: @escaping () -> Void, withPriority: ExecutorPriority)
 }
 
 extension Executor {
-    internal var numPriorities: UInt8 {
+    public var numPriorities: UInt8 {
         return 1
     }
 }
 
 extension Executor {
-
+    public func add(_ function: @escaping () -> Void) {
+        self.add(function, withPriority: .medium)
+    }
 }
@@ -0,0 +1,331 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Unit of work, referenced from queues by unmanaged address.
+internal final class ThreadPoolExecutorTask {
+    internal let function: () -> Void
+
+    internal init(_ function: @escaping () -> Void) {
+        self.function = function
+    }
+
+    /// Retains the task and returns its address.
+    @inline(__always)
+    internal func retainedAddress() -> UInt {
+        return UInt(bitPattern: Unmanaged.passRetained(self).toOpaque())
+    }
+
+    /// Runs the task and releases it.
+    @inline(__always)
+    internal static func run(retainedAddress address: UInt) {
+        Unmanaged<ThreadPoolExecutorTask>.fromOpaque(UnsafeRawPointer(bitPattern: address)!)
+            .takeRetainedValue()
+            .function()
+    }
+}
+
+/// FIFO queue for tasks added from threads that are not workers of the executor.
+internal final class ThreadPoolExecutorInjectionQueue {
+    private let mutex = Mutex()
+    private var elements: [UInt] = []
+    private var head: Int = 0
+
+    /// Number of elements, can be read without the lock.
+    private var count: Int = 0
+
+    internal var isEmpty: Bool {
+        return self.count.atomicLoad(withOrder: .seqCst) == 0
+    }
+
+    internal func push(_ element: UInt) {
+        self.mutex.synchronized {
+            self.elements.append(element)
+            _ = self.count.atomicFetchAndAdd(1, withOrder: .seqCst)
+        }
+    }
+
+    internal func pop() -> UInt? {
+        if self.isEmpty {
+            return nil
+        }
+
+        return self.mutex.synchronized {
+            guard self.head < self.elements.count else {
+                return nil
+            }
+
+            let element = self.elements[self.head]
+            self.head += 1
+            if self.head == self.elements.count {
+                self.elements.removeAll(keepingCapacity: true)
+                self.head = 0
+            }
+            _ = self.count.atomicFetchAndSub(1, withOrder: .relaxed)
+
+            return element
+        }
+    }
+}
+
+/// State of a worker thread.
+internal final class ThreadPoolExecutorWorker: ThreadSpecificValue {
+    internal let index: Int
+
+    /// One deque per priority.
+    internal let deques: [WorkStealingDeque]
+
+    /// Number of found tasks, used to give a chance to the low priorities.
+    internal var tick: UInt = 0
+
+    /// State of the xorshift generator used to select victims.
+    internal var randomState: UInt64
+
+    internal init(index: Int, numPriorities: UInt8) {
+        self.index = index
+        self.deques = (0..<numPriorities).map { _ in WorkStealingDeque() }
+        self.randomState = UInt64(index) &* 0x9E37_79B9_7F4A_7C15 | 1
+    }
+
+    @inline(__always)
+    internal func random() -> Int {
+        self.randomState ^= self.randomState << 13
+        self.randomState ^= self.randomState >> 7
+        self.randomState ^= self.randomState << 17
+
+        return Int(truncatingIfNeeded: self.randomState >> 1)
+    }
+}
+
+/// Executor that runs functions on a pool of threads with work stealing.
+///
+/// Each worker thread owns a Chase-Lev deque per priority. Functions added from a worker
+/// are pushed to its own deque, functions added from other threads are pushed to the global
+/// injection queue of the priority. An idle worker takes work from its own deque, then from
+/// the injection queue and then steals from other workers. Higher priorities are served first,
+/// but each `starvationInterval`-th task is searched from the lowest priority, so the low
+/// priorities are never starved. Workers without work park on a condition variable.
+///
+///     let executor = ThreadPoolExecutor()
+///     executor.add({ print("Hello") }, withPriority: .high)
+///     executor.shutdown()
+///
+/// - Note: The executor must not be released by its own tasks.
+public final class ThreadPoolExecutor: Executor {
+    /// Each `starvationInterval`-th task is searched from the lowest priority.
+    public static let starvationInterval: UInt = 16
+
+    /// Number of attempts to find work before a worker is parked.
+    internal static let spinLimit = 64
+
+    private static let stealCounter = InstrumentationCounter(name: "executor.threadPool.steals")
+    private static let parkCounter = InstrumentationCounter(name: "executor.threadPool.parks")
+
+    public let numPriorities: UInt8
+
+    internal let workers: [ThreadPoolExecutorWorker]
+    internal let injectionQueues: [ThreadPoolExecutorInjectionQueue]
+    internal let currentWorker = ThreadSpecific<ThreadPoolExecutorWorker>()
+
+    private let parkingMutex = Mutex()
+    private let parkingCondition = Condition()
+    private var sleepers: Int = 0
+    private var isShutdown: Bool = false
+
+    /// Number of `add` calls from other threads between the check of `isShutdown` and the push,
+    /// the shutdown waits for them before the last functions are run.
+    private var pendingAdds: Int = 0
+
+    private var threads: [NativeThread] = []
+
+    /// Creates the executor and starts the workers.
+    ///
+    /// - Parameter threadCount:   Number of worker threads.
+    /// - Parameter numPriorities: Number of priority levels, `ExecutorPriority` values are mapped to them.
+    public init(threadCount: Count = NativeThread.processorCount, numPriorities: UInt8 = 3) {
+        assert(threadCount > 0, "ThreadPoolExecutor: Thread count must be greater than 0.")
+        assert(numPriorities > 0, "ThreadPoolExecutor: Number of priorities must be greater than 0.")
+
+        self.numPriorities = numPriorities
+        self.workers = (0..<threadCount).map { ThreadPoolExecutorWorker(index: $0, numPriorities: numPriorities) }
+        self.injectionQueues = (0..<numPriorities).map { _ in ThreadPoolExecutorInjectionQueue() }
+
+        self.threads = self.workers.map { worker in
+            NativeThread { [unowned(unsafe) self] in
+                self.currentWorker.value = worker
+                self.run(worker)
+                self.currentWorker.value = nil
+            }
+        }
+    }
+
+    deinit {
+        self.shutdown()
+    }
+
+    /// Adds the function to the queue of the priority.
+    ///
+    /// - Precondition: Must not be called after `shutdown()`, except by functions of the executor.
+    public func add(_ function: @escaping () -> Void, withPriority priority: ExecutorPriority) {
+        let index = priority.index(numPriorities: self.numPriorities)
+
+        if let worker = self.currentWorker.value {
+            worker.deques[index].push(ThreadPoolExecutorTask(function).retainedAddress())
+        } else {
+            // Pairs with the store of `isShutdown`: either the shutdown waits for the push,
+            // or this call sees the flag.
+            _ = self.pendingAdds.atomicFetchAndAdd(1, withOrder: .seqCst)
+            if _slowPath(self.isShutdown.atomicLoad(withOrder: .seqCst)) {
+                fatalError("ThreadPoolExecutor: Cannot add a function after shutdown.")
+            }
+            self.injectionQueues[index].push(ThreadPoolExecutorTask(function).retainedAddress())
+            _ = self.pendingAdds.atomicFetchAndSub(1, withOrder: .release)
+        }
+
+        self.notify()
+    }
+
+    /// Runs all added functions and stops the workers. Blocks until the workers exit.
+    ///
+    /// After the call only functions of the executor may add functions, other calls of `add` are fatal errors.
+    /// Functions added concurrently with the shutdown and functions they add are run on the calling thread.
+    ///
+    /// - Precondition: Must not be called from a worker of this executor.
+    public func shutdown() {
+        self.parkingMutex.synchronized {
+            self.isShutdown.atomicStore(true, withOrder: .seqCst)
+            self.parkingCondition.broadcast()
+        }
+
+        for thread in self.threads {
+            thread.join()
+        }
+        self.threads.removeAll()
+
+        while self.pendingAdds.atomicLoad(withOrder: .acquire) != 0 {
+            NativeThread.yield()
+        }
+
+        // Functions added concurrently with the shutdown can miss the workers. The calling thread
+        // acts as the first worker, so the functions it runs can add functions to its deque.
+        let worker = self.workers[0]
+        self.currentWorker.value = worker
+        while let address = self.findTask(for: worker) {
+            ThreadPoolExecutorTask.run(retainedAddress: address)
+        }
+        self.currentWorker.value = nil
+    }
+
+    /// Wakes a parked worker if there is one.
+    @inline(__always)
+    private func notify() {
+        atomicThreadFence(withOrder: .seqCst)
+        if self.sleepers.atomicLoad(withOrder: .seqCst) > 0 {
+            self.parkingMutex.synchronized {
+                self.parkingCondition.signal()
+            }
+        }
+    }
+
+    private func run(_ worker: ThreadPoolExecutorWorker) {
+        var idleRounds = 0
+        while true {
+            if let address = self.findTask(for: worker) {
+                ThreadPoolExecutorTask.run(retainedAddress: address)
+                idleRounds = 0
+                continue
+            }
+
+            if idleRounds < ThreadPoolExecutor.spinLimit {
+                idleRounds += 1
+                NativeThread.yield()
+                continue
+            }
+
+            if !self.park() {
+                return
+            }
+            idleRounds = 0
+        }
+    }
+
+    private func findTask(for worker: ThreadPoolExecutorWorker) -> UInt? {
+        worker.tick &+= 1
+        let isLowFirst = worker.tick % ThreadPoolExecutor.starvationInterval == 0
+        let numPriorities = Int(self.numPriorities)
+
+        for step in 0..<numPriorities {
+            let index = isLowFirst ? step : numPriorities - 1 - step
+
+            if let address = worker.deques[index].take()
+                ?? self.injectionQueues[index].pop()
+                ?? self.steal(for: worker, priorityIndex: index) {
+                return address
+            }
+        }
+
+        return nil
+    }
+
+    private func steal(for worker: ThreadPoolExecutorWorker, priorityIndex: Int) -> UInt? {
+        let count = self.workers.count
+        let start = worker.random() % count
+
+        for offset in 0..<count {
+            let victim = self.workers[(start + offset) % count]
+            if victim === worker {
+                continue
+            }
+
+            if let address = victim.deques[priorityIndex].steal() {
+                ThreadPoolExecutor.stealCounter.increment()
+                return address
+            }
+        }
+
+        return nil
+    }
+
+    private var hasWork: Bool {
+        for queue in self.injectionQueues where !queue.isEmpty {
+            return true
+        }
+
+        for worker in self.workers {
+            for deque in worker.deques where !deque.isEmpty {
+                return true
+            }
+        }
+
+        return false
+    }
+
+    /// Blocks the worker until there is work.
+    ///
+    /// - Returns: `false` if the executor is shut down and there is no work.
+    private func park() -> Bool {
+        ThreadPoolExecutor.parkCounter.increment()
+        self.parkingMutex.lock()
+        defer {
+            self.parkingMutex.unlock()
+        }
+
+        _ = self.sleepers.atomicFetchAndAdd(1, withOrder: .seqCst)
+        defer {
+            _ = self.sleepers.atomicFetchAndSub(1, withOrder: .seqCst)
+        }
+
+        while !self.hasWork {
+            if self.isShutdown.atomicLoad(withOrder: .seqCst) {
+                return false
+            }
+
+            self.parkingCondition.wait(self.parkingMutex)
+        }
+
+        return true
+    }
+}
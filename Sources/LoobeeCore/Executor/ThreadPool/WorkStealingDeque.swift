@@ -0,0 +1,181 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Circular array of `WorkStealingDeque`.
+internal final class WorkStealingDequeBuffer {
+    internal let capacity: Int
+    private let mask: Int
+    private let elements: UnsafeMutablePointer<UInt>
+
+    internal init(capacity: Int) {
+        assert((capacity & (capacity - 1)) == 0, "WorkStealingDeque: Capacity must be power of two.")
+
+        self.capacity = capacity
+        self.mask = capacity - 1
+        self.elements = .allocate(capacity: capacity)
+        self.elements.initialize(repeating: 0, count: capacity)
+    }
+
+    deinit {
+        self.elements.deallocate()
+    }
+
+    @inline(__always)
+    internal func load(at index: Int) -> UInt {
+        return self.elements[index & self.mask].atomicLoad(withOrder: .relaxed)
+    }
+
+    @inline(__always)
+    internal func store(_ element: UInt, at index: Int) {
+        self.elements[index & self.mask].atomicStore(element, withOrder: .relaxed)
+    }
+
+    /// Returns a buffer of twice the capacity with elements in `top..<bottom`.
+    internal func grow(top: Int, bottom: Int) -> WorkStealingDequeBuffer {
+        let buffer = WorkStealingDequeBuffer(capacity: self.capacity * 2)
+        for index in top..<bottom {
+            buffer.store(self.load(at: index), at: index)
+        }
+
+        return buffer
+    }
+}
+
+/// Chase-Lev work-stealing deque of non-zero words.
+///
+/// The owner thread pushes and takes elements at the bottom (LIFO), any other thread
+/// steals elements from the top (FIFO).
+///
+/// [Details](https://fzn.fr/readings/ppopp13.pdf)
+internal final class WorkStealingDeque {
+    /// `top` and `bottom` are placed on separate cache lines.
+    private let indices: UnsafeMutablePointer<Int>
+
+    /// Address of the current buffer, loaded by thieves.
+    private var bufferAddress: UInt
+
+    /// Current buffer, used by the owner.
+    private var buffer: WorkStealingDequeBuffer
+
+    /// Keeps replaced buffers alive while thieves can read them.
+    private var retiredBuffers: [WorkStealingDequeBuffer] = []
+
+    private static let bottomOffset = 64 / MemoryLayout<Int>.stride
+
+    internal init(capacity: Int = 256) {
+        let count = 2 * WorkStealingDeque.bottomOffset
+
+        self.indices = AlignedSystemAllocator<Int>().allocate(count: count, alignment: .custom(size: 64))
+        self.indices.initialize(repeating: 0, count: count)
+        self.buffer = WorkStealingDequeBuffer(capacity: capacity)
+        self.bufferAddress = UInt(bitPattern: Unmanaged.passUnretained(self.buffer).toOpaque())
+    }
+
+    deinit {
+        AlignedSystemAllocator<Int>().deallocate(self.indices)
+    }
+
+    private var top: UnsafeMutablePointer<Int> {
+        @inline(__always)
+        get {
+            return self.indices
+        }
+    }
+
+    private var bottom: UnsafeMutablePointer<Int> {
+        @inline(__always)
+        get {
+            return self.indices + WorkStealingDeque.bottomOffset
+        }
+    }
+
+    /// Returns true if the deque looks empty. Can be called from any thread.
+    internal var isEmpty: Bool {
+        let bottom = self.bottom.pointee.atomicLoad(withOrder: .seqCst)
+        let top = self.top.pointee.atomicLoad(withOrder: .seqCst)
+
+        return bottom <= top
+    }
+
+    /// Pushes the element at the bottom. Can be called only by the owner.
+    ///
+    /// - Precondition: `element` must not be 0.
+    internal func push(_ element: UInt) {
+        let bottom = self.bottom.pointee.atomicLoad(withOrder: .relaxed)
+        let top = self.top.pointee.atomicLoad(withOrder: .acquire)
+
+        if _slowPath(bottom - top > self.buffer.capacity - 1) {
+            self.retiredBuffers.append(self.buffer)
+            self.buffer = self.buffer.grow(top: top, bottom: bottom)
+            self.bufferAddress.atomicStore(
+                UInt(bitPattern: Unmanaged.passUnretained(self.buffer).toOpaque()),
+                withOrder: .release
+            )
+        }
+
+        self.buffer.store(element, at: bottom)
+        atomicThreadFence(withOrder: .release)
+        self.bottom.pointee.atomicStore(bottom + 1, withOrder: .relaxed)
+    }
+
+    /// Takes the element from the bottom. Can be called only by the owner.
+    ///
+    /// - Returns: The last pushed element or nil if the deque is empty.
+    internal func take() -> UInt? {
+        let bottom = self.bottom.pointee.atomicLoad(withOrder: .relaxed) - 1
+        self.bottom.pointee.atomicStore(bottom, withOrder: .relaxed)
+        atomicThreadFence(withOrder: .seqCst)
+        var top = self.top.pointee.atomicLoad(withOrder: .relaxed)
+
+        guard top <= bottom else {
+            self.bottom.pointee.atomicStore(bottom + 1, withOrder: .relaxed)
+            return nil
+        }
+
+        let element = self.buffer.load(at: bottom)
+        if top != bottom {
+            return element
+        }
+
+        // The last element, race with thieves.
+        let isTaken = self.top.pointee.atomicCompareAndExchangeStrong(
+            expected: &top,
+            desired: top + 1,
+            successOrder: .seqCst,
+            failureOrder: .relaxed
+        )
+        self.bottom.pointee.atomicStore(bottom + 1, withOrder: .relaxed)
+
+        return isTaken ? element : nil
+    }
+
+    /// Steals the element from the top. Can be called from any thread.
+    ///
+    /// - Returns: The first pushed element or nil if the deque is empty or the race was lost.
+    internal func steal() -> UInt? {
+        var top = self.top.pointee.atomicLoad(withOrder: .acquire)
+        atomicThreadFence(withOrder: .seqCst)
+        let bottom = self.bottom.pointee.atomicLoad(withOrder: .acquire)
+
+        guard top < bottom else {
+            return nil
+        }
+
+        let address = self.bufferAddress.atomicLoad(withOrder: .consume)
+        let buffer = Unmanaged<WorkStealingDequeBuffer>.fromOpaque(UnsafeRawPointer(bitPattern: address)!)
+        let element = buffer.takeUnretainedValue().load(at: top)
+
+        let isStolen = self.top.pointee.atomicCompareAndExchangeStrong(
+            expected: &top,
+            desired: top + 1,
+            successOrder: .seqCst,
+            failureOrder: .relaxed
+        )
+
+        return isStolen ? element : nil
+    }
+}
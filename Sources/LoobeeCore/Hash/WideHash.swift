@@ -0,0 +1,379 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+/// 128-bit value of the wide hash.
+@_fixed_layout
+public struct WideHash128: Hashable {
+    public var low: UInt64
+    public var high: UInt64
+
+    @inlinable
+    public init(low: UInt64, high: UInt64) {
+        self.low = low
+        self.high = high
+    }
+}
+
+/// Fast non-cryptographic hash with 64- and 128-bit output.
+///
+/// Inputs up to 128 bytes are mixed as 16-byte pairs read from both ends. Longer inputs are
+/// processed by 64-byte stripes in 8 independent 64-bit lanes, every 1 KiB the lanes are
+/// scrambled. The lanes are mixed by the SIMD kernel selected for the processor, all kernels
+/// produce identical results. The design follows XXH3, but the constants and the results differ.
+///
+///     let hash = wideHash64("Hello, world!")
+///     let wide = wideHash128(bytes, seed: 42)
+///
+/// [Details](https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md)
+///
+/// - Note: 64-bit value is the low half of 128-bit one. Values depend on the byte order of the platform.
+public enum WideHash {
+    /// Implementation of the stripe processing.
+    public enum Kernel {
+        case scalar
+        case sse2
+        case avx2
+    }
+
+    internal static let kernelDispatch: CpuDispatch<Kernel> = {
+        #if arch(x86_64)
+        return CpuDispatch([(.baseline, .sse2), (.avx2, .avx2)])
+        #else
+        return CpuDispatch([(.baseline, .scalar)])
+        #endif
+    }()
+
+    /// Kernel selected for the current processor.
+    public static var kernel: Kernel {
+        return WideHash.kernelDispatch.kernel
+    }
+
+    internal static let stripeSize = 64
+    internal static let blockSize = 1024
+    internal static let shortLimit = 128
+
+    /// Key indexes: 0-7 accumulation, 8-15 scrambling, 16-31 and 24-39 low and high output.
+    internal static let lowKeyIndex = 16
+    internal static let highKeyIndex = 24
+
+    private static let prime32x1: UInt64 = 0x9E37_79B1
+    private static let prime32x2: UInt64 = 0x85EB_CA77
+    private static let prime32x3: UInt64 = 0xC2B2_AE3D
+    private static let prime64x1: UInt64 = 0x9E37_79B1_85EB_CA87
+    private static let prime64x2: UInt64 = 0xC2B2_AE3D_27D4_EB4F
+    private static let prime64x3: UInt64 = 0x1656_67B1_9E37_79F9
+    private static let prime64x4: UInt64 = 0x85EB_CA77_C2B2_AE63
+    private static let prime64x5: UInt64 = 0x27D4_EB2F_1656_67C5
+
+    /// Pseudo-random keys, the output of splitmix64 seeded with 0x4C6F6F6265654861.
+    internal static let keys: UnsafePointer<UInt64> = {
+        let values: [UInt64] = [
+            0xD4A4_B21B_B9FB_0B19, 0x8999_E356_3834_3AB9, 0x9BC6_3E16_D12E_6E1E, 0xA64B_1D37_83BD_8107,
+            0x1A17_008B_87D2_1DC3, 0xF633_CF9E_3343_1915, 0xB7BA_8635_AE88_AEA1, 0x4DD1_E58E_D4CB_C759,
+            0x3A04_6FA3_3042_6DF1, 0x5B7F_E1EE_4BA7_5A8C, 0x1573_3567_D75B_58A8, 0xE9DD_F42F_B0A2_74A7,
+            0xC752_130D_9584_52CC, 0x010F_140C_AE2B_78E9, 0x9C37_14AE_BF66_606A, 0x9D50_AB7B_A49E_35A2,
+            0x6041_F447_2E22_63C4, 0x1373_FD42_F370_38C3, 0xCABC_D1F1_75A7_06D0, 0xD893_F267_3BDA_0724,
+            0x1F63_D8FF_5527_989D, 0x5E33_4569_1BBB_B92F, 0x97F5_751F_929A_7BDB, 0xE1B5_C374_AF90_F0B3,
+            0xC6EE_1531_95DC_850B, 0xA6D2_5807_A4EB_F992, 0xF678_A108_BF00_FA11, 0x7AC1_8FA9_2241_7BE7,
+            0xEB31_8910_E609_5B8F, 0xD39E_A855_5DC7_6BD4, 0x44BD_D8D5_DBD7_AD66, 0xF0CF_0D6A_6AA1_3D09,
+            0x6E1E_C533_2C15_ADF4, 0x24E2_B5CF_D0B1_C41C, 0xD2A3_BF25_1378_B79A, 0xA9C7_4743_C309_7E85,
+            0x9524_4DDA_32D7_41E0, 0xBC5F_A4E8_35D1_8DE3, 0x68F3_1A81_372E_F3FE, 0xA7FC_5CF5_B817_3D8A,
+        ]
+
+        let keys = UnsafeMutablePointer<UInt64>.allocate(capacity: values.count)
+        keys.initialize(from: values, count: values.count)
+
+        return UnsafePointer(keys)
+    }()
+
+    /// Returns 64-bit hash of `data`.
+    @usableFromInline
+    internal static func hash64(_ data: UnsafeRawBufferPointer, seed: UInt64, kernel: Kernel) -> UInt64 {
+        if data.count <= WideHash.shortLimit {
+            return WideHash.short(data, seed: seed, keyIndex: WideHash.lowKeyIndex)
+        }
+
+        return WideHash.withAccumulators(of: data, seed: seed, kernel: kernel) { accumulators in
+            return WideHash.mergeLow(accumulators, count: data.count)
+        }
+    }
+
+    /// Returns 128-bit hash of `data`.
+    @usableFromInline
+    internal static func hash128(_ data: UnsafeRawBufferPointer, seed: UInt64, kernel: Kernel) -> WideHash128 {
+        if data.count <= WideHash.shortLimit {
+            return WideHash128(
+                low: WideHash.short(data, seed: seed, keyIndex: WideHash.lowKeyIndex),
+                high: WideHash.short(data, seed: seed, keyIndex: WideHash.highKeyIndex)
+            )
+        }
+
+        return WideHash.withAccumulators(of: data, seed: seed, kernel: kernel) { accumulators in
+            return WideHash128(
+                low: WideHash.mergeLow(accumulators, count: data.count),
+                high: WideHash.mergeHigh(accumulators, count: data.count)
+            )
+        }
+    }
+
+    /// Processes the long input with accumulators on the stack.
+    private static func withAccumulators<R>(
+        of data: UnsafeRawBufferPointer,
+        seed: UInt64,
+        kernel: Kernel,
+        _ body: (UnsafeMutablePointer<UInt64>) -> R
+    ) -> R {
+        var storage: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0)
+
+        return withUnsafeMutableBytes(of: &storage) { bytes in
+            let accumulators = bytes.baseAddress!.assumingMemoryBound(to: UInt64.self)
+            let base = data.baseAddress!
+            let count = data.count
+
+            WideHash.initialize(accumulators, seed: seed)
+
+            // The tail of 1...blockSize bytes is processed by `finish`, as `WideHasher` does.
+            let blockCount = (count - 1) / WideHash.blockSize
+            for block in 0..<blockCount {
+                WideHash.consumeBlock(accumulators, base + block * WideHash.blockSize, kernel: kernel)
+            }
+
+            let tailOffset = blockCount * WideHash.blockSize
+            WideHash.finish(
+                accumulators,
+                tail: base + tailOffset,
+                count: count - tailOffset,
+                lastStripe: base + count - WideHash.stripeSize,
+                kernel: kernel
+            )
+
+            return body(accumulators)
+        }
+    }
+
+    internal static func initialize(_ accumulators: UnsafeMutablePointer<UInt64>, seed: UInt64) {
+        accumulators[0] = WideHash.prime32x3 &+ seed
+        accumulators[1] = WideHash.prime64x1 &- seed
+        accumulators[2] = WideHash.prime64x2 &+ seed
+        accumulators[3] = WideHash.prime64x3 &- seed
+        accumulators[4] = WideHash.prime64x4 &+ seed
+        accumulators[5] = WideHash.prime32x2 &- seed
+        accumulators[6] = WideHash.prime64x5 &+ seed
+        accumulators[7] = WideHash.prime32x1 &- seed
+    }
+
+    /// Accumulates the block of `blockSize` bytes and scrambles the accumulators.
+    internal static func consumeBlock(
+        _ accumulators: UnsafeMutablePointer<UInt64>,
+        _ block: UnsafeRawPointer,
+        kernel: Kernel
+    ) {
+        WideHash.accumulate(accumulators, block, stripes: WideHash.blockSize / WideHash.stripeSize, kernel: kernel)
+
+        switch kernel {
+        case .scalar:
+            CLoobeeCoreWideHash_scrambleScalar(accumulators, WideHash.keys)
+        case .sse2:
+            #if arch(x86_64)
+            CLoobeeCoreWideHash_scrambleSse2(accumulators, WideHash.keys)
+            #else
+            fatalError("WideHash: Kernel is not supported.")
+            #endif
+        case .avx2:
+            #if arch(x86_64)
+            CLoobeeCoreWideHash_scrambleAvx2(accumulators, WideHash.keys)
+            #else
+            fatalError("WideHash: Kernel is not supported.")
+            #endif
+        }
+    }
+
+    /// Accumulates the last 1...blockSize bytes. The last stripe is the last `stripeSize` bytes
+    /// of the input, it overlaps the previous stripe if the tail is not a multiple of `stripeSize`.
+    internal static func finish(
+        _ accumulators: UnsafeMutablePointer<UInt64>,
+        tail: UnsafeRawPointer,
+        count: Int,
+        lastStripe: UnsafeRawPointer,
+        kernel: Kernel
+    ) {
+        WideHash.accumulate(accumulators, tail, stripes: (count - 1) / WideHash.stripeSize, kernel: kernel)
+        WideHash.accumulate(accumulators, lastStripe, stripes: 1, kernel: kernel)
+    }
+
+    @inline(__always)
+    private static func accumulate(
+        _ accumulators: UnsafeMutablePointer<UInt64>,
+        _ data: UnsafeRawPointer,
+        stripes: Int,
+        kernel: Kernel
+    ) {
+        switch kernel {
+        case .scalar:
+            CLoobeeCoreWideHash_accumulateScalar(accumulators, data, stripes, WideHash.keys)
+        case .sse2:
+            #if arch(x86_64)
+            CLoobeeCoreWideHash_accumulateSse2(accumulators, data, stripes, WideHash.keys)
+            #else
+            fatalError("WideHash: Kernel is not supported.")
+            #endif
+        case .avx2:
+            #if arch(x86_64)
+            CLoobeeCoreWideHash_accumulateAvx2(accumulators, data, stripes, WideHash.keys)
+            #else
+            fatalError("WideHash: Kernel is not supported.")
+            #endif
+        }
+    }
+
+    /// Reduces the accumulators to the low 64 bits of the hash.
+    internal static func mergeLow(_ accumulators: UnsafeMutablePointer<UInt64>, count: Int) -> UInt64 {
+        return WideHash.merge(
+            accumulators,
+            initial: UInt64(count) &* WideHash.prime64x1,
+            keys: WideHash.keys + WideHash.lowKeyIndex
+        )
+    }
+
+    /// Reduces the accumulators to the high 64 bits of the hash.
+    internal static func mergeHigh(_ accumulators: UnsafeMutablePointer<UInt64>, count: Int) -> UInt64 {
+        return WideHash.merge(
+            accumulators,
+            initial: ~(UInt64(count) &* WideHash.prime64x2),
+            keys: WideHash.keys + WideHash.highKeyIndex
+        )
+    }
+
+    private static func merge(
+        _ accumulators: UnsafeMutablePointer<UInt64>,
+        initial: UInt64,
+        keys: UnsafePointer<UInt64>
+    ) -> UInt64 {
+        var result = initial
+        for index in stride(from: 0, to: 8, by: 2) {
+            result = result &+ WideHash.mix(
+                accumulators[index] ^ keys[index],
+                accumulators[index + 1] ^ keys[index + 1]
+            )
+        }
+
+        return WideHash.avalanche(result)
+    }
+
+    /// Hashes up to `shortLimit` bytes.
+    internal static func short(_ data: UnsafeRawBufferPointer, seed: UInt64, keyIndex: Int) -> UInt64 {
+        let keys = WideHash.keys + keyIndex
+        let count = data.count
+
+        guard count > 16, let base = data.baseAddress else {
+            var first: UInt64 = 0
+            var second: UInt64 = 0
+
+            if count >= 9 {
+                first = CLoobeeCoreWideHash_read64(data.baseAddress!)
+                second = CLoobeeCoreWideHash_read64(data.baseAddress! + count - 8)
+            } else if count >= 4 {
+                first = UInt64(CLoobeeCoreWideHash_read32(data.baseAddress!))
+                second = UInt64(CLoobeeCoreWideHash_read32(data.baseAddress! + count - 4))
+            } else if count > 0 {
+                first = UInt64(data[0]) | UInt64(data[count >> 1]) << 8 | UInt64(data[count - 1]) << 16
+            }
+
+            let mixed = WideHash.mix(first ^ (keys[0] &+ seed), second ^ (keys[1] &- seed))
+
+            return WideHash.avalanche(mixed &+ UInt64(count) &* WideHash.prime64x1)
+        }
+
+        var result = UInt64(count) &* WideHash.prime64x1
+        for pair in 0..<((count + 31) / 32) {
+            let pairKeys = keys + 4 * pair
+
+            result = result &+ WideHash.mix16(base + 16 * pair, seed: seed, keys: pairKeys)
+            result = result &+ WideHash.mix16(base + count - 16 * (pair + 1), seed: seed, keys: pairKeys + 2)
+        }
+
+        return WideHash.avalanche(result)
+    }
+
+    @inline(__always)
+    private static func mix16(_ data: UnsafeRawPointer, seed: UInt64, keys: UnsafePointer<UInt64>) -> UInt64 {
+        return WideHash.mix(
+            CLoobeeCoreWideHash_read64(data) ^ (keys[0] &+ seed),
+            CLoobeeCoreWideHash_read64(data + 8) ^ (keys[1] &- seed)
+        )
+    }
+
+    /// Folds the 128-bit product.
+    @inline(__always)
+    private static func mix(_ lhs: UInt64, _ rhs: UInt64) -> UInt64 {
+        let product = lhs.multipliedFullWidth(by: rhs)
+
+        return product.high ^ product.low
+    }
+
+    @inline(__always)
+    private static func avalanche(_ value: UInt64) -> UInt64 {
+        var value = value
+        value ^= value >> 37
+        value = value &* 0x1656_6791_9E37_79F9
+        value ^= value >> 32
+
+        return value
+    }
+}
+
+/// Wide hash, 64 bits.
+///
+/// - SeeAlso: `WideHash`.
+@inlinable
+public func wideHash64(_ buffer: UnsafeRawBufferPointer, seed: UInt64 = 0) -> UInt64 {
+    return WideHash.hash64(buffer, seed: seed, kernel: WideHash.kernel)
+}
+
+@inlinable
+public func wideHash64(_ buffer: [Byte], seed: UInt64 = 0) -> UInt64 {
+    return buffer.withUnsafeBytes { wideHash64($0, seed: seed) }
+}
+
+@inlinable
+public func wideHash64(_ buffer: String, seed: UInt64 = 0) -> UInt64 {
+    #if swift(>=5.0)
+    let hash = buffer.utf8.withContiguousStorageIfAvailable { wideHash64(UnsafeRawBufferPointer($0), seed: seed) }
+    if let hash = hash {
+        return hash
+    }
+    #endif
+
+    return ContiguousArray(buffer.utf8).withUnsafeBytes { wideHash64($0, seed: seed) }
+}
+
+/// Wide hash, 128 bits.
+///
+/// - SeeAlso: `WideHash`.
+@inlinable
+public func wideHash128(_ buffer: UnsafeRawBufferPointer, seed: UInt64 = 0) -> WideHash128 {
+    return WideHash.hash128(buffer, seed: seed, kernel: WideHash.kernel)
+}
+
+@inlinable
+public func wideHash128(_ buffer: [Byte], seed: UInt64 = 0) -> WideHash128 {
+    return buffer.withUnsafeBytes { wideHash128($0, seed: seed) }
+}
+
+@inlinable
+public func wideHash128(_ buffer: String, seed: UInt64 = 0) -> WideHash128 {
+    #if swift(>=5.0)
+    let hash = buffer.utf8.withContiguousStorageIfAvailable { wideHash128(UnsafeRawBufferPointer($0), seed: seed) }
+    if let hash = hash {
+        return hash
+    }
+    #endif
+
+    return ContiguousArray(buffer.utf8).withUnsafeBytes { wideHash128($0, seed: seed) }
+}
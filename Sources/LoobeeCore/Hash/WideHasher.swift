@@ -0,0 +1,208 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Incremental calculation of the wide hash for data that arrives in chunks.
+///
+/// The result does not depend on how the data is split: it equals `wideHash64(_:seed:)`
+/// and `wideHash128(_:seed:)` of the concatenated chunks.
+///
+///     let hasher = WideHasher()
+///     hasher.update(header)
+///     hasher.update(body)
+///     let hash = hasher.finalize64()
+///
+/// - SeeAlso: `WideHash`.
+public final class WideHasher {
+    public let seed: UInt64
+
+    private let kernel: WideHash.Kernel
+
+    /// Accumulators, last stripe of the consumed input, scratch stripe and the block buffer.
+    private let storage: UnsafeMutableRawPointer
+
+    private var bufferCount: Int = 0
+
+    /// Total number of bytes.
+    public private(set) var count: Int = 0
+
+    private static var accumulatorsOffset: Int {
+        return 0
+    }
+
+    private static var lastStripeOffset: Int {
+        return WideHash.stripeSize
+    }
+
+    private static var scratchOffset: Int {
+        return 2 * WideHash.stripeSize
+    }
+
+    private static var bufferOffset: Int {
+        return 3 * WideHash.stripeSize
+    }
+
+    public convenience init(seed: UInt64 = 0) {
+        self.init(seed: seed, kernel: WideHash.kernel)
+    }
+
+    internal init(seed: UInt64, kernel: WideHash.Kernel) {
+        self.seed = seed
+        self.kernel = kernel
+
+        let size = WideHasher.bufferOffset + WideHash.blockSize
+        self.storage = UnsafeMutableRawPointer(
+            AlignedSystemAllocator<UInt8>().allocate(count: size, alignment: .custom(size: 64))
+        )
+        self.reset()
+    }
+
+    deinit {
+        AlignedSystemAllocator<UInt8>().deallocate(self.storage.assumingMemoryBound(to: UInt8.self))
+    }
+
+    private var accumulators: UnsafeMutablePointer<UInt64> {
+        return (self.storage + WideHasher.accumulatorsOffset).assumingMemoryBound(to: UInt64.self)
+    }
+
+    private var buffer: UnsafeMutableRawPointer {
+        return self.storage + WideHasher.bufferOffset
+    }
+
+    /// Removes all data, the seed is kept.
+    public func reset() {
+        (self.storage + WideHasher.accumulatorsOffset).bindMemory(to: UInt64.self, capacity: 8)
+        WideHash.initialize(self.accumulators, seed: self.seed)
+        self.bufferCount = 0
+        self.count = 0
+    }
+
+    /// Appends the data.
+    public func update(_ data: UnsafeRawBufferPointer) {
+        guard var input = data.baseAddress, data.count > 0 else {
+            return
+        }
+
+        var remaining = data.count
+        self.count += remaining
+
+        if self.bufferCount + remaining <= WideHash.blockSize {
+            memcpy(self.buffer + self.bufferCount, input, remaining)
+            self.bufferCount += remaining
+            return
+        }
+
+        // A block is consumed only when more data follows it, so the buffer is never empty
+        // in `finalize`, as the tail of `WideHash` is never empty.
+        var lastBlockEnd = UnsafeRawPointer(self.buffer + WideHash.blockSize)
+        if self.bufferCount > 0 {
+            let fill = WideHash.blockSize - self.bufferCount
+            memcpy(self.buffer + self.bufferCount, input, fill)
+            input += fill
+            remaining -= fill
+
+            WideHash.consumeBlock(self.accumulators, self.buffer, kernel: self.kernel)
+            self.bufferCount = 0
+        }
+
+        while remaining > WideHash.blockSize {
+            WideHash.consumeBlock(self.accumulators, input, kernel: self.kernel)
+            input += WideHash.blockSize
+            remaining -= WideHash.blockSize
+            lastBlockEnd = input
+        }
+
+        memcpy(self.storage + WideHasher.lastStripeOffset, lastBlockEnd - WideHash.stripeSize, WideHash.stripeSize)
+        memcpy(self.buffer, input, remaining)
+        self.bufferCount = remaining
+    }
+
+    /// Appends the data.
+    public func update(_ data: [Byte]) {
+        data.withUnsafeBytes { self.update($0) }
+    }
+
+    /// Appends UTF-8 code units of the string, native strings are read in place and others are copied first.
+    public func update(_ string: String) {
+        #if swift(>=5.0)
+        let isUpdated = string.utf8.withContiguousStorageIfAvailable { self.update(UnsafeRawBufferPointer($0)) }
+        if isUpdated != nil {
+            return
+        }
+        #endif
+
+        ContiguousArray(string.utf8).withUnsafeBytes { self.update($0) }
+    }
+
+    /// Returns 64-bit hash of the appended data. The hasher can be updated further.
+    public func finalize64() -> UInt64 {
+        if self.count <= WideHash.shortLimit {
+            return WideHash.short(self.bufferedData, seed: self.seed, keyIndex: WideHash.lowKeyIndex)
+        }
+
+        return self.withFinishedAccumulators { WideHash.mergeLow($0, count: self.count) }
+    }
+
+    /// Returns 128-bit hash of the appended data. The hasher can be updated further.
+    public func finalize128() -> WideHash128 {
+        if self.count <= WideHash.shortLimit {
+            return WideHash128(
+                low: WideHash.short(self.bufferedData, seed: self.seed, keyIndex: WideHash.lowKeyIndex),
+                high: WideHash.short(self.bufferedData, seed: self.seed, keyIndex: WideHash.highKeyIndex)
+            )
+        }
+
+        return self.withFinishedAccumulators { accumulators in
+            return WideHash128(
+                low: WideHash.mergeLow(accumulators, count: self.count),
+                high: WideHash.mergeHigh(accumulators, count: self.count)
+            )
+        }
+    }
+
+    private var bufferedData: UnsafeRawBufferPointer {
+        return UnsafeRawBufferPointer(start: self.buffer, count: self.bufferCount)
+    }
+
+    /// Processes the buffered tail with a copy of the accumulators.
+    private func withFinishedAccumulators<R>(_ body: (UnsafeMutablePointer<UInt64>) -> R) -> R {
+        var storage: (UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0, 0, 0, 0, 0)
+
+        return withUnsafeMutableBytes(of: &storage) { bytes in
+            let accumulators = bytes.baseAddress!.assumingMemoryBound(to: UInt64.self)
+            accumulators.assign(from: self.accumulators, count: 8)
+
+            let lastStripe: UnsafeRawPointer
+            if self.bufferCount >= WideHash.stripeSize {
+                lastStripe = UnsafeRawPointer(self.buffer + self.bufferCount - WideHash.stripeSize)
+            } else {
+                // The last stripe starts in the consumed block.
+                let scratch = self.storage + WideHasher.scratchOffset
+                let previousCount = WideHash.stripeSize - self.bufferCount
+
+                memcpy(scratch, self.storage + WideHasher.lastStripeOffset + self.bufferCount, previousCount)
+                memcpy(scratch + previousCount, self.buffer, self.bufferCount)
+                lastStripe = UnsafeRawPointer(scratch)
+            }
+
+            WideHash.finish(
+                accumulators,
+                tail: self.buffer,
+                count: self.bufferCount,
+                lastStripe: lastStripe,
+                kernel: self.kernel
+            )
+
+            return body(accumulators)
+        }
+    }
+}
@@ -12,9 +12,7 @@ public func fnv32(_ buffer: String, hash: UInt32 = 2_166_136_261) -> UInt32 {
     var hash = hash
 
     for byte: UInt8 in buffer.utf8 {
-        let toAdd = (hash << 1) &+ (hash << 4) &+ (hash << 7) &+ (hash << 8) &+ (hash << 24)
-        hash = hash &+ toAdd
-        hash = hash ^ UInt32(byte)
+        hash = (hash &* 16_777_619) ^ UInt32(byte)
     }
 
     return hash
@@ -22,25 +20,15 @@ public func fnv32(_ buffer: String, hash: UInt32 = 2_166_136_261) -> UInt32 {
 
 @inlinable
 public func fnv32(_ buffer: [Byte], hash: UInt32 = 2_166_136_261) -> UInt32 {
-    var hash = hash
-
-    for byte in buffer {
-        let toAdd = (hash << 1) &+ (hash << 4) &+ (hash << 7) &+ (hash << 8) &+ (hash << 24)
-        hash = hash &+ toAdd
-        hash = hash ^ UInt32(byte.integerValue)
-    }
-
-    return hash
+    return buffer.withUnsafeBytes { fnv32($0, hash: hash) }
 }
 
 @inlinable
 public func fnv32(_ buffer: UnsafeRawBufferPointer, hash: UInt32 = 2_166_136_261) -> UInt32 {
     var hash = hash
 
-    for byte in buffer.bindMemory(to: Byte.self) {
-        let toAdd = (hash << 1) &+ (hash << 4) &+ (hash << 7) &+ (hash << 8) &+ (hash << 24)
-        hash = hash &+ toAdd
-        hash = hash ^ UInt32(byte.integerValue)
+    for byte in buffer {
+        hash = (hash &* 16_777_619) ^ UInt32(byte)
     }
 
     return hash
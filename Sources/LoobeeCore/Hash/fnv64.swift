@@ -12,10 +12,7 @@ public func fnv64(_ buffer: String, hash: UInt64 = 14_695_981_039_346_656_037) -
     var hash = hash
 
     for byte: UInt8 in buffer.utf8 {
-        let toAdd1 = (hash << 1) &+ (hash << 4) &+ (hash << 5)
-        let toAdd2 = (hash << 7) &+ (hash << 8) &+ (hash << 40)
-        hash = hash &+ toAdd1 &+ toAdd2
-        hash = hash ^ UInt64(byte)
+        hash = (hash &* 1_099_511_628_211) ^ UInt64(byte)
     }
 
     return hash
@@ -23,27 +20,15 @@ public func fnv64(_ buffer: String, hash: UInt64 = 14_695_981_039_346_656_037) -
 
 @inlinable
 public func fnv64(_ buffer: [Byte], hash: UInt64 = 14_695_981_039_346_656_037) -> UInt64 {
-    var hash = hash
-
-    for byte in buffer {
-        let toAdd1 = (hash << 1) &+ (hash << 4) &+ (hash << 5)
-        let toAdd2 = (hash << 7) &+ (hash << 8) &+ (hash << 40)
-        hash = hash &+ toAdd1 &+ toAdd2
-        hash = hash ^ UInt64(byte.integerValue)
-    }
-
-    return hash
+    return buffer.withUnsafeBytes { fnv64($0, hash: hash) }
 }
 
 @inlinable
 public func fnv64(_ buffer: UnsafeRawBufferPointer, hash: UInt64 = 14_695_981_039_346_656_037) -> UInt64 {
     var hash = hash
 
-    for byte in buffer.bindMemory(to: Byte.self) {
-        let toAdd1 = (hash << 1) &+ (hash << 4) &+ (hash << 5)
-        let toAdd2 = (hash << 7) &+ (hash << 8) &+ (hash << 40)
-        hash = hash &+ toAdd1 &+ toAdd2
-        hash = hash ^ UInt64(byte.integerValue)
+    for byte in buffer {
+        hash = (hash &* 1_099_511_628_211) ^ UInt64(byte)
     }
 
     return hash
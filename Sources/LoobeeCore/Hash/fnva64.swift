@@ -12,10 +12,7 @@ public func fnva64(_ buffer: String, hash: UInt64 = 14_695_981_039_346_656_037)
     var hash = hash
 
     for byte: UInt8 in buffer.utf8 {
-        hash = hash ^ UInt64(byte)
-        let toAdd1 = (hash << 1) &+ (hash << 4) &+ (hash << 5)
-        let toAdd2 = (hash << 7) &+ (hash << 8) &+ (hash << 40)
-        hash = hash &+ toAdd1 &+ toAdd2
+        hash = (hash ^ UInt64(byte)) &* 1_099_511_628_211
     }
 
     return hash
@@ -23,27 +20,15 @@ public func fnva64(_ buffer: String, hash: UInt64 = 14_695_981_039_346_656_037)
 
 @inlinable
 public func fnva64(_ buffer: [Byte], hash: UInt64 = 14_695_981_039_346_656_037) -> UInt64 {
-    var hash = hash
-
-    for byte in buffer {
-        hash = hash ^ UInt64(byte.integerValue)
-        let toAdd1 = (hash << 1) &+ (hash << 4) &+ (hash << 5)
-        let toAdd2 = (hash << 7) &+ (hash << 8) &+ (hash << 40)
-        hash = hash &+ toAdd1 &+ toAdd2
-    }
-
-    return hash
+    return buffer.withUnsafeBytes { fnva64($0, hash: hash) }
 }
 
 @inlinable
 public func fnva64(_ buffer: UnsafeRawBufferPointer, hash: UInt64 = 14_695_981_039_346_656_037) -> UInt64 {
     var hash = hash
 
-    for byte in buffer.bindMemory(to: Byte.self) {
-        hash = hash ^ UInt64(byte.integerValue)
-        let toAdd1 = (hash << 1) &+ (hash << 4) &+ (hash << 5)
-        let toAdd2 = (hash << 7) &+ (hash << 8) &+ (hash << 40)
-        hash = hash &+ toAdd1 &+ toAdd2
+    for byte in buffer {
+        hash = (hash ^ UInt64(byte)) &* 1_099_511_628_211
     }
 
     return hash
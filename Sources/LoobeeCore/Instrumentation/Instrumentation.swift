@@ -0,0 +1,127 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Low-overhead instrumentation of hot paths: `InstrumentationCounter`, `InstrumentationHistogram`
+/// and `TraceSpan`.
+///
+/// Instrumentation is compiled in with the `LOOBEE_INSTRUMENTATION` compilation condition
+/// (`make build INSTRUMENTATION=1`), otherwise all records are empty inlined functions.
+/// Values are written to memory of the current thread and aggregated when they are read.
+///
+///     print(Instrumentation.counters())
+///     // Open in chrome://tracing or https://ui.perfetto.dev.
+///     print(Instrumentation.chromeTrace())
+///
+/// - Note: Durations are measured by the time stamp counter, the processor must have the invariant TSC.
+public enum Instrumentation {
+    /// Whether the library is compiled with `LOOBEE_INSTRUMENTATION`.
+    @inlinable
+    public static var isEnabled: Bool {
+        #if LOOBEE_INSTRUMENTATION
+        return true
+        #else
+        return false
+        #endif
+    }
+
+    /// Ticks of the time stamp counter per nanosecond, measured against the monotonic clock
+    /// by the first access. 1 without `LOOBEE_INSTRUMENTATION`, the counter is not read.
+    #if LOOBEE_INSTRUMENTATION
+    public static let cyclesPerNanosecond: Double = Instrumentation.calibrate()
+    #else
+    public static let cyclesPerNanosecond: Double = 1
+    #endif
+
+    /// Returns the time stamp counter, 0 without `LOOBEE_INSTRUMENTATION`.
+    @inlinable
+    @inline(__always)
+    public static func timestamp() -> UInt64 {
+        #if LOOBEE_INSTRUMENTATION
+        return CLoobeeCoreReadTimestampCounter()
+        #else
+        return 0
+        #endif
+    }
+
+    public static func nanoseconds(fromCycles cycles: UInt64) -> Double {
+        return Double(cycles) / Instrumentation.cyclesPerNanosecond
+    }
+
+    /// Returns values of all registered counters.
+    public static func counters() -> [String: Int] {
+        #if LOOBEE_INSTRUMENTATION
+        return InstrumentationRegistry.shared.counters
+        #else
+        return [:]
+        #endif
+    }
+
+    /// Returns snapshots of all registered histograms.
+    public static func histograms() -> [String: InstrumentationHistogramSnapshot] {
+        #if LOOBEE_INSTRUMENTATION
+        return InstrumentationRegistry.shared.histograms
+        #else
+        return [:]
+        #endif
+    }
+
+    /// Returns the last spans of all threads in the JSON format of `chrome://tracing` and Perfetto.
+    public static func chromeTrace() -> String {
+        #if LOOBEE_INSTRUMENTATION
+        return TraceEvent.chromeTrace(
+            InstrumentationRegistry.shared.traceEvents,
+            cyclesPerNanosecond: Instrumentation.cyclesPerNanosecond
+        )
+        #else
+        return TraceEvent.chromeTrace([], cyclesPerNanosecond: 1)
+        #endif
+    }
+
+    /// Runs `body` in a `TraceSpan`.
+    @inlinable
+    @inline(__always)
+    public static func span<R>(_ name: StaticString, _ body: () throws -> R) rethrows -> R {
+        let span = TraceSpan(name)
+        defer {
+            span.end()
+        }
+
+        return try body()
+    }
+
+    #if LOOBEE_INSTRUMENTATION
+    /// Counts ticks of the time stamp counter during 10 milliseconds of the monotonic clock.
+    private static func calibrate() -> Double {
+        guard Environment.current.cpuId.hasTsc() else {
+            fatalError("Instrumentation: The processor has no time stamp counter.")
+        }
+
+        let startNanoseconds = Instrumentation.monotonicNanoseconds()
+        let startCycles = CLoobeeCoreReadTimestampCounter()
+        usleep(10_000)
+        let cycles = CLoobeeCoreReadTimestampCounter() &- startCycles
+        let nanoseconds = Instrumentation.monotonicNanoseconds() - startNanoseconds
+
+        return Double(cycles) / Double(nanoseconds)
+    }
+
+    private static func monotonicNanoseconds() -> UInt64 {
+        var time = timespec()
+        clock_gettime(CLOCK_MONOTONIC, &time)
+
+        return UInt64(time.tv_sec) &* 1_000_000_000 &+ UInt64(time.tv_nsec)
+    }
+    #endif
+}
@@ -0,0 +1,54 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Counter of events on hot paths.
+///
+/// Each thread increments its own copy of the counter by a plain store, without a shared atomic
+/// and without a read-modify-write operation. The copies of all threads are summed when the value
+/// is read, values of exited threads are kept.
+///
+///     static let stealCounter = InstrumentationCounter(name: "executor.steals")
+///
+///     stealCounter.increment()
+///     print(stealCounter.value)
+///
+/// - Note: Without `LOOBEE_INSTRUMENTATION` increments are compiled out and the value is always 0.
+public struct InstrumentationCounter {
+    public let name: String
+
+    #if LOOBEE_INSTRUMENTATION
+    @usableFromInline internal let index: Int
+    #endif
+
+    /// Registers the counter. Counters with the same name share the value.
+    ///
+    /// - Precondition: Not more than 256 different names can be registered.
+    public init(name: String) {
+        self.name = name
+
+        #if LOOBEE_INSTRUMENTATION
+        self.index = InstrumentationRegistry.shared.counterIndex(named: name)
+        #endif
+    }
+
+    @inlinable
+    @inline(__always)
+    public func increment(by value: Int = 1) {
+        #if LOOBEE_INSTRUMENTATION
+        InstrumentationThreadState.current.add(value, toCounter: self.index)
+        #endif
+    }
+
+    /// Sum of the increments of all threads.
+    public var value: Int {
+        #if LOOBEE_INSTRUMENTATION
+        return InstrumentationRegistry.shared.counterValue(self.index)
+        #else
+        return 0
+        #endif
+    }
+}
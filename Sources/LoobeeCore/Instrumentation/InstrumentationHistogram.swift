@@ -0,0 +1,174 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Distribution of durations in cycles of the time stamp counter.
+///
+/// Buckets have the relative width of 1/32 (about 3%) over the whole range of `UInt64`: values below 64
+/// have own buckets, each next power of two is split into 32 buckets. A value is recorded by three stores
+/// to the buckets of the current thread, threads are merged when a snapshot is taken.
+///
+///     static let parseHistogram = InstrumentationHistogram(name: "http.parse")
+///
+///     let request = parseHistogram.measure {
+///         parser.parse(bytes)
+///     }
+///     print(parseHistogram.snapshot().percentile(0.99))
+///
+/// - Note: Without `LOOBEE_INSTRUMENTATION` nothing is recorded and snapshots are empty.
+public struct InstrumentationHistogram {
+    /// Number of buckets, the last one contains values from `63 << 58`.
+    @usableFromInline internal static let bucketCount = 1920
+
+    /// Index of the sum of values in the buckets of a thread.
+    @usableFromInline internal static let sumIndex = InstrumentationHistogram.bucketCount
+
+    /// Index of the maximum value in the buckets of a thread.
+    @usableFromInline internal static let maxIndex = InstrumentationHistogram.bucketCount + 1
+
+    /// Number of words of the buckets of a thread.
+    @usableFromInline internal static let slotCount = InstrumentationHistogram.bucketCount + 2
+
+    public let name: String
+
+    #if LOOBEE_INSTRUMENTATION
+    @usableFromInline internal let index: Int
+    #endif
+
+    /// Registers the histogram. Histograms with the same name share the values.
+    ///
+    /// - Precondition: Not more than 64 different names can be registered.
+    public init(name: String) {
+        self.name = name
+
+        #if LOOBEE_INSTRUMENTATION
+        self.index = InstrumentationRegistry.shared.histogramIndex(named: name)
+        #endif
+    }
+
+    /// Records the duration in cycles of `Instrumentation.timestamp()`.
+    @inlinable
+    @inline(__always)
+    public func record(cycles: UInt64) {
+        #if LOOBEE_INSTRUMENTATION
+        InstrumentationThreadState.current.record(cycles, inHistogram: self.index)
+        #endif
+    }
+
+    /// Records the duration from `start` returned by `Instrumentation.timestamp()` to now.
+    @inlinable
+    @inline(__always)
+    public func recordElapsed(since start: UInt64) {
+        #if LOOBEE_INSTRUMENTATION
+        self.record(cycles: Instrumentation.timestamp() &- start)
+        #endif
+    }
+
+    /// Runs `body` and records its duration.
+    @inlinable
+    @inline(__always)
+    public func measure<R>(_ body: () throws -> R) rethrows -> R {
+        #if LOOBEE_INSTRUMENTATION
+        let start = Instrumentation.timestamp()
+        defer {
+            self.recordElapsed(since: start)
+        }
+        #endif
+
+        return try body()
+    }
+
+    /// Returns values recorded by all threads.
+    public func snapshot() -> InstrumentationHistogramSnapshot {
+        #if LOOBEE_INSTRUMENTATION
+        return InstrumentationRegistry.shared.histogramSnapshot(self.index)
+        #else
+        return InstrumentationHistogramSnapshot(slots: [])
+        #endif
+    }
+
+    @inlinable
+    @inline(__always)
+    internal static func bucketIndex(of value: UInt64) -> Int {
+        let shift = Swift.max(0, 58 - value.leadingZeroBitCount)
+
+        return 32 * shift + Int(truncatingIfNeeded: value >> UInt64(shift))
+    }
+
+    /// Returns the smallest value of the bucket.
+    internal static func lowerBound(ofBucket index: Int) -> UInt64 {
+        let shift = index < 64 ? 0 : index / 32 - 1
+
+        return UInt64(index - 32 * shift) << UInt64(shift)
+    }
+
+    /// Returns the middle of the bucket, the estimate of its values.
+    internal static func midpoint(ofBucket index: Int) -> UInt64 {
+        let shift = index < 64 ? 0 : index / 32 - 1
+
+        return InstrumentationHistogram.lowerBound(ofBucket: index) + (UInt64(1) << UInt64(shift)) / 2
+    }
+}
+
+/// Values of `InstrumentationHistogram` recorded by all threads at a moment.
+///
+/// Durations are converted to nanoseconds by `Instrumentation.nanoseconds(fromCycles:)`.
+public struct InstrumentationHistogramSnapshot {
+    /// Buckets followed by the sum and the maximum, empty if nothing is recorded.
+    internal let slots: [UInt64]
+
+    /// Number of recorded values.
+    public let count: UInt64
+
+    internal init(slots: [UInt64]) {
+        self.slots = slots
+        self.count = slots.isEmpty ? 0 : slots[0..<InstrumentationHistogram.bucketCount].reduce(0) { $0 &+ $1 }
+    }
+
+    public var meanNanoseconds: Double {
+        if self.count == 0 {
+            return 0
+        }
+
+        return Instrumentation.nanoseconds(fromCycles: self.slots[InstrumentationHistogram.sumIndex])
+            / Double(self.count)
+    }
+
+    public var maxNanoseconds: Double {
+        return Instrumentation.nanoseconds(fromCycles: self.maxCycles)
+    }
+
+    /// Returns the duration of the fraction of values, e.g. 0.99 for p99.
+    ///
+    /// - Precondition: `fraction` must be in 0...1.
+    public func percentile(_ fraction: Double) -> Double {
+        return Instrumentation.nanoseconds(fromCycles: self.percentileCycles(fraction))
+    }
+
+    internal var maxCycles: UInt64 {
+        return self.slots.isEmpty ? 0 : self.slots[InstrumentationHistogram.maxIndex]
+    }
+
+    /// Returns the middle of the bucket of the value with the rank, but not more than the maximum.
+    internal func percentileCycles(_ fraction: Double) -> UInt64 {
+        assert(fraction >= 0 && fraction <= 1, "InstrumentationHistogramSnapshot: Fraction must be in 0...1.")
+
+        if self.count == 0 {
+            return 0
+        }
+
+        let rank = Swift.max(1, UInt64((fraction * Double(self.count)).rounded(.up)))
+        var total: UInt64 = 0
+        for index in 0..<InstrumentationHistogram.bucketCount {
+            total += self.slots[index]
+            if total >= rank {
+                return Swift.min(InstrumentationHistogram.midpoint(ofBucket: index), self.maxCycles)
+            }
+        }
+
+        return self.maxCycles
+    }
+}
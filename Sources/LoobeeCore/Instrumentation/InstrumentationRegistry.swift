@@ -0,0 +1,337 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if LOOBEE_INSTRUMENTATION
+
+/// Counters, histograms and spans of a thread.
+///
+/// Only the owner thread writes, by relaxed stores without read-modify-write operations.
+/// Any thread reads under the mutex of the registry, so the memory is not freed while it is read.
+@usableFromInline
+internal final class InstrumentationThreadState: ThreadSpecificValue {
+    /// Number of words of a span record: sequence, address of the name, start and end.
+    @usableFromInline internal static let spanRecordSize = 4
+
+    /// Values of counters. The block is aligned to the cache line, so counters of different
+    /// threads never share a line.
+    @usableFromInline internal let counters: UnsafeMutablePointer<Int>
+
+    /// Addresses of buckets of histograms, 0 until the thread records the first value.
+    @usableFromInline internal let histograms: UnsafeMutablePointer<UInt>
+
+    /// Ring of the last `InstrumentationRegistry.spanCapacity` spans.
+    @usableFromInline internal let spans: UnsafeMutablePointer<UInt64>
+
+    /// Number of spans written by the thread.
+    @usableFromInline internal var spanCount: UInt64 = 0
+
+    /// Identifier of the thread in the trace.
+    internal let threadId: Int
+
+    internal init(threadId: Int) {
+        let counterCount = InstrumentationRegistry.maxCounterCount
+        let histogramCount = InstrumentationRegistry.maxHistogramCount
+        let spanWordCount = InstrumentationRegistry.spanCapacity * InstrumentationThreadState.spanRecordSize
+
+        self.threadId = threadId
+        self.counters = AlignedSystemAllocator<Int>().allocate(count: counterCount, alignment: .custom(size: 64))
+        self.counters.initialize(repeating: 0, count: counterCount)
+        self.histograms = AlignedSystemAllocator<UInt>().allocate(count: histogramCount, alignment: .custom(size: 64))
+        self.histograms.initialize(repeating: 0, count: histogramCount)
+        self.spans = AlignedSystemAllocator<UInt64>().allocate(count: spanWordCount, alignment: .custom(size: 64))
+        self.spans.initialize(repeating: 0, count: spanWordCount)
+    }
+
+    deinit {
+        for index in 0..<InstrumentationRegistry.maxHistogramCount {
+            if let buckets = self.buckets(ofHistogram: index) {
+                AlignedSystemAllocator<UInt64>().deallocate(buckets)
+            }
+        }
+
+        AlignedSystemAllocator<Int>().deallocate(self.counters)
+        AlignedSystemAllocator<UInt>().deallocate(self.histograms)
+        AlignedSystemAllocator<UInt64>().deallocate(self.spans)
+    }
+
+    /// State of the current thread, created by the first call on the thread.
+    @inlinable
+    @inline(__always)
+    internal static var current: InstrumentationThreadState {
+        let registry = InstrumentationRegistry.shared
+        if let state = registry.threadState.value {
+            return state
+        }
+
+        return registry.createState()
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func add(_ value: Int, toCounter index: Int) {
+        let counter = self.counters + index
+        counter.pointee.atomicStore(counter.pointee &+ value, withOrder: .relaxed)
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func record(_ cycles: UInt64, inHistogram index: Int) {
+        var address = self.histograms[index]
+        if _slowPath(address == 0) {
+            address = self.allocateHistogram(index)
+        }
+
+        let buckets = UnsafeMutablePointer<UInt64>(bitPattern: address)!
+        let bucket = buckets + InstrumentationHistogram.bucketIndex(of: cycles)
+        bucket.pointee.atomicStore(bucket.pointee &+ 1, withOrder: .relaxed)
+
+        let sum = buckets + InstrumentationHistogram.sumIndex
+        sum.pointee.atomicStore(sum.pointee &+ cycles, withOrder: .relaxed)
+
+        let max = buckets + InstrumentationHistogram.maxIndex
+        if cycles > max.pointee {
+            max.pointee.atomicStore(cycles, withOrder: .relaxed)
+        }
+    }
+
+    /// Writes the span to the ring. Each record is a seqlock: the sequence is odd while
+    /// the record is written, so readers skip torn records.
+    @inlinable
+    @inline(__always)
+    internal func addSpan(name: UInt, start: UInt64, end: UInt64) {
+        let index = Int(truncatingIfNeeded: self.spanCount) & (InstrumentationRegistry.spanCapacity - 1)
+        let record = self.spans + index * InstrumentationThreadState.spanRecordSize
+        let sequence = record.pointee
+
+        record.pointee.atomicStore(sequence &+ 1, withOrder: .relaxed)
+        atomicThreadFence(withOrder: .release)
+        record[1].atomicStore(UInt64(name), withOrder: .relaxed)
+        record[2].atomicStore(start, withOrder: .relaxed)
+        record[3].atomicStore(end, withOrder: .relaxed)
+        record.pointee.atomicStore(sequence &+ 2, withOrder: .release)
+
+        self.spanCount.atomicStore(self.spanCount &+ 1, withOrder: .release)
+    }
+
+    @usableFromInline
+    internal func allocateHistogram(_ index: Int) -> UInt {
+        let count = InstrumentationHistogram.slotCount
+        let buckets = AlignedSystemAllocator<UInt64>().allocate(count: count, alignment: .custom(size: 64))
+        buckets.initialize(repeating: 0, count: count)
+
+        let address = UInt(bitPattern: buckets)
+        self.histograms[index].atomicStore(address, withOrder: .release)
+
+        return address
+    }
+
+    /// Buckets of the histogram, `nil` if the thread has not recorded values. Can be called from any thread.
+    internal func buckets(ofHistogram index: Int) -> UnsafeMutablePointer<UInt64>? {
+        return UnsafeMutablePointer(bitPattern: self.histograms[index].atomicLoad(withOrder: .acquire))
+    }
+
+    /// Returns the spans of the ring that are not being written. Can be called from any thread.
+    internal func traceEvents() -> [TraceEvent] {
+        let count = self.spanCount.atomicLoad(withOrder: .acquire)
+        let capacity = UInt64(InstrumentationRegistry.spanCapacity)
+        var events: [TraceEvent] = []
+
+        for position in (count > capacity ? count - capacity : 0)..<count {
+            let index = Int(truncatingIfNeeded: position) & (InstrumentationRegistry.spanCapacity - 1)
+            let record = self.spans + index * InstrumentationThreadState.spanRecordSize
+
+            let sequence = record.pointee.atomicLoad(withOrder: .acquire)
+            let nameAddress = record[1].atomicLoad(withOrder: .relaxed)
+            let start = record[2].atomicLoad(withOrder: .relaxed)
+            let end = record[3].atomicLoad(withOrder: .relaxed)
+            atomicThreadFence(withOrder: .acquire)
+
+            if sequence & 1 == 0 && sequence == record.pointee.atomicLoad(withOrder: .relaxed),
+               let pointer = UnsafePointer<CChar>(bitPattern: UInt(nameAddress)) {
+                let name = String(cString: pointer)
+                events.append(TraceEvent(name: name, threadId: self.threadId, start: start, end: end))
+            }
+        }
+
+        return events
+    }
+
+    internal override func threadWillExit() {
+        InstrumentationRegistry.shared.remove(self)
+    }
+}
+
+/// Names of counters and histograms and states of threads.
+///
+/// Values of exited threads are merged into totals, so they are not lost.
+@usableFromInline
+internal final class InstrumentationRegistry {
+    internal static let maxCounterCount = 256
+    internal static let maxHistogramCount = 64
+
+    /// Number of the last spans kept for each thread and for all exited threads, power of two.
+    @usableFromInline internal static let spanCapacity = 4096
+
+    @usableFromInline internal static let shared = InstrumentationRegistry()
+
+    @usableFromInline internal let threadState = ThreadSpecific<InstrumentationThreadState>()
+
+    private let mutex = Mutex()
+
+    // Guarded by `mutex`.
+    private var counterNames: [String] = []
+    private var histogramNames: [String] = []
+    private var states: [InstrumentationThreadState] = []
+    private var exitedCounters = [Int](repeating: 0, count: InstrumentationRegistry.maxCounterCount)
+    private var exitedHistograms: [[UInt64]] = []
+    private var exitedEvents: [TraceEvent] = []
+    private var nextThreadId = 1
+
+    /// Returns the index of the counter, counters with the same name share the index.
+    internal func counterIndex(named name: String) -> Int {
+        return self.mutex.synchronized {
+            if let index = self.counterNames.firstIndex(of: name) {
+                return index
+            }
+            if self.counterNames.count == InstrumentationRegistry.maxCounterCount {
+                fatalError(
+                    "Instrumentation: Too many counters, the limit is \(InstrumentationRegistry.maxCounterCount)."
+                )
+            }
+
+            self.counterNames.append(name)
+            return self.counterNames.count - 1
+        }
+    }
+
+    /// Returns the index of the histogram, histograms with the same name share the index.
+    internal func histogramIndex(named name: String) -> Int {
+        return self.mutex.synchronized {
+            if let index = self.histogramNames.firstIndex(of: name) {
+                return index
+            }
+            if self.histogramNames.count == InstrumentationRegistry.maxHistogramCount {
+                fatalError(
+                    "Instrumentation: Too many histograms, the limit is \(InstrumentationRegistry.maxHistogramCount)."
+                )
+            }
+
+            self.histogramNames.append(name)
+            self.exitedHistograms.append([UInt64](repeating: 0, count: InstrumentationHistogram.slotCount))
+            return self.histogramNames.count - 1
+        }
+    }
+
+    @usableFromInline
+    internal func createState() -> InstrumentationThreadState {
+        let state: InstrumentationThreadState = self.mutex.synchronized {
+            let state = InstrumentationThreadState(threadId: self.nextThreadId)
+            self.nextThreadId += 1
+            self.states.append(state)
+
+            return state
+        }
+        self.threadState.value = state
+
+        return state
+    }
+
+    /// Merges values of the exiting thread into totals and releases its state.
+    internal func remove(_ state: InstrumentationThreadState) {
+        self.mutex.synchronized {
+            for index in 0..<self.counterNames.count {
+                self.exitedCounters[index] += state.counters[index]
+            }
+
+            for index in 0..<self.histogramNames.count {
+                if let buckets = state.buckets(ofHistogram: index) {
+                    InstrumentationRegistry.merge(buckets, into: &self.exitedHistograms[index])
+                }
+            }
+
+            self.exitedEvents += state.traceEvents()
+            if self.exitedEvents.count > InstrumentationRegistry.spanCapacity {
+                self.exitedEvents.sort { $0.end < $1.end }
+                self.exitedEvents.removeFirst(self.exitedEvents.count - InstrumentationRegistry.spanCapacity)
+            }
+
+            if let index = self.states.firstIndex(where: { $0 === state }) {
+                self.states.remove(at: index)
+            }
+        }
+    }
+
+    internal func counterValue(_ index: Int) -> Int {
+        return self.mutex.synchronized {
+            self.states.reduce(self.exitedCounters[index]) { sum, state in
+                sum + state.counters[index].atomicLoad(withOrder: .relaxed)
+            }
+        }
+    }
+
+    internal var counters: [String: Int] {
+        return self.mutex.synchronized {
+            var counters: [String: Int] = [:]
+            for (index, name) in self.counterNames.enumerated() {
+                counters[name] = self.states.reduce(self.exitedCounters[index]) { sum, state in
+                    sum + state.counters[index].atomicLoad(withOrder: .relaxed)
+                }
+            }
+
+            return counters
+        }
+    }
+
+    internal func histogramSnapshot(_ index: Int) -> InstrumentationHistogramSnapshot {
+        return self.mutex.synchronized {
+            self.unsafeHistogramSnapshot(index)
+        }
+    }
+
+    internal var histograms: [String: InstrumentationHistogramSnapshot] {
+        return self.mutex.synchronized {
+            var histograms: [String: InstrumentationHistogramSnapshot] = [:]
+            for (index, name) in self.histogramNames.enumerated() {
+                histograms[name] = self.unsafeHistogramSnapshot(index)
+            }
+
+            return histograms
+        }
+    }
+
+    /// Spans of all threads sorted by the start.
+    internal var traceEvents: [TraceEvent] {
+        return self.mutex.synchronized {
+            self.states.reduce(self.exitedEvents) { events, state in
+                events + state.traceEvents()
+            }
+        }.sorted { $0.start < $1.start }
+    }
+
+    /// - Precondition: `mutex` must be locked.
+    private func unsafeHistogramSnapshot(_ index: Int) -> InstrumentationHistogramSnapshot {
+        var slots = self.exitedHistograms[index]
+        for state in self.states {
+            if let buckets = state.buckets(ofHistogram: index) {
+                InstrumentationRegistry.merge(buckets, into: &slots)
+            }
+        }
+
+        return InstrumentationHistogramSnapshot(slots: slots)
+    }
+
+    private static func merge(_ buckets: UnsafeMutablePointer<UInt64>, into slots: inout [UInt64]) {
+        for index in 0..<InstrumentationHistogram.bucketCount + 1 {
+            slots[index] = slots[index] &+ buckets[index].atomicLoad(withOrder: .relaxed)
+        }
+
+        let max = buckets[InstrumentationHistogram.maxIndex].atomicLoad(withOrder: .relaxed)
+        slots[InstrumentationHistogram.maxIndex] = Swift.max(slots[InstrumentationHistogram.maxIndex], max)
+    }
+}
+
+#endif
@@ -0,0 +1,120 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Interval of work on a thread, written to the ring of the last spans of the thread when it ends.
+///
+/// Spans are exported by `Instrumentation.chromeTrace()`. The name is not copied: only the address
+/// of the literal is written, so a span costs two reads of the time stamp counter and six stores.
+///
+///     let span = TraceSpan("executor.task")
+///     task.run()
+///     span.end()
+///
+/// - Note: Without `LOOBEE_INSTRUMENTATION` spans are compiled out.
+public struct TraceSpan {
+    #if LOOBEE_INSTRUMENTATION
+    /// Name of spans created with a literal of a single character.
+    @usableFromInline internal static let unnamed: StaticString = "span"
+
+    @usableFromInline internal let name: StaticString
+    @usableFromInline internal let start: UInt64
+    #endif
+
+    /// Starts the span.
+    @inlinable
+    @inline(__always)
+    public init(_ name: StaticString) {
+        #if LOOBEE_INSTRUMENTATION
+        self.name = name.hasPointerRepresentation ? name : TraceSpan.unnamed
+        self.start = Instrumentation.timestamp()
+        #endif
+    }
+
+    /// Ends the span and writes it to the ring of the current thread.
+    @inlinable
+    @inline(__always)
+    public func end() {
+        #if LOOBEE_INSTRUMENTATION
+        let end = Instrumentation.timestamp()
+        InstrumentationThreadState.current.addSpan(
+            name: UInt(bitPattern: self.name.utf8Start),
+            start: self.start,
+            end: end
+        )
+        #endif
+    }
+}
+
+/// Span read from the ring of a thread.
+internal struct TraceEvent {
+    internal let name: String
+    internal let threadId: Int
+
+    /// Time stamps of `Instrumentation.timestamp()`.
+    internal let start: UInt64
+    internal let end: UInt64
+}
+
+extension TraceEvent {
+    /// Formats events as a JSON object of the Trace Event Format of Chrome (`chrome://tracing`, Perfetto):
+    /// complete events with times in microseconds from the first event.
+    internal static func chromeTrace(_ events: [TraceEvent], cyclesPerNanosecond: Double) -> String {
+        let base = events.map { $0.start }.min() ?? 0
+        let processId = getpid()
+        var json = "{\"traceEvents\":["
+
+        for (index, event) in events.enumerated() {
+            if index > 0 {
+                json += ","
+            }
+
+            let start = UInt64(Double(event.start - base) / cyclesPerNanosecond)
+            let duration = UInt64(Double(event.end &- event.start) / cyclesPerNanosecond)
+            json += "{\"name\":\"\(TraceEvent.escaped(event.name))\",\"ph\":\"X\""
+            json += ",\"ts\":\(TraceEvent.microseconds(start)),\"dur\":\(TraceEvent.microseconds(duration))"
+            json += ",\"pid\":\(processId),\"tid\":\(event.threadId)}"
+        }
+
+        return json + "],\"displayTimeUnit\":\"ns\"}"
+    }
+
+    /// Formats nanoseconds as microseconds with three decimal digits.
+    private static func microseconds(_ nanoseconds: UInt64) -> String {
+        let fraction = String(nanoseconds % 1000)
+
+        return "\(nanoseconds / 1000)." + String(repeating: "0", count: 3 - fraction.count) + fraction
+    }
+
+    private static func escaped(_ string: String) -> String {
+        var result = ""
+        for scalar in string.unicodeScalars {
+            switch scalar {
+            case "\"":
+                result += "\\\""
+            case "\\":
+                result += "\\\\"
+            case "\n":
+                result += "\\n"
+            case "\t":
+                result += "\\t"
+            case _ where scalar.value < 0x20:
+                let hex = String(scalar.value, radix: 16)
+                result += "\\u" + String(repeating: "0", count: 4 - hex.count) + hex
+            default:
+                result.unicodeScalars.append(scalar)
+            }
+        }
+
+        return result
+    }
+}
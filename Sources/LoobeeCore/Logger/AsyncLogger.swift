@@ -0,0 +1,309 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Logger that formats and writes messages on a background thread.
+///
+/// The caller checks the level, takes the timestamp and pushes a 64-byte binary record
+/// (level, timestamp, template identifier and up to 4 arguments) to a lock-free ring buffer.
+/// The background thread formats records and writes them to the file descriptor in batches.
+/// Records of each thread are written in the order of the calls.
+///
+///     static let accepted = LogTemplate("Accepted {count} connections in {elapsed} ms")
+///
+///     let logger = AsyncLogger(fileDescriptor: STDERR_FILENO, level: .info)
+///     logger.log(.info, accepted, .int(count), .double(elapsed)) // Does not allocate.
+///     logger.debug("Not formatted") // Discarded by the level.
+///
+/// Messages passed by the `Logger` protocol methods are boxed together with the context
+/// and formatted on the background thread.
+///
+/// - Note: The logger does not close the file descriptor.
+public final class AsyncLogger: Logger {
+    /// What to do with a record if the ring buffer is full.
+    public enum OverflowPolicy {
+        /// The record is discarded and counted in `droppedCount`.
+        case drop
+
+        /// The caller waits until the background thread frees space.
+        case block
+    }
+
+    /// Records less severe than the level are discarded by the caller before any work.
+    public let level: LogLevel
+
+    public let overflowPolicy: OverflowPolicy
+
+    public let fileDescriptor: Int32
+
+    @usableFromInline internal let ring: LogRingBuffer
+
+    /// 1 if the background thread waits for records.
+    @usableFromInline internal var consumerSleeping: UInt32 = 0
+
+    /// The number of records discarded by the `.drop` policy.
+    @usableFromInline internal var droppedRecords: UInt = 0
+
+    /// Position of the ring up to which records are written to the file descriptor.
+    private var writtenPosition: UInt = 0
+
+    private var isShutdown: Bool = false
+    private var thread: NativeThread?
+
+    /// Writes are batched up to this number of bytes.
+    internal static let batchSize = 64 * 1024
+
+    /// Creates the logger and starts the background thread.
+    ///
+    /// - Parameter fileDescriptor: Descriptor to write formatted lines.
+    /// - Parameter level:          The least severe level that is logged.
+    /// - Parameter capacity:       The number of records in the ring buffer, must be a power of 2.
+    /// - Parameter overflowPolicy: What to do with a record if the ring buffer is full.
+    public init(
+        fileDescriptor: Int32 = STDERR_FILENO,
+        level: LogLevel = .info,
+        capacity: Int = 16 * 1024,
+        overflowPolicy: OverflowPolicy = .drop
+    ) {
+        self.fileDescriptor = fileDescriptor
+        self.level = level
+        self.overflowPolicy = overflowPolicy
+        self.ring = LogRingBuffer(capacity: capacity)
+
+        self.thread = NativeThread { [unowned(unsafe) self] in
+            self.run()
+        }
+    }
+
+    deinit {
+        self.shutdown()
+    }
+
+    /// The number of records discarded because the ring buffer was full.
+    public var droppedCount: Int {
+        return Int(self.droppedRecords.atomicLoad(withOrder: .relaxed))
+    }
+
+    /// Returns true if records of the level are logged.
+    @inlinable
+    @inline(__always)
+    public func isEnabled(_ level: LogLevel) -> Bool {
+        return level.rawValue <= self.level.rawValue
+    }
+
+    @inlinable
+    public func log(_ level: LogLevel, _ template: LogTemplate) {
+        if self.isEnabled(level) {
+            self.push(level, template, count: 0, .int(0), .int(0), .int(0), .int(0))
+        }
+    }
+
+    @inlinable
+    public func log(_ level: LogLevel, _ template: LogTemplate, _ first: LogArgument) {
+        if self.isEnabled(level) {
+            self.push(level, template, count: 1, first, .int(0), .int(0), .int(0))
+        }
+    }
+
+    @inlinable
+    public func log(_ level: LogLevel, _ template: LogTemplate, _ first: LogArgument, _ second: LogArgument) {
+        if self.isEnabled(level) {
+            self.push(level, template, count: 2, first, second, .int(0), .int(0))
+        }
+    }
+
+    @inlinable
+    public func log(
+        _ level: LogLevel,
+        _ template: LogTemplate,
+        _ first: LogArgument,
+        _ second: LogArgument,
+        _ third: LogArgument
+    ) {
+        if self.isEnabled(level) {
+            self.push(level, template, count: 3, first, second, third, .int(0))
+        }
+    }
+
+    @inlinable
+    public func log(
+        _ level: LogLevel,
+        _ template: LogTemplate,
+        _ first: LogArgument,
+        _ second: LogArgument,
+        _ third: LogArgument,
+        _ fourth: LogArgument
+    ) {
+        if self.isEnabled(level) {
+            self.push(level, template, count: 4, first, second, third, fourth)
+        }
+    }
+
+    public func log(_ level: LogLevel, _ message: String, context: ContextData) {
+        if self.isEnabled(level) {
+            let box = LogMessageBox(message: message, context: context)
+            self.push(level, LogTemplate.message, count: 1, retainedObject: LogArgument.retain(box))
+        }
+    }
+
+    /// Blocks until records logged before the call are written to the file descriptor.
+    public func flush() {
+        let position = self.ring.claimedPosition
+        while self.writtenPosition.atomicLoad(withOrder: .acquire) &- position > UInt.max / 2 {
+            self.wakeConsumer()
+            NativeThread.yield()
+        }
+    }
+
+    /// Writes all logged records and stops the background thread. Blocks until the thread exits.
+    ///
+    /// - Precondition: Records must not be logged after the call.
+    public func shutdown() {
+        guard let thread = self.thread else {
+            return
+        }
+
+        self.isShutdown.atomicStore(true, withOrder: .seqCst)
+        self.wakeConsumer()
+        thread.join()
+        self.thread = nil
+    }
+
+    @inlinable
+    internal func push(
+        _ level: LogLevel,
+        _ template: LogTemplate,
+        count: UInt8,
+        _ first: LogArgument,
+        _ second: LogArgument,
+        _ third: LogArgument,
+        _ fourth: LogArgument
+    ) {
+        var record = LogRecord()
+        record.timestamp = LogFormatter.now()
+        record.templateId = template.id
+        record.level = level.rawValue
+        record.argumentCount = count
+
+        let arguments = (first.encoded, second.encoded, third.encoded, fourth.encoded)
+        record.argumentKinds = arguments.0.kind.rawValue
+            | arguments.1.kind.rawValue << LogArgumentKind.bitWidth
+            | arguments.2.kind.rawValue << (2 * LogArgumentKind.bitWidth)
+            | arguments.3.kind.rawValue << (3 * LogArgumentKind.bitWidth)
+        record.arguments = (arguments.0.payload, arguments.1.payload, arguments.2.payload, arguments.3.payload)
+
+        self.push(record)
+    }
+
+    private func push(_ level: LogLevel, _ template: LogTemplate, count: UInt8, retainedObject: UInt64) {
+        var record = LogRecord()
+        record.timestamp = LogFormatter.now()
+        record.templateId = template.id
+        record.level = level.rawValue
+        record.argumentCount = count
+        record.argumentKinds = LogArgumentKind.message.rawValue
+        record.arguments.0 = retainedObject
+
+        self.push(record)
+    }
+
+    @inlinable
+    internal func push(_ record: LogRecord) {
+        while !self.ring.push(record) {
+            switch self.overflowPolicy {
+            case .drop:
+                self.drop(record)
+
+                return
+            case .block:
+                self.wakeConsumer()
+                NativeThread.yield()
+            }
+        }
+
+        self.wakeConsumer()
+    }
+
+    /// Releases the arguments of the record that does not fit in the ring buffer.
+    @usableFromInline
+    internal func drop(_ record: LogRecord) {
+        for index in 0..<Int(record.argumentCount) {
+            let argument = record.argument(at: index)
+            LogArgument.release(kind: argument.kind, payload: argument.payload)
+        }
+        _ = self.droppedRecords.atomicFetchAndAdd(1, withOrder: .seqCst)
+        self.wakeConsumer()
+    }
+
+    /// Wakes the background thread if it waits for records.
+    ///
+    /// Must follow a sequentially consistent write, e.g. the claim of a position in the ring.
+    /// The background thread sets the flag before it checks the ring, so either it sees the write
+    /// or the load sees the flag. No fence is needed, the load is a plain load on x86.
+    @usableFromInline
+    @inline(__always)
+    internal func wakeConsumer() {
+        if self.consumerSleeping.atomicLoad(withOrder: .seqCst) != 0 {
+            if self.consumerSleeping.atomicExchange(newValue: 0, withOrder: .seqCst) != 0 {
+                self.consumerSleeping.atomicNotifyOne()
+            }
+        }
+    }
+
+    /// Body of the background thread.
+    private func run() {
+        var formatter = LogFormatter()
+        var buffer: [UInt8] = []
+        buffer.reserveCapacity(AsyncLogger.batchSize + 4096)
+        var reportedDropped: UInt = 0
+
+        while true {
+            while buffer.count < AsyncLogger.batchSize, let record = self.ring.pop() {
+                formatter.append(record, to: &buffer)
+            }
+
+            let dropped = self.droppedRecords.atomicLoad(withOrder: .relaxed)
+            if dropped != reportedDropped {
+                formatter.appendPrefix(timestamp: LogFormatter.now(), level: .warning, to: &buffer)
+                buffer += "AsyncLogger: \(dropped - reportedDropped) records dropped\n".utf8
+                reportedDropped = dropped
+            }
+
+            let isEmpty = self.ring.isEmpty
+            if !buffer.isEmpty && (isEmpty || buffer.count >= AsyncLogger.batchSize) {
+                LogFormatter.write(buffer, to: self.fileDescriptor)
+                buffer.removeAll(keepingCapacity: true)
+                self.writtenPosition.atomicStore(self.ring.dequeuePosition, withOrder: .release)
+            }
+            if !isEmpty {
+                continue
+            }
+
+            if self.isShutdown.atomicLoad(withOrder: .seqCst) {
+                // Producers stop before the shutdown, so the ring is drained.
+                return
+            }
+
+            self.consumerSleeping.atomicStore(1, withOrder: .seqCst)
+            let isIdle = !self.ring.hasClaimedRecords
+                && self.droppedRecords.atomicLoad(withOrder: .seqCst) == reportedDropped
+                && !self.isShutdown.atomicLoad(withOrder: .seqCst)
+            if isIdle {
+                self.consumerSleeping.atomicWait(expected: 1)
+            } else {
+                // A claimed record is being written by a producer.
+                NativeThread.yield()
+            }
+            self.consumerSleeping.atomicStore(0, withOrder: .relaxed)
+        }
+    }
+}
@@ -0,0 +1,94 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Argument of a `LogTemplate`, stored in the log record as a kind and 8 bytes.
+///
+///     logger.log(.info, accepted, .int(count), .double(elapsed))
+///
+/// - Note: `.string` allocates a box for the value, other kinds do not allocate.
+public enum LogArgument {
+    case int(Int)
+    case uint(UInt)
+    case double(Double)
+    case bool(Bool)
+    case string(String)
+}
+
+/// Retained value of a `.string` argument.
+@usableFromInline
+internal final class LogStringBox {
+    internal let value: String
+
+    @usableFromInline
+    internal init(_ value: String) {
+        self.value = value
+    }
+}
+
+/// Retained message and context passed by the `Logger` protocol methods.
+@usableFromInline
+internal final class LogMessageBox {
+    internal let message: String
+    internal let context: [String: String]
+
+    @usableFromInline
+    internal init(message: String, context: [String: String]) {
+        self.message = message
+        self.context = context
+    }
+}
+
+/// Kind of an argument in the log record.
+@usableFromInline
+internal enum LogArgumentKind: UInt16 {
+    case int = 0
+    case uint = 1
+    case double = 2
+    case bool = 3
+    case string = 4
+    case message = 5
+
+    /// Number of bits of the kind in `LogRecord.argumentKinds`.
+    @usableFromInline internal static var bitWidth: UInt16 {
+        return 3
+    }
+}
+
+extension LogArgument {
+    /// Returns the kind and the payload of the argument. Strings are retained.
+    @inlinable
+    internal var encoded: (kind: LogArgumentKind, payload: UInt64) {
+        switch self {
+        case .int(let value):
+            return (.int, UInt64(bitPattern: Int64(value)))
+        case .uint(let value):
+            return (.uint, UInt64(value))
+        case .double(let value):
+            return (.double, value.bitPattern)
+        case .bool(let value):
+            return (.bool, value ? 1 : 0)
+        case .string(let value):
+            return (.string, LogArgument.retain(LogStringBox(value)))
+        }
+    }
+
+    /// Retains the object and returns its address.
+    @inlinable
+    internal static func retain(_ object: AnyObject) -> UInt64 {
+        return UInt64(UInt(bitPattern: Unmanaged.passRetained(object).toOpaque()))
+    }
+
+    /// Releases the object that was retained for the payload, if the kind has one.
+    internal static func release(kind: LogArgumentKind, payload: UInt64) {
+        switch kind {
+        case .string, .message:
+            Unmanaged<AnyObject>.fromOpaque(UnsafeRawPointer(bitPattern: UInt(payload))!).release()
+        default:
+            break
+        }
+    }
+}
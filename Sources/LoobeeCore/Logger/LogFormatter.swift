@@ -0,0 +1,197 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Formats log lines: `2019-03-01T12:00:00.123456Z INFO message`.
+@usableFromInline
+internal struct LogFormatter {
+    /// Formats of templates, the index is the identifier.
+    private var templates: [LogTemplateFormat] = []
+
+    /// The second of `secondPrefix`.
+    private var cachedSecond: Int = -1
+
+    /// Formatted date and time up to seconds.
+    private var secondPrefix: [UInt8] = []
+
+    internal init() {
+    }
+
+    /// Returns the current time in nanoseconds since 1970.
+    @inlinable
+    internal static func now() -> UInt64 {
+        var time = timespec()
+        clock_gettime(CLOCK_REALTIME, &time)
+
+        return UInt64(time.tv_sec) &* 1_000_000_000 &+ UInt64(time.tv_nsec)
+    }
+
+    /// Appends the line of the record to the buffer and releases the arguments of the record.
+    internal mutating func append(_ record: LogRecord, to buffer: inout [UInt8]) {
+        if Int(record.templateId) >= self.templates.count {
+            LogTemplateRegistry.shared.update(&self.templates)
+        }
+
+        let level = LogLevel(rawValue: record.level) ?? .debug
+        self.appendPrefix(timestamp: record.timestamp, level: level, to: &buffer)
+
+        let format = self.templates[Int(record.templateId)]
+        for (index, placeholder) in format.placeholders.enumerated() {
+            buffer += format.parts[index]
+            if index < Int(record.argumentCount) {
+                let argument = record.argument(at: index)
+                LogFormatter.append(kind: argument.kind, payload: argument.payload, to: &buffer)
+            } else {
+                buffer += placeholder
+            }
+        }
+        buffer += format.parts[format.placeholders.count]
+        buffer.append(UInt8(ascii: "\n"))
+
+        for index in 0..<Int(record.argumentCount) {
+            let argument = record.argument(at: index)
+            LogArgument.release(kind: argument.kind, payload: argument.payload)
+        }
+    }
+
+    /// Appends the line of the message with placeholders replaced by the context values.
+    internal mutating func append(
+        level: LogLevel,
+        message: String,
+        context: [String: String],
+        to buffer: inout [UInt8]
+    ) {
+        self.appendPrefix(timestamp: LogFormatter.now(), level: level, to: &buffer)
+        LogFormatter.append(message: message, context: context, to: &buffer)
+        buffer.append(UInt8(ascii: "\n"))
+    }
+
+    /// Appends the timestamp and the level followed by spaces.
+    internal mutating func appendPrefix(timestamp: UInt64, level: LogLevel, to buffer: inout [UInt8]) {
+        let second = Int(timestamp / 1_000_000_000)
+        if second != self.cachedSecond {
+            var time = time_t(second)
+            var date = tm()
+            gmtime_r(&time, &date)
+
+            self.secondPrefix.removeAll(keepingCapacity: true)
+            LogFormatter.append(Int(date.tm_year) + 1900, digits: 4, to: &self.secondPrefix)
+            self.secondPrefix.append(UInt8(ascii: "-"))
+            LogFormatter.append(Int(date.tm_mon) + 1, digits: 2, to: &self.secondPrefix)
+            self.secondPrefix.append(UInt8(ascii: "-"))
+            LogFormatter.append(Int(date.tm_mday), digits: 2, to: &self.secondPrefix)
+            self.secondPrefix.append(UInt8(ascii: "T"))
+            LogFormatter.append(Int(date.tm_hour), digits: 2, to: &self.secondPrefix)
+            self.secondPrefix.append(UInt8(ascii: ":"))
+            LogFormatter.append(Int(date.tm_min), digits: 2, to: &self.secondPrefix)
+            self.secondPrefix.append(UInt8(ascii: ":"))
+            LogFormatter.append(Int(date.tm_sec), digits: 2, to: &self.secondPrefix)
+            self.secondPrefix.append(UInt8(ascii: "."))
+            self.cachedSecond = second
+        }
+
+        buffer += self.secondPrefix
+        LogFormatter.append(Int(timestamp % 1_000_000_000 / 1000), digits: 6, to: &buffer)
+        buffer.append(UInt8(ascii: "Z"))
+        buffer.append(UInt8(ascii: " "))
+        buffer += level.description.utf8
+        buffer.append(UInt8(ascii: " "))
+    }
+
+    /// Appends the non-negative value with leading zeros.
+    private static func append(_ value: Int, digits: Int, to buffer: inout [UInt8]) {
+        var divisor = 1
+        for _ in 1..<digits {
+            divisor *= 10
+        }
+
+        var value = value
+        while divisor > 0 {
+            buffer.append(UInt8(ascii: "0") + UInt8(value / divisor % 10))
+            value %= divisor
+            divisor /= 10
+        }
+    }
+
+    private static func append(kind: LogArgumentKind, payload: UInt64, to buffer: inout [UInt8]) {
+        switch kind {
+        case .int:
+            buffer += String(Int64(bitPattern: payload)).utf8
+        case .uint:
+            buffer += String(payload).utf8
+        case .double:
+            buffer += String(Double(bitPattern: payload)).utf8
+        case .bool:
+            buffer += (payload != 0 ? "true" : "false").utf8
+        case .string:
+            let box = Unmanaged<LogStringBox>.fromOpaque(UnsafeRawPointer(bitPattern: UInt(payload))!)
+            buffer += box.takeUnretainedValue().value.utf8
+        case .message:
+            let box = Unmanaged<LogMessageBox>.fromOpaque(UnsafeRawPointer(bitPattern: UInt(payload))!)
+                .takeUnretainedValue()
+            LogFormatter.append(message: box.message, context: box.context, to: &buffer)
+        }
+    }
+
+    /// Replaces `{name}` by the value of `name` in the context, unknown placeholders are kept.
+    private static func append(message: String, context: [String: String], to buffer: inout [UInt8]) {
+        guard !context.isEmpty else {
+            buffer += message.utf8
+            return
+        }
+
+        let bytes = Array(message.utf8)
+        var position = 0
+        while let open = bytes[position...].firstIndex(of: UInt8(ascii: "{")),
+            let close = bytes[open...].firstIndex(of: UInt8(ascii: "}")) {
+            let name = String(decoding: bytes[(open + 1)..<close], as: UTF8.self)
+            guard let value = context[name] else {
+                buffer += bytes[position...open]
+                position = open + 1
+                continue
+            }
+
+            buffer += bytes[position..<open]
+            buffer += value.utf8
+            position = close + 1
+        }
+        buffer += bytes[position...]
+    }
+
+    /// Writes all bytes to the file descriptor, retries partial and interrupted writes.
+    ///
+    /// - Returns: `false` if the data cannot be written.
+    @discardableResult
+    internal static func write(_ buffer: [UInt8], to fileDescriptor: Int32) -> Bool {
+        return buffer.withUnsafeBytes { bytes in
+            var offset = 0
+            while offset < bytes.count {
+                #if os(OSX)
+                let result = Darwin.write(fileDescriptor, bytes.baseAddress! + offset, bytes.count - offset)
+                #elseif os(Linux)
+                let result = Glibc.write(fileDescriptor, bytes.baseAddress! + offset, bytes.count - offset)
+                #endif
+
+                if result < 0 {
+                    if errno == EINTR {
+                        continue
+                    }
+
+                    return false
+                }
+                offset += result
+            }
+
+            return true
+        }
+    }
+}
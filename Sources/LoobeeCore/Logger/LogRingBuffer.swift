@@ -0,0 +1,184 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Binary log record, the size is one cache line.
+@usableFromInline
+@_fixed_layout
+internal struct LogRecord {
+    /// Position of the record in the ring, written by the ring buffer.
+    @usableFromInline internal var sequence: UInt = 0
+
+    /// Nanoseconds since 1970.
+    @usableFromInline internal var timestamp: UInt64 = 0
+
+    @usableFromInline internal var templateId: UInt32 = 0
+
+    @usableFromInline internal var level: UInt8 = 0
+
+    @usableFromInline internal var argumentCount: UInt8 = 0
+
+    /// `LogArgumentKind`s of the arguments, `LogArgumentKind.bitWidth` bits each.
+    @usableFromInline internal var argumentKinds: UInt16 = 0
+
+    @usableFromInline internal var arguments: (UInt64, UInt64, UInt64, UInt64) = (0, 0, 0, 0)
+
+    @usableFromInline internal var padding: UInt64 = 0
+
+    @inlinable
+    internal init() {
+    }
+
+    /// The maximum number of arguments.
+    @usableFromInline internal static var maxArgumentCount: Int {
+        return 4
+    }
+
+    /// Returns the kind and the payload of the argument.
+    internal func argument(at index: Int) -> (kind: LogArgumentKind, payload: UInt64) {
+        let kind = (self.argumentKinds >> (UInt16(index) * LogArgumentKind.bitWidth)) & 0x7
+        let payload: UInt64
+        switch index {
+        case 0:
+            payload = self.arguments.0
+        case 1:
+            payload = self.arguments.1
+        case 2:
+            payload = self.arguments.2
+        default:
+            payload = self.arguments.3
+        }
+
+        return (LogArgumentKind(rawValue: kind)!, payload)
+    }
+}
+
+/// Bounded multi-producer single-consumer ring of `LogRecord`s.
+///
+/// Each slot has a sequence number: a producer claims the position with a CAS on the enqueue
+/// position, writes the record and publishes it by storing `position + 1` to the sequence.
+/// The consumer reads the published record and stores `position + capacity` to make the slot
+/// free for the next round. Producers do not wait for each other, a full ring is reported
+/// to the caller.
+///
+/// [Details](http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue)
+@usableFromInline
+internal final class LogRingBuffer {
+    @usableFromInline internal let slots: UnsafeMutablePointer<LogRecord>
+
+    @usableFromInline internal let mask: UInt
+
+    /// The enqueue position, placed on a separate cache line.
+    @usableFromInline internal let enqueuePosition: UnsafeMutablePointer<UInt>
+
+    /// The dequeue position, used only by the consumer.
+    internal private(set) var dequeuePosition: UInt = 0
+
+    /// - Precondition: `capacity` must be a power of 2.
+    internal init(capacity: Int) {
+        assert(capacity > 0 && capacity & (capacity - 1) == 0, "LogRingBuffer: Capacity must be a power of 2.")
+
+        self.mask = UInt(capacity - 1)
+        self.slots = AlignedSystemAllocator<LogRecord>().allocate(count: capacity, alignment: .custom(size: 64))
+        for index in 0..<capacity {
+            var record = LogRecord()
+            record.sequence = UInt(index)
+            (self.slots + index).initialize(to: record)
+        }
+
+        self.enqueuePosition = AlignedSystemAllocator<UInt>().allocate(count: 1, alignment: .custom(size: 64))
+        self.enqueuePosition.initialize(to: 0)
+    }
+
+    deinit {
+        while let record = self.pop() {
+            for index in 0..<Int(record.argumentCount) {
+                let argument = record.argument(at: index)
+                LogArgument.release(kind: argument.kind, payload: argument.payload)
+            }
+        }
+
+        AlignedSystemAllocator<LogRecord>().deallocate(self.slots)
+        AlignedSystemAllocator<UInt>().deallocate(self.enqueuePosition)
+    }
+
+    /// The number of records.
+    internal var capacity: Int {
+        return Int(self.mask) + 1
+    }
+
+    /// Position of the next record, all records before it are claimed by producers.
+    internal var claimedPosition: UInt {
+        return self.enqueuePosition.pointee.atomicLoad(withOrder: .acquire)
+    }
+
+    /// Adds the record. Can be called from any thread.
+    ///
+    /// - Returns: `false` if the ring is full.
+    @inlinable
+    internal func push(_ record: LogRecord) -> Bool {
+        var position = self.enqueuePosition.pointee.atomicLoad(withOrder: .relaxed)
+
+        while true {
+            let slot = self.slots + Int(position & self.mask)
+            let sequence = slot.pointee.sequence.atomicLoad(withOrder: .acquire)
+            let difference = Int(bitPattern: sequence &- position)
+
+            if difference == 0 {
+                // Sequentially consistent, so the claim is ordered with the check of a sleeping consumer,
+                // the same lock-prefixed instruction on x86.
+                if self.enqueuePosition.pointee.atomicCompareAndExchangeWeak(
+                    expected: &position,
+                    desired: position &+ 1,
+                    withOrder: .seqCst
+                ) {
+                    // The sequence is not copied, the consumer can read it concurrently.
+                    slot.pointee.timestamp = record.timestamp
+                    slot.pointee.templateId = record.templateId
+                    slot.pointee.level = record.level
+                    slot.pointee.argumentCount = record.argumentCount
+                    slot.pointee.argumentKinds = record.argumentKinds
+                    slot.pointee.arguments = record.arguments
+                    slot.pointee.sequence.atomicStore(position &+ 1, withOrder: .release)
+
+                    return true
+                }
+            } else if difference < 0 {
+                return false
+            } else {
+                position = self.enqueuePosition.pointee.atomicLoad(withOrder: .relaxed)
+            }
+        }
+    }
+
+    /// Returns true if producers claimed positions that are not popped yet, including records
+    /// that are not published. Only for the consumer.
+    internal var hasClaimedRecords: Bool {
+        return self.enqueuePosition.pointee.atomicLoad(withOrder: .seqCst) != self.dequeuePosition
+    }
+
+    /// Returns true if the next record is not published yet. Only for the consumer.
+    internal var isEmpty: Bool {
+        let slot = self.slots + Int(self.dequeuePosition & self.mask)
+
+        return slot.pointee.sequence.atomicLoad(withOrder: .acquire) != self.dequeuePosition &+ 1
+    }
+
+    /// Removes the next record. Only for the consumer.
+    internal func pop() -> LogRecord? {
+        let position = self.dequeuePosition
+        let slot = self.slots + Int(position & self.mask)
+        guard slot.pointee.sequence.atomicLoad(withOrder: .acquire) == position &+ 1 else {
+            return nil
+        }
+
+        let record = slot.pointee
+        slot.pointee.sequence.atomicStore(position &+ self.mask &+ 1, withOrder: .release)
+        self.dequeuePosition = position &+ 1
+
+        return record
+    }
+}
@@ -0,0 +1,96 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Message template registered once per process, log records contain only its identifier.
+///
+/// Placeholders have the same form as in `Logger` messages: `{name}`, but they are replaced
+/// by the arguments in order, the name only describes the argument.
+///
+///     static let accepted = LogTemplate("Accepted {count} connections in {elapsed} ms")
+///
+///     logger.log(.info, accepted, .int(count), .double(elapsed))
+///
+/// - Note: Templates with the same format have the same identifier.
+public struct LogTemplate {
+    /// Identifier in the registry.
+    public let id: UInt32
+
+    /// Registers the format if it is not registered yet.
+    public init(_ format: String) {
+        self.id = LogTemplateRegistry.shared.register(format)
+    }
+
+    /// The template of messages passed by the `Logger` protocol methods.
+    internal static let message = LogTemplate("{message}")
+}
+
+/// Format split by placeholders.
+internal struct LogTemplateFormat {
+    /// Text around the placeholders, contains `placeholders.count + 1` parts.
+    internal let parts: [[UInt8]]
+
+    /// Placeholders with braces, written instead of missing arguments.
+    internal let placeholders: [[UInt8]]
+
+    internal init(_ format: String) {
+        var parts: [[UInt8]] = []
+        var placeholders: [[UInt8]] = []
+        var part: [UInt8] = []
+        var placeholder: [UInt8]?
+
+        for byte in format.utf8 {
+            if byte == UInt8(ascii: "{") {
+                // The text before an unclosed brace is not a placeholder.
+                part += placeholder ?? []
+                placeholder = [byte]
+            } else if byte == UInt8(ascii: "}"), let opened = placeholder {
+                parts.append(part)
+                placeholders.append(opened + [byte])
+                part = []
+                placeholder = nil
+            } else if placeholder != nil {
+                placeholder!.append(byte)
+            } else {
+                part.append(byte)
+            }
+        }
+        parts.append(part + (placeholder ?? []))
+
+        self.parts = parts
+        self.placeholders = placeholders
+    }
+}
+
+/// Process-wide storage of template formats.
+internal final class LogTemplateRegistry {
+    internal static let shared = LogTemplateRegistry()
+
+    private let mutex = Mutex()
+    private var formats: [LogTemplateFormat] = []
+    private var identifiers: [String: UInt32] = [:]
+
+    internal func register(_ format: String) -> UInt32 {
+        return self.mutex.synchronized {
+            if let id = self.identifiers[format] {
+                return id
+            }
+
+            let id = UInt32(self.formats.count)
+            self.formats.append(LogTemplateFormat(format))
+            self.identifiers[format] = id
+
+            return id
+        }
+    }
+
+    /// Appends formats registered after the first `cache.count` to the cache.
+    internal func update(_ cache: inout [LogTemplateFormat]) {
+        self.mutex.synchronized {
+            cache += self.formats[cache.count...]
+        }
+    }
+}
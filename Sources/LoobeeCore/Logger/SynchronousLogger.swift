@@ -0,0 +1,48 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Logger that formats and writes each message on the calling thread under a lock.
+///
+/// Lines have the same format as lines of `AsyncLogger`.
+///
+///     let logger = SynchronousLogger(fileDescriptor: STDERR_FILENO, level: .warning)
+///     logger.error("Cannot open {path}", context: ["path": path])
+///
+/// - Note: The logger does not close the file descriptor.
+public final class SynchronousLogger: Logger {
+    /// Messages less severe than the level are discarded.
+    public let level: LogLevel
+
+    public let fileDescriptor: Int32
+
+    private let mutex = Mutex()
+    private var formatter = LogFormatter()
+    private var buffer: [UInt8] = []
+
+    public init(fileDescriptor: Int32 = STDERR_FILENO, level: LogLevel = .info) {
+        self.fileDescriptor = fileDescriptor
+        self.level = level
+    }
+
+    public func log(_ level: LogLevel, _ message: String, context: ContextData) {
+        guard level.rawValue <= self.level.rawValue else {
+            return
+        }
+
+        self.mutex.synchronized {
+            self.buffer.removeAll(keepingCapacity: true)
+            self.formatter.append(level: level, message: message, context: context, to: &self.buffer)
+            LogFormatter.write(self.buffer, to: self.fileDescriptor)
+        }
+    }
+}
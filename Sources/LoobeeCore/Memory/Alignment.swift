@@ -10,6 +10,9 @@ public enum Alignment: Equatable {
     /// Default alignment for system.
     case system
 
+    /// Alignment to the page of the system, e.g. for memory that is mapped or protected by pages.
+    case page
+
     /// Custom alignment.
     ///
     /// - Precondition: `size` must be greater than 4 on x32 and greater than 8 on x64.
@@ -20,6 +23,8 @@ public enum Alignment: Equatable {
         switch self {
         case .system:
             return MemoryLayout<Size>.size * 2
+        case .page:
+            return MemoryPolicy.systemPageSize
         case .custom(let size):
             let minSize = MemoryLayout.size(ofValue: size)
             assert(size >= minSize, "Bad alignment: must be greater than \(minSize).")
@@ -13,9 +13,29 @@ import func Glibc.posix_memalign
 import func Glibc.free
 #endif
 
-/// Uses `posix_memalign` and `free`.
+/// Uses `posix_memalign` and `free`, or `mmap` and `munmap` for a non-default `MemoryPolicy`.
+///
+///     let allocator = AlignedSystemAllocator<UInt64>(policy: MemoryPolicy(pageSize: .transparentHuge))
+///     let table = allocator.allocate(count: 1 << 24, alignment: .system)
+///     // ...
+///     allocator.deallocate(table, count: 1 << 24)
 public struct AlignedSystemAllocator<T> {
+    /// Placement of the memory.
+    public let policy: MemoryPolicy
+
+    public init(policy: MemoryPolicy = .default) {
+        self.policy = policy
+    }
+
+    /// Returns memory for `count` instances of `T`. Mapped memory is aligned at least to its page size.
     public func allocate(count: Count, alignment: Alignment) -> UnsafeMutablePointer<T> {
+        if !self.policy.isDefault {
+            let size = MemoryLayout<T>.stride * count
+
+            return MemoryMapping.map(size: size, alignment: alignment.size, policy: self.policy)
+                .bindMemory(to: T.self, capacity: count)
+        }
+
         var pointer: UnsafeMutableRawPointer?
         let resultCode = posix_memalign(&pointer, alignment.size, MemoryLayout<T>.stride * count)
         if _slowPath(resultCode != 0) {
@@ -25,7 +45,28 @@ public struct AlignedSystemAllocator<T> {
         return pointer!.bindMemory(to: T.self, capacity: count)
     }
 
+    /// Releases memory allocated with the default policy.
+    ///
+    /// - Precondition: The policy must be default, mapped memory is released by `deallocate(_:count:)`.
+    ///                 The size of the mapping is unknown here and `free` of it corrupts the heap,
+    ///                 so a non-default policy is a fatal error in all builds.
     public func deallocate(_ pointer: UnsafeMutablePointer<T>) {
+        if _slowPath(!self.policy.isDefault) {
+            fatalError("AlignedSystemAllocator: Mapped memory must be deallocated with its count.")
+        }
+
         free(pointer)
     }
+
+    /// Releases memory allocated with any policy.
+    ///
+    /// - Precondition: `count` must be equal to the count passed to `allocate(count:alignment:)`.
+    public func deallocate(_ pointer: UnsafeMutablePointer<T>, count: Count) {
+        if self.policy.isDefault {
+            free(pointer)
+            return
+        }
+
+        MemoryMapping.unmap(UnsafeMutableRawPointer(pointer), size: MemoryLayout<T>.stride * count, policy: self.policy)
+    }
 }
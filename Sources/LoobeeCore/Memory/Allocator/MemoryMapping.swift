@@ -0,0 +1,144 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Memory of a non-default `MemoryPolicy`, mapped by `mmap`.
+internal enum MemoryMapping {
+    #if os(Linux)
+    /// `MAP_HUGETLB | MAP_HUGE_2MB`: log2 of the page size is shifted by `MAP_HUGE_SHIFT`.
+    private static let hugeTlbFlags = MAP_HUGETLB | (21 << 26)
+    #endif
+
+    /// Maps `policy.roundedSize(size)` bytes aligned to `alignment` and applies the policy.
+    /// A zero size maps one page, as `mmap` rejects empty mappings.
+    ///
+    /// Explicit huge pages fall back to transparent huge pages if the pool has no free pages.
+    internal static func map(size: Size, alignment: Size, policy: MemoryPolicy) -> UnsafeMutableRawPointer {
+        let length = MemoryMapping.length(of: size, policy: policy)
+        var pointer: UnsafeMutableRawPointer?
+        var isHugeTlb = false
+
+        #if os(Linux)
+        if policy.pageSize == .huge {
+            pointer = MemoryMapping.map(
+                length: length,
+                alignment: alignment,
+                granularity: MemoryPolicy.hugePageSize,
+                flags: MemoryMapping.hugeTlbFlags
+            )
+            isHugeTlb = pointer != nil
+        }
+        #endif
+
+        if pointer == nil {
+            // Transparent huge pages are used only for aligned ranges of 2 MiB.
+            pointer = MemoryMapping.map(
+                length: length,
+                alignment: max(alignment, policy.pageSize.size),
+                granularity: MemoryPolicy.systemPageSize,
+                flags: 0
+            )
+        }
+
+        guard let base = pointer else {
+            fatalError("AlignedSystemAllocator: Cannot map memory. Code: \(errno)")
+        }
+
+        MemoryMapping.apply(policy, to: base, length: length, isHugeTlb: isHugeTlb)
+
+        return base
+    }
+
+    /// Unmaps memory returned by `map` for the same size and policy.
+    internal static func unmap(_ pointer: UnsafeMutableRawPointer, size: Size, policy: MemoryPolicy) {
+        munmap(pointer, MemoryMapping.length(of: size, policy: policy))
+    }
+
+    private static func length(of size: Size, policy: MemoryPolicy) -> Size {
+        return policy.roundedSize(max(size, 1))
+    }
+
+    /// Maps `length + alignment - granularity` bytes and unmaps both ends, so the start is aligned.
+    /// `granularity` is the alignment of the mappings of the kernel.
+    private static func map(
+        length: Size,
+        alignment: Size,
+        granularity: Size,
+        flags: Int32
+    ) -> UnsafeMutableRawPointer? {
+        let alignment = max(alignment, granularity)
+        let extra = alignment - granularity
+        let mapped = mmap(nil, length + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | flags, -1, 0)
+        guard let base = mapped, base != UnsafeMutableRawPointer(bitPattern: -1) else {
+            return nil
+        }
+
+        let address = Address(bitPattern: base)
+        let head = ((address + alignment - 1) & ~(alignment - 1)) - address
+        if head > 0 {
+            munmap(base, head)
+        }
+        if extra - head > 0 {
+            munmap(base + head + length, extra - head)
+        }
+
+        return base + head
+    }
+
+    /// Sets the hints and the NUMA placement, then faults the pages in if it is requested.
+    /// The result of hints is ignored: the memory works without them.
+    private static func apply(_ policy: MemoryPolicy, to base: UnsafeMutableRawPointer, length: Size, isHugeTlb: Bool) {
+        #if os(Linux)
+        if policy.pageSize != .system && !isHugeTlb {
+            _ = madvise(base, length, MADV_HUGEPAGE)
+        }
+        #endif
+
+        switch policy.access {
+        case .normal:
+            break
+        case .sequential:
+            _ = madvise(base, length, MADV_SEQUENTIAL)
+        case .random:
+            _ = madvise(base, length, MADV_RANDOM)
+        }
+
+        #if os(Linux)
+        switch policy.placement {
+        case .local:
+            break
+        case .node(let node):
+            _ = CLoobeeCoreMemory_bind(base, length, MemoryMapping.nodeMask([node]), isInterleaved: false)
+        case .interleave(let nodes):
+            let mask = MemoryMapping.nodeMask(nodes.isEmpty ? Array(0..<MemoryPolicy.nodeCount) : nodes)
+            _ = CLoobeeCoreMemory_bind(base, length, mask, isInterleaved: true)
+        }
+        #endif
+
+        // A page is placed when it is touched first, so after the placement is set.
+        if policy.isPrefaulted {
+            for offset in stride(from: 0, to: length, by: MemoryPolicy.systemPageSize) {
+                base.storeBytes(of: 0, toByteOffset: offset, as: UInt8.self)
+            }
+        }
+    }
+
+    private static func nodeMask(_ nodes: [Int]) -> UInt64 {
+        return nodes.reduce(0) { mask, node -> UInt64 in
+            assert(node >= 0 && node < 64, "MemoryPolicy: Node must be in 0..<64.")
+
+            return mask | UInt64(1) << UInt64(node)
+        }
+    }
+}
@@ -0,0 +1,383 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Counters of `PoolAllocator`.
+public struct PoolAllocatorStatistics {
+    /// Number of slabs requested from the system.
+    public let slabCount: Count
+
+    /// Number of objects that are allocated and not yet deallocated.
+    public let liveObjects: Count
+
+    /// Number of objects deallocated by a thread other than the owner of their slab.
+    public let remoteDeallocations: Count
+}
+
+/// Accessors to a slab: memory of `slabSize` bytes aligned to `slabSize`.
+///
+/// The first cache line contains the fields of the owner thread, the second one contains
+/// the list of slots deallocated by other threads. Slots start after the header.
+@usableFromInline
+internal struct PoolSlab {
+    @usableFromInline internal static let cacheLineSize: Size = 64
+    @usableFromInline internal static let headerSize: Size = 2 * PoolSlab.cacheLineSize
+
+    @usableFromInline internal let base: UnsafeMutableRawPointer
+
+    @usableFromInline
+    internal init(base: UnsafeMutableRawPointer) {
+        self.base = base
+    }
+
+    /// Address of the `PoolAllocatorThreadCache` that owns the slab, 0 if the slab is abandoned.
+    @usableFromInline internal var owner: UnsafeMutablePointer<UInt> {
+        return self.base.assumingMemoryBound(to: UInt.self)
+    }
+
+    /// Head of the list of slots deallocated by the owner.
+    @usableFromInline internal var localFree: UnsafeMutablePointer<UInt> {
+        return self.base.assumingMemoryBound(to: UInt.self) + 1
+    }
+
+    /// Offset of the first slot that has never been allocated.
+    @usableFromInline internal var bumpOffset: UnsafeMutablePointer<UInt> {
+        return self.base.assumingMemoryBound(to: UInt.self) + 2
+    }
+
+    /// Head of the list of slots deallocated by other threads.
+    @usableFromInline internal var remoteFree: UnsafeMutablePointer<UInt> {
+        return self.base.assumingMemoryBound(to: UInt.self) + 8
+    }
+
+    @usableFromInline
+    internal static func of(_ pointer: UnsafeMutableRawPointer, slabSize: Size) -> PoolSlab {
+        let address = UInt(bitPattern: pointer) & ~UInt(slabSize - 1)
+        return PoolSlab(base: UnsafeMutableRawPointer(bitPattern: address)!)
+    }
+}
+
+/// Cache of a thread, owns slabs and serves allocations from them without synchronization.
+@usableFromInline
+internal final class PoolAllocatorThreadCache: ThreadSpecificValue {
+    @usableFromInline internal unowned(unsafe) let pool: PoolAllocatorStorage
+
+    /// Slab from which allocations are served.
+    @usableFromInline internal var current: PoolSlab?
+
+    /// All slabs owned by the cache.
+    @usableFromInline internal var slabs: [PoolSlab] = []
+
+    // Counters are written only by the owner thread and read by any thread.
+    @usableFromInline internal var allocations: Int = 0
+    @usableFromInline internal var deallocations: Int = 0
+    @usableFromInline internal var remoteDeallocations: Int = 0
+
+    @usableFromInline
+    internal init(pool: PoolAllocatorStorage) {
+        self.pool = pool
+    }
+
+    @inlinable
+    @inline(__always)
+    internal var address: UInt {
+        return UInt(bitPattern: Unmanaged.passUnretained(self).toOpaque())
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func allocate() -> UnsafeMutableRawPointer {
+        let allocations = self.allocations &+ 1
+        self.allocations.atomicStore(allocations, withOrder: .relaxed)
+
+        if let slab = self.current, let slot = self.pop(from: slab) {
+            return slot
+        }
+
+        return self.allocateSlow()
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func pop(from slab: PoolSlab) -> UnsafeMutableRawPointer? {
+        let head = slab.localFree.pointee
+        if _fastPath(head != 0) {
+            let slot = UnsafeMutableRawPointer(bitPattern: head)!
+            slab.localFree.pointee = slot.load(as: UInt.self)
+            return slot
+        }
+
+        let offset = slab.bumpOffset.pointee
+        if offset + UInt(self.pool.slotSize) <= UInt(self.pool.slabSize) {
+            slab.bumpOffset.pointee = offset + UInt(self.pool.slotSize)
+            return slab.base + Int(offset)
+        }
+
+        return nil
+    }
+
+    /// Allocations not served from the current slab, all pools together.
+    private static let slowPathCounter = InstrumentationCounter(name: "allocator.pool.slowPaths")
+
+    @usableFromInline
+    internal func allocateSlow() -> UnsafeMutableRawPointer {
+        PoolAllocatorThreadCache.slowPathCounter.increment()
+
+        for slab in self.slabs {
+            if let slot = self.pop(from: slab) ?? self.collectAndPop(from: slab) {
+                self.current = slab
+                return slot
+            }
+        }
+
+        // An adopted slab can be full, it is kept anyway to collect its remote deallocations later.
+        while true {
+            let slab = self.pool.acquireSlab(for: self)
+            self.slabs.append(slab)
+
+            if let slot = self.pop(from: slab) ?? self.collectAndPop(from: slab) {
+                self.current = slab
+                return slot
+            }
+        }
+    }
+
+    /// Moves slots deallocated by other threads to the local list.
+    ///
+    /// - Precondition: The local list of `slab` must be empty.
+    @usableFromInline
+    internal func collectAndPop(from slab: PoolSlab) -> UnsafeMutableRawPointer? {
+        let head = slab.remoteFree.pointee.atomicExchange(newValue: 0, withOrder: .acquire)
+        if head == 0 {
+            return nil
+        }
+
+        slab.localFree.pointee = head
+        return self.pop(from: slab)
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func deallocate(_ pointer: UnsafeMutableRawPointer) {
+        let deallocations = self.deallocations &+ 1
+        self.deallocations.atomicStore(deallocations, withOrder: .relaxed)
+
+        let slab = PoolSlab.of(pointer, slabSize: self.pool.slabSize)
+        if _fastPath(slab.owner.pointee.atomicLoad(withOrder: .relaxed) == self.address) {
+            pointer.storeBytes(of: slab.localFree.pointee, as: UInt.self)
+            slab.localFree.pointee = UInt(bitPattern: pointer)
+            return
+        }
+
+        let remoteDeallocations = self.remoteDeallocations &+ 1
+        self.remoteDeallocations.atomicStore(remoteDeallocations, withOrder: .relaxed)
+
+        var head = slab.remoteFree.pointee.atomicLoad(withOrder: .relaxed)
+        repeat {
+            pointer.storeBytes(of: head, as: UInt.self)
+        } while !slab.remoteFree.pointee.atomicCompareAndExchangeWeak(
+            expected: &head,
+            desired: UInt(bitPattern: pointer),
+            successOrder: .release,
+            failureOrder: .relaxed
+        )
+    }
+
+    internal override func threadWillExit() {
+        self.pool.abandon(self)
+    }
+}
+
+/// Shared state of `PoolAllocator` instances.
+@usableFromInline
+internal final class PoolAllocatorStorage {
+    @usableFromInline internal let slotSize: Size
+    @usableFromInline internal let slabSize: Size
+
+    @usableFromInline internal let threadCache = ThreadSpecific<PoolAllocatorThreadCache>()
+
+    private let allocator: AlignedSystemAllocator<UInt8>
+    private let mutex = Mutex()
+
+    // Guarded by `mutex`.
+    private var caches: [PoolAllocatorThreadCache] = []
+    private var slabs: [PoolSlab] = []
+    private var abandonedSlabs: [PoolSlab] = []
+    private var exitedAllocations: Int = 0
+    private var exitedDeallocations: Int = 0
+    private var exitedRemoteDeallocations: Int = 0
+
+    internal init(slotSize: Size, slabSize: Size, policy: MemoryPolicy) {
+        assert((slabSize & (slabSize - 1)) == 0, "PoolAllocator: Slab size must be power of two.")
+        assert(slabSize - PoolSlab.headerSize >= slotSize, "PoolAllocator: Slab must contain at least one slot.")
+
+        self.slotSize = slotSize
+        self.slabSize = slabSize
+        self.allocator = AlignedSystemAllocator<UInt8>(policy: policy)
+    }
+
+    deinit {
+        for slab in self.slabs {
+            self.allocator.deallocate(slab.base.assumingMemoryBound(to: UInt8.self), count: self.slabSize)
+        }
+    }
+
+    @inlinable
+    @inline(__always)
+    internal var cache: PoolAllocatorThreadCache {
+        if let cache = self.threadCache.value {
+            return cache
+        }
+
+        return self.createCache()
+    }
+
+    @usableFromInline
+    internal func createCache() -> PoolAllocatorThreadCache {
+        let cache = PoolAllocatorThreadCache(pool: self)
+        self.mutex.synchronized {
+            self.caches.append(cache)
+        }
+        self.threadCache.value = cache
+
+        return cache
+    }
+
+    /// Returns an abandoned slab or requests a new one from the system. The slab is owned by `cache`.
+    internal func acquireSlab(for cache: PoolAllocatorThreadCache) -> PoolSlab {
+        self.mutex.lock()
+        defer {
+            self.mutex.unlock()
+        }
+
+        if let slab = self.abandonedSlabs.popLast() {
+            slab.owner.pointee.atomicStore(cache.address, withOrder: .relaxed)
+            return slab
+        }
+
+        let base = UnsafeMutableRawPointer(
+            self.allocator.allocate(count: self.slabSize, alignment: .custom(size: self.slabSize))
+        )
+        base.bindMemory(to: UInt.self, capacity: PoolSlab.headerSize / MemoryLayout<UInt>.stride)
+            .initialize(repeating: 0, count: PoolSlab.headerSize / MemoryLayout<UInt>.stride)
+
+        let slab = PoolSlab(base: base)
+        slab.bumpOffset.pointee = UInt(PoolSlab.headerSize)
+        slab.owner.pointee.atomicStore(cache.address, withOrder: .relaxed)
+        self.slabs.append(slab)
+
+        return slab
+    }
+
+    /// Passes slabs of the exiting thread to other threads.
+    internal func abandon(_ cache: PoolAllocatorThreadCache) {
+        self.mutex.synchronized {
+            for slab in cache.slabs {
+                slab.owner.pointee.atomicStore(0, withOrder: .relaxed)
+                self.abandonedSlabs.append(slab)
+            }
+
+            self.exitedAllocations += cache.allocations
+            self.exitedDeallocations += cache.deallocations
+            self.exitedRemoteDeallocations += cache.remoteDeallocations
+
+            if let index = self.caches.firstIndex(where: { $0 === cache }) {
+                self.caches.remove(at: index)
+            }
+        }
+    }
+
+    internal var statistics: PoolAllocatorStatistics {
+        return self.mutex.synchronized {
+            var allocations = self.exitedAllocations
+            var deallocations = self.exitedDeallocations
+            var remoteDeallocations = self.exitedRemoteDeallocations
+
+            for cache in self.caches {
+                allocations += cache.allocations.atomicLoad(withOrder: .relaxed)
+                deallocations += cache.deallocations.atomicLoad(withOrder: .relaxed)
+                remoteDeallocations += cache.remoteDeallocations.atomicLoad(withOrder: .relaxed)
+            }
+
+            return PoolAllocatorStatistics(
+                slabCount: self.slabs.count,
+                liveObjects: allocations - deallocations,
+                remoteDeallocations: remoteDeallocations
+            )
+        }
+    }
+}
+
+/// Allocates fixed-size objects from cache-line aligned slabs.
+///
+/// Each thread owns its slabs, so allocation and deallocation of objects of the own slabs
+/// take no locks and no read-modify-write atomic operations. Objects deallocated by another
+/// thread are returned to the owning slab with a single CAS. When a thread exits, its slabs
+/// are passed to other threads.
+///
+/// Slots of at least a cache line start at a cache line boundary, smaller ones never cross it.
+///
+///     let allocator = PoolAllocator<Node>()
+///     let node = allocator.allocate(count: 1)
+///     // ...
+///     allocator.deallocate(node)
+///
+/// - Note: Copies of the allocator share the same pool. The pool is released with the last copy,
+///         so all of them must outlive the allocated objects and the threads that use them.
+/// - Note: Each pool uses one thread-specific key of the system.
+public struct PoolAllocator<T> {
+    @usableFromInline internal let storage: PoolAllocatorStorage
+
+    /// Maximum `count` that can be passed to `allocate(count:)`.
+    public let slotCapacity: Count
+
+    /// Creates a new pool.
+    ///
+    /// - Parameter slotCapacity: Number of instances of `T` in one slot.
+    /// - Parameter slabSize:     Size of slabs requested from the system.
+    /// - Parameter policy:       Placement of the slabs. With huge pages the slab size should be
+    ///                           a multiple of `MemoryPolicy.hugePageSize`, each slab takes at least one page.
+    ///
+    /// - Precondition: `slabSize` must be power of two.
+    public init(slotCapacity: Count = 1, slabSize: Size = 64 * 1024, policy: MemoryPolicy = .default) {
+        let lineSize = PoolSlab.cacheLineSize
+        let slotSize = max(MemoryLayout<T>.stride * slotCapacity, MemoryLayout<UInt>.stride)
+
+        // Slots smaller than a cache line are rounded to a power of two, which divides the line, larger
+        // ones to whole lines, so no slot straddles more lines than it needs. Small slots are not padded
+        // to a full line: a 16 bytes node would take 4 times the memory.
+        let lineAlignment = slotSize < lineSize ? 1 << (Size.bitWidth - (slotSize - 1).leadingZeroBitCount) : lineSize
+        let alignment = max(MemoryLayout<T>.alignment, lineAlignment)
+
+        self.storage = PoolAllocatorStorage(
+            slotSize: (slotSize + alignment - 1) & ~(alignment - 1),
+            slabSize: slabSize,
+            policy: policy
+        )
+        self.slotCapacity = slotCapacity
+    }
+
+    /// Returns memory for `count` instances of `T`.
+    ///
+    /// - Precondition: `count` must not be greater than `slotCapacity`.
+    @inlinable
+    public func allocate(count: Count) -> UnsafeMutablePointer<T> {
+        assert(count <= self.slotCapacity, "PoolAllocator: Count must not be greater than slot capacity.")
+
+        return self.storage.cache.allocate().bindMemory(to: T.self, capacity: count)
+    }
+
+    /// Returns memory to the pool. Can be called from any thread.
+    @inlinable
+    public func deallocate(_ pointer: UnsafeMutablePointer<T>) {
+        self.storage.cache.deallocate(UnsafeMutableRawPointer(pointer))
+    }
+
+    /// Current counters of the pool.
+    public var statistics: PoolAllocatorStatistics {
+        return self.storage.statistics
+    }
+}
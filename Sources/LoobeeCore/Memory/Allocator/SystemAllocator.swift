@@ -15,6 +15,9 @@ import func Glibc.free
 
 /// Uses default `malloc` and `free`.
 public struct SystemAllocator<T> {
+    public init() {
+    }
+
     public func allocate(count: Count) -> UnsafeMutablePointer<T> {
         let pointer = malloc(MemoryLayout<T>.stride * count)
         if _slowPath(pointer == nil) {
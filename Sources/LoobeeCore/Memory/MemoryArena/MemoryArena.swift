@@ -5,14 +5,261 @@
 // For the full copyright and license information, please view the LICENSE
 // file that was distributed with this source code.
 
-internal class MemoryArenaBlock {
+/// Continuous region of memory from which the arena serves allocations.
+///
+/// Blocks are chained from the newest to the oldest one.
+@usableFromInline
+internal final class MemoryArenaBlock {
+    ///
+    @usableFromInline internal let start: UnsafeMutablePointer<UInt8>
 
+    ///
+    @usableFromInline internal let capacity: Size
+
+    /// Number of bytes used from the `start`.
+    @usableFromInline internal var offset: Size = 0
+
+    /// Block that was current before this one.
+    @usableFromInline internal let previous: MemoryArenaBlock?
+
+    @usableFromInline internal let allocator: AlignedSystemAllocator<UInt8>
+
+    /// Mapped blocks get the whole rounded size.
+    @usableFromInline
+    internal init(capacity: Size, previous: MemoryArenaBlock?, allocator: AlignedSystemAllocator<UInt8>) {
+        let capacity = allocator.policy.roundedSize(capacity)
+
+        self.start = allocator.allocate(count: capacity, alignment: MemoryArena.blockAlignment)
+        self.capacity = capacity
+        self.previous = previous
+        self.allocator = allocator
+    }
+
+    deinit {
+        self.allocator.deallocate(self.start, count: self.capacity)
+    }
+
+    /// Bumps the offset and returns the aligned address, or nil if the block has no space.
+    @inlinable
+    @inline(__always)
+    internal func allocate(size: Size, alignment: Size) -> UnsafeMutableRawPointer? {
+        let base = Address(bitPattern: self.start)
+        let aligned = (base + self.offset + alignment - 1) & ~(alignment - 1)
+        let end = aligned - base + size
+
+        guard _fastPath(end <= self.capacity) else {
+            return nil
+        }
+
+        self.offset = end
+
+        return UnsafeMutableRawPointer(bitPattern: aligned)
+    }
 }
 
 /// An arena is a collection of allocated objects that can be efficiently deallocated all at once.
-public class MemoryArena {
-//    public func allocate(size: Size) -> UnsafeRawPointer
-//    {
-//
-//    }
+///
+/// Memory is requested from `AlignedSystemAllocator` by blocks of growing size, each allocation
+/// just bumps a pointer inside the current block. Individual allocations can't be deallocated,
+/// instead all memory is released by `reset()` or by rewinding to a `Checkpoint`.
+///
+///     let arena = MemoryArena()
+///     let buffer: UnsafeMutablePointer<UInt32> = arena.allocate(count: 16)
+///     // ...
+///     arena.reset()
+///
+/// An arena of big short-lived tables can place its blocks on huge pages:
+///
+///     let arena = MemoryArena(
+///         initialBlockSize: MemoryPolicy.hugePageSize,
+///         maxBlockSize: 64 * MemoryPolicy.hugePageSize,
+///         policy: MemoryPolicy(pageSize: .transparentHuge)
+///     )
+///
+/// - Note: The arena does not call deinitializers of objects placed into the memory.
+/// - Note: The arena is not thread-safe.
+public final class MemoryArena {
+    /// Alignment of each block, equal to the cache line size.
+    @usableFromInline internal static let blockAlignment: Alignment = .custom(size: 64)
+
+    /// Position in the arena that can be restored by `rewind(to:)`.
+    @_fixed_layout
+    public struct Checkpoint {
+        @usableFromInline internal let block: MemoryArenaBlock
+        @usableFromInline internal let offset: Size
+
+        @usableFromInline
+        internal init(block: MemoryArenaBlock, offset: Size) {
+            self.block = block
+            self.offset = offset
+        }
+    }
+
+    /// Size of the first block.
+    public let initialBlockSize: Size
+
+    /// The size limit up to which the blocks are grown.
+    public let maxBlockSize: Size
+
+    /// Placement of the blocks.
+    public let policy: MemoryPolicy
+
+    /// The first block, is never released until the arena is alive.
+    @usableFromInline internal let firstBlock: MemoryArenaBlock
+
+    /// The block from which memory is currently served.
+    @usableFromInline internal var currentBlock: MemoryArenaBlock
+
+    /// Creates a new arena.
+    ///
+    /// - Parameter initialBlockSize: Size of the first block.
+    /// - Parameter maxBlockSize:     Each next block is twice the size of the previous one up to this limit.
+    /// - Parameter policy:           Placement of the blocks. Sizes of mapped blocks are rounded up
+    ///                               to the page size.
+    ///
+    /// - Precondition: `initialBlockSize` must be greater than 0 and not greater than `maxBlockSize`.
+    public init(initialBlockSize: Size = 4096, maxBlockSize: Size = 1024 * 1024, policy: MemoryPolicy = .default) {
+        assert(initialBlockSize > 0, "MemoryArena: Initial block size must be greater than 0.")
+        assert(initialBlockSize <= maxBlockSize, "MemoryArena: Initial block size must be less than maximum.")
+
+        self.initialBlockSize = initialBlockSize
+        self.maxBlockSize = maxBlockSize
+        self.policy = policy
+        self.firstBlock = MemoryArenaBlock(
+            capacity: initialBlockSize,
+            previous: nil,
+            allocator: AlignedSystemAllocator<UInt8>(policy: policy)
+        )
+        self.currentBlock = self.firstBlock
+    }
+
+    /// Total size of the blocks owned by the arena.
+    public var capacity: Size {
+        var result: Size = 0
+        var block: MemoryArenaBlock? = self.currentBlock
+        while let current = block {
+            result += current.capacity
+            block = current.previous
+        }
+
+        return result
+    }
+
+    /// Number of the blocks owned by the arena.
+    public var blockCount: Count {
+        var result: Count = 0
+        var block: MemoryArenaBlock? = self.currentBlock
+        while let current = block {
+            result += 1
+            block = current.previous
+        }
+
+        return result
+    }
+
+    /// Allocates `size` bytes with the given alignment.
+    ///
+    /// - Parameter size:      Number of bytes.
+    /// - Parameter alignment: Alignment of the returned address.
+    ///
+    /// - Returns: Pointer to the uninitialized memory, valid until `reset()` or `rewind(to:)`.
+    @inlinable
+    public func allocate(size: Size, alignment: Alignment) -> UnsafeMutableRawPointer {
+        return self.allocate(size: size, alignmentSize: alignment.size)
+    }
+
+    /// Allocates memory for `count` instances of `T` with the given alignment.
+    ///
+    /// - Parameter count:     Number of instances.
+    /// - Parameter alignment: Alignment of the returned address.
+    ///
+    /// - Returns: Pointer to the uninitialized memory, valid until `reset()` or `rewind(to:)`.
+    @inlinable
+    public func allocate<T>(count: Count, alignment: Alignment) -> UnsafeMutablePointer<T> {
+        return self.allocate(size: MemoryLayout<T>.stride * count, alignmentSize: alignment.size)
+            .bindMemory(to: T.self, capacity: count)
+    }
+
+    /// Allocates memory for `count` instances of `T` with the natural alignment of `T`.
+    ///
+    /// - Parameter count: Number of instances.
+    ///
+    /// - Returns: Pointer to the uninitialized memory, valid until `reset()` or `rewind(to:)`.
+    @inlinable
+    public func allocate<T>(count: Count) -> UnsafeMutablePointer<T> {
+        return self.allocate(size: MemoryLayout<T>.stride * count, alignmentSize: MemoryLayout<T>.alignment)
+            .bindMemory(to: T.self, capacity: count)
+    }
+
+    /// Releases all allocations. The first block is kept for reuse, all other blocks are deallocated.
+    public func reset() {
+        self.currentBlock = self.firstBlock
+        self.firstBlock.offset = 0
+    }
+
+    /// Returns the current position of the arena.
+    @inlinable
+    public func checkpoint() -> Checkpoint {
+        return Checkpoint(block: self.currentBlock, offset: self.currentBlock.offset)
+    }
+
+    /// Releases all allocations made after `checkpoint` was taken.
+    ///
+    /// - Precondition: `checkpoint` must be taken from this arena and must not be invalidated
+    ///                 by `reset()` or by rewinding to an earlier checkpoint.
+    public func rewind(to checkpoint: Checkpoint) {
+        while self.currentBlock !== checkpoint.block {
+            guard let previous = self.currentBlock.previous else {
+                fatalError("MemoryArena: Checkpoint does not belong to the arena.")
+            }
+
+            self.currentBlock = previous
+        }
+
+        self.currentBlock.offset = checkpoint.offset
+    }
+
+    /// Calls `body` and releases all allocations made inside it.
+    ///
+    ///     arena.withScope {
+    ///         let temporary: UnsafeMutablePointer<UInt8> = arena.allocate(count: 1024)
+    ///         // ...
+    ///     }
+    @inlinable
+    public func withScope<R>(_ body: () throws -> R) rethrows -> R {
+        let checkpoint = self.checkpoint()
+        defer {
+            self.rewind(to: checkpoint)
+        }
+
+        return try body()
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func allocate(size: Size, alignmentSize: Size) -> UnsafeMutableRawPointer {
+        if let pointer = self.currentBlock.allocate(size: size, alignment: alignmentSize) {
+            return pointer
+        }
+
+        return self.allocateInNewBlock(size: size, alignmentSize: alignmentSize)
+    }
+
+    @usableFromInline
+    internal func allocateInNewBlock(size: Size, alignmentSize: Size) -> UnsafeMutableRawPointer {
+        let required = size + max(alignmentSize - MemoryArena.blockAlignment.size, 0)
+        let capacity = max(min(self.currentBlock.capacity * 2, self.maxBlockSize), required)
+
+        self.currentBlock = MemoryArenaBlock(
+            capacity: capacity,
+            previous: self.currentBlock,
+            allocator: self.firstBlock.allocator
+        )
+
+        guard let pointer = self.currentBlock.allocate(size: size, alignment: alignmentSize) else {
+            fatalError("MemoryArena: Cannot allocate \(size) bytes.")
+        }
+
+        return pointer
+    }
 }
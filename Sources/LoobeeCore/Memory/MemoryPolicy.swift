@@ -0,0 +1,134 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Placement of memory requested from the system: page size, NUMA nodes and access hints.
+///
+/// The default policy uses `posix_memalign`, any other policy maps memory by `mmap`. All options
+/// are hints: if huge pages are not available or NUMA placement is not supported, memory is
+/// allocated with the system pages of the local node.
+///
+///     // A big table on huge pages of node 0, faulted in before the first access.
+///     let policy = MemoryPolicy(pageSize: .huge, placement: .node(0), isPrefaulted: true, access: .random)
+///     let allocator = AlignedSystemAllocator<UInt64>(policy: policy)
+///     let table = allocator.allocate(count: 1 << 27, alignment: .system)
+///     // ...
+///     allocator.deallocate(table, count: 1 << 27)
+///
+/// - Note: Huge pages and NUMA placement are supported on Linux only.
+public struct MemoryPolicy: Equatable {
+    /// Size of pages of the mapping.
+    public enum PageSize: Equatable {
+        /// Pages of the system, 4 KiB on x86-64.
+        case system
+
+        /// Transparent huge pages of 2 MiB, requested by `madvise(MADV_HUGEPAGE)`. The kernel
+        /// uses small pages where it has no free huge pages.
+        case transparentHuge
+
+        /// Pages of 2 MiB from the `hugetlbfs` pool reserved by the administrator (`vm.nr_hugepages`).
+        /// If the pool has no free pages, transparent huge pages are used.
+        case huge
+
+        /// Granularity of the mapping: its start and size are multiples of it.
+        public var size: Size {
+            switch self {
+            case .system:
+                return MemoryPolicy.systemPageSize
+            case .transparentHuge, .huge:
+                return MemoryPolicy.hugePageSize
+            }
+        }
+    }
+
+    /// NUMA nodes of the pages.
+    public enum Placement: Equatable {
+        /// The node of the processor that touches a page first.
+        case local
+
+        /// All pages on the node.
+        case node(Int)
+
+        /// Pages interleaved over the nodes, over all nodes if the list is empty.
+        case interleave([Int])
+    }
+
+    /// Expected order of accesses, passed to `madvise`.
+    public enum Access: Equatable {
+        case normal
+
+        /// Pages are read ahead aggressively and freed soon after the access.
+        case sequential
+
+        /// Pages are not read ahead.
+        case random
+    }
+
+    /// Size of huge pages, the default size of x86-64 and ARM64.
+    public static let hugePageSize: Size = 2 * 1024 * 1024
+
+    /// Size of pages of the system.
+    public static let systemPageSize: Size = Size(sysconf(Int32(_SC_PAGESIZE)))
+
+    /// Number of NUMA nodes of the system, 1 if it is unknown.
+    public static let nodeCount: Count = {
+        #if os(Linux)
+        return Count(CLoobeeCoreMemory_nodeCount())
+        #else
+        return 1
+        #endif
+    }()
+
+    /// `posix_memalign` with the default placement of the system.
+    public static let `default` = MemoryPolicy()
+
+    public var pageSize: PageSize
+
+    public var placement: Placement
+
+    /// Fault in all pages when memory is allocated, so the first accesses do not stall.
+    public var isPrefaulted: Bool
+
+    public var access: Access
+
+    public init(
+        pageSize: PageSize = .system,
+        placement: Placement = .local,
+        isPrefaulted: Bool = false,
+        access: Access = .normal
+    ) {
+        self.pageSize = pageSize
+        self.placement = placement
+        self.isPrefaulted = isPrefaulted
+        self.access = access
+    }
+
+    /// Whether memory is allocated by `posix_memalign` rather than mapped.
+    public var isDefault: Bool {
+        return self == MemoryPolicy.default
+    }
+
+    /// Returns the size of the memory actually reserved for `size` bytes: the size rounded up
+    /// to the page size for mapped memory. Owners of big blocks can use the whole rounded size.
+    @inlinable
+    public func roundedSize(_ size: Size) -> Size {
+        if self.isDefault {
+            return size
+        }
+
+        let pageSize = self.pageSize.size
+
+        return (size + pageSize - 1) & ~(pageSize - 1)
+    }
+}
@@ -0,0 +1,83 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+private final class NativeThreadContext {
+    let body: () -> Void
+
+    init(body: @escaping () -> Void) {
+        self.body = body
+    }
+}
+
+#if os(OSX)
+private let nativeThreadEntry: @convention(c) (UnsafeMutableRawPointer) -> UnsafeMutableRawPointer? = { context in
+    Unmanaged<NativeThreadContext>.fromOpaque(context).takeRetainedValue().body()
+    return nil
+}
+#elseif os(Linux)
+private let nativeThreadEntry: @convention(c) (UnsafeMutableRawPointer?) -> UnsafeMutableRawPointer? = { context in
+    Unmanaged<NativeThreadContext>.fromOpaque(context!).takeRetainedValue().body()
+    return nil
+}
+#endif
+
+/// Thread of the operating system, wraps `pthread_t`.
+///
+///     let thread = NativeThread {
+///         print("Hello")
+///     }
+///     thread.join()
+///
+/// - Note: Each thread must be joined.
+public final class NativeThread {
+    private let handle: pthread_t
+
+    /// Starts a new thread that executes `body`.
+    public init(_ body: @escaping () -> Void) {
+        let context = Unmanaged.passRetained(NativeThreadContext(body: body)).toOpaque()
+
+        #if os(OSX)
+        var handle: pthread_t?
+        #elseif os(Linux)
+        var handle = pthread_t()
+        #endif
+
+        let resultCode = pthread_create(&handle, nil, nativeThreadEntry, context)
+        if _slowPath(resultCode != 0) {
+            fatalError("NativeThread: Cannot create thread. Code: \(resultCode)")
+        }
+
+        #if os(OSX)
+        self.handle = handle!
+        #elseif os(Linux)
+        self.handle = handle
+        #endif
+    }
+
+    /// Blocks the current thread until this thread exits.
+    public func join() {
+        pthread_join(self.handle, nil)
+    }
+
+    /// Number of processors available to the process.
+    public static var processorCount: Count {
+        return max(Count(sysconf(Int32(_SC_NPROCESSORS_ONLN))), 1)
+    }
+
+    /// Offers the processor to other threads.
+    @inlinable
+    @inline(__always)
+    public static func yield() {
+        sched_yield()
+    }
+}
@@ -436,3 +436,32 @@ extension Atomic where T: AtomicBitwiseContract {
         _ = lhs.bitXorAndFetch(rhs.load())
     }
 }
+
+extension Atomic where T: AtomicWaitContract {
+    /// Calls the `T.atomicWait(expected:)` method.
+    ///
+    /// - SeeAlso: `AtomicWaitContract.atomicWait(expected:)`
+    @inlinable
+    @inline(__always)
+    public func wait(expected: T) {
+        self.value.atomicWait(expected: expected)
+    }
+
+    /// Calls the `T.atomicNotifyOne()` method.
+    ///
+    /// - SeeAlso: `AtomicWaitContract.atomicNotifyOne()`
+    @inlinable
+    @inline(__always)
+    public func notifyOne() {
+        self.value.atomicNotifyOne()
+    }
+
+    /// Calls the `T.atomicNotifyAll()` method.
+    ///
+    /// - SeeAlso: `AtomicWaitContract.atomicNotifyAll()`
+    @inlinable
+    @inline(__always)
+    public func notifyAll() {
+        self.value.atomicNotifyAll()
+    }
+}
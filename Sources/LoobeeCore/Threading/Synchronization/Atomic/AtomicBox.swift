@@ -6,13 +6,27 @@
 // file that was distributed with this source code.
 
 /// A box that provides atomic access to an object, maintaining the correct retain counts.
+///
+/// Replaced objects are not released immediately, but retired to the `EpochReclamation` domain,
+/// so a concurrent reader never observes a released object. `read(_:)` accesses the object
+/// without retaining it, readers do not contend on its reference count.
+///
+///     let box = AtomicBox(object: Config())
+///     let timeout = box.read { $0.timeout }    // Readers.
+///     box.store(Config())                     // Writer.
 public final class AtomicBox<T> where T: AnyObject {
     @usableFromInline
     internal var address: UInt
 
+    @usableFromInline
+    internal let reclamation: EpochReclamation
+
+    /// - Parameter object:      The initial object.
+    /// - Parameter reclamation: The domain that releases replaced objects.
     @inlinable
-    public init(object: T) {
+    public init(object: T, reclamation: EpochReclamation = .shared) {
         self.address = .init(bitPattern: Unmanaged<T>.passRetained(object).toOpaque())
+        self.reclamation = reclamation
     }
 
     @inlinable
@@ -37,7 +51,7 @@ public final class AtomicBox<T> where T: AnyObject {
         let newAddress = UInt(bitPattern: Unmanaged<T>.passRetained(object).toOpaque())
         let oldAddress = self.address.atomicExchange(newValue: newAddress, withOrder: order)
 
-        Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: oldAddress)!).release()
+        self.reclamation.retire(Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: oldAddress)!))
     }
 
     /// Atomically assign the object with the `.seqCst` memory order.
@@ -51,6 +65,8 @@ public final class AtomicBox<T> where T: AnyObject {
 
     /// Atomically obtains the object.
     ///
+    /// - Note: The returned object is retained, prefer `read(withOrder:_:)` for short accesses.
+    ///
     /// - Parameter order: Memory order constraints to enforce.
     ///
     /// - Precondition: `order` must be one of `.relaxed`, `.consume`, `.acquire` or `.seqCst`.
@@ -58,11 +74,13 @@ public final class AtomicBox<T> where T: AnyObject {
     /// - Returns: The current object.
     @inlinable
     public func load(withOrder order: AtomicOrder) -> T {
-        let address = self.address.atomicLoad(withOrder: order)
+        return self.reclamation.withCriticalSection {
+            let address = self.address.atomicLoad(withOrder: order)
 
-        return Unmanaged<T>.fromOpaque(
-            UnsafeRawPointer(bitPattern: address)!
-            ).takeUnretainedValue()
+            return Unmanaged<T>.fromOpaque(
+                UnsafeRawPointer(bitPattern: address)!
+                ).takeUnretainedValue()
+        }
     }
 
     /// Atomically obtains the object with the `.seqCst` memory order.
@@ -74,6 +92,41 @@ public final class AtomicBox<T> where T: AnyObject {
         return self.load(withOrder: .seqCst)
     }
 
+    /// Atomically obtains the object and calls `body` with it, without retaining the object.
+    ///
+    /// The object is not released until `body` returns, even if it is replaced concurrently.
+    ///
+    ///     let count = box.read(withOrder: .acquire) { $0.count }
+    ///
+    /// - Parameter order: Memory order constraints to enforce.
+    /// - Parameter body:  The closure, must not escape the object and wait for other threads.
+    ///
+    /// - Precondition: `order` must be one of `.relaxed`, `.consume`, `.acquire` or `.seqCst`.
+    ///
+    /// - Returns: The result of `body`.
+    @inlinable
+    public func read<R>(withOrder order: AtomicOrder, _ body: (T) throws -> R) rethrows -> R {
+        return try self.reclamation.withCriticalSection {
+            let address = self.address.atomicLoad(withOrder: order)
+
+            return try Unmanaged<T>.fromOpaque(
+                UnsafeRawPointer(bitPattern: address)!
+                )._withUnsafeGuaranteedRef(body)
+        }
+    }
+
+    /// Atomically obtains the object with the `.seqCst` memory order and calls `body` with it,
+    /// without retaining the object.
+    ///
+    /// - Parameter body: The closure, must not escape the object and wait for other threads.
+    ///
+    /// - Returns: The result of `body`.
+    @inlinable
+    @inline(__always)
+    public func read<R>(_ body: (T) throws -> R) rethrows -> R {
+        return try self.read(withOrder: .seqCst, body)
+    }
+
     /// Atomically assign the object of `newObject` and obtains the object held previously.
     ///
     /// - Parameter newObject: The object to assign.
@@ -84,11 +137,17 @@ public final class AtomicBox<T> where T: AnyObject {
     /// - Returns: The object before the call this method.
     @inlinable
     public func exchange(newObject: T, withOrder order: AtomicOrder) -> T {
-        let oldPointer = self.address.atomicExchange(
+        let oldAddress = self.address.atomicExchange(
             newValue: UInt(bitPattern: Unmanaged<T>.passRetained(newObject).toOpaque()),
             withOrder: order
         )
-        return Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: oldPointer)!).takeRetainedValue()
+        let oldPointer = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: oldAddress)!)
+        let oldObject = oldPointer.takeUnretainedValue()
+
+        // Readers can still access the object, so the reference of the box is retired.
+        self.reclamation.retire(oldPointer)
+
+        return oldObject
     }
 
     /// Atomically assign the object of `newObject` and obtains the object held previously.
@@ -123,28 +182,31 @@ public final class AtomicBox<T> where T: AnyObject {
         successOrder: AtomicOrder,
         failureOrder: AtomicOrder
         ) -> Bool {
-        return withExtendedLifetime(desired) {
-            let expectedPointer = Unmanaged<T>.passUnretained(expected)
-            let desiredPointer = Unmanaged<T>.passUnretained(desired)
+        // On failure `expected` is loaded from the box, the section keeps it alive until retained.
+        return self.reclamation.withCriticalSection {
+            withExtendedLifetime(desired) {
+                let expectedPointer = Unmanaged<T>.passUnretained(expected)
+                let desiredPointer = Unmanaged<T>.passUnretained(desired)
 
-            var expectedAddress = UInt(bitPattern: expectedPointer.toOpaque())
-            let desiredAddress = UInt(bitPattern: desiredPointer.toOpaque())
+                var expectedAddress = UInt(bitPattern: expectedPointer.toOpaque())
+                let desiredAddress = UInt(bitPattern: desiredPointer.toOpaque())
 
-            let result = self.address.atomicCompareAndExchangeWeak(
-                expected: &expectedAddress,
-                desired: desiredAddress,
-                successOrder: successOrder,
-                failureOrder: failureOrder
-            )
+                let result = self.address.atomicCompareAndExchangeWeak(
+                    expected: &expectedAddress,
+                    desired: desiredAddress,
+                    successOrder: successOrder,
+                    failureOrder: failureOrder
+                )
 
-            expected = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: expectedAddress)!).takeUnretainedValue()
+                expected = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: expectedAddress)!).takeUnretainedValue()
 
-            if result {
-                _ = desiredPointer.retain()
-                expectedPointer.release()
-            }
+                if result {
+                    _ = desiredPointer.retain()
+                    self.reclamation.retire(expectedPointer)
+                }
 
-            return result
+                return result
+            }
         }
     }
 
@@ -226,28 +288,31 @@ public final class AtomicBox<T> where T: AnyObject {
         successOrder: AtomicOrder,
         failureOrder: AtomicOrder
     ) -> Bool {
-        return withExtendedLifetime(desired) {
-            let expectedPointer = Unmanaged<T>.passUnretained(expected)
-            let desiredPointer = Unmanaged<T>.passUnretained(desired)
+        // On failure `expected` is loaded from the box, the section keeps it alive until retained.
+        return self.reclamation.withCriticalSection {
+            withExtendedLifetime(desired) {
+                let expectedPointer = Unmanaged<T>.passUnretained(expected)
+                let desiredPointer = Unmanaged<T>.passUnretained(desired)
 
-            var expectedAddress = UInt(bitPattern: expectedPointer.toOpaque())
-            let desiredAddress = UInt(bitPattern: desiredPointer.toOpaque())
+                var expectedAddress = UInt(bitPattern: expectedPointer.toOpaque())
+                let desiredAddress = UInt(bitPattern: desiredPointer.toOpaque())
 
-            let result = self.address.atomicCompareAndExchangeStrong(
-                expected: &expectedAddress,
-                desired: desiredAddress,
-                successOrder: successOrder,
-                failureOrder: failureOrder
-            )
+                let result = self.address.atomicCompareAndExchangeStrong(
+                    expected: &expectedAddress,
+                    desired: desiredAddress,
+                    successOrder: successOrder,
+                    failureOrder: failureOrder
+                )
 
-            expected = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: expectedAddress)!).takeUnretainedValue()
+                expected = Unmanaged<T>.fromOpaque(UnsafeRawPointer(bitPattern: expectedAddress)!).takeUnretainedValue()
 
-            if result {
-                _ = desiredPointer.retain()
-                expectedPointer.release()
-            }
+                if result {
+                    _ = desiredPointer.retain()
+                    self.reclamation.retire(expectedPointer)
+                }
 
-            return result
+                return result
+            }
         }
     }
 
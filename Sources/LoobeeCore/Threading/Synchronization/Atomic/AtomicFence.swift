@@ -0,0 +1,18 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+/// Establishes memory synchronization ordering of non-atomic and relaxed atomic accesses,
+/// as instructed by `order`, without an associated atomic operation.
+///
+/// - Parameter order: Memory order constraints to enforce.
+@inlinable
+@inline(__always)
+public func atomicThreadFence(withOrder order: AtomicOrder) {
+    CLoobeeCoreAtomicThreadFence(order: order)
+}
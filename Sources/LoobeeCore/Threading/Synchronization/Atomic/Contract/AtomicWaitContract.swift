@@ -0,0 +1,33 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Each realization allows threads to block until the atomic value is changed,
+/// using `futex` on Linux and `__ulock` on macOS.
+///
+///     // Waiter.
+///     while flag.atomicLoad(withOrder: .acquire) == 0 {
+///         flag.atomicWait(expected: 0)
+///     }
+///
+///     // Notifier.
+///     flag.atomicStore(1, withOrder: .release)
+///     flag.atomicNotifyAll()
+public protocol AtomicWaitContract {
+    /// Blocks the current thread while the value is equal to `expected`.
+    ///
+    /// Returns immediately if the value is not equal to `expected`, after a notification,
+    /// or spuriously, so the value must be checked again.
+    ///
+    /// - Parameter expected: The value to wait while it is stored.
+    mutating func atomicWait(expected: Self)
+
+    /// Wakes one thread that is blocked in `atomicWait(expected:)` on this value.
+    mutating func atomicNotifyOne()
+
+    /// Wakes all threads that are blocked in `atomicWait(expected:)` on this value.
+    mutating func atomicNotifyAll()
+}
@@ -0,0 +1,160 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import CLoobeeCore
+
+/// Pair of 64-bit words that is accessed atomically as a whole, e.g. a pointer and a tag.
+///
+/// Operations use `cmpxchg16b` if the processor supports it and the value is aligned to 16 bytes,
+/// otherwise they are serialized by a spin lock selected by the address. The choice depends only on
+/// the processor and the address, so all operations on a value use the same path.
+///
+/// - Note: A stored property of a class is aligned to 16 bytes if it is placed first.
+/// - Note: All operations are sequentially consistent regardless of the requested order.
+public typealias AtomicUInt128 = CLoobeeCoreAtomicUInt128
+
+/// Spin locks for `AtomicUInt128` values that can't be accessed by `cmpxchg16b`.
+@usableFromInline
+internal enum AtomicUInt128Fallback {
+    @usableFromInline internal static let isLockFree = Environment.current.cpuId.hasCx16()
+
+    /// Each lock is placed on its own cache line.
+    @usableFromInline internal static let lockStride = 64
+
+    @usableFromInline internal static let lockCount = 64
+
+    @usableFromInline internal static let locks: UnsafeMutablePointer<Bool> = {
+        let count = AtomicUInt128Fallback.lockCount * AtomicUInt128Fallback.lockStride
+        let locks = UnsafeMutablePointer<Bool>.allocate(capacity: count)
+        locks.initialize(repeating: false, count: count)
+
+        return locks
+    }()
+
+    @inlinable
+    internal static func withLock<R>(for pointer: UnsafeMutablePointer<AtomicUInt128>, _ body: () -> R) -> R {
+        let index = (Int(bitPattern: pointer) >> 4) & (AtomicUInt128Fallback.lockCount - 1)
+        let lock = AtomicUInt128Fallback.locks + index * AtomicUInt128Fallback.lockStride
+
+        while lock.pointee.atomicExchange(newValue: true, withOrder: .acquire) {
+            while lock.pointee.atomicLoad(withOrder: .relaxed) {
+                NativeThread.yield()
+            }
+        }
+        defer {
+            lock.pointee.atomicStore(false, withOrder: .release)
+        }
+
+        return body()
+    }
+}
+
+extension AtomicUInt128 {
+    /// Creates the pair of the pointer and the tag.
+    @inlinable
+    public init(pointer: UnsafeMutableRawPointer?, tag: UInt64) {
+        self.init(low: UInt64(UInt(bitPattern: pointer)), high: tag)
+    }
+
+    /// The low word as a pointer.
+    @inlinable
+    public var pointer: UnsafeMutableRawPointer? {
+        return UnsafeMutableRawPointer(bitPattern: UInt(truncatingIfNeeded: self.low))
+    }
+
+    /// The high word.
+    @inlinable
+    public var tag: UInt64 {
+        return self.high
+    }
+
+    /// Sequentially consistent compare and exchange, used by all operations.
+    @inlinable
+    @inline(__always)
+    internal static func compareAndExchange(
+        _ pointer: UnsafeMutablePointer<AtomicUInt128>,
+        expected: inout AtomicUInt128,
+        desired: AtomicUInt128
+    ) -> Bool {
+        if _fastPath(AtomicUInt128Fallback.isLockFree && Int(bitPattern: pointer) & 15 == 0) {
+            return CLoobeeCoreAtomicUInt128_compareExchange(pointer, expected: &expected, desired: desired)
+        }
+
+        return AtomicUInt128Fallback.withLock(for: pointer) {
+            if pointer.pointee == expected {
+                pointer.pointee = desired
+                return true
+            }
+
+            expected = pointer.pointee
+            return false
+        }
+    }
+}
+
+extension AtomicUInt128: Equatable {
+    @inlinable
+    public static func == (lhs: AtomicUInt128, rhs: AtomicUInt128) -> Bool {
+        return lhs.low == rhs.low && lhs.high == rhs.high
+    }
+}
+
+extension AtomicUInt128: AtomicContract {
+    @inlinable
+    @inline(__always)
+    public static func isAlwaysLockFree() -> Bool {
+        return AtomicUInt128Fallback.isLockFree
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicStore(_ value: AtomicUInt128, withOrder order: AtomicOrder) {
+        _ = self.atomicExchange(newValue: value, withOrder: order)
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicLoad(withOrder order: AtomicOrder) -> AtomicUInt128 {
+        // Exchanges the value with itself, `cmpxchg16b` is the only atomic 16-byte load.
+        var expected = AtomicUInt128()
+        _ = AtomicUInt128.compareAndExchange(&self, expected: &expected, desired: expected)
+
+        return expected
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicExchange(newValue: AtomicUInt128, withOrder order: AtomicOrder) -> AtomicUInt128 {
+        var expected = AtomicUInt128()
+        while !AtomicUInt128.compareAndExchange(&self, expected: &expected, desired: newValue) {
+        }
+
+        return expected
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicCompareAndExchangeWeak(
+        expected: inout AtomicUInt128,
+        desired: AtomicUInt128,
+        successOrder: AtomicOrder,
+        failureOrder: AtomicOrder
+        ) -> Bool {
+        return AtomicUInt128.compareAndExchange(&self, expected: &expected, desired: desired)
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicCompareAndExchangeStrong(
+        expected: inout AtomicUInt128,
+        desired: AtomicUInt128,
+        successOrder: AtomicOrder,
+        failureOrder: AtomicOrder
+        ) -> Bool {
+        return AtomicUInt128.compareAndExchange(&self, expected: &expected, desired: desired)
+    }
+}
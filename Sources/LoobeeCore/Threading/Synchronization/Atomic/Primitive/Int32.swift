@@ -130,3 +130,23 @@ extension Int32: AtomicBitwiseContract {
         return CLoobeeCoreAtomicInt32_bitXorAndFetch(&self, op: value, order: order)
     }
 }
+
+extension Int32: AtomicWaitContract {
+    @inlinable
+    @inline(__always)
+    public mutating func atomicWait(expected: Int32) {
+        CLoobeeCoreAtomicInt32_wait(&self, expected: expected)
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicNotifyOne() {
+        CLoobeeCoreAtomicInt32_notify(&self, all: false)
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicNotifyAll() {
+        CLoobeeCoreAtomicInt32_notify(&self, all: true)
+    }
+}
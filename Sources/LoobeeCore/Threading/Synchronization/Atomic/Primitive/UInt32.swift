@@ -130,3 +130,23 @@ extension UInt32: AtomicBitwiseContract {
         return CLoobeeCoreAtomicUInt32_bitXorAndFetch(&self, op: value, order: order)
     }
 }
+
+extension UInt32: AtomicWaitContract {
+    @inlinable
+    @inline(__always)
+    public mutating func atomicWait(expected: UInt32) {
+        CLoobeeCoreAtomicUInt32_wait(&self, expected: expected)
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicNotifyOne() {
+        CLoobeeCoreAtomicUInt32_notify(&self, all: false)
+    }
+
+    @inlinable
+    @inline(__always)
+    public mutating func atomicNotifyAll() {
+        CLoobeeCoreAtomicUInt32_notify(&self, all: true)
+    }
+}
@@ -0,0 +1,57 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Condition variable, wraps `pthread_cond_t`.
+public final class Condition {
+    @usableFromInline
+    internal let handle: UnsafeMutablePointer<pthread_cond_t>
+
+    public init() {
+        self.handle = .allocate(capacity: 1)
+
+        let resultCode = pthread_cond_init(self.handle, nil)
+        if _slowPath(resultCode != 0) {
+            fatalError("Condition: Cannot initialize condition. Code: \(resultCode)")
+        }
+    }
+
+    deinit {
+        pthread_cond_destroy(self.handle)
+        self.handle.deallocate()
+    }
+
+    /// Atomically releases `mutex` and blocks the current thread until the condition is signaled.
+    /// The mutex is acquired again before return.
+    ///
+    /// - Note: Spurious wakeups are possible, the predicate must be checked in a loop.
+    /// - Precondition: `mutex` must be held by the current thread.
+    @inlinable
+    @inline(__always)
+    public func wait(_ mutex: Mutex) {
+        pthread_cond_wait(self.handle, mutex.handle)
+    }
+
+    /// Unblocks at least one of the waiting threads.
+    @inlinable
+    @inline(__always)
+    public func signal() {
+        pthread_cond_signal(self.handle)
+    }
+
+    /// Unblocks all waiting threads.
+    @inlinable
+    @inline(__always)
+    public func broadcast() {
+        pthread_cond_broadcast(self.handle)
+    }
+}
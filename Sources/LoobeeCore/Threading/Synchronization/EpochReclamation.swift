@@ -0,0 +1,260 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Objects retired by a thread in one epoch.
+internal struct EpochReclamationBucket {
+    internal var epoch: UInt = 0
+    internal var addresses: [UInt] = []
+
+    /// Releases the objects.
+    ///
+    /// - Note: Deinitializers of the objects can retire other objects, so the caller must not
+    ///         hold the lock or access the storage of the addresses.
+    internal static func release(_ addresses: [UInt]) {
+        for address in addresses {
+            Unmanaged<AnyObject>.fromOpaque(UnsafeRawPointer(bitPattern: address)!).release()
+        }
+    }
+}
+
+/// State of a thread registered in `EpochReclamation`.
+@usableFromInline
+internal final class EpochReclamationRecord: ThreadSpecificValue {
+    /// Epoch observed by the thread inside a critical section, 0 outside. Read by other threads.
+    @usableFromInline internal var epoch: UInt = 0
+
+    /// Nesting depth of critical sections, used only by the owning thread.
+    @usableFromInline internal var depth: Int = 0
+
+    /// Retired objects indexed by `epoch % 3`, used only by the owning thread.
+    internal var buckets = [EpochReclamationBucket](repeating: EpochReclamationBucket(), count: 3)
+    internal var retiredCount: Int = 0
+
+    internal unowned(unsafe) let domain: EpochReclamation
+
+    internal init(domain: EpochReclamation) {
+        self.domain = domain
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func enter(globalEpoch: UnsafeMutablePointer<UInt>) {
+        if self.depth == 0 {
+            self.epoch.atomicStore(globalEpoch.pointee.atomicLoad(withOrder: .relaxed), withOrder: .relaxed)
+            // Orders the announcement before the loads of shared objects, pairs with `tryAdvance()`.
+            atomicThreadFence(withOrder: .seqCst)
+        }
+        self.depth += 1
+    }
+
+    @inlinable
+    @inline(__always)
+    internal func leave() {
+        self.depth -= 1
+        if self.depth == 0 {
+            self.epoch.atomicStore(0, withOrder: .release)
+        }
+    }
+
+    internal func retire(_ address: UInt, epoch: UInt) {
+        let index = Int(epoch % 3)
+        self.retiredCount += 1
+
+        if self.buckets[index].epoch == epoch {
+            self.buckets[index].addresses.append(address)
+            return
+        }
+
+        // The bucket holds objects of the epoch `epoch - 3` or older.
+        let addresses = self.buckets[index].addresses
+        self.buckets[index] = EpochReclamationBucket(epoch: epoch, addresses: [address])
+        self.retiredCount -= addresses.count
+
+        EpochReclamationBucket.release(addresses)
+    }
+
+    /// Releases objects retired two or more epochs before `globalEpoch`.
+    internal func reclaim(globalEpoch: UInt) {
+        var addresses: [UInt] = []
+        for index in 0..<self.buckets.count where self.buckets[index].epoch + 2 <= globalEpoch {
+            addresses.append(contentsOf: self.buckets[index].addresses)
+            self.buckets[index].addresses = []
+        }
+        self.retiredCount -= addresses.count
+
+        EpochReclamationBucket.release(addresses)
+    }
+
+    internal override func threadWillExit() {
+        self.domain.abandon(self)
+    }
+}
+
+/// Epoch-based reclamation of objects shared between threads.
+///
+/// Readers access shared objects inside `withCriticalSection(_:)` without retaining them.
+/// Entering a critical section announces the global epoch with a plain store and a fence,
+/// so readers do not execute read-modify-write operations and do not write shared cache lines.
+/// A writer unlinks the object from the shared structure and passes it to `retire(_:)`;
+/// the object is released when every thread has left the critical sections that could
+/// observe it, i.e. the global epoch has advanced twice since the retirement.
+///
+///     let domain = EpochReclamation.shared
+///     domain.withCriticalSection {
+///         // Objects loaded here are not released until the section ends.
+///     }
+///     domain.retire(Unmanaged.passRetained(object))
+///
+/// [Details](https://www.cl.cam.ac.uk/techreports/UCAM-CL-TR-579.pdf)
+///
+/// - Note: A thread that stays in a critical section blocks the reclamation of all threads.
+public final class EpochReclamation {
+    /// Domain used by `AtomicBox` by default.
+    public static let shared = EpochReclamation()
+
+    /// Number of retired objects of a thread after which it tries to advance the epoch.
+    internal static let reclaimThreshold = 64
+
+    /// Global epoch, starts from 1, so 0 means "quiescent" in records.
+    @usableFromInline internal let globalEpoch: UnsafeMutablePointer<UInt>
+
+    @usableFromInline internal let threadRecord = ThreadSpecific<EpochReclamationRecord>()
+
+    private let mutex = Mutex()
+
+    // Guarded by `mutex`.
+    private var records: [EpochReclamationRecord] = []
+    private var abandonedBuckets: [EpochReclamationBucket] = []
+
+    public init() {
+        let count = 64 / MemoryLayout<UInt>.stride
+
+        self.globalEpoch = AlignedSystemAllocator<UInt>().allocate(count: count, alignment: .custom(size: 64))
+        self.globalEpoch.initialize(repeating: 0, count: count)
+        self.globalEpoch.pointee = 1
+    }
+
+    deinit {
+        for bucket in self.records.flatMap({ $0.buckets }) + self.abandonedBuckets {
+            EpochReclamationBucket.release(bucket.addresses)
+        }
+
+        AlignedSystemAllocator<UInt>().deallocate(self.globalEpoch)
+    }
+
+    /// Calls `body` in a critical section. Objects retired by any thread are not released
+    /// until the section ends. Sections can be nested.
+    ///
+    /// - Note: `body` must not wait for other threads to reclaim objects.
+    @inlinable
+    public func withCriticalSection<R>(_ body: () throws -> R) rethrows -> R {
+        let record = self.record
+        record._withUnsafeGuaranteedRef { $0.enter(globalEpoch: self.globalEpoch) }
+        defer {
+            record._withUnsafeGuaranteedRef { $0.leave() }
+        }
+
+        return try body()
+    }
+
+    /// Releases the object when no thread can access it.
+    ///
+    /// - Parameter object: The object unlinked from shared structures, the reference is consumed.
+    public func retire<T>(_ object: Unmanaged<T>) where T: AnyObject {
+        let record = self.record.takeUnretainedValue()
+        let epoch = self.globalEpoch.pointee.atomicLoad(withOrder: .seqCst)
+
+        record.retire(UInt(bitPattern: object.toOpaque()), epoch: epoch)
+
+        if record.retiredCount >= EpochReclamation.reclaimThreshold {
+            self.tryAdvance()
+            record.reclaim(globalEpoch: self.globalEpoch.pointee.atomicLoad(withOrder: .acquire))
+        }
+    }
+
+    /// Advances the epoch as far as readers allow and releases the objects retired
+    /// by the current thread that are no longer accessible.
+    public func reclaim() {
+        self.tryAdvance()
+        self.tryAdvance()
+
+        let record = self.record.takeUnretainedValue()
+        record.reclaim(globalEpoch: self.globalEpoch.pointee.atomicLoad(withOrder: .acquire))
+    }
+
+    /// Number of objects retired by the current thread and not yet released.
+    internal var retiredCount: Int {
+        return self.record.takeUnretainedValue().retiredCount
+    }
+
+    @inlinable
+    @inline(__always)
+    internal var record: Unmanaged<EpochReclamationRecord> {
+        if let record = self.threadRecord.unmanagedValue {
+            return record
+        }
+
+        return self.createRecord()
+    }
+
+    @usableFromInline
+    internal func createRecord() -> Unmanaged<EpochReclamationRecord> {
+        let record = EpochReclamationRecord(domain: self)
+        self.mutex.synchronized {
+            self.records.append(record)
+        }
+        self.threadRecord.value = record
+
+        return Unmanaged.passUnretained(record)
+    }
+
+    /// Increments the global epoch if all threads in critical sections have observed it.
+    internal func tryAdvance() {
+        let buckets = self.mutex.synchronized { () -> [EpochReclamationBucket] in
+            let epoch = self.globalEpoch.pointee.atomicLoad(withOrder: .seqCst)
+            for record in self.records {
+                let recordEpoch = record.epoch.atomicLoad(withOrder: .seqCst)
+                if recordEpoch != 0 && recordEpoch != epoch {
+                    return []
+                }
+            }
+
+            var current = epoch
+            if self.globalEpoch.pointee.atomicCompareAndExchangeStrong(
+                expected: &current,
+                desired: epoch + 1,
+                successOrder: .seqCst,
+                failureOrder: .relaxed
+            ) {
+                current = epoch + 1
+            }
+
+            let reclaimable = self.abandonedBuckets.filter { $0.epoch + 2 <= current }
+            self.abandonedBuckets.removeAll { $0.epoch + 2 <= current }
+
+            return reclaimable
+        }
+
+        // Outside of the lock, as deinitializers can retire objects.
+        for bucket in buckets {
+            EpochReclamationBucket.release(bucket.addresses)
+        }
+    }
+
+    /// Passes objects retired by the exiting thread to the domain.
+    internal func abandon(_ record: EpochReclamationRecord) {
+        self.mutex.synchronized {
+            for bucket in record.buckets where !bucket.addresses.isEmpty {
+                self.abandonedBuckets.append(bucket)
+            }
+
+            if let index = self.records.firstIndex(where: { $0 === record }) {
+                self.records.remove(at: index)
+            }
+        }
+    }
+}
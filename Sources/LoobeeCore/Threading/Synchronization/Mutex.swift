@@ -0,0 +1,69 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Mutual exclusion lock, wraps `pthread_mutex_t`.
+public final class Mutex {
+    @usableFromInline
+    internal let handle: UnsafeMutablePointer<pthread_mutex_t>
+
+    public init() {
+        self.handle = .allocate(capacity: 1)
+
+        let resultCode = pthread_mutex_init(self.handle, nil)
+        if _slowPath(resultCode != 0) {
+            fatalError("Mutex: Cannot initialize mutex. Code: \(resultCode)")
+        }
+    }
+
+    deinit {
+        pthread_mutex_destroy(self.handle)
+        self.handle.deallocate()
+    }
+
+    /// Blocks the current thread until the lock is acquired.
+    @inlinable
+    @inline(__always)
+    public func lock() {
+        pthread_mutex_lock(self.handle)
+    }
+
+    /// Acquires the lock if it is not held by another thread.
+    ///
+    /// - Returns: `true` if the lock was acquired, `false` otherwise.
+    @inlinable
+    @inline(__always)
+    public func tryLock() -> Bool {
+        return pthread_mutex_trylock(self.handle) == 0
+    }
+
+    /// Releases the lock.
+    ///
+    /// - Precondition: The lock must be held by the current thread.
+    @inlinable
+    @inline(__always)
+    public func unlock() {
+        pthread_mutex_unlock(self.handle)
+    }
+
+    /// Calls `body` while holding the lock.
+    @inlinable
+    @inline(__always)
+    public func synchronized<R>(_ body: () throws -> R) rethrows -> R {
+        self.lock()
+        defer {
+            self.unlock()
+        }
+
+        return try body()
+    }
+}
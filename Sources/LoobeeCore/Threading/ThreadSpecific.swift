@@ -0,0 +1,78 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Base class for values of `ThreadSpecific` storage.
+@usableFromInline
+internal class ThreadSpecificValue {
+    /// Called on the owning thread when it exits.
+    internal func threadWillExit() {
+    }
+}
+
+#if os(OSX)
+private let threadSpecificDestructor: @convention(c) (UnsafeMutableRawPointer) -> Void = { pointer in
+    Unmanaged<ThreadSpecificValue>.fromOpaque(pointer).takeUnretainedValue().threadWillExit()
+}
+#elseif os(Linux)
+private let threadSpecificDestructor: @convention(c) (UnsafeMutableRawPointer?) -> Void = { pointer in
+    Unmanaged<ThreadSpecificValue>.fromOpaque(pointer!).takeUnretainedValue().threadWillExit()
+}
+#endif
+
+/// Slot of thread-specific storage, wraps `pthread_key_t`.
+///
+/// Values are stored unretained, the owner of the slot is responsible for their lifetime.
+/// When a thread exits, `threadWillExit()` is called on its value.
+///
+/// - Note: After the slot is destroyed, `threadWillExit()` is no longer called.
+@usableFromInline
+internal final class ThreadSpecific<T: ThreadSpecificValue> {
+    private var key = pthread_key_t()
+
+    @usableFromInline
+    internal init() {
+        let resultCode = pthread_key_create(&self.key, threadSpecificDestructor)
+        if _slowPath(resultCode != 0) {
+            fatalError("ThreadSpecific: Cannot create key. Code: \(resultCode)")
+        }
+    }
+
+    deinit {
+        pthread_key_delete(self.key)
+    }
+
+    /// Value of the current thread.
+    @usableFromInline
+    internal var value: T? {
+        @inline(__always)
+        get {
+            guard let pointer = pthread_getspecific(self.key) else {
+                return nil
+            }
+
+            return Unmanaged<T>.fromOpaque(pointer).takeUnretainedValue()
+        }
+        set {
+            pthread_setspecific(self.key, newValue.map { Unmanaged.passUnretained($0).toOpaque() })
+        }
+    }
+
+    /// Value of the current thread, without retain and release of the value on the hot path.
+    @usableFromInline
+    internal var unmanagedValue: Unmanaged<T>? {
+        @inline(__always)
+        get {
+            return pthread_getspecific(self.key).map { Unmanaged<T>.fromOpaque($0) }
+        }
+    }
+}
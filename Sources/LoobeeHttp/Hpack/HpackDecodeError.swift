@@ -0,0 +1,28 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Reason of rejection of a HPACK header block.
+///
+/// All errors break the state of the dynamic table, so the connection must be closed
+/// with COMPRESSION_ERROR, except `headerListTooLarge` and `tooManyHeaders` that are reported
+/// after the whole block is processed.
+public enum HpackDecodeError: Equatable {
+    /// The block ends inside of a representation.
+    case truncated
+    /// An integer is longer than the decoder supports.
+    case invalidInteger
+    /// An index is 0 or is out of the static and dynamic tables.
+    case invalidIndex
+    /// A Huffman-encoded string contains EOS, an incomplete code or invalid padding.
+    case invalidHuffmanCode
+    /// A dynamic table size update exceeds the limit or follows a header field.
+    case invalidTableSizeUpdate
+    /// The size of the header list exceeds the limit.
+    case headerListTooLarge
+    /// The number of headers exceeds the limit.
+    case tooManyHeaders
+}
@@ -0,0 +1,334 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Decoder of HPACK header blocks ([RFC7541](https://tools.ietf.org/html/rfc7541)) for HTTP/2.
+///
+/// Decoded fields are not `String`s: literals that are not Huffman-encoded refer to the block,
+/// entries of the static table refer to static memory, and Huffman-decoded strings and entries
+/// of the dynamic table are placed into an arena that is reused by each block.
+///
+///     let decoder = HpackDecoder()
+///     if let error = decoder.decode(block) {
+///         // Close the connection with COMPRESSION_ERROR.
+///     }
+///     for header in decoder.headers {
+///         let name = String(decoding: header.name, as: UTF8.self)
+///     }
+///
+/// The size of the header list is counted as `HttpHeaderSize.raw`, that includes fields referenced
+/// by indices, so a small block that repeats a large entry of the dynamic table (header bomb)
+/// is rejected by `maxHeaderListSize` before the entries are copied.
+///
+/// - Note: The decoder is not thread-safe.
+public final class HpackDecoder {
+    /// The limit of the size of the header list, in bytes of `HttpHeaderSize.raw`.
+    public let maxHeaderListSize: Int
+
+    /// The limit of the number of headers in a block.
+    public let maxHeaderCount: Int
+
+    /// Headers of the last block in the order of the block.
+    public private(set) var headers: [HpackHeaderField] = []
+
+    /// Sizes of the last block.
+    public private(set) var headerSize: HttpHeaderSize = (raw: 0, compressed: 0)
+
+    /// The limit of dynamic table size updates, the value of SETTINGS_HEADER_TABLE_SIZE.
+    public var tableSizeLimit: Int {
+        return self.table.capacity
+    }
+
+    /// The current maximum size of the dynamic table.
+    public var maxTableSize: Int {
+        return self.table.maxSize
+    }
+
+    private let table: HpackDynamicTable
+    private let arena: MemoryArena
+
+    /// Space for a name of the dynamic table, the names are never longer than the table.
+    private let scratch: UnsafeMutablePointer<UInt8>
+
+    /// Size of the header list of the current block.
+    private var headerListSize = 0
+
+    /// Error of a limit, after it the rest of the block is processed only to update the dynamic table.
+    private var limitError: HpackDecodeError?
+
+    /// - Parameter tableSizeLimit:    The limit of the dynamic table, the value of SETTINGS_HEADER_TABLE_SIZE.
+    /// - Parameter maxHeaderListSize: The limit of the header list, the value of SETTINGS_MAX_HEADER_LIST_SIZE.
+    /// - Parameter maxHeaderCount:    The limit of the number of headers in a block.
+    public init(tableSizeLimit: Int = 4096, maxHeaderListSize: Int = 16 * 1024, maxHeaderCount: Int = 100) {
+        self.table = HpackDynamicTable(capacity: tableSizeLimit, isIndexed: false)
+        self.arena = MemoryArena(initialBlockSize: 4096)
+        self.scratch = UnsafeMutablePointer<UInt8>.allocate(capacity: max(tableSizeLimit, 1))
+        self.maxHeaderListSize = maxHeaderListSize
+        self.maxHeaderCount = maxHeaderCount
+        self.headers.reserveCapacity(32)
+    }
+
+    deinit {
+        self.scratch.deallocate()
+    }
+
+    /// Decodes the block, the headers are available in `headers`.
+    ///
+    /// - Parameter block: The complete header block (HEADERS frame and its CONTINUATION frames).
+    ///                    Must not be changed until the headers are used.
+    ///
+    /// - Returns: nil on success.
+    public func decode(_ block: UnsafeRawBufferPointer) -> HpackDecodeError? {
+        self.headers.removeAll(keepingCapacity: true)
+        self.arena.reset()
+        self.headerListSize = 0
+        self.limitError = nil
+        defer {
+            self.headerSize = (raw: UInt(self.headerListSize), compressed: UInt(block.count))
+        }
+
+        var offset = 0
+        var isTableSizeUpdateAllowed = true
+        while offset < block.count {
+            let byte = block[offset]
+            var error: HpackDecodeError?
+
+            if byte & 0x80 != 0 {
+                error = self.decodeIndexedField(block, &offset)
+            } else if byte & 0xC0 == 0x40 {
+                error = self.decodeLiteralField(block, &offset, prefixBits: 6, isIndexed: true)
+            } else if byte & 0xE0 == 0x20 {
+                error = isTableSizeUpdateAllowed
+                    ? self.decodeTableSizeUpdate(block, &offset)
+                    : .invalidTableSizeUpdate
+            } else {
+                error = self.decodeLiteralField(block, &offset, prefixBits: 4, isIndexed: false)
+            }
+
+            if error != nil {
+                return error
+            }
+            isTableSizeUpdateAllowed = isTableSizeUpdateAllowed && byte & 0xE0 == 0x20
+        }
+
+        return self.limitError
+    }
+
+    /// Indexed header field (RFC7541 6.1).
+    private func decodeIndexedField(_ block: UnsafeRawBufferPointer, _ offset: inout Int) -> HpackDecodeError? {
+        var index = 0
+        if let error = HpackDecoder.decodeInteger(block, &offset, prefixBits: 7, &index) {
+            return error
+        }
+
+        if index >= 1 && index <= HpackStaticTable.count {
+            let name = HpackStaticTable.name(at: index)
+            let value = HpackStaticTable.value(at: index)
+            if self.reserve(name.count + value.count + HpackDynamicTable.entryOverhead) {
+                self.storeField(name: name, value: value)
+            }
+
+            return nil
+        }
+
+        guard let entry = self.dynamicEntry(at: index) else {
+            return .invalidIndex
+        }
+
+        // Checked before the copy, so repeated references to large entries do not allocate.
+        if !self.reserve(entry.size) {
+            return nil
+        }
+
+        let name: UnsafeMutablePointer<UInt8> = self.arena.allocate(count: entry.nameCount)
+        let value: UnsafeMutablePointer<UInt8> = self.arena.allocate(count: entry.valueCount)
+        self.table.copyName(of: entry, to: name)
+        self.table.copyValue(of: entry, to: value)
+        self.storeField(
+            name: UnsafeRawBufferPointer(start: name, count: entry.nameCount),
+            value: UnsafeRawBufferPointer(start: value, count: entry.valueCount)
+        )
+
+        return nil
+    }
+
+    /// Literal header field with incremental indexing, without indexing or never indexed (RFC7541 6.2).
+    private func decodeLiteralField(
+        _ block: UnsafeRawBufferPointer,
+        _ offset: inout Int,
+        prefixBits: Int,
+        isIndexed: Bool
+    ) -> HpackDecodeError? {
+        let isSensitive = !isIndexed && block[offset] & 0x10 != 0
+
+        var nameIndex = 0
+        if let error = HpackDecoder.decodeInteger(block, &offset, prefixBits: prefixBits, &nameIndex) {
+            return error
+        }
+
+        var name = UnsafeRawBufferPointer(start: nil, count: 0)
+        var nameEntry: HpackDynamicTable.Entry?
+        if nameIndex == 0 {
+            if let error = self.decodeString(block, &offset, &name) {
+                return error
+            }
+        } else if nameIndex <= HpackStaticTable.count {
+            name = HpackStaticTable.name(at: nameIndex)
+        } else if let entry = self.dynamicEntry(at: nameIndex) {
+            nameEntry = entry
+        } else {
+            return .invalidIndex
+        }
+
+        var value = UnsafeRawBufferPointer(start: nil, count: 0)
+        if let error = self.decodeString(block, &offset, &value) {
+            return error
+        }
+
+        let nameCount = nameEntry?.nameCount ?? name.count
+        let isStored = self.reserve(nameCount + value.count + HpackDynamicTable.entryOverhead)
+
+        if let entry = nameEntry, isStored || isIndexed {
+            // Names of fields that are not stored are only inserted into the table, so they are copied
+            // to the scratch buffer instead of the arena.
+            let destination: UnsafeMutablePointer<UInt8> = isStored
+                ? self.arena.allocate(count: entry.nameCount)
+                : self.scratch
+            self.table.copyName(of: entry, to: destination)
+            name = UnsafeRawBufferPointer(start: destination, count: entry.nameCount)
+        }
+
+        if isIndexed {
+            self.table.insert(name: name, value: value)
+        }
+        if isStored {
+            self.storeField(name: name, value: value, isSensitive: isSensitive)
+        }
+
+        return nil
+    }
+
+    /// Dynamic table size update (RFC7541 6.3).
+    private func decodeTableSizeUpdate(_ block: UnsafeRawBufferPointer, _ offset: inout Int) -> HpackDecodeError? {
+        var size = 0
+        if let error = HpackDecoder.decodeInteger(block, &offset, prefixBits: 5, &size) {
+            return error
+        }
+        guard size <= self.table.capacity else {
+            return .invalidTableSizeUpdate
+        }
+
+        self.table.setMaxSize(size)
+
+        return nil
+    }
+
+    /// Integer with a prefix of `prefixBits` bits (RFC7541 5.1), values are limited by 2^35.
+    @inline(__always)
+    private static func decodeInteger(
+        _ block: UnsafeRawBufferPointer,
+        _ offset: inout Int,
+        prefixBits: Int,
+        _ value: inout Int
+    ) -> HpackDecodeError? {
+        let mask = (1 << prefixBits) - 1
+        value = Int(block[offset]) & mask
+        offset += 1
+        if value < mask {
+            return nil
+        }
+
+        var shift = 0
+        while true {
+            guard offset < block.count else {
+                return .truncated
+            }
+
+            let byte = Int(block[offset])
+            offset += 1
+            value += (byte & 0x7F) << shift
+            if byte & 0x80 == 0 {
+                return nil
+            }
+
+            shift += 7
+            if shift > 28 {
+                return .invalidInteger
+            }
+        }
+    }
+
+    /// String literal (RFC7541 5.2), Huffman-encoded strings are decoded into the arena.
+    private func decodeString(
+        _ block: UnsafeRawBufferPointer,
+        _ offset: inout Int,
+        _ string: inout UnsafeRawBufferPointer
+    ) -> HpackDecodeError? {
+        guard offset < block.count else {
+            return .truncated
+        }
+
+        let isHuffmanEncoded = block[offset] & 0x80 != 0
+        var count = 0
+        if let error = HpackDecoder.decodeInteger(block, &offset, prefixBits: 7, &count) {
+            return error
+        }
+        guard count <= block.count - offset else {
+            return .truncated
+        }
+
+        let bytes = UnsafeRawBufferPointer(rebasing: block[offset..<(offset + count)])
+        offset += count
+
+        if !isHuffmanEncoded || count == 0 {
+            string = bytes
+            return nil
+        }
+
+        let output: UnsafeMutablePointer<UInt8> = self.arena.allocate(count: HpackHuffman.maxDecodedCount(count))
+        guard let decodedCount = HpackHuffman.decode(bytes, into: output) else {
+            return .invalidHuffmanCode
+        }
+
+        string = UnsafeRawBufferPointer(start: output, count: decodedCount)
+
+        return nil
+    }
+
+    /// Returns the entry of the dynamic table by the index in the address space of both tables.
+    @inline(__always)
+    private func dynamicEntry(at index: Int) -> HpackDynamicTable.Entry? {
+        let dynamicIndex = index - HpackStaticTable.count - 1
+        guard dynamicIndex >= 0 && dynamicIndex < self.table.count else {
+            return nil
+        }
+
+        return self.table.entry(at: dynamicIndex)
+    }
+
+    /// Adds the size of a field to the size of the header list, returns false if the field
+    /// must not be stored because of the limits.
+    private func reserve(_ fieldSize: Int) -> Bool {
+        self.headerListSize += fieldSize
+
+        if self.limitError == nil {
+            if self.headerListSize > self.maxHeaderListSize {
+                self.limitError = .headerListTooLarge
+            } else if self.headers.count == self.maxHeaderCount {
+                self.limitError = .tooManyHeaders
+            }
+        }
+
+        return self.limitError == nil
+    }
+
+    @inline(__always)
+    private func storeField(name: UnsafeRawBufferPointer, value: UnsafeRawBufferPointer, isSensitive: Bool = false) {
+        self.headers.append(HpackHeaderField(name: name, value: value, isSensitive: isSensitive))
+    }
+}
@@ -0,0 +1,238 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// The dynamic table, [RFC7541 2.3.2](https://tools.ietf.org/html/rfc7541#section-2.3.2).
+///
+/// Names and values are stored one after another in a preallocated ring of bytes, and the entries
+/// in a ring of descriptors. The bytes of the entries are always less than the maximum size
+/// of the table, so an insertion never reallocates: it evicts the oldest entries until the new one
+/// fits by the size, and the new bytes can only overwrite the evicted ones.
+internal final class HpackDynamicTable {
+    /// The size of an entry is the length of its name and value plus this overhead (RFC7541 4.1).
+    internal static let entryOverhead = 32
+
+    /// Descriptor of an entry.
+    internal struct Entry {
+        /// Offset of the name in the ring of bytes, the value follows the name.
+        internal let offset: Int
+        internal let nameCount: Int
+        internal let valueCount: Int
+        internal let nameHash: UInt64
+        internal let fieldHash: UInt64
+
+        internal var size: Int {
+            return self.nameCount + self.valueCount + HpackDynamicTable.entryOverhead
+        }
+    }
+
+    /// The limit of `maxSize`, the table never allocates more bytes.
+    internal let capacity: Int
+
+    /// The current maximum size.
+    internal private(set) var maxSize: Int
+
+    /// The sum of the sizes of the entries.
+    internal private(set) var size = 0
+
+    /// The number of entries.
+    internal var count: Int {
+        return self.insertedCount - self.evictedCount
+    }
+
+    private let bytes: UnsafeMutablePointer<UInt8>
+    private let byteCapacity: Int
+    private let entries: UnsafeMutablePointer<Entry>
+    private let entryMask: Int
+
+    /// Positions are numbers of entries in the order of insertion.
+    private var insertedCount = 0
+    private var evictedCount = 0
+    private var writeOffset = 0
+
+    /// Positions of entries by hashes, are maintained only for the encoder.
+    private let isIndexed: Bool
+    private var fieldPositions: [UInt64: Int] = [:]
+    private var namePositions: [UInt64: Int] = [:]
+
+    /// - Parameter capacity:  The limit of the maximum size (SETTINGS_HEADER_TABLE_SIZE).
+    /// - Parameter isIndexed: Maintain hashes for `index(fieldHash:name:value:)` and `index(nameHash:name:)`.
+    internal init(capacity: Int, isIndexed: Bool) {
+        assert(capacity >= 0, "HpackDynamicTable: Capacity must not be negative.")
+
+        var entryCapacity = 1
+        while entryCapacity <= capacity / HpackDynamicTable.entryOverhead {
+            entryCapacity <<= 1
+        }
+
+        self.capacity = capacity
+        self.maxSize = capacity
+        self.byteCapacity = max(capacity, 1)
+        self.bytes = UnsafeMutablePointer<UInt8>.allocate(capacity: self.byteCapacity)
+        self.entries = UnsafeMutablePointer<Entry>.allocate(capacity: entryCapacity)
+        self.entryMask = entryCapacity - 1
+        self.isIndexed = isIndexed
+    }
+
+    deinit {
+        self.bytes.deallocate()
+        self.entries.deallocate()
+    }
+
+    /// Returns the entry, 0 is the newest one.
+    ///
+    /// - Precondition: `index` must be less than `count`.
+    @inline(__always)
+    internal func entry(at index: Int) -> Entry {
+        assert(index >= 0 && index < self.count, "HpackDynamicTable: Bad index.")
+
+        return self.entries[(self.insertedCount - 1 - index) & self.entryMask]
+    }
+
+    /// Changes the maximum size and evicts the entries that do not fit.
+    ///
+    /// - Precondition: `maxSize` must not be greater than `capacity`.
+    internal func setMaxSize(_ maxSize: Int) {
+        assert(maxSize >= 0 && maxSize <= self.capacity, "HpackDynamicTable: Bad maximum size.")
+
+        self.maxSize = maxSize
+        self.evict(toSize: maxSize)
+    }
+
+    /// Inserts the entry, if it is larger than the maximum size the table becomes empty (RFC7541 4.4).
+    internal func insert(
+        name: UnsafeRawBufferPointer,
+        value: UnsafeRawBufferPointer,
+        nameHash: UInt64 = 0,
+        fieldHash: UInt64 = 0
+    ) {
+        let entrySize = name.count + value.count + HpackDynamicTable.entryOverhead
+        if entrySize > self.maxSize {
+            self.evict(toSize: 0)
+            return
+        }
+
+        self.evict(toSize: self.maxSize - entrySize)
+
+        let entry = Entry(
+            offset: self.writeOffset,
+            nameCount: name.count,
+            valueCount: value.count,
+            nameHash: nameHash,
+            fieldHash: fieldHash
+        )
+        self.write(name)
+        self.write(value)
+
+        (self.entries + (self.insertedCount & self.entryMask)).initialize(to: entry)
+        if self.isIndexed {
+            self.fieldPositions[fieldHash] = self.insertedCount
+            self.namePositions[nameHash] = self.insertedCount
+        }
+        self.insertedCount += 1
+        self.size += entrySize
+    }
+
+    /// Copies the name of the entry to the destination, that must have space for `entry.nameCount` bytes.
+    @inline(__always)
+    internal func copyName(of entry: Entry, to destination: UnsafeMutablePointer<UInt8>) {
+        self.copy(from: entry.offset, count: entry.nameCount, to: destination)
+    }
+
+    /// Copies the value of the entry to the destination, that must have space for `entry.valueCount` bytes.
+    @inline(__always)
+    internal func copyValue(of entry: Entry, to destination: UnsafeMutablePointer<UInt8>) {
+        self.copy(from: (entry.offset + entry.nameCount) % self.byteCapacity, count: entry.valueCount, to: destination)
+    }
+
+    /// Returns the index of the newest entry with the name and value, 0 is the newest entry.
+    ///
+    /// - Precondition: The table must be created with `isIndexed`.
+    internal func index(fieldHash: UInt64, name: UnsafeRawBufferPointer, value: UnsafeRawBufferPointer) -> Int? {
+        guard let position = self.fieldPositions[fieldHash] else {
+            return nil
+        }
+
+        let entry = self.entries[position & self.entryMask]
+        let valueOffset = (entry.offset + entry.nameCount) % self.byteCapacity
+        let isEqual = self.isEqual(offset: entry.offset, count: entry.nameCount, to: name)
+            && self.isEqual(offset: valueOffset, count: entry.valueCount, to: value)
+
+        return isEqual ? self.insertedCount - 1 - position : nil
+    }
+
+    /// Returns the index of the newest entry with the name, 0 is the newest entry.
+    ///
+    /// - Precondition: The table must be created with `isIndexed`.
+    internal func index(nameHash: UInt64, name: UnsafeRawBufferPointer) -> Int? {
+        guard let position = self.namePositions[nameHash] else {
+            return nil
+        }
+
+        let entry = self.entries[position & self.entryMask]
+
+        return self.isEqual(offset: entry.offset, count: entry.nameCount, to: name)
+            ? self.insertedCount - 1 - position
+            : nil
+    }
+
+    /// Evicts the oldest entries until the size is not greater than the argument.
+    private func evict(toSize targetSize: Int) {
+        while self.size > targetSize {
+            let position = self.evictedCount
+            let entry = self.entries[position & self.entryMask]
+            if self.isIndexed {
+                if self.fieldPositions[entry.fieldHash] == position {
+                    self.fieldPositions[entry.fieldHash] = nil
+                }
+                if self.namePositions[entry.nameHash] == position {
+                    self.namePositions[entry.nameHash] = nil
+                }
+            }
+
+            self.evictedCount += 1
+            self.size -= entry.size
+        }
+    }
+
+    private func write(_ buffer: UnsafeRawBufferPointer) {
+        guard let base = buffer.baseAddress else {
+            return
+        }
+
+        let headCount = min(buffer.count, self.byteCapacity - self.writeOffset)
+        memcpy(self.bytes + self.writeOffset, base, headCount)
+        memcpy(self.bytes, base + headCount, buffer.count - headCount)
+        self.writeOffset = (self.writeOffset + buffer.count) % self.byteCapacity
+    }
+
+    @inline(__always)
+    private func copy(from offset: Int, count: Int, to destination: UnsafeMutablePointer<UInt8>) {
+        let headCount = min(count, self.byteCapacity - offset)
+        memcpy(destination, self.bytes + offset, headCount)
+        memcpy(destination + headCount, self.bytes, count - headCount)
+    }
+
+    private func isEqual(offset: Int, count: Int, to buffer: UnsafeRawBufferPointer) -> Bool {
+        if count != buffer.count {
+            return false
+        }
+        guard let base = buffer.baseAddress else {
+            return true
+        }
+
+        let headCount = min(count, self.byteCapacity - offset)
+
+        return memcmp(self.bytes + offset, base, headCount) == 0
+            && memcmp(self.bytes, base + headCount, count - headCount) == 0
+    }
+}
@@ -0,0 +1,209 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Encoder of HPACK header blocks ([RFC7541](https://tools.ietf.org/html/rfc7541)) for HTTP/2.
+///
+/// Fields are searched in the static and dynamic tables by `fnva64` hashes of the name and value,
+/// strings are Huffman-encoded when it makes them shorter.
+///
+///     let encoder = HpackEncoder()
+///     var block: [UInt8] = []
+///     encoder.encode(name: ":status", value: "200", into: &block)
+///     encoder.encode(name: "set-cookie", value: session, indexing: .never, into: &block)
+///
+/// - Note: Names must be lowercase, as HTTP/2 requires, the encoder does not convert them.
+/// - Note: The encoder is not thread-safe.
+public final class HpackEncoder {
+    /// How a field that is not found in the tables is represented.
+    public enum Indexing {
+        /// Literal with incremental indexing, the field is added to the dynamic table (RFC7541 6.2.1).
+        case incremental
+        /// Literal without indexing (RFC7541 6.2.2).
+        case none
+        /// Never indexed literal, intermediaries must not index the field too (RFC7541 6.2.3).
+        /// Fields with this indexing are never represented by an index.
+        case never
+    }
+
+    /// Use the Huffman code for strings that become shorter.
+    public let isHuffmanEnabled: Bool
+
+    /// The limit of the dynamic table, the value of SETTINGS_HEADER_TABLE_SIZE received from the peer.
+    public var tableSizeLimit: Int {
+        return self.table.capacity
+    }
+
+    /// The current maximum size of the dynamic table.
+    public var maxTableSize: Int {
+        return self.table.maxSize
+    }
+
+    private let table: HpackDynamicTable
+
+    /// The smallest size set by `setMaxTableSize(_:)` since the last block, nil if the size is not changed.
+    private var smallestTableSize: Int?
+
+    /// - Parameter tableSizeLimit:   The limit of the dynamic table, the value of SETTINGS_HEADER_TABLE_SIZE.
+    /// - Parameter isHuffmanEnabled: Use the Huffman code for strings that become shorter.
+    public init(tableSizeLimit: Int = 4096, isHuffmanEnabled: Bool = true) {
+        self.table = HpackDynamicTable(capacity: tableSizeLimit, isIndexed: true)
+        self.isHuffmanEnabled = isHuffmanEnabled
+    }
+
+    /// Changes the maximum size of the dynamic table, the update is written before the next field.
+    ///
+    /// - Precondition: `size` must not be greater than `tableSizeLimit`.
+    /// - Precondition: Must be called between header blocks.
+    public func setMaxTableSize(_ size: Int) {
+        if size < 0 || size > self.table.capacity {
+            fatalError("HpackEncoder: Bad table size: \(size)")
+        }
+
+        self.smallestTableSize = min(self.smallestTableSize ?? size, size)
+        self.table.setMaxSize(size)
+    }
+
+    /// Appends the representation of the field to the block.
+    ///
+    /// - Returns: The size of the field in the header list and the number of written bytes.
+    @discardableResult
+    public func encode(
+        name: UnsafeRawBufferPointer,
+        value: UnsafeRawBufferPointer,
+        indexing: Indexing = .incremental,
+        into output: inout [UInt8]
+    ) -> HttpHeaderSize {
+        let startCount = output.count
+        self.encodeTableSizeUpdate(into: &output)
+
+        let nameHash = HpackHash.name(name)
+        let fieldHash = HpackHash.field(nameHash: nameHash, value: value)
+
+        if indexing != .never, let index = self.index(fieldHash: fieldHash, name: name, value: value) {
+            HpackEncoder.encodeInteger(index, prefixBits: 7, flags: 0x80, into: &output)
+        } else {
+            let nameIndex = self.index(nameHash: nameHash, name: name) ?? 0
+            switch indexing {
+            case .incremental:
+                HpackEncoder.encodeInteger(nameIndex, prefixBits: 6, flags: 0x40, into: &output)
+            case .none:
+                HpackEncoder.encodeInteger(nameIndex, prefixBits: 4, flags: 0x00, into: &output)
+            case .never:
+                HpackEncoder.encodeInteger(nameIndex, prefixBits: 4, flags: 0x10, into: &output)
+            }
+
+            if nameIndex == 0 {
+                self.encodeString(name, into: &output)
+            }
+            self.encodeString(value, into: &output)
+
+            if indexing == .incremental {
+                self.table.insert(name: name, value: value, nameHash: nameHash, fieldHash: fieldHash)
+            }
+        }
+
+        return (
+            raw: UInt(name.count + value.count + HpackDynamicTable.entryOverhead),
+            compressed: UInt(output.count - startCount)
+        )
+    }
+
+    /// Appends the representation of the field to the block.
+    ///
+    /// - Returns: The size of the field in the header list and the number of written bytes.
+    @discardableResult
+    public func encode(
+        name: String,
+        value: String,
+        indexing: Indexing = .incremental,
+        into output: inout [UInt8]
+    ) -> HttpHeaderSize {
+        return name.withCString { name in
+            value.withCString { value in
+                self.encode(
+                    name: UnsafeRawBufferPointer(start: name, count: strlen(name)),
+                    value: UnsafeRawBufferPointer(start: value, count: strlen(value)),
+                    indexing: indexing,
+                    into: &output
+                )
+            }
+        }
+    }
+
+    /// Returns the index of the field in the static or dynamic table.
+    private func index(fieldHash: UInt64, name: UnsafeRawBufferPointer, value: UnsafeRawBufferPointer) -> Int? {
+        if let index = HpackStaticTable.index(fieldHash: fieldHash, name: name, value: value) {
+            return index
+        }
+
+        return self.table.index(fieldHash: fieldHash, name: name, value: value)
+            .map { HpackStaticTable.count + 1 + $0 }
+    }
+
+    /// Returns the index of a field with the name in the static or dynamic table.
+    private func index(nameHash: UInt64, name: UnsafeRawBufferPointer) -> Int? {
+        if let index = HpackStaticTable.index(nameHash: nameHash, name: name) {
+            return index
+        }
+
+        return self.table.index(nameHash: nameHash, name: name)
+            .map { HpackStaticTable.count + 1 + $0 }
+    }
+
+    /// Dynamic table size updates (RFC7541 6.3): the smallest size since the last block,
+    /// so the peer evicts the same entries, and the current size.
+    private func encodeTableSizeUpdate(into output: inout [UInt8]) {
+        guard let smallestTableSize = self.smallestTableSize else {
+            return
+        }
+
+        if smallestTableSize < self.table.maxSize {
+            HpackEncoder.encodeInteger(smallestTableSize, prefixBits: 5, flags: 0x20, into: &output)
+        }
+        HpackEncoder.encodeInteger(self.table.maxSize, prefixBits: 5, flags: 0x20, into: &output)
+        self.smallestTableSize = nil
+    }
+
+    /// String literal (RFC7541 5.2).
+    private func encodeString(_ string: UnsafeRawBufferPointer, into output: inout [UInt8]) {
+        if self.isHuffmanEnabled {
+            let encodedCount = HpackHuffman.encodedCount(string)
+            if encodedCount < string.count {
+                HpackEncoder.encodeInteger(encodedCount, prefixBits: 7, flags: 0x80, into: &output)
+                HpackHuffman.encode(string, into: &output)
+                return
+            }
+        }
+
+        HpackEncoder.encodeInteger(string.count, prefixBits: 7, flags: 0x00, into: &output)
+        output.append(contentsOf: string)
+    }
+
+    /// Integer with a prefix of `prefixBits` bits (RFC7541 5.1).
+    @inline(__always)
+    private static func encodeInteger(_ value: Int, prefixBits: Int, flags: UInt8, into output: inout [UInt8]) {
+        let mask = (1 << prefixBits) - 1
+        if value < mask {
+            output.append(flags | UInt8(truncatingIfNeeded: value))
+            return
+        }
+
+        output.append(flags | UInt8(truncatingIfNeeded: mask))
+        var rest = value - mask
+        while rest >= 0x80 {
+            output.append(UInt8(truncatingIfNeeded: rest) | 0x80)
+            rest >>= 7
+        }
+        output.append(UInt8(truncatingIfNeeded: rest))
+    }
+}
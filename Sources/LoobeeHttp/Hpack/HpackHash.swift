@@ -0,0 +1,22 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+/// Hashes of names and fields, the tables are searched by them instead of comparing strings.
+internal enum HpackHash {
+    @inline(__always)
+    internal static func name(_ name: UnsafeRawBufferPointer) -> UInt64 {
+        return fnva64(name)
+    }
+
+    /// Continues the hash of the name by a separator that cannot appear in names, and the value.
+    @inline(__always)
+    internal static func field(nameHash: UInt64, value: UnsafeRawBufferPointer) -> UInt64 {
+        return fnva64(value, hash: (nameHash ^ 0xFF) &* 1_099_511_628_211)
+    }
+}
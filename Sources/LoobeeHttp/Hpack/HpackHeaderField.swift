@@ -0,0 +1,28 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Header field decoded from a HPACK header block.
+///
+/// The name and value are not copied when possible: they refer to the block, to the static table
+/// or to the arena of the decoder (Huffman-encoded strings and entries of the dynamic table).
+/// They are valid until the next call of `HpackDecoder.decode(_:)` and while the block is alive.
+@_fixed_layout
+public struct HpackHeaderField {
+    public let name: UnsafeRawBufferPointer
+    public let value: UnsafeRawBufferPointer
+
+    /// The field is a never indexed literal, intermediaries must forward it in the same
+    /// representation ([RFC7541 6.2.3](https://tools.ietf.org/html/rfc7541#section-6.2.3)).
+    public let isSensitive: Bool
+
+    @inlinable
+    public init(name: UnsafeRawBufferPointer, value: UnsafeRawBufferPointer, isSensitive: Bool) {
+        self.name = name
+        self.value = value
+        self.isSensitive = isSensitive
+    }
+}
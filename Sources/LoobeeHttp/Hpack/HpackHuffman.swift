@@ -0,0 +1,238 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Huffman code of HPACK strings, [RFC7541 5.2](https://tools.ietf.org/html/rfc7541#section-5.2).
+///
+/// The decoder is table-driven and consumes 4 bits per lookup: a state is an internal node
+/// of the code tree (there are 256 of them), and the table contains the transition for each state
+/// and nibble. The shortest code is 5 bits long, so one transition emits at most one symbol.
+internal enum HpackHuffman {
+    /// Transition of the decoder from a state by a nibble.
+    internal struct Transition {
+        /// The transition emits `symbol`.
+        internal static let emitsSymbol: UInt8 = 1
+
+        /// The next state can be the end of the string: the bits since the last symbol are
+        /// at most 7 most significant bits of EOS, that is, valid padding.
+        internal static let isAccepted: UInt8 = 2
+
+        /// The nibble completes EOS, which is an error in the string.
+        internal static let isFailure: UInt8 = 4
+
+        internal let state: UInt8
+        internal let flags: UInt8
+        internal let symbol: UInt8
+    }
+
+    /// Codes of the symbols aligned to the least significant bit, the last one is EOS (Appendix B).
+    internal static let codes: [UInt32] = [
+        0x1FF8, 0x7F_FFD8, 0xFFF_FFE2, 0xFFF_FFE3, 0xFFF_FFE4, 0xFFF_FFE5, 0xFFF_FFE6, 0xFFF_FFE7,
+        0xFFF_FFE8, 0xFF_FFEA, 0x3FFF_FFFC, 0xFFF_FFE9, 0xFFF_FFEA, 0x3FFF_FFFD, 0xFFF_FFEB, 0xFFF_FFEC,
+        0xFFF_FFED, 0xFFF_FFEE, 0xFFF_FFEF, 0xFFF_FFF0, 0xFFF_FFF1, 0xFFF_FFF2, 0x3FFF_FFFE, 0xFFF_FFF3,
+        0xFFF_FFF4, 0xFFF_FFF5, 0xFFF_FFF6, 0xFFF_FFF7, 0xFFF_FFF8, 0xFFF_FFF9, 0xFFF_FFFA, 0xFFF_FFFB,
+        0x14, 0x3F8, 0x3F9, 0xFFA, 0x1FF9, 0x15, 0xF8, 0x7FA,
+        0x3FA, 0x3FB, 0xF9, 0x7FB, 0xFA, 0x16, 0x17, 0x18,
+        0x0, 0x1, 0x2, 0x19, 0x1A, 0x1B, 0x1C, 0x1D,
+        0x1E, 0x1F, 0x5C, 0xFB, 0x7FFC, 0x20, 0xFFB, 0x3FC,
+        0x1FFA, 0x21, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62,
+        0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A,
+        0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72,
+        0xFC, 0x73, 0xFD, 0x1FFB, 0x7_FFF0, 0x1FFC, 0x3FFC, 0x22,
+        0x7FFD, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+        0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2A, 0x7,
+        0x2B, 0x76, 0x2C, 0x8, 0x9, 0x2D, 0x77, 0x78,
+        0x79, 0x7A, 0x7B, 0x7FFE, 0x7FC, 0x3FFD, 0x1FFD, 0xFFF_FFFC,
+        0xF_FFE6, 0x3F_FFD2, 0xF_FFE7, 0xF_FFE8, 0x3F_FFD3, 0x3F_FFD4, 0x3F_FFD5, 0x7F_FFD9,
+        0x3F_FFD6, 0x7F_FFDA, 0x7F_FFDB, 0x7F_FFDC, 0x7F_FFDD, 0x7F_FFDE, 0xFF_FFEB, 0x7F_FFDF,
+        0xFF_FFEC, 0xFF_FFED, 0x3F_FFD7, 0x7F_FFE0, 0xFF_FFEE, 0x7F_FFE1, 0x7F_FFE2, 0x7F_FFE3,
+        0x7F_FFE4, 0x1F_FFDC, 0x3F_FFD8, 0x7F_FFE5, 0x3F_FFD9, 0x7F_FFE6, 0x7F_FFE7, 0xFF_FFEF,
+        0x3F_FFDA, 0x1F_FFDD, 0xF_FFE9, 0x3F_FFDB, 0x3F_FFDC, 0x7F_FFE8, 0x7F_FFE9, 0x1F_FFDE,
+        0x7F_FFEA, 0x3F_FFDD, 0x3F_FFDE, 0xFF_FFF0, 0x1F_FFDF, 0x3F_FFDF, 0x7F_FFEB, 0x7F_FFEC,
+        0x1F_FFE0, 0x1F_FFE1, 0x3F_FFE0, 0x1F_FFE2, 0x7F_FFED, 0x3F_FFE1, 0x7F_FFEE, 0x7F_FFEF,
+        0xF_FFEA, 0x3F_FFE2, 0x3F_FFE3, 0x3F_FFE4, 0x7F_FFF0, 0x3F_FFE5, 0x3F_FFE6, 0x7F_FFF1,
+        0x3FF_FFE0, 0x3FF_FFE1, 0xF_FFEB, 0x7_FFF1, 0x3F_FFE7, 0x7F_FFF2, 0x3F_FFE8, 0x1FF_FFEC,
+        0x3FF_FFE2, 0x3FF_FFE3, 0x3FF_FFE4, 0x7FF_FFDE, 0x7FF_FFDF, 0x3FF_FFE5, 0xFF_FFF1, 0x1FF_FFED,
+        0x7_FFF2, 0x1F_FFE3, 0x3FF_FFE6, 0x7FF_FFE0, 0x7FF_FFE1, 0x3FF_FFE7, 0x7FF_FFE2, 0xFF_FFF2,
+        0x1F_FFE4, 0x1F_FFE5, 0x3FF_FFE8, 0x3FF_FFE9, 0xFFF_FFFD, 0x7FF_FFE3, 0x7FF_FFE4, 0x7FF_FFE5,
+        0xF_FFEC, 0xFF_FFF3, 0xF_FFED, 0x1F_FFE6, 0x3F_FFE9, 0x1F_FFE7, 0x1F_FFE8, 0x7F_FFF3,
+        0x3F_FFEA, 0x3F_FFEB, 0x1FF_FFEE, 0x1FF_FFEF, 0xFF_FFF4, 0xFF_FFF5, 0x3FF_FFEA, 0x7F_FFF4,
+        0x3FF_FFEB, 0x7FF_FFE6, 0x3FF_FFEC, 0x3FF_FFED, 0x7FF_FFE7, 0x7FF_FFE8, 0x7FF_FFE9, 0x7FF_FFEA,
+        0x7FF_FFEB, 0xFFF_FFFE, 0x7FF_FFEC, 0x7FF_FFED, 0x7FF_FFEE, 0x7FF_FFEF, 0x7FF_FFF0, 0x3FF_FFEE,
+        0x3FFF_FFFF,
+    ]
+
+    /// Lengths of the codes in bits.
+    internal static let lengths: [UInt8] = [
+        13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+        28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+        6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+        5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+        13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+        15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+        6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+        20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+        24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+        22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+        21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+        26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+        19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+        20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+        26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+        30,
+    ]
+
+    /// Transitions of the decoder, 16 per state.
+    internal static let transitions: [Transition] = HpackHuffman.makeTransitions()
+
+    /// Returns the number of bytes of the encoded string.
+    internal static func encodedCount(_ bytes: UnsafeRawBufferPointer) -> Int {
+        let lengths = HpackHuffman.lengths
+        var bitCount = 0
+        for byte in bytes {
+            bitCount += Int(lengths[Int(byte)])
+        }
+
+        return (bitCount + 7) >> 3
+    }
+
+    /// Appends the encoded string to the output, the last byte is padded by the prefix of EOS.
+    internal static func encode(_ bytes: UnsafeRawBufferPointer, into output: inout [UInt8]) {
+        let codes = HpackHuffman.codes
+        let lengths = HpackHuffman.lengths
+
+        // Holds less than 8 pending bits between symbols, codes are at most 30 bits long.
+        var accumulator: UInt64 = 0
+        var bitCount: UInt64 = 0
+        for byte in bytes {
+            let length = UInt64(lengths[Int(byte)])
+            accumulator = (accumulator &<< length) | UInt64(codes[Int(byte)])
+            bitCount += length
+
+            while bitCount >= 8 {
+                bitCount -= 8
+                output.append(UInt8(truncatingIfNeeded: accumulator &>> bitCount))
+            }
+        }
+
+        if bitCount > 0 {
+            output.append(UInt8(truncatingIfNeeded: (accumulator &<< (8 - bitCount)) | (0xFF &>> bitCount)))
+        }
+    }
+
+    /// The maximum number of bytes that can be decoded from `count` bytes.
+    @inline(__always)
+    internal static func maxDecodedCount(_ count: Int) -> Int {
+        return count * 8 / 5
+    }
+
+    /// Decodes the string.
+    ///
+    /// - Parameter bytes:  The encoded string.
+    /// - Parameter output: Memory for at least `maxDecodedCount(bytes.count)` bytes.
+    ///
+    /// - Returns: The number of decoded bytes, or nil if the string contains EOS, an incomplete
+    ///            code or padding that is longer than 7 bits or is not the prefix of EOS.
+    internal static func decode(_ bytes: UnsafeRawBufferPointer, into output: UnsafeMutablePointer<UInt8>) -> Int? {
+        return HpackHuffman.transitions.withUnsafeBufferPointer { transitions -> Int? in
+            var state = 0
+            var isAccepted = true
+            var count = 0
+
+            for byte in bytes {
+                let high = transitions[(state << 4) | Int(byte >> 4)]
+                if high.flags & Transition.isFailure != 0 {
+                    return nil
+                }
+                if high.flags & Transition.emitsSymbol != 0 {
+                    output[count] = high.symbol
+                    count += 1
+                }
+
+                let low = transitions[(Int(high.state) << 4) | Int(byte & 0x0F)]
+                if low.flags & Transition.isFailure != 0 {
+                    return nil
+                }
+                if low.flags & Transition.emitsSymbol != 0 {
+                    output[count] = low.symbol
+                    count += 1
+                }
+
+                state = Int(low.state)
+                isAccepted = low.flags & Transition.isAccepted != 0
+            }
+
+            return isAccepted ? count : nil
+        }
+    }
+
+    /// Builds the code tree and the transitions between its internal nodes.
+    private static func makeTransitions() -> [Transition] {
+        let codes = HpackHuffman.codes
+        let lengths = HpackHuffman.lengths
+
+        // Two children per internal node, the root is 0. Leaves are stored as `~symbol`.
+        var children = [Int](repeating: 0, count: 2 * 256)
+        var nodeCount = 1
+        for symbol in 0..<codes.count {
+            let code = Int(codes[symbol])
+            var node = 0
+            for shift in stride(from: Int(lengths[symbol]) - 1, to: 0, by: -1) {
+                let index = (node << 1) | ((code >> shift) & 1)
+                if children[index] == 0 {
+                    children[index] = nodeCount
+                    nodeCount += 1
+                }
+                node = children[index]
+            }
+            children[(node << 1) | (code & 1)] = ~symbol
+        }
+        assert(nodeCount == 256, "HpackHuffman: The code tree must have 256 internal nodes.")
+
+        // Padding is a prefix of EOS (all ones) of at most 7 bits.
+        var isAccepting = [Bool](repeating: false, count: 256)
+        var paddingNode = 0
+        for _ in 0..<8 {
+            isAccepting[paddingNode] = true
+            paddingNode = children[(paddingNode << 1) | 1]
+        }
+
+        var transitions: [Transition] = []
+        transitions.reserveCapacity(256 * 16)
+        for state in 0..<256 {
+            for nibble in 0..<16 {
+                var node = state
+                var flags: UInt8 = 0
+                var symbol = 0
+                for shift in stride(from: 3, through: 0, by: -1) {
+                    let child = children[(node << 1) | ((nibble >> shift) & 1)]
+                    if child > 0 {
+                        node = child
+                        continue
+                    }
+
+                    symbol = ~child
+                    if symbol == 256 {
+                        flags = Transition.isFailure
+                        break
+                    }
+                    flags |= Transition.emitsSymbol
+                    node = 0
+                }
+
+                if flags != Transition.isFailure && isAccepting[node] {
+                    flags |= Transition.isAccepted
+                }
+                transitions.append(
+                    Transition(state: UInt8(node), flags: flags, symbol: UInt8(truncatingIfNeeded: symbol))
+                )
+            }
+        }
+
+        return transitions
+    }
+}
@@ -0,0 +1,156 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// The static table, [RFC7541 Appendix A](https://tools.ietf.org/html/rfc7541#appendix-A).
+///
+/// Names and values are static strings, so decoded headers refer to them without copying.
+internal enum HpackStaticTable {
+    /// The number of entries, the dynamic table starts from the next index.
+    internal static let count = 61
+
+    /// Entries in the order of indices, `entries[0]` has index 1.
+    internal static let entries: [(name: StaticString, value: StaticString)] = [
+        (":authority", ""),
+        (":method", "GET"),
+        (":method", "POST"),
+        (":path", "/"),
+        (":path", "/index.html"),
+        (":scheme", "http"),
+        (":scheme", "https"),
+        (":status", "200"),
+        (":status", "204"),
+        (":status", "206"),
+        (":status", "304"),
+        (":status", "400"),
+        (":status", "404"),
+        (":status", "500"),
+        ("accept-charset", ""),
+        ("accept-encoding", "gzip, deflate"),
+        ("accept-language", ""),
+        ("accept-ranges", ""),
+        ("accept", ""),
+        ("access-control-allow-origin", ""),
+        ("age", ""),
+        ("allow", ""),
+        ("authorization", ""),
+        ("cache-control", ""),
+        ("content-disposition", ""),
+        ("content-encoding", ""),
+        ("content-language", ""),
+        ("content-length", ""),
+        ("content-location", ""),
+        ("content-range", ""),
+        ("content-type", ""),
+        ("cookie", ""),
+        ("date", ""),
+        ("etag", ""),
+        ("expect", ""),
+        ("expires", ""),
+        ("from", ""),
+        ("host", ""),
+        ("if-match", ""),
+        ("if-modified-since", ""),
+        ("if-none-match", ""),
+        ("if-range", ""),
+        ("if-unmodified-since", ""),
+        ("last-modified", ""),
+        ("link", ""),
+        ("location", ""),
+        ("max-forwards", ""),
+        ("proxy-authenticate", ""),
+        ("proxy-authorization", ""),
+        ("range", ""),
+        ("referer", ""),
+        ("refresh", ""),
+        ("retry-after", ""),
+        ("server", ""),
+        ("set-cookie", ""),
+        ("strict-transport-security", ""),
+        ("transfer-encoding", ""),
+        ("user-agent", ""),
+        ("vary", ""),
+        ("via", ""),
+        ("www-authenticate", ""),
+    ]
+
+    /// Indices of entries by `HpackHash.field`.
+    private static let fieldIndices: [UInt64: Int] = HpackStaticTable.makeIndices(byName: false)
+
+    /// Indices of the first entry with the name by `HpackHash.name`.
+    private static let nameIndices: [UInt64: Int] = HpackStaticTable.makeIndices(byName: true)
+
+    /// Returns the name of the entry.
+    ///
+    /// - Precondition: `index` must be in `1...count`.
+    @inline(__always)
+    internal static func name(at index: Int) -> UnsafeRawBufferPointer {
+        return HpackStaticTable.buffer(HpackStaticTable.entries[index - 1].name)
+    }
+
+    /// Returns the value of the entry.
+    ///
+    /// - Precondition: `index` must be in `1...count`.
+    @inline(__always)
+    internal static func value(at index: Int) -> UnsafeRawBufferPointer {
+        return HpackStaticTable.buffer(HpackStaticTable.entries[index - 1].value)
+    }
+
+    /// Returns the index of the entry with the name and value.
+    internal static func index(
+        fieldHash: UInt64,
+        name: UnsafeRawBufferPointer,
+        value: UnsafeRawBufferPointer
+    ) -> Int? {
+        guard let index = HpackStaticTable.fieldIndices[fieldHash] else {
+            return nil
+        }
+
+        let isEqual = HpackStaticTable.isEqual(HpackStaticTable.name(at: index), name)
+            && HpackStaticTable.isEqual(HpackStaticTable.value(at: index), value)
+
+        return isEqual ? index : nil
+    }
+
+    /// Returns the index of the first entry with the name.
+    internal static func index(nameHash: UInt64, name: UnsafeRawBufferPointer) -> Int? {
+        guard let index = HpackStaticTable.nameIndices[nameHash] else {
+            return nil
+        }
+
+        return HpackStaticTable.isEqual(HpackStaticTable.name(at: index), name) ? index : nil
+    }
+
+    @inline(__always)
+    private static func buffer(_ string: StaticString) -> UnsafeRawBufferPointer {
+        return UnsafeRawBufferPointer(start: string.utf8Start, count: string.utf8CodeUnitCount)
+    }
+
+    /// Confirms a match of hashes.
+    @inline(__always)
+    private static func isEqual(_ lhs: UnsafeRawBufferPointer, _ rhs: UnsafeRawBufferPointer) -> Bool {
+        return lhs.count == rhs.count && (lhs.isEmpty || memcmp(lhs.baseAddress!, rhs.baseAddress!, lhs.count) == 0)
+    }
+
+    private static func makeIndices(byName: Bool) -> [UInt64: Int] {
+        var indices: [UInt64: Int] = [:]
+        for index in 1...HpackStaticTable.count {
+            let nameHash = HpackHash.name(HpackStaticTable.name(at: index))
+            let hash = byName ? nameHash : HpackHash.field(nameHash: nameHash, value: HpackStaticTable.value(at: index))
+            if indices[hash] == nil {
+                indices[hash] = index
+            }
+        }
+
+        return indices
+    }
+}
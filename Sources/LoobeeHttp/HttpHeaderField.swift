@@ -0,0 +1,19 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Header field of a HTTP message, the value is without the leading and trailing whitespaces.
+@_fixed_layout
+public struct HttpHeaderField: Equatable {
+    public let name: HttpSlice
+    public let value: HttpSlice
+
+    @inlinable
+    public init(name: HttpSlice, value: HttpSlice) {
+        self.name = name
+        self.value = value
+    }
+}
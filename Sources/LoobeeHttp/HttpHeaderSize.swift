@@ -6,4 +6,8 @@
 // file that was distributed with this source code.
 
 /// Tuple that contains info about header size.
-internal typealias HttpHeaderSize = (raw: UInt, compressed: UInt)
+///
+/// `raw` is the size of the header list as it is limited by SETTINGS_MAX_HEADER_LIST_SIZE
+/// of HTTP/2: the length of the name and value plus 32 for each field. `compressed` is the size
+/// of the encoded representation.
+public typealias HttpHeaderSize = (raw: UInt, compressed: UInt)
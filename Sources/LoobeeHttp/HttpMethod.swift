@@ -5,7 +5,11 @@
 // For the full copyright and license information, please view the LICENSE
 // file that was distributed with this source code.
 
-import LoobeeCore
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
 
 /// The Method token indicates the method to be performed on the resource identified by the Request-URI.
 ///
@@ -47,24 +51,66 @@ public enum HttpMethod: LosslessStringConvertible, TextOutputStreamable {
 
     /// - Note: Rule of "The method is case-sensitive." from RFC2616 5.1.1 is ignored.
     public init?<T>(_ description: T) where T: StringProtocol {
-        switch true {
-        case description.caseInsensitiveASCIICompare("GET"):
+        var key: UInt64 = 0
+        var count = 0
+        for byte in description.utf8 {
+            guard count < HttpMethod.maxLength else {
+                return nil
+            }
+
+            key |= UInt64(byte) << UInt64(count * 8)
+            count += 1
+        }
+
+        self.init(key: key, count: count)
+    }
+
+    /// Creates the method from its bytes, e.g. a slice of the request line.
+    ///
+    /// - Note: Rule of "The method is case-sensitive." from RFC2616 5.1.1 is ignored.
+    public init?(bytes: UnsafeRawBufferPointer) {
+        guard let base = bytes.baseAddress, bytes.count <= HttpMethod.maxLength else {
+            return nil
+        }
+
+        var key: UInt64 = 0
+        memcpy(&key, base, bytes.count)
+
+        self.init(key: UInt64(littleEndian: key), count: bytes.count)
+    }
+
+    /// The length of the longest method.
+    internal static let maxLength = 7
+
+    /// Matches the method by the key, that contains bytes of the name in the little-endian order.
+    ///
+    /// Names are compared at once as 8-byte integers. Setting of the `0x20` bit lowercases ASCII letters
+    /// and can map to a lowercase letter only the same letter, so names with other bytes do not match.
+    internal init?(key: UInt64, count: Int) {
+        guard count > 0 else {
+            return nil
+        }
+
+        let lowercaseMask: UInt64 = 0x2020_2020_2020_2020 >> UInt64(64 - count * 8)
+
+        switch key | lowercaseMask {
+        case 0x0000_0000_0074_6567: // get
             self = .get
-        case description.caseInsensitiveASCIICompare("POST"):
+        case 0x0000_0000_7473_6F70: // post
             self = .post
-        case description.caseInsensitiveASCIICompare("OPTIONS"):
+        case 0x0073_6E6F_6974_706F: // options
             self = .options
-        case description.caseInsensitiveASCIICompare("DELETE"):
+        case 0x0000_6574_656C_6564: // delete
             self = .delete
-        case description.caseInsensitiveASCIICompare("HEAD"):
+        case 0x0000_0000_6461_6568: // head
             self = .head
-        case description.caseInsensitiveASCIICompare("CONNECT"):
+        case 0x0074_6365_6E6E_6F63: // connect
             self = .connect
-        case description.caseInsensitiveASCIICompare("PUT"):
+        case 0x0000_0000_0074_7570: // put
             self = .put
-        case description.caseInsensitiveASCIICompare("TRACE"):
+        case 0x0000_0065_6361_7274: // trace
             self = .trace
-        case description.caseInsensitiveASCIICompare("PATCH"):
+        case 0x0000_0068_6374_6170: // patch
             self = .patch
         default:
             return nil
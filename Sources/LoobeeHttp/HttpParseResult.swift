@@ -0,0 +1,35 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Reason of rejection of a HTTP message.
+public enum HttpParseError: Equatable {
+    /// Control character other than HTAB, or CR that is not followed by LF.
+    case invalidCharacter
+    /// The request line is not `method SP request-target SP HTTP-version`.
+    case invalidRequestLine
+    /// Unknown method.
+    case invalidMethod
+    /// Unsupported version.
+    case invalidVersion
+    /// The header line has no colon, the name is empty or contains non-token characters,
+    /// or the line is an obsolete line folding.
+    case invalidHeader
+    /// The number of headers exceeds the limit.
+    case tooManyHeaders
+    /// The head (start line and headers) exceeds the limit.
+    case headTooLarge
+}
+
+/// Result of parsing of the received data.
+public enum HttpParseResult: Equatable {
+    /// More data is required.
+    case incomplete
+    /// The head is parsed, the message body (if any) starts at `headLength`.
+    case complete(headLength: Int)
+    /// The message is invalid, the connection should be closed after the error response.
+    case invalid(HttpParseError)
+}
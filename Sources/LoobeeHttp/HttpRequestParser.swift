@@ -0,0 +1,267 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Incremental parser of the head (request line and headers) of HTTP/1.1 requests.
+///
+/// The parser does not copy the data: the target and headers are `HttpSlice`s of the buffer,
+/// and the storage of headers is reused between requests. Data can arrive in parts: the caller
+/// appends received bytes to the buffer and passes the whole buffer again, the parser continues
+/// from the line where it stopped and does not rescan checked bytes.
+///
+/// Lines are split and validated in one pass by `ByteSearch.firstControlCharacter(in:)`,
+/// that uses SSE4.2/AVX2 kernels if the processor supports them. Methods are matched
+/// as 8-byte integers.
+///
+///     var parser = HttpRequestParser()
+///     switch parser.parse(buffer) {
+///     case .incomplete:
+///         // Read more data into the buffer.
+///     case .complete(let headLength):
+///         let host = parser.header(named: "Host", in: buffer)?.string(in: buffer)
+///     case .invalid(let error):
+///         // Respond with 400 and close the connection.
+///     }
+///
+/// Line ends can be CRLF or LF (RFC7230 3.5), empty lines before the request line are ignored.
+/// Obsolete line folding is rejected.
+public struct HttpRequestParser {
+    /// State of the parser.
+    private enum State {
+        case requestLine
+        case headers
+        case complete(headLength: Int)
+        case invalid(HttpParseError)
+    }
+
+    /// The limit of the length of the head.
+    public let maxHeadLength: Int
+
+    /// The limit of the number of headers.
+    public let maxHeaderCount: Int
+
+    /// The method, nil until the request line is parsed.
+    public private(set) var method: HttpMethod?
+
+    /// The request target.
+    public private(set) var target = HttpSlice(offset: 0, count: 0)
+
+    /// The version.
+    public private(set) var version = HttpVersion.http11
+
+    /// Headers in the order of the message.
+    public private(set) var headers: [HttpHeaderField] = []
+
+    private var state = State.requestLine
+
+    /// Offset of the first byte of the current line.
+    private var lineStart = 0
+
+    /// Offset of the first byte of the current line that is not checked yet.
+    private var scanOffset = 0
+
+    public init(maxHeadLength: Int = 64 * 1024, maxHeaderCount: Int = 100) {
+        self.maxHeadLength = maxHeadLength
+        self.maxHeaderCount = maxHeaderCount
+        self.headers.reserveCapacity(32)
+    }
+
+    /// Prepares the parser for the next request, the storage of headers is kept.
+    public mutating func reset() {
+        self.method = nil
+        self.target = HttpSlice(offset: 0, count: 0)
+        self.version = HttpVersion.http11
+        self.headers.removeAll(keepingCapacity: true)
+        self.state = .requestLine
+        self.lineStart = 0
+        self.scanOffset = 0
+    }
+
+    /// Parses the received data.
+    ///
+    /// - Parameter buffer: All data received since the start of the request or `reset()`.
+    ///                     The data passed by previous calls must not be changed.
+    public mutating func parse(_ buffer: UnsafeRawBufferPointer) -> HttpParseResult {
+        switch self.state {
+        case .complete(let headLength):
+            return .complete(headLength: headLength)
+        case .invalid(let error):
+            return .invalid(error)
+        case .requestLine, .headers:
+            break
+        }
+
+        guard let base = buffer.baseAddress else {
+            return .incomplete
+        }
+
+        while true {
+            let unchecked = UnsafeRawBufferPointer(start: base + self.scanOffset, count: buffer.count - self.scanOffset)
+            guard let controlIndex = ByteSearch.firstControlCharacter(in: unchecked) else {
+                self.scanOffset = buffer.count
+                return self.incomplete(buffer)
+            }
+
+            let lineEnd = self.scanOffset + controlIndex
+            let nextLine: Int
+            switch buffer[lineEnd] {
+            case UInt8(ascii: "\n"):
+                nextLine = lineEnd + 1
+            case UInt8(ascii: "\r"):
+                guard lineEnd + 1 < buffer.count else {
+                    self.scanOffset = lineEnd
+                    return self.incomplete(buffer)
+                }
+                guard buffer[lineEnd + 1] == UInt8(ascii: "\n") else {
+                    return self.fail(.invalidCharacter)
+                }
+
+                nextLine = lineEnd + 2
+            default:
+                return self.fail(.invalidCharacter)
+            }
+
+            if nextLine > self.maxHeadLength {
+                return self.fail(.headTooLarge)
+            }
+
+            let line = UnsafeRawBufferPointer(start: base + self.lineStart, count: lineEnd - self.lineStart)
+            switch self.state {
+            case .requestLine:
+                if !line.isEmpty {
+                    if let error = self.parseRequestLine(line) {
+                        return self.fail(error)
+                    }
+                    self.state = .headers
+                }
+            default:
+                if line.isEmpty {
+                    self.state = .complete(headLength: nextLine)
+                    return .complete(headLength: nextLine)
+                }
+                if let error = self.parseHeader(line) {
+                    return self.fail(error)
+                }
+            }
+
+            self.lineStart = nextLine
+            self.scanOffset = nextLine
+        }
+    }
+
+    /// Returns the value of the first header with the name, the names are case-insensitive.
+    ///
+    /// - Precondition: `buffer` must contain the parsed data at the same offsets.
+    public func header(named name: String, in buffer: UnsafeRawBufferPointer) -> HttpSlice? {
+        return name.withCString { name in
+            let name = UnsafeRawBufferPointer(start: name, count: strlen(name))
+            for header in self.headers where header.name.count == name.count {
+                if ByteSearch.asciiCaseInsensitiveEqual(header.name.bytes(in: buffer), name) {
+                    return header.value
+                }
+            }
+
+            return nil
+        }
+    }
+
+    private mutating func incomplete(_ buffer: UnsafeRawBufferPointer) -> HttpParseResult {
+        if buffer.count > self.maxHeadLength {
+            return self.fail(.headTooLarge)
+        }
+
+        return .incomplete
+    }
+
+    private mutating func fail(_ error: HttpParseError) -> HttpParseResult {
+        self.state = .invalid(error)
+
+        return .invalid(error)
+    }
+
+    /// Parses `method SP request-target SP HTTP-version`.
+    private mutating func parseRequestLine(_ line: UnsafeRawBufferPointer) -> HttpParseError? {
+        let offset = self.lineStart
+
+        if ByteSearch.firstIndex(of: UInt8(ascii: "\t"), in: line) != nil {
+            return .invalidRequestLine
+        }
+
+        guard let methodEnd = ByteSearch.firstIndex(of: UInt8(ascii: " "), in: line) else {
+            return .invalidRequestLine
+        }
+        guard let method = HttpMethod(bytes: UnsafeRawBufferPointer(rebasing: line[0..<methodEnd])) else {
+            return .invalidMethod
+        }
+
+        let targetStart = methodEnd + 1
+        let rest = UnsafeRawBufferPointer(rebasing: line[targetStart...])
+        guard let targetCount = ByteSearch.firstIndex(of: UInt8(ascii: " "), in: rest), targetCount > 0 else {
+            return .invalidRequestLine
+        }
+        guard let version = HttpVersion(bytes: UnsafeRawBufferPointer(rebasing: rest[(targetCount + 1)...])) else {
+            return .invalidVersion
+        }
+
+        self.method = method
+        self.target = HttpSlice(offset: offset + targetStart, count: targetCount)
+        self.version = version
+
+        return nil
+    }
+
+    /// Parses `field-name ":" OWS field-value OWS`.
+    private mutating func parseHeader(_ line: UnsafeRawBufferPointer) -> HttpParseError? {
+        let offset = self.lineStart
+
+        guard let colon = ByteSearch.firstIndex(of: UInt8(ascii: ":"), in: line), colon > 0 else {
+            return .invalidHeader
+        }
+        if line[0..<colon].contains(where: { !HttpRequestParser.isToken($0) }) {
+            return .invalidHeader
+        }
+
+        var valueStart = colon + 1
+        var valueEnd = line.count
+        while valueStart < valueEnd && HttpRequestParser.isWhitespace(line[valueStart]) {
+            valueStart += 1
+        }
+        while valueEnd > valueStart && HttpRequestParser.isWhitespace(line[valueEnd - 1]) {
+            valueEnd -= 1
+        }
+
+        if self.headers.count == self.maxHeaderCount {
+            return .tooManyHeaders
+        }
+
+        self.headers.append(HttpHeaderField(
+            name: HttpSlice(offset: offset, count: colon),
+            value: HttpSlice(offset: offset + valueStart, count: valueEnd - valueStart)
+        ))
+
+        return nil
+    }
+
+    /// Returns true for `tchar` of RFC7230 3.2.6: ALPHA, DIGIT and ``!#$%&'*+-.^_`|~``.
+    private static func isToken(_ byte: UInt8) -> Bool {
+        let mask: UInt64 = byte < 64 ? 0x03FF_6CFA_0000_0000 : 0x57FF_FFFF_C7FF_FFFE
+
+        return byte < 128 && (mask >> UInt64(byte & 63)) & 1 == 1
+    }
+
+    /// Returns true for SP and HTAB.
+    private static func isWhitespace(_ byte: UInt8) -> Bool {
+        return byte == UInt8(ascii: " ") || byte == UInt8(ascii: "\t")
+    }
+}
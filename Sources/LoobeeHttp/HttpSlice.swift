@@ -0,0 +1,47 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+/// Range of bytes in the buffer passed to a parser.
+///
+/// Slices do not copy the data and stay valid when the buffer is moved (e.g. reallocated
+/// between partial reads), as long as its bytes are not changed.
+///
+///     let target = parser.target.bytes(in: buffer)
+@_fixed_layout
+public struct HttpSlice: Equatable {
+    /// Offset of the first byte from the start of the buffer.
+    public let offset: Int
+
+    /// The number of bytes.
+    public let count: Int
+
+    @inlinable
+    public init(offset: Int, count: Int) {
+        self.offset = offset
+        self.count = count
+    }
+
+    /// Offsets of the bytes in the buffer.
+    @inlinable public var range: Range<Int> {
+        return self.offset..<(self.offset + self.count)
+    }
+
+    /// Returns the bytes of the slice.
+    ///
+    /// - Precondition: `buffer` must contain the parsed data at the same offsets.
+    @inlinable
+    public func bytes(in buffer: UnsafeRawBufferPointer) -> UnsafeRawBufferPointer {
+        return UnsafeRawBufferPointer(rebasing: buffer[self.range])
+    }
+
+    /// Returns a copy of the bytes of the slice as a string, invalid UTF-8 sequences are repaired.
+    ///
+    /// - Precondition: `buffer` must contain the parsed data at the same offsets.
+    public func string(in buffer: UnsafeRawBufferPointer) -> String {
+        return String(decoding: self.bytes(in: buffer), as: UTF8.self)
+    }
+}
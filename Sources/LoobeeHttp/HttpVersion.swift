@@ -0,0 +1,54 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+
+/// Version of the HTTP protocol, `HTTP/<major>.<minor>`.
+public struct HttpVersion: Equatable, CustomStringConvertible {
+    public let major: Int
+    public let minor: Int
+
+    ///
+    public static let http10 = HttpVersion(major: 1, minor: 0)
+
+    ///
+    public static let http11 = HttpVersion(major: 1, minor: 1)
+
+    public init(major: Int, minor: Int) {
+        self.major = major
+        self.minor = minor
+    }
+
+    /// Creates the version from the bytes of the request line, only `HTTP/1.0` and `HTTP/1.1` are supported.
+    ///
+    /// - Note: The protocol name is case-sensitive (RFC7230 2.6).
+    public init?(bytes: UnsafeRawBufferPointer) {
+        guard let base = bytes.baseAddress, bytes.count == 8 else {
+            return nil
+        }
+
+        var key: UInt64 = 0
+        memcpy(&key, base, 8)
+
+        switch UInt64(littleEndian: key) {
+        case 0x312E_312F_5054_5448: // HTTP/1.1
+            self = .http11
+        case 0x302E_312F_5054_5448: // HTTP/1.0
+            self = .http10
+        default:
+            return nil
+        }
+    }
+
+    public var description: String {
+        return "HTTP/\(self.major).\(self.minor)"
+    }
+}
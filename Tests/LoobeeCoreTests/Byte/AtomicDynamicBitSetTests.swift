@@ -0,0 +1,96 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class AtomicDynamicBitSetTests: XCTestCase {
+    func testSetReset() {
+        let bitset = AtomicDynamicBitSet(count: 130)
+
+        XCTAssertEqual(bitset.set(129), .zero)
+        XCTAssertEqual(bitset.set(129), .one)
+        XCTAssertEqual(bitset[129], .one)
+        XCTAssertEqual(bitset[128], .zero)
+        XCTAssertEqual(bitset.nonzeroBitCount, 1)
+
+        XCTAssertEqual(bitset.reset(129), .one)
+        XCTAssertEqual(bitset.reset(129), .zero)
+        XCTAssertEqual(bitset[129], .zero)
+    }
+
+    func testSnapshot() {
+        var source = DynamicBitSet(count: 200)
+        source[3] = .one
+        source[150] = .one
+
+        let bitset = AtomicDynamicBitSet(source)
+        XCTAssertEqual(bitset.snapshot(), source)
+
+        bitset.set(4)
+        source[4] = .one
+        XCTAssertEqual(bitset.snapshot(), source)
+    }
+
+    func testClaimZeroBit() {
+        let bitset = AtomicDynamicBitSet(count: 130)
+
+        XCTAssertEqual(bitset.claimZeroBit(), 0)
+        XCTAssertEqual(bitset.claimZeroBit(), 1)
+        XCTAssertEqual(bitset.claimZeroBit(hint: 128), 128)
+        XCTAssertEqual(bitset.claimZeroBit(hint: 128), 129)
+        // Wraps around to the first word.
+        XCTAssertEqual(bitset.claimZeroBit(hint: 128), 2)
+        XCTAssertEqual(bitset.claimZeroBit(hint: 64), 64)
+        XCTAssertEqual(bitset.claimZeroBit(hint: 64 * 3), 3)
+        // Negative hints wrap around from the end.
+        XCTAssertEqual(bitset.claimZeroBit(hint: -64), 4)
+        XCTAssertEqual(bitset.claimZeroBit(hint: Int.min), 65)
+
+        while bitset.claimZeroBit() != nil {
+        }
+        XCTAssertEqual(bitset.nonzeroBitCount, 130)
+        XCTAssertTrue(bitset.snapshot().isAllOnes)
+
+        bitset.reset(77)
+        XCTAssertEqual(bitset.claimZeroBit(hint: 129), 77)
+        XCTAssertNil(bitset.claimZeroBit())
+
+        XCTAssertNil(AtomicDynamicBitSet(count: 0).claimZeroBit())
+    }
+
+    func testConcurrentClaim() {
+        let threadCount = 4
+        let iterations = 10_000
+        let bitset = AtomicDynamicBitSet(count: threadCount * iterations)
+        let claimedBy = UnsafeMutablePointer<Int>.allocate(capacity: bitset.count)
+        claimedBy.initialize(repeating: -1, count: bitset.count)
+        defer {
+            claimedBy.deallocate()
+        }
+
+        let threads = (0..<threadCount).map { thread in
+            NativeThread {
+                for _ in 0..<iterations {
+                    guard let slot = bitset.claimZeroBit(hint: thread * 64) else {
+                        XCTFail("All bits are claimed.")
+                        return
+                    }
+                    claimedBy[slot] = thread
+                }
+            }
+        }
+        for thread in threads {
+            thread.join()
+        }
+
+        // Each bit is claimed exactly once.
+        XCTAssertTrue(bitset.snapshot().isAllOnes)
+        XCTAssertNil(bitset.claimZeroBit())
+        XCTAssertFalse(UnsafeBufferPointer(start: claimedBy, count: bitset.count).contains(-1))
+    }
+}
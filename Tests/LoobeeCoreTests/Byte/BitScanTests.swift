@@ -0,0 +1,52 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class BitScanTests: XCTestCase {
+    func testFirstSetBit() {
+        var words = [UInt64](repeating: 0, count: 10)
+
+        words.withUnsafeBufferPointer { XCTAssertNil(BitScan.firstSetBit(in: $0)) }
+
+        words[0] = 0b1001
+        words[7] = 1 << 63
+        words.withUnsafeBufferPointer { words in
+            XCTAssertEqual(BitScan.firstSetBit(in: words), 0)
+            XCTAssertEqual(BitScan.firstSetBit(in: words, from: 1), 3)
+            XCTAssertEqual(BitScan.firstSetBit(in: words, from: 4), 7 * 64 + 63)
+            XCTAssertEqual(BitScan.firstSetBit(in: words, from: 7 * 64 + 63), 7 * 64 + 63)
+            XCTAssertNil(BitScan.firstSetBit(in: words, from: 8 * 64))
+            XCTAssertNil(BitScan.firstSetBit(in: words, from: 100 * 64))
+        }
+
+        XCTAssertNil(BitScan.firstSetBit(in: UnsafeBufferPointer(start: nil, count: 0)))
+    }
+
+    func testFirstSetBitKernels() {
+        let dispatch = BitScan.firstSetBitDispatch
+        var words = [UInt64](repeating: 0, count: 40)
+
+        for level in dispatch.supportedLevels {
+            let kernel = dispatch.kernel(for: level)
+
+            for count in 0...words.count {
+                XCTAssertEqual(kernel(words, count), count * 64, "\(level)")
+            }
+
+            for index in 0..<(words.count * 64) {
+                words[index / 64] = 1 << UInt64(index % 64)
+                for count in [index / 64 + 1, words.count] {
+                    XCTAssertEqual(kernel(words, count), index, "\(level)")
+                }
+                XCTAssertEqual(kernel(words, index / 64), index / 64 * 64, "\(level)")
+                words[index / 64] = 0
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class ByteSearchTests: XCTestCase {
+    func testFirstIndex() {
+        let data: [UInt8] = Array("GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\n".utf8)
+
+        data.withUnsafeBytes { buffer in
+            XCTAssertEqual(ByteSearch.firstIndex(of: UInt8(ascii: " "), in: buffer), 3)
+            XCTAssertEqual(ByteSearch.firstIndex(of: UInt8(ascii: "\r"), in: buffer), 24)
+            XCTAssertEqual(ByteSearch.firstIndex(of: UInt8(ascii: "G"), in: buffer), 0)
+            XCTAssertNil(ByteSearch.firstIndex(of: 0, in: buffer))
+        }
+
+        XCTAssertNil(ByteSearch.firstIndex(of: 0, in: UnsafeRawBufferPointer(start: nil, count: 0)))
+    }
+
+    func testFindByteKernels() {
+        let dispatch = ByteSearch.findByteDispatch
+        var data = [UInt8](repeating: 1, count: 300)
+
+        data.withUnsafeMutableBytes { buffer in
+            let base = buffer.baseAddress!
+            for level in dispatch.supportedLevels {
+                let kernel = dispatch.kernel(for: level)
+
+                for offset in 0..<33 {
+                    for count in 0..<(buffer.count - offset) where count % 7 == 0 || count < 70 {
+                        XCTAssertEqual(kernel(base + offset, count, 0), count, "\(level)")
+
+                        for position in [0, count / 2, count - 1] where position >= 0 && count > 0 {
+                            buffer[offset + position] = 0
+                            XCTAssertEqual(kernel(base + offset, count, 0), position, "\(level)")
+                            buffer[offset + position] = 1
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    func testAsciiCaseInsensitiveEqual() {
+        let lhs = Array("Content-Type: TEXT/html; charset=UTF-8 @[`{".utf8)
+        let rhs = Array("content-type: text/HTML; Charset=utf-8 @[`{".utf8)
+        let other = Array("content-type: text/HTML; Charset=utf-8 `{@[".utf8)
+
+        lhs.withUnsafeBytes { lhs in
+            rhs.withUnsafeBytes { rhs in
+                XCTAssertTrue(ByteSearch.asciiCaseInsensitiveEqual(lhs, rhs))
+                XCTAssertFalse(ByteSearch.asciiCaseInsensitiveEqual(lhs, UnsafeRawBufferPointer(rebasing: rhs[1...])))
+            }
+            other.withUnsafeBytes { other in
+                XCTAssertFalse(ByteSearch.asciiCaseInsensitiveEqual(lhs, other))
+            }
+        }
+    }
+
+    func testAsciiCaseInsensitiveEqualKernels() {
+        let dispatch = ByteSearch.asciiCaseInsensitiveEqualDispatch
+        let scalar = dispatch.kernel(for: .baseline)
+        let alphabet = Array("aAzZ@[`{0 \u{7F}".utf8) + [0xC1, 0xE1, 0xFF]
+
+        var lhs = [UInt8](repeating: 0, count: 200)
+        var rhs = [UInt8](repeating: 0, count: 200)
+        for index in 0..<lhs.count {
+            lhs[index] = alphabet[index % alphabet.count]
+            rhs[index] = lhs[index] ^ (lhs[index] >= 0x41 && lhs[index] <= 0x5A ? 0x20 : 0)
+        }
+
+        for level in dispatch.supportedLevels {
+            let kernel = dispatch.kernel(for: level)
+
+            for count in 0...lhs.count {
+                XCTAssertTrue(kernel(lhs, rhs, count), "\(level)")
+            }
+
+            for position in 0..<lhs.count {
+                for byte in alphabet {
+                    var changed = rhs
+                    changed[position] = byte
+                    XCTAssertEqual(kernel(lhs, changed, lhs.count), scalar(lhs, changed, lhs.count), "\(level)")
+                }
+            }
+        }
+    }
+
+    func testFirstControlCharacter() {
+        let data: [UInt8] = Array("Host: example.com\t \r\n".utf8)
+
+        data.withUnsafeBytes { buffer in
+            XCTAssertEqual(ByteSearch.firstControlCharacter(in: buffer), 19)
+            XCTAssertNil(ByteSearch.firstControlCharacter(in: UnsafeRawBufferPointer(rebasing: buffer[0..<19])))
+        }
+    }
+
+    func testFindControlKernels() {
+        let dispatch = ByteSearch.findControlDispatch
+        var data = [UInt8](repeating: UInt8(ascii: "a"), count: 100)
+
+        data.withUnsafeMutableBytes { buffer in
+            let base = buffer.baseAddress!
+            for level in dispatch.supportedLevels {
+                let kernel = dispatch.kernel(for: level)
+
+                for byte in 0...UInt8.max {
+                    let isControl = (byte < 0x20 && byte != 0x09) || byte == 0x7F
+
+                    for position in [0, 15, 16, 31, 32, 63, 64, 99] {
+                        buffer[position] = byte
+                        for offset in [0, 1, 7] {
+                            let expected = isControl && position >= offset ? position - offset : buffer.count - offset
+                            XCTAssertEqual(kernel(base + offset, buffer.count - offset), expected, "\(level) \(byte)")
+                        }
+                        buffer[position] = UInt8(ascii: "a")
+                    }
+                }
+            }
+        }
+    }
+}
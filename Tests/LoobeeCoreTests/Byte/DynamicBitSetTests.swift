@@ -0,0 +1,243 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class DynamicBitSetTests: XCTestCase {
+    /// Deterministic pseudo-random bits with the given density in percents.
+    private func makeBitSet(count: Int, density: Int, seed: UInt64) -> DynamicBitSet {
+        var bitset = DynamicBitSet(count: count)
+        var state = seed
+
+        bitset.makeUnique()
+        for wordIndex in 0..<bitset.wordCount {
+            var word: UInt64 = 0
+            for bit in 0..<min(64, count - wordIndex << 6) {
+                state = state &* 6_364_136_223_846_793_005 &+ 1_442_695_040_888_963_407
+                if Int((state >> 33) % 100) < density {
+                    word |= 1 << UInt64(bit)
+                }
+            }
+            bitset.storage.words[wordIndex] = word
+        }
+
+        return bitset
+    }
+
+    func testInit() {
+        let zeros = DynamicBitSet(count: 130)
+        XCTAssertEqual(zeros.count, 130)
+        XCTAssertEqual(zeros.wordCount, 3)
+        XCTAssertTrue(zeros.isAllZeros)
+        XCTAssertFalse(zeros.isAnyOnes)
+
+        let ones = DynamicBitSet(count: 130, repeating: .one)
+        XCTAssertTrue(ones.isAllOnes)
+        XCTAssertEqual(ones.nonzeroBitCount, 130)
+
+        let empty = DynamicBitSet(count: 0)
+        XCTAssertTrue(empty.isAllZeros)
+        XCTAssertTrue(empty.isAllOnes)
+        XCTAssertNil(empty.firstSetBit())
+        XCTAssertEqual(Array(empty.setBitIndices), [])
+    }
+
+    func testSubscript() {
+        var bitset = DynamicBitSet(count: 200)
+
+        bitset[0] = .one
+        bitset[64] = .one
+        bitset[199] = .one
+        XCTAssertEqual(bitset[0], .one)
+        XCTAssertEqual(bitset[1], .zero)
+        XCTAssertEqual(bitset[64], .one)
+        XCTAssertEqual(bitset[199], .one)
+        XCTAssertEqual(bitset.nonzeroBitCount, 3)
+
+        bitset[64] = .zero
+        XCTAssertEqual(bitset[64], .zero)
+
+        var reference: BitReference<UInt64> = bitset[100]
+        reference.toggle()
+        XCTAssertEqual(bitset[100], .one)
+
+        XCTAssertEqual(bitset.test(199), .one)
+        XCTAssertNil(bitset.test(200))
+        XCTAssertNil(bitset.test(-1))
+    }
+
+    func testCopyOnWrite() {
+        var bitset = DynamicBitSet(count: 100)
+        let copy = bitset
+
+        bitset[10] = .one
+        XCTAssertEqual(bitset[10], .one)
+        XCTAssertEqual(copy[10], .zero)
+
+        var other = bitset
+        other.reset()
+        XCTAssertEqual(bitset[10], .one)
+        XCTAssertTrue(other.isAllZeros)
+    }
+
+    func testSetReset() {
+        var bitset = DynamicBitSet(count: 100)
+
+        bitset.set()
+        XCTAssertTrue(bitset.isAllOnes)
+        XCTAssertEqual(bitset.nonzeroBitCount, 100)
+
+        bitset.reset()
+        XCTAssertTrue(bitset.isAllZeros)
+    }
+
+    func testBitwiseOperations() {
+        for count in [0, 1, 63, 64, 65, 255, 256, 257, 1000, 4099] {
+            let lhs = self.makeBitSet(count: count, density: 50, seed: 1)
+            let rhs = self.makeBitSet(count: count, density: 30, seed: 2)
+
+            let and = lhs & rhs
+            let or = lhs | rhs
+            let xor = lhs ^ rhs
+            let not = ~lhs
+
+            for position in 0..<count {
+                let left = lhs[position] == .one
+                let right = rhs[position] == .one
+
+                XCTAssertEqual(and[position] == .one, left && right)
+                XCTAssertEqual(or[position] == .one, left || right)
+                XCTAssertEqual(xor[position] == .one, left != right)
+                XCTAssertEqual(not[position] == .one, !left)
+            }
+            XCTAssertEqual(not.nonzeroBitCount, count - lhs.nonzeroBitCount)
+            XCTAssertTrue((lhs ^ lhs).isAllZeros)
+            XCTAssertTrue((lhs | not).isAllOnes)
+
+            var inPlace = lhs
+            inPlace &= rhs
+            XCTAssertEqual(inPlace, and)
+            inPlace = lhs
+            inPlace |= rhs
+            XCTAssertEqual(inPlace, or)
+            inPlace = lhs
+            inPlace ^= rhs
+            XCTAssertEqual(inPlace, xor)
+            XCTAssertEqual(lhs, self.makeBitSet(count: count, density: 50, seed: 1))
+        }
+    }
+
+    func testKernels() {
+        let lhs = self.makeBitSet(count: 64 * 71 + 5, density: 50, seed: 3)
+        let rhs = self.makeBitSet(count: 64 * 71 + 5, density: 50, seed: 4)
+        let count = lhs.wordCount
+
+        var expected = [UInt64](repeating: 0, count: count)
+        var actual = [UInt64](repeating: 0, count: count)
+
+        lhs.withUnsafeWords { lhs in
+            rhs.withUnsafeWords { rhs in
+                let binaryDispatches = [DynamicBitSet.andDispatch, DynamicBitSet.orDispatch, DynamicBitSet.xorDispatch]
+                for dispatch in binaryDispatches {
+                    dispatch.kernel(for: .baseline)(&expected, lhs.baseAddress!, rhs.baseAddress!, count)
+                    for level in dispatch.supportedLevels {
+                        dispatch.kernel(for: level)(&actual, lhs.baseAddress!, rhs.baseAddress!, count)
+                        XCTAssertEqual(actual, expected, "\(level)")
+                    }
+                }
+
+                let notDispatch = DynamicBitSet.notDispatch
+                notDispatch.kernel(for: .baseline)(&expected, lhs.baseAddress!, count)
+                for level in notDispatch.supportedLevels {
+                    notDispatch.kernel(for: level)(&actual, lhs.baseAddress!, count)
+                    XCTAssertEqual(actual, expected, "\(level)")
+                }
+
+                let popcountDispatch = DynamicBitSet.popcountDispatch
+                for level in popcountDispatch.supportedLevels {
+                    for count in 0...count {
+                        let expected = lhs[0..<count].reduce(0) { $0 + $1.nonzeroBitCount }
+                        XCTAssertEqual(popcountDispatch.kernel(for: level)(lhs.baseAddress!, count), expected)
+                    }
+                }
+            }
+        }
+    }
+
+    func testFirstSetBit() {
+        var bitset = DynamicBitSet(count: 1000)
+        XCTAssertNil(bitset.firstSetBit())
+
+        bitset[5] = .one
+        bitset[700] = .one
+        XCTAssertEqual(bitset.firstSetBit(), 5)
+        XCTAssertEqual(bitset.firstSetBit(from: 5), 5)
+        XCTAssertEqual(bitset.firstSetBit(from: 6), 700)
+        XCTAssertNil(bitset.firstSetBit(from: 701))
+        XCTAssertNil(bitset.firstSetBit(from: 1000))
+    }
+
+    func testSetBitIndices() {
+        let bitset = self.makeBitSet(count: 3001, density: 10, seed: 5)
+        let expected = (0..<bitset.count).filter { bitset[$0] == .one }
+
+        XCTAssertEqual(Array(bitset.setBitIndices), expected)
+
+        var position = bitset.firstSetBit()
+        var indices: [Int] = []
+        while let index = position {
+            indices.append(index)
+            position = bitset.firstSetBit(from: index + 1)
+        }
+        XCTAssertEqual(indices, expected)
+    }
+
+    func testEquatableAndHashable() {
+        let lhs = self.makeBitSet(count: 500, density: 50, seed: 6)
+        var rhs = self.makeBitSet(count: 500, density: 50, seed: 6)
+
+        XCTAssertEqual(lhs, rhs)
+        XCTAssertEqual(lhs.hashValue, rhs.hashValue)
+        XCTAssertNotEqual(lhs, DynamicBitSet(count: 501))
+
+        rhs[499] = !rhs[499]
+        XCTAssertNotEqual(lhs, rhs)
+    }
+
+    func testRankSelect() {
+        for density in [0, 1, 10, 50, 99, 100] {
+            for count in [0, 1, 64, 511, 512, 513, 5000, 70_001] {
+                let bitset = self.makeBitSet(count: count, density: density, seed: UInt64(count))
+                let index = bitset.makeRankIndex()
+                XCTAssertEqual(index.nonzeroBitCount, bitset.nonzeroBitCount)
+
+                var rank = 0
+                for position in 0..<count {
+                    XCTAssertEqual(index.rank(position), rank)
+                    if bitset[position] == .one {
+                        XCTAssertEqual(index.select(rank), position)
+                        rank += 1
+                    }
+                }
+                XCTAssertEqual(index.rank(count), rank)
+                XCTAssertNil(index.select(rank))
+                XCTAssertNil(index.select(-1))
+            }
+        }
+    }
+
+    func testRankIndexIsSnapshot() {
+        var bitset = DynamicBitSet(count: 100)
+        bitset[10] = .one
+        let index = bitset.makeRankIndex()
+
+        bitset[5] = .one
+        XCTAssertEqual(index.rank(11), 1)
+        XCTAssertEqual(index.select(0), 10)
+    }
+}
@@ -0,0 +1,98 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class IntrusiveAtomicStackTests: XCTestCase {
+    func testPushPop() {
+        let stack = IntrusiveAtomicStack<IntrusiveTestNode>()
+        XCTAssertTrue(stack.isEmpty)
+        XCTAssertNil(stack.pop())
+
+        for value in 0..<3 {
+            stack.push(IntrusiveTestNode(value))
+        }
+        XCTAssertFalse(stack.isEmpty)
+
+        XCTAssertEqual(stack.pop()?.value, 2)
+        XCTAssertEqual(stack.pop()?.value, 1)
+        let last = stack.pop()
+        XCTAssertEqual(last?.value, 0)
+        XCTAssertNil(last?.nextNode)
+        XCTAssertNil(stack.pop())
+        XCTAssertTrue(stack.isEmpty)
+    }
+
+    func testPushAllPopAll() {
+        let stack = IntrusiveAtomicStack<IntrusiveTestNode>()
+        var list = IntrusiveSList<IntrusiveTestNode>(mode: .linear)
+        list.pushBack(IntrusiveTestNode(1))
+        list.pushBack(IntrusiveTestNode(2))
+
+        stack.push(IntrusiveTestNode(3))
+        stack.push(contentsOf: &list)
+        stack.push(IntrusiveTestNode(0))
+        XCTAssertTrue(list.isEmpty)
+
+        var popped = stack.popAll()
+        XCTAssertTrue(stack.isEmpty)
+
+        var values = [Int]()
+        popped.forEach { values.append($0.value) }
+        XCTAssertEqual(values, [0, 1, 2, 3])
+        XCTAssertEqual(popped.last?.value, 3)
+
+        XCTAssertTrue(stack.popAll().isEmpty)
+        popped.removeAll()
+    }
+
+    func testDeinitReleasesNodes() {
+        weak var node: IntrusiveTestNode?
+        do {
+            let stack = IntrusiveAtomicStack<IntrusiveTestNode>()
+            let current = IntrusiveTestNode(0)
+            node = current
+            stack.push(current)
+            stack.push(IntrusiveTestNode(1))
+        }
+
+        XCTAssertNil(node)
+    }
+
+    func testConcurrent() {
+        let stack = IntrusiveAtomicStack<IntrusiveTestNode>()
+        let threadCount = 4
+        let iterations = 10_000
+
+        // Nodes stay alive during the test, as required by `pop()`.
+        let nodes = (0..<64).map { IntrusiveTestNode($0) }
+        for node in nodes {
+            stack.push(node)
+        }
+
+        let threads = (0..<threadCount).map { _ in
+            NativeThread {
+                for _ in 0..<iterations {
+                    if let node = stack.pop() {
+                        stack.push(node)
+                    }
+                }
+            }
+        }
+
+        for thread in threads {
+            thread.join()
+        }
+
+        var values = Set<Int>()
+        while let node = stack.pop() {
+            values.insert(node.value)
+        }
+        XCTAssertEqual(values, Set(0..<64))
+    }
+}
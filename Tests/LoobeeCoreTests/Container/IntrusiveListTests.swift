@@ -0,0 +1,97 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class IntrusiveListTests: XCTestCase {
+    private func values(of list: IntrusiveList<IntrusiveTestNode>) -> [Int] {
+        var result = [Int]()
+        list.forEach { result.append($0.value) }
+
+        return result
+    }
+
+    func testPushPop() {
+        var list = IntrusiveList<IntrusiveTestNode>()
+        XCTAssertTrue(list.isEmpty)
+
+        list.pushBack(IntrusiveTestNode(2))
+        list.pushBack(IntrusiveTestNode(3))
+        list.pushFront(IntrusiveTestNode(1))
+
+        XCTAssertEqual(self.values(of: list), [1, 2, 3])
+        XCTAssertNil(list.first?.prevNode)
+        XCTAssertNil(list.last?.nextNode)
+
+        XCTAssertEqual(list.popBack()?.value, 3)
+        XCTAssertEqual(list.popFront()?.value, 1)
+        let last = list.popFront()
+        XCTAssertEqual(last?.value, 2)
+        XCTAssertNil(last?.nextNode)
+        XCTAssertNil(last?.prevNode)
+        XCTAssertNil(list.popBack())
+        XCTAssertTrue(list.isEmpty)
+    }
+
+    func testInsertRemove() {
+        var list = IntrusiveList<IntrusiveTestNode>()
+        let nodes = (0..<5).map { IntrusiveTestNode($0) }
+        list.pushBack(nodes[2])
+        list.insert(nodes[4], after: nodes[2])
+        list.insert(nodes[0], before: nodes[2])
+        list.insert(nodes[1], after: nodes[0])
+        list.insert(nodes[3], before: nodes[4])
+
+        XCTAssertEqual(self.values(of: list), [0, 1, 2, 3, 4])
+        XCTAssert(list.first === nodes[0])
+        XCTAssert(list.last === nodes[4])
+
+        list.remove(nodes[2])
+        XCTAssertEqual(self.values(of: list), [0, 1, 3, 4])
+        XCTAssert(nodes[3].prevNode === nodes[1])
+
+        list.remove(nodes[0])
+        list.remove(nodes[4])
+        XCTAssertEqual(self.values(of: list), [1, 3])
+        XCTAssert(list.first === nodes[1])
+        XCTAssert(list.last === nodes[3])
+        XCTAssertNil(nodes[2].nextNode)
+        XCTAssertNil(nodes[2].prevNode)
+    }
+
+    func testAppend() {
+        var list = IntrusiveList<IntrusiveTestNode>()
+        var other = IntrusiveList<IntrusiveTestNode>()
+
+        other.pushBack(IntrusiveTestNode(1))
+        list.append(contentsOf: &other)
+        XCTAssertTrue(other.isEmpty)
+
+        other.pushBack(IntrusiveTestNode(2))
+        other.pushBack(IntrusiveTestNode(3))
+        list.append(contentsOf: &other)
+        XCTAssertEqual(self.values(of: list), [1, 2, 3])
+        XCTAssertEqual(list.last?.prevNode?.value, 2)
+    }
+
+    func testDeinitReleasesNodes() {
+        weak var node: IntrusiveTestNode?
+        do {
+            let box = MoveonlyBox(init: IntrusiveList<IntrusiveTestNode>())
+            for value in 0..<100_000 {
+                let current = IntrusiveTestNode(value)
+                node = node ?? current
+                box.value.pushBack(current)
+            }
+
+            XCTAssertNotNil(node)
+        }
+
+        XCTAssertNil(node)
+    }
+}
@@ -0,0 +1,103 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class IntrusiveMPSCQueueTests: XCTestCase {
+    func testPushPop() {
+        let queue = IntrusiveMPSCQueue<IntrusiveTestNode>()
+        XCTAssertTrue(queue.isEmpty)
+        XCTAssertNil(queue.pop())
+
+        for value in 0..<3 {
+            queue.push(IntrusiveTestNode(value))
+        }
+        XCTAssertFalse(queue.isEmpty)
+
+        XCTAssertEqual(queue.pop()?.value, 0)
+        XCTAssertEqual(queue.pop()?.value, 1)
+        let last = queue.pop()
+        XCTAssertEqual(last?.value, 2)
+        XCTAssertNil(last?.nextNode)
+        XCTAssertNil(queue.pop())
+
+        queue.push(IntrusiveTestNode(3))
+        XCTAssertEqual(queue.pop()?.value, 3)
+    }
+
+    func testPushAllPopAll() {
+        let queue = IntrusiveMPSCQueue<IntrusiveTestNode>()
+        var list = IntrusiveSList<IntrusiveTestNode>(mode: .circular)
+        list.pushBack(IntrusiveTestNode(1))
+        list.pushBack(IntrusiveTestNode(2))
+
+        queue.push(IntrusiveTestNode(0))
+        queue.push(contentsOf: &list)
+        queue.push(IntrusiveTestNode(3))
+        XCTAssertTrue(list.isEmpty)
+
+        var popped = queue.popAll()
+        XCTAssertTrue(queue.isEmpty)
+
+        var values = [Int]()
+        popped.forEach { values.append($0.value) }
+        XCTAssertEqual(values, [0, 1, 2, 3])
+        XCTAssertNil(popped.last?.nextNode)
+
+        XCTAssertTrue(queue.popAll().isEmpty)
+        popped.removeAll()
+    }
+
+    func testDeinitReleasesNodes() {
+        weak var node: IntrusiveTestNode?
+        do {
+            let queue = IntrusiveMPSCQueue<IntrusiveTestNode>()
+            let current = IntrusiveTestNode(0)
+            node = current
+            queue.push(current)
+            queue.push(IntrusiveTestNode(1))
+        }
+
+        XCTAssertNil(node)
+    }
+
+    func testConcurrent() {
+        let queue = IntrusiveMPSCQueue<IntrusiveTestNode>()
+        let producerCount = 4
+        let iterations = 10_000
+
+        let producers = (0..<producerCount).map { producer in
+            NativeThread {
+                for index in 0..<iterations {
+                    queue.push(IntrusiveTestNode(producer * iterations + index))
+                }
+            }
+        }
+
+        var lastValues = [Int](repeating: -1, count: producerCount)
+        var count = 0
+        while count < producerCount * iterations {
+            guard let node = queue.pop() else {
+                NativeThread.yield()
+                continue
+            }
+
+            // Nodes of each producer are received in the order they were pushed.
+            let producer = node.value / iterations
+            XCTAssertGreaterThan(node.value, lastValues[producer])
+            lastValues[producer] = node.value
+            count += 1
+        }
+
+        for producer in producers {
+            producer.join()
+        }
+
+        XCTAssertTrue(queue.isEmpty)
+    }
+}
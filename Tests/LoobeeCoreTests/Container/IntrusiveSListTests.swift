@@ -0,0 +1,131 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal final class IntrusiveTestNode: IntrusiveListNode, IntrusiveSListNode {
+    var nextNode: IntrusiveTestNode?
+    var prevNode: IntrusiveTestNode?
+
+    let value: Int
+
+    init(_ value: Int) {
+        self.value = value
+    }
+}
+
+internal class IntrusiveSListTests: XCTestCase {
+    private func values(of list: IntrusiveSList<IntrusiveTestNode>) -> [Int] {
+        var result = [Int]()
+        list.forEach { result.append($0.value) }
+
+        return result
+    }
+
+    func testPushPop() {
+        var list = IntrusiveSList<IntrusiveTestNode>(mode: .linear)
+        XCTAssertTrue(list.isEmpty)
+
+        list.pushBack(IntrusiveTestNode(2))
+        list.pushBack(IntrusiveTestNode(3))
+        list.pushFront(IntrusiveTestNode(1))
+
+        XCTAssertEqual(self.values(of: list), [1, 2, 3])
+        XCTAssertEqual(list.first?.value, 1)
+        XCTAssertEqual(list.last?.value, 3)
+        XCTAssertNil(list.last?.nextNode)
+
+        XCTAssertEqual(list.popFront()?.value, 1)
+        XCTAssertEqual(list.popFront()?.value, 2)
+        let last = list.popFront()
+        XCTAssertEqual(last?.value, 3)
+        XCTAssertNil(last?.nextNode)
+        XCTAssertNil(list.popFront())
+        XCTAssertTrue(list.isEmpty)
+        XCTAssertNil(list.last)
+    }
+
+    func testCircular() {
+        var list = IntrusiveSList<IntrusiveTestNode>(mode: .circular)
+
+        list.pushBack(IntrusiveTestNode(1))
+        XCTAssert(list.first?.nextNode === list.first)
+
+        list.pushBack(IntrusiveTestNode(2))
+        list.pushBack(IntrusiveTestNode(3))
+        XCTAssert(list.last?.nextNode === list.first)
+
+        list.rotate()
+        XCTAssertEqual(self.values(of: list), [2, 3, 1])
+        XCTAssert(list.last?.nextNode === list.first)
+
+        let first = list.popFront()
+        XCTAssertEqual(first?.value, 2)
+        XCTAssertNil(first?.nextNode)
+        XCTAssertEqual(self.values(of: list), [3, 1])
+        XCTAssert(list.last?.nextNode === list.first)
+
+        list.removeAll()
+        XCTAssertTrue(list.isEmpty)
+    }
+
+    func testInsertRemove() {
+        var list = IntrusiveSList<IntrusiveTestNode>(mode: .linear)
+        let first = IntrusiveTestNode(1)
+        let third = IntrusiveTestNode(3)
+        list.pushBack(first)
+        list.pushBack(third)
+
+        list.insert(IntrusiveTestNode(2), after: first)
+        list.insert(IntrusiveTestNode(4), after: third)
+        XCTAssertEqual(self.values(of: list), [1, 2, 3, 4])
+        XCTAssertEqual(list.last?.value, 4)
+
+        XCTAssertEqual(list.remove(after: third)?.value, 4)
+        XCTAssert(list.last === third)
+        XCTAssertNil(list.remove(after: third))
+        XCTAssertEqual(list.remove(after: first)?.value, 2)
+        XCTAssertEqual(self.values(of: list), [1, 3])
+    }
+
+    func testAppend() {
+        var list = IntrusiveSList<IntrusiveTestNode>(mode: .linear)
+        var other = IntrusiveSList<IntrusiveTestNode>(mode: .circular)
+
+        list.append(contentsOf: &other)
+        XCTAssertTrue(list.isEmpty)
+
+        other.pushBack(IntrusiveTestNode(1))
+        other.pushBack(IntrusiveTestNode(2))
+        list.append(contentsOf: &other)
+        XCTAssertTrue(other.isEmpty)
+        XCTAssertEqual(self.values(of: list), [1, 2])
+        XCTAssertNil(list.last?.nextNode)
+
+        other.pushBack(IntrusiveTestNode(3))
+        list.append(contentsOf: &other)
+        XCTAssertEqual(self.values(of: list), [1, 2, 3])
+        XCTAssertEqual(list.last?.value, 3)
+    }
+
+    func testDeinitReleasesNodes() {
+        weak var node: IntrusiveTestNode?
+        do {
+            let box = MoveonlyBox(init: IntrusiveSList<IntrusiveTestNode>(mode: .circular))
+            for value in 0..<100_000 {
+                let current = IntrusiveTestNode(value)
+                node = node ?? current
+                box.value.pushBack(current)
+            }
+
+            XCTAssertNotNil(node)
+        }
+
+        XCTAssertNil(node)
+    }
+}
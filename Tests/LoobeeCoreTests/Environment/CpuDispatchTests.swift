@@ -0,0 +1,64 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class CpuDispatchTests: XCTestCase {
+    func testSelection() {
+        let implementations: [(level: CpuFeatureLevel, kernel: String)] = [
+            (.avx2, "avx2"),
+            (.baseline, "baseline"),
+        ]
+
+        let baseline = CpuDispatch(implementations, maxLevel: .baseline)
+        XCTAssertEqual(baseline.level, .baseline)
+        XCTAssertEqual(baseline.kernel, "baseline")
+
+        let sse42 = CpuDispatch(implementations, maxLevel: .sse42)
+        XCTAssertEqual(sse42.level, .baseline)
+        XCTAssertEqual(sse42.kernel, "baseline")
+
+        let avx512 = CpuDispatch(implementations, maxLevel: .avx512)
+        XCTAssertEqual(avx512.level, .avx2)
+        XCTAssertEqual(avx512.kernel, "avx2")
+
+        XCTAssertEqual(avx512.implementations.map { $0.level }, [.baseline, .avx2])
+    }
+
+    func testKernelForLevel() {
+        let dispatch = CpuDispatch([(.baseline, 0), (.sse42, 1), (.avx512, 3)], maxLevel: .baseline)
+
+        XCTAssertEqual(dispatch.kernel(for: .baseline), 0)
+        XCTAssertEqual(dispatch.kernel(for: .sse42), 1)
+        XCTAssertEqual(dispatch.kernel(for: .avx2), 1)
+        XCTAssertEqual(dispatch.kernel(for: .avx512), 3)
+    }
+
+    func testSupportedLevels() {
+        let dispatch = CpuDispatch([(.baseline, 0), (.sse42, 1), (.avx2, 2), (.avx512, 3)])
+        let maxLevel = Environment.current.cpuFeatureLevel
+
+        XCTAssertEqual(dispatch.supportedLevels, CpuFeatureLevel.allCases.filter { $0 <= maxLevel })
+        XCTAssertEqual(dispatch.level, maxLevel)
+        XCTAssertEqual(dispatch.kernel, maxLevel.rawValue)
+    }
+
+    func testFeatureLevel() {
+        XCTAssertLessThan(CpuFeatureLevel.baseline, .sse42)
+        XCTAssertLessThan(CpuFeatureLevel.sse42, .avx2)
+        XCTAssertLessThan(CpuFeatureLevel.avx2, .avx512)
+
+        for level in CpuFeatureLevel.allCases {
+            XCTAssertEqual(CpuFeatureLevel(name: level.name), level)
+        }
+        XCTAssertNil(CpuFeatureLevel(name: "native"))
+
+        let detected = CpuFeatureLevel(cpuId: Environment.current.cpuId)
+        XCTAssertLessThanOrEqual(Environment.current.cpuFeatureLevel, detected)
+    }
+}
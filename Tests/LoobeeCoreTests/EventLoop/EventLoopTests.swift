@@ -0,0 +1,125 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(Linux)
+
+import Glibc
+@testable import LoobeeCore
+import XCTest
+
+internal class EventLoopTests: XCTestCase {
+    /// Waits for the condition for at most 10 seconds.
+    private func wait(until condition: () -> Bool) -> Bool {
+        let deadline = EventLoop.now() + 10_000_000_000
+        while !condition() {
+            if EventLoop.now() > deadline {
+                return false
+            }
+            usleep(1000)
+        }
+
+        return true
+    }
+
+    func testAddFromOtherThreads() {
+        let loop = EventLoop()
+        let counter = Atomic<Int>(0)
+
+        let threads = (0..<4).map { _ in
+            NativeThread {
+                for _ in 0..<10_000 {
+                    loop.add {
+                        _ = counter.fetchAndAdd(1)
+                    }
+                }
+            }
+        }
+        for thread in threads {
+            thread.join()
+        }
+
+        XCTAssertTrue(self.wait { counter.load() == 40_000 })
+        loop.shutdown()
+    }
+
+    func testAddFromLoop() {
+        let loop = EventLoop()
+        let mutex = Mutex()
+        var order: [Int] = []
+        let isDone = Atomic<Bool>(false)
+
+        XCTAssertFalse(loop.isInLoop)
+        XCTAssertNil(EventLoop.current)
+
+        loop.add {
+            XCTAssertTrue(loop.isInLoop)
+            XCTAssertTrue(EventLoop.current === loop)
+
+            // Functions added by a function are run after the functions added before.
+            loop.add {
+                mutex.synchronized { order.append(3) }
+                isDone.store(true)
+            }
+            mutex.synchronized { order.append(1) }
+        }
+        loop.add {
+            mutex.synchronized { order.append(2) }
+        }
+
+        XCTAssertTrue(self.wait { isDone.load() })
+        loop.shutdown()
+        XCTAssertEqual(order, [1, 2, 3])
+    }
+
+    func testSchedule() {
+        let loop = EventLoop()
+        let mutex = Mutex()
+        var fired: [Int] = []
+        let isDone = Atomic<Bool>(false)
+        let start = EventLoop.now()
+        var elapsed: UInt64 = 0
+
+        loop.add {
+            loop.schedule(after: 30_000_000) {
+                mutex.synchronized { fired.append(30) }
+            }
+            let cancelled = loop.schedule(after: 20_000_000) {
+                mutex.synchronized { fired.append(20) }
+            }
+            loop.schedule(after: 10_000_000) {
+                mutex.synchronized { fired.append(10) }
+                XCTAssertTrue(loop.cancel(cancelled))
+            }
+            loop.schedule(after: 50_000_000) {
+                elapsed = EventLoop.now() - start
+                isDone.store(true)
+            }
+        }
+
+        XCTAssertTrue(self.wait { isDone.load() })
+        loop.shutdown()
+        XCTAssertEqual(fired, [10, 30])
+        XCTAssertGreaterThanOrEqual(elapsed, 50_000_000)
+    }
+
+    func testShutdownSkipsLaterFunctions() {
+        let loop = EventLoop()
+        let counter = Atomic<Int>(0)
+
+        loop.add {
+            _ = counter.fetchAndAdd(1)
+        }
+        loop.shutdown()
+        loop.add {
+            _ = counter.fetchAndAdd(1)
+        }
+
+        XCTAssertEqual(counter.load(), 1)
+    }
+}
+
+#endif
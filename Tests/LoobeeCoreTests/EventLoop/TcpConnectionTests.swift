@@ -0,0 +1,224 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(Linux)
+
+import Glibc
+@testable import LoobeeCore
+import XCTest
+
+/// Sends the received data back.
+private final class EchoHandler: TcpConnectionHandler {
+    /// Number of callbacks called on a loop thread.
+    private let loopCallCount: Atomic<Int>?
+
+    init(loopCallCount: Atomic<Int>? = nil) {
+        self.loopCallCount = loopCallCount
+    }
+
+    func connection(_ connection: TcpConnection, didRead buffer: IOBuffer) {
+        if EventLoop.current != nil {
+            _ = self.loopCallCount?.fetchAndAdd(1)
+        }
+        connection.write(buffer)
+    }
+
+    func connectionDidClose(_ connection: TcpConnection, error: SocketError?) {
+    }
+}
+
+/// Collects the received data.
+private final class ClientHandler: TcpConnectionHandler {
+    let isOpen = Atomic<Bool>(false)
+    let isClosed = Atomic<Bool>(false)
+
+    private let mutex = Mutex()
+    private var receivedBytes: [UInt8] = []
+    private var closeError: SocketError?
+
+    var received: [UInt8] {
+        return self.mutex.synchronized { self.receivedBytes }
+    }
+
+    var receivedCount: Int {
+        return self.mutex.synchronized { self.receivedBytes.count }
+    }
+
+    var error: SocketError? {
+        return self.mutex.synchronized { self.closeError }
+    }
+
+    func connectionDidOpen(_ connection: TcpConnection) {
+        self.isOpen.store(true)
+    }
+
+    func connection(_ connection: TcpConnection, didRead buffer: IOBuffer) {
+        self.mutex.synchronized {
+            self.receivedBytes.append(contentsOf: buffer.bytes)
+        }
+        buffer.release()
+    }
+
+    func connectionDidClose(_ connection: TcpConnection, error: SocketError?) {
+        self.mutex.synchronized {
+            self.closeError = error
+        }
+        self.isClosed.store(true)
+    }
+}
+
+internal class TcpConnectionTests: XCTestCase {
+    /// Waits for the condition for at most 10 seconds.
+    private func wait(until condition: () -> Bool) -> Bool {
+        let deadline = EventLoop.now() + 10_000_000_000
+        while !condition() {
+            if EventLoop.now() > deadline {
+                return false
+            }
+            usleep(1000)
+        }
+
+        return true
+    }
+
+    private func makeBytes(count: Int) -> [UInt8] {
+        return (0..<count).map { index in
+            UInt8(truncatingIfNeeded: index &* 31 &+ index >> 8)
+        }
+    }
+
+    func testEcho() {
+        let group = EventLoopGroup(loopCount: 2, isPinned: false)
+        let server = TcpServer(group: group) {
+            EchoHandler()
+        }
+        XCTAssertNil(server.start(port: 0))
+        XCTAssertNotEqual(server.port, 0)
+
+        // Writes are queued before the connection is established.
+        let clients = (0..<8).map { index -> (TcpConnection, ClientHandler) in
+            let handler = ClientHandler()
+            let connection = TcpConnection.connect(
+                to: "127.0.0.1",
+                port: server.port,
+                on: group.next(),
+                handler: handler
+            )
+            Array("message \(index)".utf8).withUnsafeBytes { connection.write($0) }
+
+            return (connection, handler)
+        }
+
+        for (index, (connection, handler)) in clients.enumerated() {
+            let expected = Array("message \(index)".utf8)
+            XCTAssertTrue(self.wait { handler.receivedCount == expected.count })
+            XCTAssertTrue(handler.isOpen.load())
+            XCTAssertEqual(handler.received, expected)
+
+            connection.close()
+            XCTAssertTrue(self.wait { handler.isClosed.load() })
+            XCTAssertNil(handler.error)
+        }
+
+        server.stop()
+        group.shutdown()
+    }
+
+    func testLargeWrite() {
+        let group = EventLoopGroup(loopCount: 2, isPinned: false)
+        let server = TcpServer(group: group) {
+            EchoHandler()
+        }
+        XCTAssertNil(server.start(port: 0))
+
+        // Much more than the socket buffers, so both sides get EAGAIN and wait for writability.
+        let bytes = self.makeBytes(count: 8 * 1024 * 1024)
+        let handler = ClientHandler()
+        let connection = TcpConnection.connect(to: "127.0.0.1", port: server.port, on: group.loops[0], handler: handler)
+        bytes.withUnsafeBytes { connection.write($0) }
+
+        XCTAssertTrue(self.wait { handler.receivedCount >= bytes.count })
+        XCTAssertTrue(handler.received == bytes)
+
+        connection.close()
+        XCTAssertTrue(self.wait { handler.isClosed.load() })
+        group.shutdown()
+    }
+
+    func testExecutorKeepsOrder() {
+        let group = EventLoopGroup(loopCount: 2, isPinned: false)
+        let executor = ThreadPoolExecutor(threadCount: 4)
+        let loopCallCount = Atomic<Int>(0)
+        let server = TcpServer(group: group, executor: executor) {
+            EchoHandler(loopCallCount: loopCallCount)
+        }
+        XCTAssertNil(server.start(port: 0))
+
+        let bytes = self.makeBytes(count: 1024 * 1024)
+        let handler = ClientHandler()
+        let connection = TcpConnection.connect(to: "127.0.0.1", port: server.port, on: group.loops[1], handler: handler)
+
+        // Many small writes, the callbacks of the server run on the workers one after another.
+        var offset = 0
+        bytes.withUnsafeBytes { pointer in
+            while offset < pointer.count {
+                let count = min(1000, pointer.count - offset)
+                connection.write(UnsafeRawBufferPointer(rebasing: pointer[offset..<offset + count]))
+                offset += count
+            }
+        }
+
+        XCTAssertTrue(self.wait { handler.receivedCount >= bytes.count })
+        XCTAssertTrue(handler.received == bytes)
+        XCTAssertEqual(loopCallCount.load(), 0)
+
+        connection.close()
+        XCTAssertTrue(self.wait { handler.isClosed.load() })
+        group.shutdown()
+        executor.shutdown()
+    }
+
+    func testConnectionRefused() {
+        // The port of a stopped server is free.
+        let serverGroup = EventLoopGroup(loopCount: 1, isPinned: false)
+        let server = TcpServer(group: serverGroup) {
+            EchoHandler()
+        }
+        XCTAssertNil(server.start(port: 0))
+        serverGroup.shutdown()
+
+        let loop = EventLoop()
+        let handler = ClientHandler()
+        TcpConnection.connect(to: "127.0.0.1", port: server.port, on: loop, handler: handler)
+
+        XCTAssertTrue(self.wait { handler.isClosed.load() })
+        XCTAssertFalse(handler.isOpen.load())
+        XCTAssertEqual(handler.error, SocketError(code: ECONNREFUSED))
+        loop.shutdown()
+    }
+
+    func testShutdownClosesConnections() {
+        let serverGroup = EventLoopGroup(loopCount: 1, isPinned: false)
+        let server = TcpServer(group: serverGroup) {
+            EchoHandler()
+        }
+        XCTAssertNil(server.start(port: 0))
+
+        let loop = EventLoop()
+        let handler = ClientHandler()
+        TcpConnection.connect(to: "127.0.0.1", port: server.port, on: loop, handler: handler)
+        XCTAssertTrue(self.wait { handler.isOpen.load() })
+
+        // The peer sees the end of the stream.
+        serverGroup.shutdown()
+        XCTAssertTrue(self.wait { handler.isClosed.load() })
+        XCTAssertNil(handler.error)
+        loop.shutdown()
+    }
+}
+
+#endif
@@ -0,0 +1,184 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class TimerWheelTests: XCTestCase {
+    func testExpiresInOrder() {
+        let wheel = TimerWheel(tickDuration: 1, now: 1000)
+        var fired: [Int] = []
+
+        for delay in [30, 10, 20, 10] {
+            wheel.schedule(at: 1000 + UInt64(delay)) {
+                fired.append(delay)
+            }
+        }
+        XCTAssertEqual(wheel.count, 4)
+
+        XCTAssertEqual(wheel.advance(to: 1009), 0)
+        XCTAssertEqual(wheel.advance(to: 1010), 2)
+        XCTAssertEqual(fired, [10, 10])
+        XCTAssertEqual(wheel.advance(to: 1100), 2)
+        XCTAssertEqual(fired, [10, 10, 20, 30])
+        XCTAssertEqual(wheel.count, 0)
+    }
+
+    func testDeadlineIsRoundedUpToTick() {
+        let wheel = TimerWheel(tickDuration: 1000, now: 0)
+        var isFired = false
+
+        wheel.schedule(at: 1500) {
+            isFired = true
+        }
+
+        wheel.advance(to: 1999)
+        XCTAssertFalse(isFired)
+        wheel.advance(to: 2000)
+        XCTAssertTrue(isFired)
+    }
+
+    func testPastDeadlineExpiresOnNextTick() {
+        let wheel = TimerWheel(tickDuration: 1, now: 500)
+        var isFired = false
+
+        wheel.schedule(at: 100) {
+            isFired = true
+        }
+
+        wheel.advance(to: 500)
+        XCTAssertFalse(isFired)
+        wheel.advance(to: 501)
+        XCTAssertTrue(isFired)
+    }
+
+    func testCancel() {
+        let wheel = TimerWheel(tickDuration: 1, now: 0)
+        var fired: [Int] = []
+
+        let first = wheel.schedule(at: 10) {
+            fired.append(1)
+        }
+        wheel.schedule(at: 10) {
+            fired.append(2)
+        }
+        let far = wheel.schedule(at: 100_000) {
+            fired.append(3)
+        }
+
+        XCTAssertTrue(wheel.cancel(first))
+        XCTAssertFalse(wheel.cancel(first))
+        XCTAssertTrue(wheel.cancel(far))
+        XCTAssertEqual(wheel.count, 1)
+
+        wheel.advance(to: 1_000_000)
+        XCTAssertEqual(fired, [2])
+
+        // The node of the cancelled timer is reused, the old handle does not cancel the new timer.
+        wheel.schedule(at: 1_000_010) {
+            fired.append(4)
+        }
+        XCTAssertFalse(wheel.cancel(first))
+        wheel.advance(to: 1_000_010)
+        XCTAssertEqual(fired, [2, 4])
+    }
+
+    func testCascade() {
+        let now: UInt64 = 123_456_789
+        let wheel = TimerWheel(tickDuration: 1, now: now)
+        let delays: [UInt64] = [63, 64, 65, 4095, 4096, 300_000, 16_777_215, 16_777_216, 40_000_000]
+        var firedAt: [UInt64: UInt64] = [:]
+        var time = now
+
+        for delay in delays {
+            wheel.schedule(at: now + delay) {
+                firedAt[delay] = time
+            }
+        }
+
+        // Irregular steps, so cascades happen both inside and at the end of an advance.
+        var step: UInt64 = 1
+        while wheel.count > 0 {
+            time += step
+            wheel.advance(to: time)
+            step = step * 7 % 100_003 + 1
+        }
+
+        for delay in delays {
+            guard let fireTime = firedAt[delay] else {
+                XCTFail("Timer \(delay) is not fired")
+                continue
+            }
+
+            XCTAssertGreaterThanOrEqual(fireTime, now + delay)
+        }
+    }
+
+    func testExactExpiration() {
+        let now: UInt64 = (1 << 40) - 5000
+        let wheel = TimerWheel(tickDuration: 1, now: now)
+        var fired: [UInt64] = []
+        var time = now
+
+        // Deadlines cross the boundaries of all levels of the wheel.
+        let deadlines = (0..<200).map { index -> UInt64 in
+            now + UInt64(index * index * index * 37 % 50_000_000 + 1)
+        }
+        for deadline in deadlines {
+            wheel.schedule(at: deadline) {
+                XCTAssertEqual(time, deadline)
+                fired.append(deadline)
+            }
+        }
+
+        // Each advance stops exactly at a deadline or at a time without timers.
+        while let expiration = wheel.nextExpiration {
+            time = expiration
+            wheel.advance(to: time)
+        }
+
+        XCTAssertEqual(fired, deadlines.sorted())
+    }
+
+    func testNextExpiration() {
+        let wheel = TimerWheel(tickDuration: 1000, now: 0)
+        XCTAssertNil(wheel.nextExpiration)
+
+        wheel.schedule(at: 5000) {
+        }
+        XCTAssertEqual(wheel.nextExpiration, 5000)
+
+        wheel.schedule(at: 3_000_000) {
+        }
+        wheel.advance(to: 5000)
+        XCTAssertEqual(wheel.count, 1)
+
+        // The timer is on level 1, the wheel must be advanced when its slot is cascaded.
+        XCTAssertEqual(wheel.nextExpiration, 2_944_000)
+        wheel.advance(to: 2_944_000)
+        XCTAssertEqual(wheel.nextExpiration, 3_000_000)
+    }
+
+    func testScheduleFromCallback() {
+        let wheel = TimerWheel(tickDuration: 1, now: 0)
+        var fireCount = 0
+
+        func reschedule() {
+            fireCount += 1
+            if fireCount < 100 {
+                wheel.schedule(at: UInt64(fireCount * 10), reschedule)
+            }
+        }
+        wheel.schedule(at: 0, reschedule)
+
+        for time in 0...1000 {
+            wheel.advance(to: UInt64(time))
+        }
+
+        XCTAssertEqual(fireCount, 100)
+    }
+}
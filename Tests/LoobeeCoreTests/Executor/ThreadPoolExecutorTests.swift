@@ -0,0 +1,138 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class ThreadPoolExecutorTests: XCTestCase {
+    private func waitUntil(_ counter: Atomic<Int>, reaches value: Int) {
+        while counter.load() < value {
+            NativeThread.yield()
+        }
+    }
+
+    func testPriorityIndex() {
+        XCTAssertEqual(ExecutorPriority.low.index(numPriorities: 3), 0)
+        XCTAssertEqual(ExecutorPriority.medium.index(numPriorities: 3), 1)
+        XCTAssertEqual(ExecutorPriority.high.index(numPriorities: 3), 2)
+        XCTAssertEqual(ExecutorPriority.custom(value: -128).index(numPriorities: 3), 0)
+        XCTAssertEqual(ExecutorPriority.custom(value: 100).index(numPriorities: 1), 0)
+        XCTAssertEqual(ExecutorPriority.custom(value: 64).index(numPriorities: 2), 0)
+        XCTAssertEqual(ExecutorPriority.custom(value: 127).index(numPriorities: 2), 1)
+    }
+
+    func testAdd() {
+        let executor = ThreadPoolExecutor(threadCount: 4)
+        let counter = Atomic<Int>(0)
+
+        for _ in 0..<10_000 {
+            executor.add {
+                _ = counter.fetchAndAdd(1)
+            }
+        }
+
+        self.waitUntil(counter, reaches: 10_000)
+        executor.shutdown()
+        XCTAssertEqual(counter.load(), 10_000)
+    }
+
+    func testAddFromWorker() {
+        let executor = ThreadPoolExecutor(threadCount: 4)
+        let counter = Atomic<Int>(0)
+
+        func spawn(depth: Int) {
+            _ = counter.fetchAndAdd(1)
+            if depth == 0 {
+                return
+            }
+
+            executor.add { spawn(depth: depth - 1) }
+            executor.add { spawn(depth: depth - 1) }
+        }
+
+        executor.add { spawn(depth: 12) }
+
+        self.waitUntil(counter, reaches: (1 << 13) - 1)
+        executor.shutdown()
+    }
+
+    func testShutdownRunsPendingTasks() {
+        let executor = ThreadPoolExecutor(threadCount: 2)
+        let counter = Atomic<Int>(0)
+
+        for _ in 0..<1000 {
+            executor.add({ _ = counter.fetchAndAdd(1) }, withPriority: .low)
+        }
+        executor.shutdown()
+
+        XCTAssertEqual(counter.load(), 1000)
+    }
+
+    func testShutdownRunsTasksAddedByPendingTasks() {
+        let executor = ThreadPoolExecutor(threadCount: 2)
+        let counter = Atomic<Int>(0)
+
+        for _ in 0..<1000 {
+            executor.add({
+                executor.add({ _ = counter.fetchAndAdd(1) }, withPriority: .low)
+            }, withPriority: .low)
+        }
+        executor.shutdown()
+
+        XCTAssertEqual(counter.load(), 1000)
+    }
+
+    func testHighPriorityFirst() {
+        let executor = ThreadPoolExecutor(threadCount: 1)
+        let gate = Atomic<Bool>(false)
+        let mutex = Mutex()
+        var order = [ExecutorPriority]()
+
+        executor.add {
+            while !gate.load() {
+                NativeThread.yield()
+            }
+        }
+
+        for _ in 0..<4 {
+            executor.add({ mutex.synchronized { order.append(.low) } }, withPriority: .low)
+        }
+        for _ in 0..<4 {
+            executor.add({ mutex.synchronized { order.append(.high) } }, withPriority: .high)
+        }
+
+        gate.store(true)
+        executor.shutdown()
+
+        XCTAssertEqual(order.count, 8)
+        XCTAssertEqual(order.prefix(3).map { $0.value }, [127, 127, 127])
+    }
+
+    func testLowPriorityIsNotStarved() {
+        let executor = ThreadPoolExecutor(threadCount: 1)
+        let isLowDone = Atomic<Bool>(false)
+        let highCount = Atomic<Int>(0)
+
+        func high() {
+            _ = highCount.fetchAndAdd(1)
+            if !isLowDone.load() {
+                executor.add(high, withPriority: .high)
+                executor.add(high, withPriority: .high)
+            }
+        }
+
+        executor.add(high, withPriority: .high)
+        executor.add({ isLowDone.store(true) }, withPriority: .low)
+
+        while !isLowDone.load() {
+            NativeThread.yield()
+        }
+        executor.shutdown()
+
+        XCTAssertLessThanOrEqual(highCount.load(), 4 * Int(ThreadPoolExecutor.starvationInterval))
+    }
+}
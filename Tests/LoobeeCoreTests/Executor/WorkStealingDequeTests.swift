@@ -0,0 +1,89 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class WorkStealingDequeTests: XCTestCase {
+    func testTakeIsLifo() {
+        let deque = WorkStealingDeque()
+        deque.push(1)
+        deque.push(2)
+        deque.push(3)
+
+        XCTAssertEqual(deque.take(), 3)
+        XCTAssertEqual(deque.take(), 2)
+        XCTAssertEqual(deque.take(), 1)
+        XCTAssertNil(deque.take())
+        XCTAssertTrue(deque.isEmpty)
+    }
+
+    func testStealIsFifo() {
+        let deque = WorkStealingDeque()
+        deque.push(1)
+        deque.push(2)
+        deque.push(3)
+
+        XCTAssertEqual(deque.steal(), 1)
+        XCTAssertEqual(deque.take(), 3)
+        XCTAssertEqual(deque.steal(), 2)
+        XCTAssertNil(deque.steal())
+        XCTAssertTrue(deque.isEmpty)
+    }
+
+    func testGrow() {
+        let deque = WorkStealingDeque(capacity: 4)
+        for element in 1...100 {
+            deque.push(UInt(element))
+        }
+
+        XCTAssertEqual(deque.steal(), 1)
+        for element in (2...100).reversed() {
+            XCTAssertEqual(deque.take(), UInt(element))
+        }
+        XCTAssertNil(deque.take())
+    }
+
+    func testConcurrentSteal() {
+        let deque = WorkStealingDeque(capacity: 16)
+        let elementCount = 100_000
+        let thiefCount = 3
+        let isDone = Atomic<Bool>(false)
+        let sums = (0..<thiefCount).map { _ in Atomic<UInt>(0) }
+
+        let thieves = (0..<thiefCount).map { index in
+            NativeThread {
+                while true {
+                    if let element = deque.steal() {
+                        _ = sums[index].fetchAndAdd(element)
+                    } else if isDone.load() && deque.isEmpty {
+                        return
+                    }
+                }
+            }
+        }
+
+        var ownerSum: UInt = 0
+        for element in 1...elementCount {
+            deque.push(UInt(element))
+            if element % 3 == 0, let taken = deque.take() {
+                ownerSum += taken
+            }
+        }
+        while let taken = deque.take() {
+            ownerSum += taken
+        }
+        isDone.store(true)
+
+        for thief in thieves {
+            thief.join()
+        }
+
+        let total = sums.reduce(ownerSum) { $0 + $1.load() }
+        XCTAssertEqual(total, UInt(elementCount * (elementCount + 1) / 2))
+    }
+}
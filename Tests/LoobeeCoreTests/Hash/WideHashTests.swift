@@ -0,0 +1,124 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+/// Bytes `i * 131 + 7`, the reference values were calculated from them.
+internal func wideHashTestData(count: Int) -> [Byte] {
+    return (0..<count).map { Byte(UInt8(truncatingIfNeeded: $0 &* 131 &+ 7)) }
+}
+
+internal class WideHashTests: XCTestCase {
+    private let reference: [(count: Int, hash: UInt64, seededHash: UInt64)] = [
+        (0, 0x52b52603b26679f2, 0xae90b6ad8918f83a),
+        (1, 0xf01c15fdcba509e6, 0xeb6ceb152b7510bb),
+        (3, 0xa1701e6f6bf2b554, 0x34caf22a3510f4ea),
+        (4, 0x6c1fa5cd557bc25e, 0x921da5fd91585291),
+        (8, 0x0e31e20e092a4b04, 0xbe9c54a7a1fd5129),
+        (9, 0xa0cad507caf43c13, 0xe67b6d0522d0b85c),
+        (16, 0xda0d27f182bb1592, 0x1afc26b49ab073ba),
+        (17, 0xbf1280abd6654c71, 0x6c4dae44da036d58),
+        (32, 0x61576288b4de23d2, 0xde8efab9e80f6215),
+        (33, 0x369be7f854c85fae, 0x018edcdc550f77c6),
+        (64, 0x0232c32f721ee8a1, 0xfc1f9bb61c98f4fa),
+        (100, 0x4da406e6924992ff, 0x4001c4c60330efb3),
+        (128, 0x7296d6403056890b, 0x368b0127e7e3eeef),
+        (129, 0xb980af903b591c4d, 0xb6c1c65ee10bef8e),
+        (200, 0xc5feeef7b156536d, 0x563470d57189d80a),
+        (1024, 0xb3efc1a4d53deaf3, 0x9d5f7c14b89afb39),
+        (1025, 0xb727c910043e107e, 0xb75729610958feda),
+        (2048, 0x5fa5b5868f6903ba, 0x42f78c4724bce4ab),
+        (5000, 0x473c0d065a69f8b6, 0x606db1c0bc16f57a),
+    ]
+
+    private var availableKernels: [WideHash.Kernel] {
+        switch WideHash.kernel {
+        case .scalar:
+            return [.scalar]
+        case .sse2:
+            return [.scalar, .sse2]
+        case .avx2:
+            return [.scalar, .sse2, .avx2]
+        }
+    }
+
+    func testHello() {
+        XCTAssertEqual(wideHash64("Hello, world!"), 0x5deaa5da701ccf19)
+        XCTAssertEqual(wideHash64("Hello, world!"), wideHash128("Hello, world!").low)
+    }
+
+    func testReference() {
+        for (count, hash, seededHash) in self.reference {
+            let data = wideHashTestData(count: count)
+
+            XCTAssertEqual(wideHash64(data), hash, "Count: \(count)")
+            XCTAssertEqual(wideHash64(data, seed: 42), seededHash, "Count: \(count)")
+        }
+    }
+
+    func testReference128() {
+        let reference: [(count: Int, hash: WideHash128)] = [
+            (0, WideHash128(low: 0x52b52603b26679f2, high: 0x77a35b5fb65d2653)),
+            (16, WideHash128(low: 0xda0d27f182bb1592, high: 0xe1983248f9f871eb)),
+            (100, WideHash128(low: 0x4da406e6924992ff, high: 0x5ec1bd8ae8398214)),
+            (129, WideHash128(low: 0xb980af903b591c4d, high: 0xa05f16a8e8cc3148)),
+            (5000, WideHash128(low: 0x473c0d065a69f8b6, high: 0x437d5ba306367cb1)),
+        ]
+
+        for (count, hash) in reference {
+            XCTAssertEqual(wideHash128(wideHashTestData(count: count)), hash, "Count: \(count)")
+        }
+    }
+
+    func testKernelsAreIdentical() {
+        for (count, hash, seededHash) in self.reference {
+            wideHashTestData(count: count).withUnsafeBytes { data in
+                for kernel in self.availableKernels {
+                    XCTAssertEqual(WideHash.hash64(data, seed: 0, kernel: kernel), hash, "\(kernel), \(count)")
+                    XCTAssertEqual(WideHash.hash64(data, seed: 42, kernel: kernel), seededHash, "\(kernel), \(count)")
+                    XCTAssertEqual(
+                        WideHash.hash128(data, seed: 0, kernel: kernel),
+                        WideHash.hash128(data, seed: 0, kernel: .scalar)
+                    )
+                }
+            }
+        }
+    }
+
+    func testUnalignedData() {
+        let data = wideHashTestData(count: 3000)
+
+        data.withUnsafeBytes { data in
+            for offset in 1..<8 {
+                let slice = UnsafeRawBufferPointer(rebasing: data[offset..<(offset + 2000)])
+                XCTAssertEqual(wideHash64(slice), wideHash64(Array(slice).map { Byte($0) }))
+            }
+        }
+    }
+
+    func testOverloads() {
+        let string = "Loobee wide hash"
+        let bytes = Array(string.utf8).map { Byte($0) }
+
+        XCTAssertEqual(wideHash64(string), wideHash64(bytes))
+        XCTAssertEqual(wideHash128(string, seed: 1), wideHash128(bytes, seed: 1))
+        XCTAssertNotEqual(wideHash64(string), wideHash64(string, seed: 1))
+    }
+
+    func testDistribution() {
+        var hashes = Set<UInt64>()
+        var value: UInt64 = 0
+
+        for index in 0..<100_000 {
+            value = UInt64(index)
+            hashes.insert(withUnsafeBytes(of: &value) { wideHash64($0) })
+        }
+
+        XCTAssertEqual(hashes.count, 100_000)
+    }
+}
@@ -0,0 +1,70 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class WideHasherTests: XCTestCase {
+    func testEmpty() {
+        let hasher = WideHasher()
+
+        XCTAssertEqual(hasher.count, 0)
+        XCTAssertEqual(hasher.finalize64(), wideHash64([]))
+        XCTAssertEqual(hasher.finalize128(), wideHash128([]))
+    }
+
+    func testChunks() {
+        for count in [5, 100, 128, 129, 1000, 1024, 1025, 2047, 2048, 2049, 5000, 10_000] {
+            let data = wideHashTestData(count: count)
+            let expected = wideHash128(data, seed: 7)
+
+            for chunkSize in [1, 7, 63, 64, 65, 1000, 1024, 1025, 3000] {
+                let hasher = WideHasher(seed: 7)
+                for start in stride(from: 0, to: count, by: chunkSize) {
+                    hasher.update(Array(data[start..<min(count, start + chunkSize)]))
+                }
+
+                XCTAssertEqual(hasher.count, count)
+                XCTAssertEqual(hasher.finalize64(), expected.low, "Count: \(count), chunk: \(chunkSize)")
+                XCTAssertEqual(hasher.finalize128(), expected, "Count: \(count), chunk: \(chunkSize)")
+            }
+        }
+    }
+
+    func testUpdateAfterFinalize() {
+        let data = wideHashTestData(count: 3000)
+        let hasher = WideHasher()
+
+        hasher.update(Array(data[0..<1500]))
+        _ = hasher.finalize64()
+        hasher.update(Array(data[1500...]))
+
+        XCTAssertEqual(hasher.finalize64(), wideHash64(data))
+    }
+
+    func testKernels() {
+        let data = wideHashTestData(count: 5000)
+
+        for kernel in [WideHash.Kernel.scalar, WideHash.kernel] {
+            let hasher = WideHasher(seed: 0, kernel: kernel)
+            hasher.update(Array(data[0..<1100]))
+            hasher.update(Array(data[1100...]))
+
+            XCTAssertEqual(hasher.finalize64(), 0x473c0d065a69f8b6)
+        }
+    }
+
+    func testReset() {
+        let hasher = WideHasher(seed: 3)
+        hasher.update("Hello")
+        hasher.reset()
+        hasher.update("Hello, world!")
+
+        XCTAssertEqual(hasher.count, 13)
+        XCTAssertEqual(hasher.finalize64(), wideHash64("Hello, world!", seed: 3))
+    }
+}
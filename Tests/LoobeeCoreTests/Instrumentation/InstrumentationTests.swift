@@ -0,0 +1,162 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+@testable import LoobeeCore
+import XCTest
+
+internal class InstrumentationTests: XCTestCase {
+    private func runThreads(count: Int, _ body: @escaping () -> Void) {
+        let threads = (0..<count).map { _ in NativeThread(body) }
+        for thread in threads {
+            thread.join()
+        }
+    }
+
+    func testBucketIndex() {
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: 0), 0)
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: 63), 63)
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: 64), 64)
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: 65), 64)
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: 127), 95)
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: 128), 96)
+        XCTAssertEqual(InstrumentationHistogram.bucketIndex(of: UInt64.max), InstrumentationHistogram.bucketCount - 1)
+
+        // Each value is in its bucket and buckets are not wider than 1/32 of their values.
+        var value: UInt64 = 1
+        while value < UInt64.max / 3 {
+            let index = InstrumentationHistogram.bucketIndex(of: value)
+            let lowerBound = InstrumentationHistogram.lowerBound(ofBucket: index)
+            XCTAssertLessThanOrEqual(lowerBound, value)
+            XCTAssertGreaterThan(InstrumentationHistogram.lowerBound(ofBucket: index + 1), value)
+            XCTAssertLessThanOrEqual(value - lowerBound, lowerBound / 32)
+
+            value = value * 3 + 1
+        }
+    }
+
+    func testSnapshot() {
+        var slots = [UInt64](repeating: 0, count: InstrumentationHistogram.slotCount)
+        for value in UInt64(1)...1000 {
+            slots[InstrumentationHistogram.bucketIndex(of: value)] += 1
+            slots[InstrumentationHistogram.sumIndex] += value
+        }
+        slots[InstrumentationHistogram.maxIndex] = 1000
+
+        let snapshot = InstrumentationHistogramSnapshot(slots: slots)
+        XCTAssertEqual(snapshot.count, 1000)
+        XCTAssertEqual(snapshot.percentileCycles(0), 1)
+        XCTAssertEqual(snapshot.percentileCycles(0.05), 50)
+        XCTAssertEqual(Double(snapshot.percentileCycles(0.5)), 500, accuracy: 500 / 32)
+        XCTAssertEqual(Double(snapshot.percentileCycles(0.99)), 990, accuracy: 990 / 32)
+        XCTAssertEqual(snapshot.percentileCycles(1), 1000)
+        XCTAssertEqual(
+            snapshot.meanNanoseconds,
+            Instrumentation.nanoseconds(fromCycles: 500_500) / 1000,
+            accuracy: 0.001
+        )
+
+        let empty = InstrumentationHistogramSnapshot(slots: [])
+        XCTAssertEqual(empty.count, 0)
+        XCTAssertEqual(empty.percentile(0.99), 0)
+        XCTAssertEqual(empty.meanNanoseconds, 0)
+        XCTAssertEqual(empty.maxNanoseconds, 0)
+    }
+
+    func testCalibration() {
+        XCTAssertGreaterThan(Instrumentation.cyclesPerNanosecond, 0)
+        XCTAssertEqual(
+            Instrumentation.nanoseconds(fromCycles: 1000),
+            1000 / Instrumentation.cyclesPerNanosecond,
+            accuracy: 0.001
+        )
+    }
+
+    func testCounter() {
+        let counter = InstrumentationCounter(name: "test.counter")
+        let alias = InstrumentationCounter(name: "test.counter")
+        XCTAssertEqual(counter.name, "test.counter")
+        let initialValue = counter.value
+
+        // Values of exited threads are kept.
+        self.runThreads(count: 4) {
+            for _ in 0..<1000 {
+                counter.increment()
+            }
+        }
+        alias.increment(by: 10)
+
+        if Instrumentation.isEnabled {
+            XCTAssertEqual(counter.value - initialValue, 4010)
+            XCTAssertEqual(Instrumentation.counters()["test.counter"], counter.value)
+        } else {
+            XCTAssertEqual(counter.value, 0)
+            XCTAssertTrue(Instrumentation.counters().isEmpty)
+        }
+    }
+
+    func testHistogram() {
+        let histogram = InstrumentationHistogram(name: "test.histogram")
+        let initialCount = histogram.snapshot().count
+
+        self.runThreads(count: 2) {
+            for cycles in UInt64(1)...100 {
+                histogram.record(cycles: cycles)
+            }
+        }
+        let result = histogram.measure { 42 }
+        XCTAssertEqual(result, 42)
+
+        let snapshot = histogram.snapshot()
+        if Instrumentation.isEnabled {
+            XCTAssertEqual(snapshot.count - initialCount, 201)
+            XCTAssertNotNil(Instrumentation.histograms()["test.histogram"])
+        } else {
+            XCTAssertEqual(snapshot.count, 0)
+            XCTAssertEqual(Instrumentation.timestamp(), 0)
+        }
+    }
+
+    func testSpans() {
+        let result = Instrumentation.span("test.span.current") { 42 }
+        XCTAssertEqual(result, 42)
+
+        self.runThreads(count: 1) {
+            let span = TraceSpan("test.span.exited")
+            span.end()
+        }
+
+        let trace = Instrumentation.chromeTrace()
+        XCTAssertTrue(trace.hasPrefix("{\"traceEvents\":["))
+        XCTAssertEqual(trace.contains("\"name\":\"test.span.current\""), Instrumentation.isEnabled)
+        XCTAssertEqual(trace.contains("\"name\":\"test.span.exited\""), Instrumentation.isEnabled)
+    }
+
+    func testChromeTraceFormat() {
+        let events = [
+            TraceEvent(name: "a\"b", threadId: 1, start: 1000, end: 3500),
+            TraceEvent(name: "c", threadId: 2, start: 2000, end: 2001),
+        ]
+        let processId = getpid()
+
+        XCTAssertEqual(
+            TraceEvent.chromeTrace(events, cyclesPerNanosecond: 1),
+            "{\"traceEvents\":["
+                + "{\"name\":\"a\\\"b\",\"ph\":\"X\",\"ts\":0.000,\"dur\":2.500,\"pid\":\(processId),\"tid\":1},"
+                + "{\"name\":\"c\",\"ph\":\"X\",\"ts\":1.000,\"dur\":0.001,\"pid\":\(processId),\"tid\":2}"
+                + "],\"displayTimeUnit\":\"ns\"}"
+        )
+        XCTAssertEqual(
+            TraceEvent.chromeTrace([], cyclesPerNanosecond: 1),
+            "{\"traceEvents\":[],\"displayTimeUnit\":\"ns\"}"
+        )
+    }
+}
@@ -0,0 +1,198 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+#if os(OSX)
+import Darwin
+#elseif os(Linux)
+import Glibc
+#endif
+@testable import LoobeeCore
+import XCTest
+
+/// Unlinked temporary file for the output of loggers.
+internal final class LogTestFile {
+    internal let fileDescriptor: Int32
+
+    internal init() {
+        var path = Array("/tmp/loobee-log-XXXXXX".utf8CString)
+        self.fileDescriptor = mkstemp(&path)
+        unlink(path)
+    }
+
+    deinit {
+        close(self.fileDescriptor)
+    }
+
+    /// Lines without the timestamp.
+    internal var messages: [String] {
+        var bytes: [UInt8] = []
+        var chunk = [UInt8](repeating: 0, count: 64 * 1024)
+        var offset: off_t = 0
+        while true {
+            let count = pread(self.fileDescriptor, &chunk, chunk.count, offset)
+            if count <= 0 {
+                break
+            }
+            bytes += chunk[0..<count]
+            offset += off_t(count)
+        }
+
+        return LogTestFile.messages(in: bytes)
+    }
+
+    /// Splits the output into lines and removes timestamps: `2019-03-01T12:00:00.123456Z `.
+    internal static func messages(in bytes: [UInt8]) -> [String] {
+        return bytes.split(separator: UInt8(ascii: "\n")).map { line in
+            let line = Array(line)
+            XCTAssertGreaterThan(line.count, 27)
+            XCTAssertEqual(line[4], UInt8(ascii: "-"))
+            XCTAssertEqual(line[10], UInt8(ascii: "T"))
+            XCTAssertEqual(line[19], UInt8(ascii: "."))
+            XCTAssertEqual(line[26], UInt8(ascii: "Z"))
+
+            return String(decoding: line.dropFirst(28), as: UTF8.self)
+        }
+    }
+}
+
+internal class AsyncLoggerTests: XCTestCase {
+    private static let accepted = LogTemplate("Accepted {count} connections from {host} in {elapsed} ms")
+    private static let record = LogTemplate("Record {producer} {index}")
+
+    func testTemplateFormat() {
+        let format = LogTemplateFormat("a {x} b {}{y")
+        XCTAssertEqual(format.parts.map { String(decoding: $0, as: UTF8.self) }, ["a ", " b ", "{y"])
+        XCTAssertEqual(format.placeholders.map { String(decoding: $0, as: UTF8.self) }, ["{x}", "{}"])
+
+        XCTAssertEqual(LogTemplate("a {x} b {}{y").id, LogTemplate("a {x} b {}{y").id)
+        XCTAssertNotEqual(LogTemplate("a {x} b {}{y").id, LogTemplate("a {x} b").id)
+    }
+
+    func testRecordLayout() {
+        XCTAssertEqual(MemoryLayout<LogRecord>.size, 64)
+    }
+
+    func testLog() {
+        let file = LogTestFile()
+        let logger = AsyncLogger(fileDescriptor: file.fileDescriptor, level: .debug)
+
+        logger.log(.info, AsyncLoggerTests.accepted, .int(-3), .string("local"), .double(1.5))
+        logger.log(.debug, AsyncLoggerTests.accepted, .uint(4))
+        logger.log(.error, LogTemplate("{a} {b} {c} {d}"), .bool(true), .bool(false), .int(1), .int(2))
+        logger.log(.notice, LogTemplate("No arguments"))
+        logger.warning("Cannot open {path}: {reason}", context: ["path": "/a"])
+        logger.flush()
+
+        XCTAssertEqual(file.messages, [
+            "INFO Accepted -3 connections from local in 1.5 ms",
+            "DEBUG Accepted 4 connections from {host} in {elapsed} ms",
+            "ERROR true false 1 2",
+            "NOTICE No arguments",
+            "WARNING Cannot open /a: {reason}",
+        ])
+        XCTAssertEqual(logger.droppedCount, 0)
+    }
+
+    func testLevel() {
+        let file = LogTestFile()
+        let logger = AsyncLogger(fileDescriptor: file.fileDescriptor, level: .warning)
+
+        XCTAssertTrue(logger.isEnabled(.emergency))
+        XCTAssertTrue(logger.isEnabled(.warning))
+        XCTAssertFalse(logger.isEnabled(.notice))
+
+        logger.log(.info, AsyncLoggerTests.accepted, .int(1))
+        logger.debug("Debug")
+        logger.log(.critical, AsyncLoggerTests.accepted, .int(2))
+        logger.shutdown()
+
+        XCTAssertEqual(file.messages, ["CRITICAL Accepted 2 connections from {host} in {elapsed} ms"])
+    }
+
+    func testDropWhenFull() {
+        var descriptors: [Int32] = [0, 0]
+        XCTAssertEqual(pipe(&descriptors), 0)
+
+        // Fill the pipe, so the background thread blocks on the first write.
+        let flags = fcntl(descriptors[1], F_GETFL)
+        _ = fcntl(descriptors[1], F_SETFL, flags | O_NONBLOCK)
+        var filler = [UInt8](repeating: UInt8(ascii: "."), count: 4096)
+        while write(descriptors[1], &filler, filler.count) > 0 {
+        }
+        _ = fcntl(descriptors[1], F_SETFL, flags)
+
+        // The background thread can format records until its batch is full, then the ring fills up.
+        let logger = AsyncLogger(fileDescriptor: descriptors[1], capacity: 8, overflowPolicy: .drop)
+        var recordCount = 0
+        while logger.droppedCount < 100 {
+            logger.log(.info, AsyncLoggerTests.record, .string("p"), .int(recordCount))
+            recordCount += 1
+        }
+
+        var output: [UInt8] = []
+        let reader = NativeThread {
+            var chunk = [UInt8](repeating: 0, count: 64 * 1024)
+            while true {
+                let count = read(descriptors[0], &chunk, chunk.count)
+                if count <= 0 {
+                    break
+                }
+                output += chunk[0..<count]
+            }
+        }
+
+        logger.shutdown()
+        close(descriptors[1])
+        reader.join()
+        close(descriptors[0])
+
+        let messages = LogTestFile.messages(in: Array(output.drop { $0 == UInt8(ascii: ".") }))
+        let written = messages.filter { $0.hasPrefix("INFO Record p ") }
+        let reported = messages.filter { $0.hasPrefix("WARNING AsyncLogger: ") }.map { message -> Int in
+            Int(message.split(separator: " ")[2])!
+        }
+
+        XCTAssertEqual(written.count + logger.droppedCount, recordCount)
+        XCTAssertEqual(reported.reduce(0, +), logger.droppedCount)
+    }
+
+    func testConcurrentProducers() {
+        let file = LogTestFile()
+        let logger = AsyncLogger(fileDescriptor: file.fileDescriptor, capacity: 256, overflowPolicy: .block)
+        let producerCount = 4
+        let iterations = 10_000
+
+        let producers = (0..<producerCount).map { producer in
+            NativeThread {
+                for index in 0..<iterations {
+                    if index % 2 == 0 {
+                        logger.log(.info, AsyncLoggerTests.record, .int(producer), .int(index))
+                    } else {
+                        logger.log(.info, AsyncLoggerTests.record, .string(String(producer)), .int(index))
+                    }
+                }
+            }
+        }
+        for producer in producers {
+            producer.join()
+        }
+        logger.shutdown()
+
+        // Records of each producer are written in the order they were logged.
+        var nextIndices = [Int](repeating: 0, count: producerCount)
+        let messages = file.messages
+        for message in messages {
+            let fields = message.split(separator: " ")
+            let producer = Int(fields[2])!
+            XCTAssertEqual(Int(fields[3])!, nextIndices[producer])
+            nextIndices[producer] += 1
+        }
+
+        XCTAssertEqual(messages.count, producerCount * iterations)
+        XCTAssertEqual(logger.droppedCount, 0)
+    }
+}
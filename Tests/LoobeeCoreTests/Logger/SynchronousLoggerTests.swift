@@ -0,0 +1,27 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class SynchronousLoggerTests: XCTestCase {
+    func testLog() {
+        let file = LogTestFile()
+        let logger = SynchronousLogger(fileDescriptor: file.fileDescriptor, level: .notice)
+
+        logger.error("Cannot open {path}: {reason}", context: ["path": "/a", "reason": "denied"])
+        logger.info("Filtered")
+        logger.notice("{unknown} {", context: ["path": "/a"])
+        logger.log(.alert, "No context", context: [:])
+
+        XCTAssertEqual(file.messages, [
+            "ERROR Cannot open /a: denied",
+            "NOTICE {unknown} {",
+            "ALERT No context",
+        ])
+    }
+}
@@ -0,0 +1,103 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class MemoryArenaTests: XCTestCase {
+    func testAllocateAlignment() {
+        let arena = MemoryArena()
+
+        let byte: UnsafeMutablePointer<UInt8> = arena.allocate(count: 1)
+        byte.pointee = 1
+
+        let aligned: UnsafeMutablePointer<UInt64> = arena.allocate(count: 4, alignment: .custom(size: 32))
+        XCTAssertEqual(Address(bitPattern: aligned) % 32, 0)
+
+        let natural: UnsafeMutablePointer<UInt64> = arena.allocate(count: 1)
+        XCTAssertEqual(Address(bitPattern: natural) % MemoryLayout<UInt64>.alignment, 0)
+        XCTAssertGreaterThanOrEqual(Address(bitPattern: natural), Address(bitPattern: aligned + 4))
+
+        let raw = arena.allocate(size: 3, alignment: .system)
+        XCTAssertEqual(Address(bitPattern: raw) % Alignment.system.size, 0)
+
+        XCTAssertEqual(arena.blockCount, 1)
+    }
+
+    func testGrowth() {
+        let arena = MemoryArena(initialBlockSize: 128, maxBlockSize: 512)
+
+        for _ in 0..<16 {
+            let pointer: UnsafeMutablePointer<UInt8> = arena.allocate(count: 100)
+            pointer.initialize(repeating: 0xff, count: 100)
+        }
+
+        XCTAssertGreaterThan(arena.blockCount, 1)
+        XCTAssertGreaterThanOrEqual(arena.capacity, 1600)
+
+        let big: UnsafeMutablePointer<UInt8> = arena.allocate(count: 4096)
+        big.initialize(repeating: 0, count: 4096)
+        XCTAssertGreaterThanOrEqual(arena.capacity, 1600 + 4096)
+    }
+
+    func testReset() {
+        let arena = MemoryArena(initialBlockSize: 128, maxBlockSize: 1024)
+
+        let first: UnsafeMutablePointer<UInt64> = arena.allocate(count: 1)
+        for _ in 0..<32 {
+            let _: UnsafeMutablePointer<UInt64> = arena.allocate(count: 8)
+        }
+
+        XCTAssertGreaterThan(arena.blockCount, 1)
+
+        arena.reset()
+
+        XCTAssertEqual(arena.blockCount, 1)
+        XCTAssertEqual(arena.capacity, 128)
+
+        let reused: UnsafeMutablePointer<UInt64> = arena.allocate(count: 1)
+        XCTAssertEqual(reused, first)
+    }
+
+    func testRewind() {
+        let arena = MemoryArena(initialBlockSize: 128, maxBlockSize: 1024)
+
+        let _: UnsafeMutablePointer<UInt64> = arena.allocate(count: 2)
+        let checkpoint = arena.checkpoint()
+        let expected: UnsafeMutablePointer<UInt64> = arena.allocate(count: 1)
+
+        for _ in 0..<32 {
+            let _: UnsafeMutablePointer<UInt64> = arena.allocate(count: 8)
+        }
+
+        arena.rewind(to: checkpoint)
+
+        XCTAssertEqual(arena.blockCount, 1)
+
+        let actual: UnsafeMutablePointer<UInt64> = arena.allocate(count: 1)
+        XCTAssertEqual(actual, expected)
+    }
+
+    func testWithScope() {
+        let arena = MemoryArena(initialBlockSize: 128, maxBlockSize: 1024)
+
+        let before = arena.checkpoint()
+        let result: Int = arena.withScope {
+            for _ in 0..<32 {
+                let _: UnsafeMutablePointer<UInt64> = arena.allocate(count: 8)
+            }
+
+            return arena.blockCount
+        }
+        let after = arena.checkpoint()
+
+        XCTAssertGreaterThan(result, 1)
+        XCTAssertEqual(arena.blockCount, 1)
+        XCTAssert(before.block === after.block)
+        XCTAssertEqual(before.offset, after.offset)
+    }
+}
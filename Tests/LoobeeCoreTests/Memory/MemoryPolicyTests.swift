@@ -0,0 +1,125 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class MemoryPolicyTests: XCTestCase {
+    private func checkAllocation(policy: MemoryPolicy, count: Count, alignment: Alignment) {
+        let allocator = AlignedSystemAllocator<UInt64>(policy: policy)
+        let pointer = allocator.allocate(count: count, alignment: alignment)
+
+        XCTAssertEqual(Address(bitPattern: pointer) % alignment.size, 0)
+        if policy.pageSize != .system {
+            XCTAssertEqual(Address(bitPattern: pointer) % MemoryPolicy.hugePageSize, 0)
+        }
+
+        for index in 0..<count {
+            pointer[index] = UInt64(index)
+        }
+        XCTAssertEqual(pointer[count - 1], UInt64(count - 1))
+
+        allocator.deallocate(pointer, count: count)
+    }
+
+    func testDefault() {
+        XCTAssertTrue(MemoryPolicy.default.isDefault)
+        XCTAssertTrue(MemoryPolicy().isDefault)
+        XCTAssertFalse(MemoryPolicy(isPrefaulted: true).isDefault)
+        XCTAssertFalse(MemoryPolicy(placement: .interleave([])).isDefault)
+
+        XCTAssertEqual(MemoryPolicy.default.roundedSize(100), 100)
+        self.checkAllocation(policy: .default, count: 1000, alignment: .page)
+    }
+
+    func testRoundedSize() {
+        let pageSize = MemoryPolicy.systemPageSize
+        let system = MemoryPolicy(access: .random)
+
+        XCTAssertEqual(system.roundedSize(1), pageSize)
+        XCTAssertEqual(system.roundedSize(pageSize), pageSize)
+        XCTAssertEqual(system.roundedSize(pageSize + 1), pageSize * 2)
+
+        let huge = MemoryPolicy(pageSize: .huge)
+        XCTAssertEqual(huge.roundedSize(1), MemoryPolicy.hugePageSize)
+        XCTAssertEqual(huge.roundedSize(MemoryPolicy.hugePageSize + 1), MemoryPolicy.hugePageSize * 2)
+    }
+
+    func testSystemPages() {
+        self.checkAllocation(policy: MemoryPolicy(access: .sequential), count: 1, alignment: .system)
+        self.checkAllocation(policy: MemoryPolicy(isPrefaulted: true), count: 100_000, alignment: .page)
+
+        // Alignment greater than the page is made by trimming the mapping.
+        self.checkAllocation(policy: MemoryPolicy(access: .random), count: 10, alignment: .custom(size: 1 << 20))
+
+        // An empty allocation maps one page.
+        let allocator = AlignedSystemAllocator<UInt64>(policy: MemoryPolicy(access: .random))
+        let empty = allocator.allocate(count: 0, alignment: .system)
+        XCTAssertEqual(Address(bitPattern: empty) % MemoryPolicy.systemPageSize, 0)
+        allocator.deallocate(empty, count: 0)
+    }
+
+    func testHugePages() {
+        // Without huge pages in the system memory falls back to small pages.
+        let count = MemoryPolicy.hugePageSize / MemoryLayout<UInt64>.stride + 1
+        self.checkAllocation(policy: MemoryPolicy(pageSize: .transparentHuge), count: count, alignment: .system)
+        let prefaulted = MemoryPolicy(pageSize: .huge, isPrefaulted: true)
+        self.checkAllocation(policy: prefaulted, count: count, alignment: .system)
+        self.checkAllocation(
+            policy: MemoryPolicy(pageSize: .huge),
+            count: 10,
+            alignment: .custom(size: 4 * MemoryPolicy.hugePageSize)
+        )
+    }
+
+    func testPlacement() {
+        XCTAssertGreaterThanOrEqual(MemoryPolicy.nodeCount, 1)
+
+        // Node 0 always exists, placement is ignored if the kernel does not support it.
+        let node = MemoryPolicy(placement: .node(0), isPrefaulted: true)
+        self.checkAllocation(policy: node, count: 1000, alignment: .page)
+        self.checkAllocation(
+            policy: MemoryPolicy(pageSize: .transparentHuge, placement: .interleave([]), isPrefaulted: true),
+            count: 1000,
+            alignment: .page
+        )
+    }
+
+    func testArena() {
+        let arena = MemoryArena(initialBlockSize: 100, maxBlockSize: 1 << 20, policy: MemoryPolicy(access: .random))
+        XCTAssertEqual(arena.capacity, MemoryPolicy.systemPageSize)
+
+        let first: UnsafeMutablePointer<UInt8> = arena.allocate(count: MemoryPolicy.systemPageSize)
+        first.initialize(repeating: 1, count: MemoryPolicy.systemPageSize)
+        XCTAssertEqual(arena.blockCount, 1)
+
+        let second: UnsafeMutablePointer<UInt8> = arena.allocate(count: 100)
+        second.initialize(repeating: 2, count: 100)
+        XCTAssertEqual(arena.blockCount, 2)
+        XCTAssertEqual(arena.capacity % MemoryPolicy.systemPageSize, 0)
+
+        arena.reset()
+        XCTAssertEqual(arena.blockCount, 1)
+    }
+
+    func testPoolAllocator() {
+        let policy = MemoryPolicy(pageSize: .transparentHuge)
+        let allocator = PoolAllocator<UInt64>(slabSize: MemoryPolicy.hugePageSize, policy: policy)
+        let pointers = (0..<100_000).map { index -> UnsafeMutablePointer<UInt64> in
+            let pointer = allocator.allocate(count: 1)
+            pointer.pointee = UInt64(index)
+
+            return pointer
+        }
+
+        for (index, pointer) in pointers.enumerated() {
+            XCTAssertEqual(pointer.pointee, UInt64(index))
+            allocator.deallocate(pointer)
+        }
+        XCTAssertEqual(allocator.statistics.liveObjects, 0)
+    }
+}
@@ -0,0 +1,150 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class PoolAllocatorTests: XCTestCase {
+    struct Node {
+        var value: Int
+        var next: UnsafeMutablePointer<Node>?
+    }
+
+    func testAllocate() {
+        let allocator = PoolAllocator<Node>()
+
+        let first = allocator.allocate(count: 1)
+        let second = allocator.allocate(count: 1)
+        first.initialize(to: Node(value: 1, next: second))
+        second.initialize(to: Node(value: 2, next: nil))
+
+        XCTAssertNotEqual(first, second)
+        XCTAssertEqual(Address(bitPattern: first) % MemoryLayout<Node>.alignment, 0)
+        XCTAssertEqual(first.pointee.next?.pointee.value, 2)
+
+        let statistics = allocator.statistics
+        XCTAssertEqual(statistics.slabCount, 1)
+        XCTAssertEqual(statistics.liveObjects, 2)
+        XCTAssertEqual(statistics.remoteDeallocations, 0)
+
+        allocator.deallocate(first)
+        allocator.deallocate(second)
+
+        XCTAssertEqual(allocator.statistics.liveObjects, 0)
+    }
+
+    func testReuse() {
+        let allocator = PoolAllocator<Node>()
+
+        let first = allocator.allocate(count: 1)
+        allocator.deallocate(first)
+
+        XCTAssertEqual(allocator.allocate(count: 1), first)
+    }
+
+    func testSlotCapacity() {
+        let allocator = PoolAllocator<UInt64>(slotCapacity: 4)
+
+        let first = allocator.allocate(count: 4)
+        let second = allocator.allocate(count: 4)
+
+        XCTAssertGreaterThanOrEqual(Address(bitPattern: second) - Address(bitPattern: first), 32)
+    }
+
+    func testSlotSize() {
+        XCTAssertEqual(PoolAllocator<UInt8>().storage.slotSize, MemoryLayout<UInt>.stride)
+        XCTAssertEqual(PoolAllocator<UInt64>(slotCapacity: 3).storage.slotSize, 32)
+        XCTAssertEqual(PoolAllocator<UInt64>(slotCapacity: 8).storage.slotSize, 64)
+        XCTAssertEqual(PoolAllocator<UInt64>(slotCapacity: 9).storage.slotSize, 128)
+    }
+
+    func testGrowth() {
+        let allocator = PoolAllocator<Node>(slabSize: 4096)
+        var nodes = [UnsafeMutablePointer<Node>]()
+
+        for _ in 0..<1000 {
+            nodes.append(allocator.allocate(count: 1))
+        }
+
+        XCTAssertEqual(Set(nodes).count, nodes.count)
+        XCTAssertGreaterThan(allocator.statistics.slabCount, 1)
+        XCTAssertEqual(allocator.statistics.liveObjects, 1000)
+
+        for node in nodes {
+            allocator.deallocate(node)
+        }
+
+        XCTAssertEqual(allocator.statistics.liveObjects, 0)
+    }
+
+    func testRemoteDeallocate() {
+        let slabSize = 4096
+        let allocator = PoolAllocator<Node>(slabSize: slabSize)
+        let slotCount = (slabSize - PoolSlab.headerSize) / allocator.storage.slotSize
+        var nodes = [UnsafeMutablePointer<Node>]()
+
+        for _ in 0..<slotCount {
+            nodes.append(allocator.allocate(count: 1))
+        }
+
+        let thread = NativeThread {
+            for node in nodes {
+                allocator.deallocate(node)
+            }
+        }
+        thread.join()
+
+        let statistics = allocator.statistics
+        XCTAssertEqual(statistics.liveObjects, 0)
+        XCTAssertEqual(statistics.remoteDeallocations, slotCount)
+
+        // Remotely deallocated slots are reused by the owner when the slab is exhausted.
+        var reused = Set<UnsafeMutablePointer<Node>>()
+        for _ in 0..<slotCount {
+            reused.insert(allocator.allocate(count: 1))
+        }
+        XCTAssertEqual(reused, Set(nodes))
+        XCTAssertEqual(allocator.statistics.slabCount, 1)
+    }
+
+    func testConcurrent() {
+        let allocator = PoolAllocator<Node>(slabSize: 4096)
+        let threadCount = 4
+        let iterations = 10_000
+        let handoff = (0..<threadCount).map { _ in Atomic<UInt>(0) }
+
+        let threads = (0..<threadCount).map { index in
+            NativeThread {
+                let next = handoff[(index + 1) % threadCount]
+                for value in 0..<iterations {
+                    let node = allocator.allocate(count: 1)
+                    node.initialize(to: Node(value: value, next: nil))
+
+                    // Pass the node to the neighbour and free the node received from another thread.
+                    let previous = next.exchange(newValue: UInt(bitPattern: node))
+                    if let received = UnsafeMutablePointer<Node>(bitPattern: previous) {
+                        allocator.deallocate(received)
+                    }
+                }
+            }
+        }
+
+        for thread in threads {
+            thread.join()
+        }
+
+        for slot in handoff {
+            if let node = UnsafeMutablePointer<Node>(bitPattern: slot.load()) {
+                allocator.deallocate(node)
+            }
+        }
+
+        let statistics = allocator.statistics
+        XCTAssertEqual(statistics.liveObjects, 0)
+        XCTAssertGreaterThan(statistics.remoteDeallocations, 0)
+    }
+}
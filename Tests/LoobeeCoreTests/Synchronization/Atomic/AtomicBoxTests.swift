@@ -227,4 +227,83 @@ internal class AtomicBoxTests: XCTestCase {
     func testCompareAndExchangeStrongDefault() {
         self.testCompareAndExchange(mode: .strong, withOrder: nil)
     }
+
+    func testRead() {
+        let object = Foo()
+        let box = AtomicBox(object: object)
+
+        XCTAssert(box.read { $0 } === object)
+        XCTAssert(box.read(withOrder: .acquire) { $0 } === object)
+    }
+
+    func testReplacedObjectIsReclaimed() {
+        let domain = EpochReclamation()
+        weak var object: Foo?
+
+        let box: AtomicBox<Foo> = {
+            let foo = Foo()
+            object = foo
+            return AtomicBox(object: foo, reclamation: domain)
+        }()
+
+        box.store(Foo())
+        domain.withCriticalSection {
+            domain.reclaim()
+            XCTAssertNotNil(object)
+        }
+
+        domain.reclaim()
+        XCTAssertNil(object)
+    }
+
+    /// Object that poisons itself on release, so a reader of a released object is detected.
+    final class Payload {
+        static let magic: UInt = 0x5EED_F00D
+
+        var magic: UInt = Payload.magic
+        let value: Int
+
+        init(_ value: Int) {
+            self.value = value
+        }
+
+        deinit {
+            self.magic = 0
+        }
+    }
+
+    func testConcurrentReadersAndWriter() {
+        let readerCount = max(2, NativeThread.processorCount - 1)
+        let swapCount = 20_000
+        let box = AtomicBox(object: Payload(0))
+        var isDone = false
+
+        var failures = [Int](repeating: 0, count: readerCount)
+        failures.withUnsafeMutableBufferPointer { failures in
+            let readers = (0..<readerCount).map { index in
+                NativeThread {
+                    var lastValue = 0
+                    while !isDone.atomicLoad(withOrder: .acquire) {
+                        let (magic, value) = box.read { ($0.magic, $0.value) }
+                        if magic != Payload.magic || value < lastValue {
+                            failures[index] += 1
+                        }
+                        lastValue = value
+                    }
+                }
+            }
+
+            for value in 1...swapCount {
+                box.store(Payload(value))
+            }
+            isDone.atomicStore(true, withOrder: .release)
+
+            for reader in readers {
+                reader.join()
+            }
+        }
+
+        XCTAssertEqual(failures, [Int](repeating: 0, count: readerCount))
+        XCTAssertEqual(box.read { $0.value }, swapCount)
+    }
 }
@@ -29,6 +29,11 @@ internal class AtomicInt32Tests: XCTestCase {
         secondVariant: secondVariant
     )
 
+    let atomicWaitContractTest = AtomicWaitContractTests(
+        firstVariant: firstVariant,
+        secondVariant: secondVariant
+    )
+
     func testIsAlwaysLockFree() {
         self.atomicContractTest.testIsAlwaysLockFree()
     }
@@ -428,4 +433,16 @@ internal class AtomicInt32Tests: XCTestCase {
     func testBitXorAndFetchDefault() {
         self.atomicBitwiseContractTest.testBitXorAndFetchDefault()
     }
+
+    func testWaitNotExpected() {
+        self.atomicWaitContractTest.testWaitNotExpected()
+    }
+
+    func testNotifyOne() {
+        self.atomicWaitContractTest.testNotifyOne()
+    }
+
+    func testNotifyAll() {
+        self.atomicWaitContractTest.testNotifyAll()
+    }
 }
@@ -0,0 +1,200 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+import XCTest
+
+internal class AtomicUInt128Tests: XCTestCase {
+    typealias TestType = AtomicUInt128
+
+    static let firstVariant = TestType(low: 123, high: .max)
+    static let secondVariant = TestType(low: 456, high: 789)
+
+    let atomicContractTest = AtomicContractTests(
+        firstVariant: firstVariant,
+        secondVariant: secondVariant
+    )
+
+    func testIsAlwaysLockFree() {
+        self.atomicContractTest.testIsAlwaysLockFree()
+    }
+
+    func testLoadRelaxed() {
+        self.atomicContractTest.testLoadRelaxed()
+    }
+
+    func testLoadConsume() {
+        self.atomicContractTest.testLoadConsume()
+    }
+
+    func testLoadAcquire() {
+        self.atomicContractTest.testLoadAcquire()
+    }
+
+    func testLoadSeqCst() {
+        self.atomicContractTest.testLoadSeqCst()
+    }
+
+    func testLoadDefault() {
+        self.atomicContractTest.testLoadDefault()
+    }
+
+    func testStoreRelaxed() {
+        self.atomicContractTest.testStoreRelaxed()
+    }
+
+    func testStoreRelease() {
+        self.atomicContractTest.testStoreRelease()
+    }
+
+    func testStoreSeqCst() {
+        self.atomicContractTest.testStoreSeqCst()
+    }
+
+    func testStoreDefault() {
+        self.atomicContractTest.testStoreDefault()
+    }
+
+    func testExchangeRelaxed() {
+        self.atomicContractTest.testExchangeRelaxed()
+    }
+
+    func testExchangeAcquire() {
+        self.atomicContractTest.testExchangeAcquire()
+    }
+
+    func testExchangeRelease() {
+        self.atomicContractTest.testExchangeRelease()
+    }
+
+    func testExchangeAcqRel() {
+        self.atomicContractTest.testExchangeAcqRel()
+    }
+
+    func testExchangeSeqCst() {
+        self.atomicContractTest.testExchangeSeqCst()
+    }
+
+    func testExchangeDefault() {
+        self.atomicContractTest.testExchangeDefault()
+    }
+
+    func testCompareAndExchangeWeakRelaxed() {
+        self.atomicContractTest.testCompareAndExchangeWeakRelaxed()
+    }
+
+    func testCompareAndExchangeWeakConsume() {
+        self.atomicContractTest.testCompareAndExchangeWeakConsume()
+    }
+
+    func testCompareAndExchangeWeakAcquire() {
+        self.atomicContractTest.testCompareAndExchangeWeakAcquire()
+    }
+
+    func testCompareAndExchangeWeakRelease() {
+        self.atomicContractTest.testCompareAndExchangeWeakRelease()
+    }
+
+    func testCompareAndExchangeWeakAcqRel() {
+        self.atomicContractTest.testCompareAndExchangeWeakAcqRel()
+    }
+
+    func testCompareAndExchangeWeakSeqCst() {
+        self.atomicContractTest.testCompareAndExchangeWeakSeqCst()
+    }
+
+    func testCompareAndExchangeWeakDefault() {
+        self.atomicContractTest.testCompareAndExchangeWeakDefault()
+    }
+
+    func testCompareAndExchangeStrongRelaxed() {
+        self.atomicContractTest.testCompareAndExchangeStrongRelaxed()
+    }
+
+    func testCompareAndExchangeStrongConsume() {
+        self.atomicContractTest.testCompareAndExchangeStrongConsume()
+    }
+
+    func testCompareAndExchangeStrongAcquire() {
+        self.atomicContractTest.testCompareAndExchangeStrongAcquire()
+    }
+
+    func testCompareAndExchangeStrongRelease() {
+        self.atomicContractTest.testCompareAndExchangeStrongRelease()
+    }
+
+    func testCompareAndExchangeStrongAcqRel() {
+        self.atomicContractTest.testCompareAndExchangeStrongAcqRel()
+    }
+
+    func testCompareAndExchangeStrongSeqCst() {
+        self.atomicContractTest.testCompareAndExchangeStrongSeqCst()
+    }
+
+    func testCompareAndExchangeStrongDefault() {
+        self.atomicContractTest.testCompareAndExchangeStrongDefault()
+    }
+
+    func testPointerTag() {
+        var value = 0
+        let pointer = withUnsafeMutablePointer(to: &value) { UnsafeMutableRawPointer($0) }
+        let pair = TestType(pointer: pointer, tag: 42)
+
+        XCTAssertEqual(pair.pointer, pointer)
+        XCTAssertEqual(pair.tag, 42)
+        XCTAssertNil(TestType(pointer: nil, tag: 0).pointer)
+    }
+
+    private func testConcurrentIncrement(_ pointer: UnsafeMutablePointer<TestType>) {
+        let threadCount = 4
+        let iterations = 10_000
+
+        let threads = (0..<threadCount).map { _ in
+            NativeThread {
+                var expected = pointer.pointee.atomicLoad()
+                for _ in 0..<iterations {
+                    // Both words must be changed together.
+                    while !pointer.pointee.atomicCompareAndExchangeWeak(
+                        expected: &expected,
+                        desired: TestType(low: expected.low &+ 1, high: expected.high &- 1)
+                    ) {
+                    }
+                }
+            }
+        }
+
+        for thread in threads {
+            thread.join()
+        }
+
+        let result = pointer.pointee.atomicLoad()
+        XCTAssertEqual(result.low, UInt64(threadCount * iterations))
+        XCTAssertEqual(result.high, 0 &- UInt64(threadCount * iterations))
+    }
+
+    func testConcurrentAligned() {
+        let pointer = AlignedSystemAllocator<TestType>().allocate(count: 1, alignment: .custom(size: 16))
+        defer {
+            AlignedSystemAllocator<TestType>().deallocate(pointer)
+        }
+        pointer.initialize(to: TestType())
+
+        self.testConcurrentIncrement(pointer)
+    }
+
+    func testConcurrentUnaligned() {
+        // Misaligned values use the lock.
+        let raw = UnsafeMutableRawPointer.allocate(byteCount: 48, alignment: 16)
+        defer {
+            raw.deallocate()
+        }
+        let pointer = (raw + 8).bindMemory(to: TestType.self, capacity: 1)
+        pointer.initialize(to: TestType())
+
+        self.testConcurrentIncrement(pointer)
+    }
+}
@@ -0,0 +1,69 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+import LoobeeCore
+import XCTest
+
+internal class AtomicWaitContractTests<T: AtomicWaitContract & AtomicContract & Equatable> {
+    let firstVariant: T
+    let secondVariant: T
+
+    init(firstVariant: T, secondVariant: T) {
+        self.firstVariant = firstVariant
+        self.secondVariant = secondVariant
+    }
+
+    func testWaitNotExpected() {
+        var value = self.firstVariant
+
+        value.atomicWait(expected: self.secondVariant)
+
+        XCTAssertEqual(value.atomicLoad(), self.firstVariant)
+    }
+
+    private func testNotify(waiterCount: Int, notifyAll: Bool) {
+        let value = Atomic<T>(self.firstVariant)
+        let waitingCount = Atomic<Int>(0)
+        let firstVariant = self.firstVariant
+
+        let waiters = (0..<waiterCount).map { _ in
+            NativeThread {
+                _ = waitingCount.fetchAndAdd(1)
+                while value.load() == firstVariant {
+                    value.wait(expected: firstVariant)
+                }
+            }
+        }
+
+        while waitingCount.load() < waiterCount {
+            NativeThread.yield()
+        }
+
+        value.store(self.secondVariant)
+        if notifyAll {
+            value.notifyAll()
+        } else {
+            for _ in 0..<waiterCount {
+                value.notifyOne()
+            }
+        }
+
+        for waiter in waiters {
+            waiter.join()
+        }
+
+        XCTAssertEqual(value.load(), self.secondVariant)
+    }
+
+    func testNotifyOne() {
+        self.testNotify(waiterCount: 1, notifyAll: false)
+    }
+
+    func testNotifyAll() {
+        self.testNotify(waiterCount: 4, notifyAll: true)
+    }
+}
@@ -0,0 +1,108 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeCore
+import XCTest
+
+internal class EpochReclamationTests: XCTestCase {
+    final class Foo {}
+
+    func testRetireDefersRelease() {
+        let domain = EpochReclamation()
+        weak var object: Foo?
+
+        do {
+            let foo = Foo()
+            object = foo
+            domain.retire(Unmanaged.passRetained(foo))
+        }
+        XCTAssertNotNil(object)
+        XCTAssertEqual(domain.retiredCount, 1)
+
+        domain.reclaim()
+        XCTAssertNil(object)
+        XCTAssertEqual(domain.retiredCount, 0)
+    }
+
+    func testCriticalSectionBlocksRelease() {
+        let domain = EpochReclamation()
+        weak var object: Foo?
+
+        domain.withCriticalSection {
+            let foo = Foo()
+            object = foo
+            domain.retire(Unmanaged.passRetained(foo))
+
+            domain.withCriticalSection {
+                domain.reclaim()
+            }
+            domain.reclaim()
+            XCTAssertNotNil(object)
+        }
+
+        domain.reclaim()
+        XCTAssertNil(object)
+    }
+
+    func testReaderOfOtherThreadBlocksRelease() {
+        let domain = EpochReclamation()
+        weak var object: Foo?
+        var state = 0
+
+        let reader = NativeThread {
+            domain.withCriticalSection {
+                state.atomicStore(1, withOrder: .seqCst)
+                while state.atomicLoad(withOrder: .seqCst) != 2 {
+                    NativeThread.yield()
+                }
+            }
+        }
+        while state.atomicLoad(withOrder: .seqCst) != 1 {
+            NativeThread.yield()
+        }
+
+        do {
+            let foo = Foo()
+            object = foo
+            domain.retire(Unmanaged.passRetained(foo))
+        }
+        domain.reclaim()
+        XCTAssertNotNil(object)
+
+        state.atomicStore(2, withOrder: .seqCst)
+        reader.join()
+
+        domain.reclaim()
+        XCTAssertNil(object)
+    }
+
+    func testRetireAdvancesEpoch() {
+        let domain = EpochReclamation()
+
+        for _ in 0..<(EpochReclamation.reclaimThreshold * 4) {
+            domain.retire(Unmanaged.passRetained(Foo()))
+        }
+
+        XCTAssertLessThan(domain.retiredCount, EpochReclamation.reclaimThreshold * 2)
+    }
+
+    func testThreadExit() {
+        let domain = EpochReclamation()
+        weak var object: Foo?
+
+        let thread = NativeThread {
+            let foo = Foo()
+            object = foo
+            domain.retire(Unmanaged.passRetained(foo))
+        }
+        thread.join()
+        XCTAssertNotNil(object)
+
+        domain.reclaim()
+        XCTAssertNil(object)
+    }
+}
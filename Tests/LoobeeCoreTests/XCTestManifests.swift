@@ -1,5 +1,16 @@
 import XCTest
 
+extension AsyncLoggerTests {
+    static let __allTests = [
+        ("testConcurrentProducers", testConcurrentProducers),
+        ("testDropWhenFull", testDropWhenFull),
+        ("testLevel", testLevel),
+        ("testLog", testLog),
+        ("testRecordLayout", testRecordLayout),
+        ("testTemplateFormat", testTemplateFormat),
+    ]
+}
+
 extension AtomicBoolTests {
     static let __allTests = [
         ("testCompareAndExchangeStrongAcqRel", testCompareAndExchangeStrongAcqRel),
@@ -51,6 +62,7 @@ extension AtomicBoxTests {
         ("testCompareAndExchangeWeakRelaxed", testCompareAndExchangeWeakRelaxed),
         ("testCompareAndExchangeWeakRelease", testCompareAndExchangeWeakRelease),
         ("testCompareAndExchangeWeakSeqCst", testCompareAndExchangeWeakSeqCst),
+        ("testConcurrentReadersAndWriter", testConcurrentReadersAndWriter),
         ("testExchangeAcqRel", testExchangeAcqRel),
         ("testExchangeAcquire", testExchangeAcquire),
         ("testExchangeDefault", testExchangeDefault),
@@ -63,6 +75,8 @@ extension AtomicBoxTests {
         ("testLoadDefault", testLoadDefault),
         ("testLoadRelaxed", testLoadRelaxed),
         ("testLoadSeqCst", testLoadSeqCst),
+        ("testRead", testRead),
+        ("testReplacedObjectIsReclaimed", testReplacedObjectIsReclaimed),
         ("testStoreDefault", testStoreDefault),
         ("testStoreRelaxed", testStoreRelaxed),
         ("testStoreRelease", testStoreRelease),
@@ -70,6 +84,15 @@ extension AtomicBoxTests {
     ]
 }
 
+extension AtomicDynamicBitSetTests {
+    static let __allTests = [
+        ("testClaimZeroBit", testClaimZeroBit),
+        ("testConcurrentClaim", testConcurrentClaim),
+        ("testSetReset", testSetReset),
+        ("testSnapshot", testSnapshot),
+    ]
+}
+
 extension AtomicInt16Tests {
     static let __allTests = [
         ("testAddAndFetchAcqRel", testAddAndFetchAcqRel),
@@ -266,6 +289,8 @@ extension AtomicInt32Tests {
         ("testLoadDefault", testLoadDefault),
         ("testLoadRelaxed", testLoadRelaxed),
         ("testLoadSeqCst", testLoadSeqCst),
+        ("testNotifyAll", testNotifyAll),
+        ("testNotifyOne", testNotifyOne),
         ("testStoreDefault", testStoreDefault),
         ("testStoreRelaxed", testStoreRelaxed),
         ("testStoreRelease", testStoreRelease),
@@ -277,6 +302,7 @@ extension AtomicInt32Tests {
         ("testSubAndFetchRelaxed", testSubAndFetchRelaxed),
         ("testSubAndFetchRelease", testSubAndFetchRelease),
         ("testSubAndFetchSeqCst", testSubAndFetchSeqCst),
+        ("testWaitNotExpected", testWaitNotExpected),
     ]
 }
 
@@ -621,6 +647,44 @@ extension AtomicTests {
     ]
 }
 
+extension AtomicUInt128Tests {
+    static let __allTests = [
+        ("testCompareAndExchangeStrongAcqRel", testCompareAndExchangeStrongAcqRel),
+        ("testCompareAndExchangeStrongAcquire", testCompareAndExchangeStrongAcquire),
+        ("testCompareAndExchangeStrongConsume", testCompareAndExchangeStrongConsume),
+        ("testCompareAndExchangeStrongDefault", testCompareAndExchangeStrongDefault),
+        ("testCompareAndExchangeStrongRelaxed", testCompareAndExchangeStrongRelaxed),
+        ("testCompareAndExchangeStrongRelease", testCompareAndExchangeStrongRelease),
+        ("testCompareAndExchangeStrongSeqCst", testCompareAndExchangeStrongSeqCst),
+        ("testCompareAndExchangeWeakAcqRel", testCompareAndExchangeWeakAcqRel),
+        ("testCompareAndExchangeWeakAcquire", testCompareAndExchangeWeakAcquire),
+        ("testCompareAndExchangeWeakConsume", testCompareAndExchangeWeakConsume),
+        ("testCompareAndExchangeWeakDefault", testCompareAndExchangeWeakDefault),
+        ("testCompareAndExchangeWeakRelaxed", testCompareAndExchangeWeakRelaxed),
+        ("testCompareAndExchangeWeakRelease", testCompareAndExchangeWeakRelease),
+        ("testCompareAndExchangeWeakSeqCst", testCompareAndExchangeWeakSeqCst),
+        ("testConcurrentAligned", testConcurrentAligned),
+        ("testConcurrentUnaligned", testConcurrentUnaligned),
+        ("testExchangeAcqRel", testExchangeAcqRel),
+        ("testExchangeAcquire", testExchangeAcquire),
+        ("testExchangeDefault", testExchangeDefault),
+        ("testExchangeRelaxed", testExchangeRelaxed),
+        ("testExchangeRelease", testExchangeRelease),
+        ("testExchangeSeqCst", testExchangeSeqCst),
+        ("testIsAlwaysLockFree", testIsAlwaysLockFree),
+        ("testLoadAcquire", testLoadAcquire),
+        ("testLoadConsume", testLoadConsume),
+        ("testLoadDefault", testLoadDefault),
+        ("testLoadRelaxed", testLoadRelaxed),
+        ("testLoadSeqCst", testLoadSeqCst),
+        ("testPointerTag", testPointerTag),
+        ("testStoreDefault", testStoreDefault),
+        ("testStoreRelaxed", testStoreRelaxed),
+        ("testStoreRelease", testStoreRelease),
+        ("testStoreSeqCst", testStoreSeqCst),
+    ]
+}
+
 extension AtomicUInt16Tests {
     static let __allTests = [
         ("testAddAndFetchAcqRel", testAddAndFetchAcqRel),
@@ -817,6 +881,8 @@ extension AtomicUInt32Tests {
         ("testLoadDefault", testLoadDefault),
         ("testLoadRelaxed", testLoadRelaxed),
         ("testLoadSeqCst", testLoadSeqCst),
+        ("testNotifyAll", testNotifyAll),
+        ("testNotifyOne", testNotifyOne),
         ("testStoreDefault", testStoreDefault),
         ("testStoreRelaxed", testStoreRelaxed),
         ("testStoreRelease", testStoreRelease),
@@ -828,6 +894,7 @@ extension AtomicUInt32Tests {
         ("testSubAndFetchRelaxed", testSubAndFetchRelaxed),
         ("testSubAndFetchRelease", testSubAndFetchRelease),
         ("testSubAndFetchSeqCst", testSubAndFetchSeqCst),
+        ("testWaitNotExpected", testWaitNotExpected),
     ]
 }
 
@@ -1167,6 +1234,13 @@ extension BitReferenceTests {
     ]
 }
 
+extension BitScanTests {
+    static let __allTests = [
+        ("testFirstSetBit", testFirstSetBit),
+        ("testFirstSetBitKernels", testFirstSetBitKernels),
+    ]
+}
+
 extension BitSetTests {
     static let __allTests = [
         ("testBitWidth", testBitWidth),
@@ -1200,6 +1274,17 @@ extension BitSetTests {
     ]
 }
 
+extension ByteSearchTests {
+    static let __allTests = [
+        ("testAsciiCaseInsensitiveEqual", testAsciiCaseInsensitiveEqual),
+        ("testAsciiCaseInsensitiveEqualKernels", testAsciiCaseInsensitiveEqualKernels),
+        ("testFindByteKernels", testFindByteKernels),
+        ("testFindControlKernels", testFindControlKernels),
+        ("testFirstControlCharacter", testFirstControlCharacter),
+        ("testFirstIndex", testFirstIndex),
+    ]
+}
+
 extension ByteTests {
     static let __allTests = [
         ("testCustomDebugStringConvertible", testCustomDebugStringConvertible),
@@ -1211,6 +1296,52 @@ extension ByteTests {
     ]
 }
 
+extension CpuDispatchTests {
+    static let __allTests = [
+        ("testFeatureLevel", testFeatureLevel),
+        ("testKernelForLevel", testKernelForLevel),
+        ("testSelection", testSelection),
+        ("testSupportedLevels", testSupportedLevels),
+    ]
+}
+
+extension DynamicBitSetTests {
+    static let __allTests = [
+        ("testBitwiseOperations", testBitwiseOperations),
+        ("testCopyOnWrite", testCopyOnWrite),
+        ("testEquatableAndHashable", testEquatableAndHashable),
+        ("testFirstSetBit", testFirstSetBit),
+        ("testInit", testInit),
+        ("testKernels", testKernels),
+        ("testRankIndexIsSnapshot", testRankIndexIsSnapshot),
+        ("testRankSelect", testRankSelect),
+        ("testSetBitIndices", testSetBitIndices),
+        ("testSetReset", testSetReset),
+        ("testSubscript", testSubscript),
+    ]
+}
+
+extension EpochReclamationTests {
+    static let __allTests = [
+        ("testCriticalSectionBlocksRelease", testCriticalSectionBlocksRelease),
+        ("testReaderOfOtherThreadBlocksRelease", testReaderOfOtherThreadBlocksRelease),
+        ("testRetireAdvancesEpoch", testRetireAdvancesEpoch),
+        ("testRetireDefersRelease", testRetireDefersRelease),
+        ("testThreadExit", testThreadExit),
+    ]
+}
+
+#if os(Linux)
+extension EventLoopTests {
+    static let __allTests = [
+        ("testAddFromLoop", testAddFromLoop),
+        ("testAddFromOtherThreads", testAddFromOtherThreads),
+        ("testSchedule", testSchedule),
+        ("testShutdownSkipsLaterFunctions", testShutdownSkipsLaterFunctions),
+    ]
+}
+#endif
+
 extension Fnv32Tests {
     static let __allTests = [
         ("testBigString", testBigString),
@@ -1253,6 +1384,77 @@ extension Fnva64Tests {
     ]
 }
 
+extension InstrumentationTests {
+    static let __allTests = [
+        ("testBucketIndex", testBucketIndex),
+        ("testCalibration", testCalibration),
+        ("testChromeTraceFormat", testChromeTraceFormat),
+        ("testCounter", testCounter),
+        ("testHistogram", testHistogram),
+        ("testSnapshot", testSnapshot),
+        ("testSpans", testSpans),
+    ]
+}
+
+extension IntrusiveAtomicStackTests {
+    static let __allTests = [
+        ("testConcurrent", testConcurrent),
+        ("testDeinitReleasesNodes", testDeinitReleasesNodes),
+        ("testPushAllPopAll", testPushAllPopAll),
+        ("testPushPop", testPushPop),
+    ]
+}
+
+extension IntrusiveListTests {
+    static let __allTests = [
+        ("testAppend", testAppend),
+        ("testDeinitReleasesNodes", testDeinitReleasesNodes),
+        ("testInsertRemove", testInsertRemove),
+        ("testPushPop", testPushPop),
+    ]
+}
+
+extension IntrusiveMPSCQueueTests {
+    static let __allTests = [
+        ("testConcurrent", testConcurrent),
+        ("testDeinitReleasesNodes", testDeinitReleasesNodes),
+        ("testPushAllPopAll", testPushAllPopAll),
+        ("testPushPop", testPushPop),
+    ]
+}
+
+extension IntrusiveSListTests {
+    static let __allTests = [
+        ("testAppend", testAppend),
+        ("testCircular", testCircular),
+        ("testDeinitReleasesNodes", testDeinitReleasesNodes),
+        ("testInsertRemove", testInsertRemove),
+        ("testPushPop", testPushPop),
+    ]
+}
+
+extension MemoryArenaTests {
+    static let __allTests = [
+        ("testAllocateAlignment", testAllocateAlignment),
+        ("testGrowth", testGrowth),
+        ("testReset", testReset),
+        ("testRewind", testRewind),
+        ("testWithScope", testWithScope),
+    ]
+}
+
+extension MemoryPolicyTests {
+    static let __allTests = [
+        ("testArena", testArena),
+        ("testDefault", testDefault),
+        ("testHugePages", testHugePages),
+        ("testPlacement", testPlacement),
+        ("testPoolAllocator", testPoolAllocator),
+        ("testRoundedSize", testRoundedSize),
+        ("testSystemPages", testSystemPages),
+    ]
+}
+
 extension MoveonlyTests {
     static let __allTests = [
         ("testNoCopy", testNoCopy),
@@ -1260,36 +1462,150 @@ extension MoveonlyTests {
     ]
 }
 
+extension PoolAllocatorTests {
+    static let __allTests = [
+        ("testAllocate", testAllocate),
+        ("testConcurrent", testConcurrent),
+        ("testGrowth", testGrowth),
+        ("testRemoteDeallocate", testRemoteDeallocate),
+        ("testReuse", testReuse),
+        ("testSlotCapacity", testSlotCapacity),
+        ("testSlotSize", testSlotSize),
+    ]
+}
+
 extension StringProtocolTests {
     static let __allTests = [
         ("testCaseInsensitiveASCIICompareString", testCaseInsensitiveASCIICompareString),
     ]
 }
 
+extension SynchronousLoggerTests {
+    static let __allTests = [
+        ("testLog", testLog),
+    ]
+}
+
+#if os(Linux)
+extension TcpConnectionTests {
+    static let __allTests = [
+        ("testConnectionRefused", testConnectionRefused),
+        ("testEcho", testEcho),
+        ("testExecutorKeepsOrder", testExecutorKeepsOrder),
+        ("testLargeWrite", testLargeWrite),
+        ("testShutdownClosesConnections", testShutdownClosesConnections),
+    ]
+}
+#endif
+
+extension ThreadPoolExecutorTests {
+    static let __allTests = [
+        ("testAdd", testAdd),
+        ("testAddFromWorker", testAddFromWorker),
+        ("testHighPriorityFirst", testHighPriorityFirst),
+        ("testLowPriorityIsNotStarved", testLowPriorityIsNotStarved),
+        ("testPriorityIndex", testPriorityIndex),
+        ("testShutdownRunsPendingTasks", testShutdownRunsPendingTasks),
+        ("testShutdownRunsTasksAddedByPendingTasks", testShutdownRunsTasksAddedByPendingTasks),
+    ]
+}
+
+extension TimerWheelTests {
+    static let __allTests = [
+        ("testCancel", testCancel),
+        ("testCascade", testCascade),
+        ("testDeadlineIsRoundedUpToTick", testDeadlineIsRoundedUpToTick),
+        ("testExactExpiration", testExactExpiration),
+        ("testExpiresInOrder", testExpiresInOrder),
+        ("testNextExpiration", testNextExpiration),
+        ("testPastDeadlineExpiresOnNextTick", testPastDeadlineExpiresOnNextTick),
+        ("testScheduleFromCallback", testScheduleFromCallback),
+    ]
+}
+
+extension WideHashTests {
+    static let __allTests = [
+        ("testDistribution", testDistribution),
+        ("testHello", testHello),
+        ("testKernelsAreIdentical", testKernelsAreIdentical),
+        ("testOverloads", testOverloads),
+        ("testReference", testReference),
+        ("testReference128", testReference128),
+        ("testUnalignedData", testUnalignedData),
+    ]
+}
+
+extension WideHasherTests {
+    static let __allTests = [
+        ("testChunks", testChunks),
+        ("testEmpty", testEmpty),
+        ("testKernels", testKernels),
+        ("testReset", testReset),
+        ("testUpdateAfterFinalize", testUpdateAfterFinalize),
+    ]
+}
+
+extension WorkStealingDequeTests {
+    static let __allTests = [
+        ("testConcurrentSteal", testConcurrentSteal),
+        ("testGrow", testGrow),
+        ("testStealIsFifo", testStealIsFifo),
+        ("testTakeIsLifo", testTakeIsLifo),
+    ]
+}
+
 #if !os(macOS)
 public func __allTests() -> [XCTestCaseEntry] {
     return [
+        testCase(AsyncLoggerTests.__allTests),
         testCase(AtomicBoolTests.__allTests),
         testCase(AtomicBoxTests.__allTests),
+        testCase(AtomicDynamicBitSetTests.__allTests),
         testCase(AtomicInt16Tests.__allTests),
         testCase(AtomicInt32Tests.__allTests),
         testCase(AtomicInt64Tests.__allTests),
         testCase(AtomicInt8Tests.__allTests),
         testCase(AtomicIntTests.__allTests),
         testCase(AtomicTests.__allTests),
+        testCase(AtomicUInt128Tests.__allTests),
         testCase(AtomicUInt16Tests.__allTests),
         testCase(AtomicUInt32Tests.__allTests),
         testCase(AtomicUInt64Tests.__allTests),
         testCase(AtomicUInt8Tests.__allTests),
         testCase(AtomicUIntTests.__allTests),
         testCase(BitReferenceTests.__allTests),
+        testCase(BitScanTests.__allTests),
         testCase(BitSetTests.__allTests),
+        testCase(ByteSearchTests.__allTests),
         testCase(ByteTests.__allTests),
+        testCase(CpuDispatchTests.__allTests),
+        testCase(DynamicBitSetTests.__allTests),
+        testCase(EpochReclamationTests.__allTests),
+        #if os(Linux)
+        testCase(EventLoopTests.__allTests),
+        #endif
         testCase(Fnv32Tests.__allTests),
         testCase(Fnv64Tests.__allTests),
         testCase(Fnva64Tests.__allTests),
+        testCase(InstrumentationTests.__allTests),
+        testCase(IntrusiveAtomicStackTests.__allTests),
+        testCase(IntrusiveListTests.__allTests),
+        testCase(IntrusiveMPSCQueueTests.__allTests),
+        testCase(IntrusiveSListTests.__allTests),
+        testCase(MemoryArenaTests.__allTests),
+        testCase(MemoryPolicyTests.__allTests),
         testCase(MoveonlyTests.__allTests),
+        testCase(PoolAllocatorTests.__allTests),
         testCase(StringProtocolTests.__allTests),
+        testCase(SynchronousLoggerTests.__allTests),
+        #if os(Linux)
+        testCase(TcpConnectionTests.__allTests),
+        #endif
+        testCase(ThreadPoolExecutorTests.__allTests),
+        testCase(TimerWheelTests.__allTests),
+        testCase(WideHashTests.__allTests),
+        testCase(WideHasherTests.__allTests),
+        testCase(WorkStealingDequeTests.__allTests),
     ]
 }
 #endif
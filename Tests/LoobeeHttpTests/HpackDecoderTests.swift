@@ -0,0 +1,302 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeHttp
+import XCTest
+
+internal class HpackDecoderTests: XCTestCase {
+    static let commonHeaders: [(String, String)] = [
+        (":authority", "www.example.com"),
+        ("user-agent", "Mozilla/5.0 (X11; Linux x86_64; rv:65.0) Gecko/20100101 Firefox/65.0"),
+        ("accept-language", "en-US,en;q=0.5"),
+        ("accept-encoding", "gzip, deflate, br"),
+        ("cookie", "session=0f3a9c2e7b5d4e61; theme=dark; _ga=GA1.2.1234567890.1550000000"),
+    ]
+
+    /// Headers of a page load: the document, a stylesheet, a script, an image and an API call.
+    static let corpus: [[(String, String)]] = [
+        HpackDecoderTests.request("GET", "/", [("accept", "text/html,application/xhtml+xml,*/*;q=0.8")]),
+        HpackDecoderTests.request(
+            "GET",
+            "/static/css/main.3f9c2e.css",
+            [("accept", "text/css,*/*;q=0.1"), ("referer", "https://www.example.com/")]
+        ),
+        HpackDecoderTests.request(
+            "GET",
+            "/static/js/app.7b5d4e.js",
+            [("accept", "*/*"), ("referer", "https://www.example.com/")]
+        ),
+        HpackDecoderTests.request(
+            "GET",
+            "/images/logo.png",
+            [("accept", "image/webp,*/*"), ("referer", "https://www.example.com/")]
+        ),
+        HpackDecoderTests.request(
+            "POST",
+            "/api/v1/events",
+            [("content-type", "application/json"), ("content-length", "187"), ("x-request-id", "7f9c1e0a")]
+        ),
+    ]
+
+    /// Deterministic generator of pseudo-random numbers.
+    struct Random {
+        var state: UInt64
+
+        mutating func next(_ upperBound: Int) -> Int {
+            self.state = self.state &* 6_364_136_223_846_793_005 &+ 1_442_695_040_888_963_407
+            return Int((self.state >> 33) % UInt64(upperBound))
+        }
+    }
+
+    static func request(_ method: String, _ path: String, _ headers: [(String, String)]) -> [(String, String)] {
+        let pseudoHeaders = [(":method", method), (":scheme", "https"), (":path", path)]
+
+        return pseudoHeaders + HpackDecoderTests.commonHeaders + headers
+    }
+
+    static func bytes(_ hex: String) -> [UInt8] {
+        var result: [UInt8] = []
+        var index = hex.startIndex
+        while index < hex.endIndex {
+            let next = hex.index(index, offsetBy: 2)
+            result.append(UInt8(hex[index..<next], radix: 16)!)
+            index = next
+        }
+
+        return result
+    }
+
+    static func format(_ header: HpackHeaderField) -> String {
+        let field = String(decoding: header.name, as: UTF8.self) + ": " + String(decoding: header.value, as: UTF8.self)
+
+        return header.isSensitive ? field + " (sensitive)" : field
+    }
+
+    static func decode(_ block: [UInt8], with decoder: HpackDecoder) -> (headers: [String], error: HpackDecodeError?) {
+        return block.withUnsafeBytes { buffer -> (headers: [String], error: HpackDecodeError?) in
+            let error = decoder.decode(buffer)
+
+            return (decoder.headers.map(HpackDecoderTests.format), error)
+        }
+    }
+
+    static func decode(_ hex: String, with decoder: HpackDecoder) -> (headers: [String], error: HpackDecodeError?) {
+        return HpackDecoderTests.decode(HpackDecoderTests.bytes(hex), with: decoder)
+    }
+
+    /// RFC7541 Appendix C.2.
+    func testLiterals() {
+        let decoder = HpackDecoder()
+
+        var result = HpackDecoderTests.decode("400a637573746f6d2d6b65790d637573746f6d2d686561646572", with: decoder)
+        XCTAssertNil(result.error)
+        XCTAssertEqual(result.headers, ["custom-key: custom-header"])
+
+        result = HpackDecoderTests.decode("040c2f73616d706c652f70617468", with: decoder)
+        XCTAssertNil(result.error)
+        XCTAssertEqual(result.headers, [":path: /sample/path"])
+
+        result = HpackDecoderTests.decode("100870617373776f726406736563726574", with: decoder)
+        XCTAssertNil(result.error)
+        XCTAssertEqual(result.headers, ["password: secret (sensitive)"])
+
+        result = HpackDecoderTests.decode("82be", with: decoder)
+        XCTAssertNil(result.error)
+        XCTAssertEqual(result.headers, [":method: GET", "custom-key: custom-header"])
+    }
+
+    func testLiteralsReferToBlock() {
+        let decoder = HpackDecoder()
+        let block = HpackDecoderTests.bytes("040c2f73616d706c652f70617468")
+
+        block.withUnsafeBytes { buffer in
+            XCTAssertNil(decoder.decode(buffer))
+            XCTAssertEqual(decoder.headers[0].value.baseAddress, buffer.baseAddress! + 2)
+        }
+    }
+
+    /// RFC7541 Appendix C.3 and C.4.
+    func testRequests() {
+        let blocks = [
+            [
+                "828684410f7777772e6578616d706c652e636f6d",
+                "828684be58086e6f2d6361636865",
+                "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565",
+            ],
+            [
+                "828684418cf1e3c2e5f23a6ba0ab90f4ff",
+                "828684be5886a8eb10649cbf",
+                "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf",
+            ],
+        ]
+        let expected = [
+            [":method: GET", ":scheme: http", ":path: /", ":authority: www.example.com"],
+            [":method: GET", ":scheme: http", ":path: /", ":authority: www.example.com", "cache-control: no-cache"],
+            [
+                ":method: GET", ":scheme: https", ":path: /index.html", ":authority: www.example.com",
+                "custom-key: custom-value",
+            ],
+        ]
+
+        for sequence in blocks {
+            let decoder = HpackDecoder()
+            for (block, headers) in zip(sequence, expected) {
+                let result = HpackDecoderTests.decode(block, with: decoder)
+                XCTAssertNil(result.error)
+                XCTAssertEqual(result.headers, headers)
+            }
+        }
+    }
+
+    /// RFC7541 Appendix C.6 with a dynamic table size update to 256 in the first block.
+    func testResponsesWithEviction() {
+        let decoder = HpackDecoder()
+        let blocks = [
+            "3fe101488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff"
+                + "6e919d29ad171863c78f0b97c8e9ae82ae43d3",
+            "4883640effc1c0bf",
+            "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b"
+                + "3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007",
+        ]
+        let expected = [
+            [
+                ":status: 302", "cache-control: private", "date: Mon, 21 Oct 2013 20:13:21 GMT",
+                "location: https://www.example.com",
+            ],
+            [
+                ":status: 307", "cache-control: private", "date: Mon, 21 Oct 2013 20:13:21 GMT",
+                "location: https://www.example.com",
+            ],
+            [
+                ":status: 200", "cache-control: private", "date: Mon, 21 Oct 2013 20:13:22 GMT",
+                "location: https://www.example.com", "content-encoding: gzip",
+                "set-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+            ],
+        ]
+
+        for (block, headers) in zip(blocks, expected) {
+            let result = HpackDecoderTests.decode(block, with: decoder)
+            XCTAssertNil(result.error)
+            XCTAssertEqual(result.headers, headers)
+            XCTAssertEqual(decoder.maxTableSize, 256)
+        }
+    }
+
+    func testHeaderSize() {
+        let decoder = HpackDecoder()
+
+        XCTAssertNil(HpackDecoderTests.decode("828684418cf1e3c2e5f23a6ba0ab90f4ff", with: decoder).error)
+        XCTAssertEqual(decoder.headerSize.raw, 42 + 43 + 38 + 57)
+        XCTAssertEqual(decoder.headerSize.compressed, 17)
+
+        XCTAssertNil(HpackDecoderTests.decode("", with: decoder).error)
+        XCTAssertTrue(decoder.headers.isEmpty)
+        XCTAssertEqual(decoder.headerSize.raw, 0)
+    }
+
+    func testErrors() {
+        let cases: [(String, HpackDecodeError)] = [
+            ("80", .invalidIndex),
+            ("be", .invalidIndex),
+            ("7f00", .invalidIndex),
+            ("ff", .truncated),
+            ("ff8080808080", .invalidInteger),
+            ("40", .truncated),
+            ("400561", .truncated),
+            ("400161", .truncated),
+            ("4081ff0161", .invalidHuffmanCode),
+            ("00016181ff", .invalidHuffmanCode),
+            ("8220", .invalidTableSizeUpdate),
+            ("3fe21f", .invalidTableSizeUpdate),
+        ]
+
+        for (block, error) in cases {
+            XCTAssertEqual(HpackDecoderTests.decode(block, with: HpackDecoder()).error, error, block)
+        }
+
+        // Updates are allowed only at the start of the block.
+        let decoder = HpackDecoder()
+        XCTAssertNil(HpackDecoderTests.decode("203fe11f82", with: decoder).error)
+        XCTAssertEqual(decoder.maxTableSize, 4096)
+    }
+
+    func testLimits() {
+        let block = "828684418cf1e3c2e5f23a6ba0ab90f4ff"
+
+        var decoder = HpackDecoder(maxHeaderCount: 2)
+        var result = HpackDecoderTests.decode(block, with: decoder)
+        XCTAssertEqual(result.error, .tooManyHeaders)
+        XCTAssertEqual(result.headers, [":method: GET", ":scheme: http"])
+
+        decoder = HpackDecoder(maxHeaderListSize: 179)
+        result = HpackDecoderTests.decode(block, with: decoder)
+        XCTAssertEqual(result.error, .headerListTooLarge)
+        XCTAssertEqual(result.headers.count, 3)
+        XCTAssertEqual(decoder.headerSize.raw, 180)
+
+        // The rest of the block updates the dynamic table.
+        result = HpackDecoderTests.decode("be", with: decoder)
+        XCTAssertNil(result.error)
+        XCTAssertEqual(result.headers, [":authority: www.example.com"])
+    }
+
+    func testHeaderBomb() {
+        let encoder = HpackEncoder()
+        var block: [UInt8] = []
+        encoder.encode(name: "x", value: String(repeating: "a", count: 4000), into: &block)
+        // Each byte references the entry of 4033 bytes.
+        block += [UInt8](repeating: 0xBE, count: 10_000)
+
+        let decoder = HpackDecoder()
+        let result = HpackDecoderTests.decode(block, with: decoder)
+
+        XCTAssertEqual(result.error, .headerListTooLarge)
+        XCTAssertEqual(result.headers.count, 4)
+        XCTAssertEqual(decoder.headerSize.raw, 10_001 * 4033)
+        XCTAssertEqual(decoder.headerSize.compressed, UInt(block.count))
+    }
+
+    func testRoundTrip() {
+        var random = Random(state: 42)
+        let names = [
+            ":method", ":path", ":status", "accept", "cookie", "set-cookie", "x-request-id", "x-custom-header",
+            String(repeating: "n", count: 300),
+        ]
+        let indexings: [HpackEncoder.Indexing] = [.incremental, .incremental, .none, .never]
+
+        for isHuffmanEnabled in [true, false] {
+            let encoder = HpackEncoder(isHuffmanEnabled: isHuffmanEnabled)
+            let decoder = HpackDecoder(maxHeaderListSize: 1 << 20)
+
+            for _ in 0..<500 {
+                if random.next(20) == 0 {
+                    encoder.setMaxTableSize(random.next(4097))
+                }
+
+                var block: [UInt8] = []
+                var expected: [String] = []
+                for _ in 0..<random.next(12) {
+                    let name = names[random.next(names.count)]
+                    let value = String((0..<random.next(random.next(4) == 0 ? 600 : 20)).map { _ in
+                        Character(Unicode.Scalar(UInt8(32 + random.next(95))))
+                    })
+                    let indexing = indexings[random.next(indexings.count)]
+
+                    encoder.encode(name: name, value: value, indexing: indexing, into: &block)
+                    expected.append(name + ": " + value + (indexing == .never ? " (sensitive)" : ""))
+                }
+
+                let result = HpackDecoderTests.decode(block, with: decoder)
+                XCTAssertNil(result.error)
+                XCTAssertEqual(result.headers, expected)
+                if !block.isEmpty {
+                    XCTAssertEqual(decoder.maxTableSize, encoder.maxTableSize)
+                }
+            }
+        }
+    }
+}
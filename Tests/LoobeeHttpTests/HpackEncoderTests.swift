@@ -0,0 +1,202 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeHttp
+import XCTest
+
+internal class HpackEncoderTests: XCTestCase {
+    static let firstRequest = [
+        (":method", "GET"),
+        (":scheme", "http"),
+        (":path", "/"),
+        (":authority", "www.example.com"),
+    ]
+
+    static let secondRequest = HpackEncoderTests.firstRequest + [("cache-control", "no-cache")]
+
+    static let thirdRequest = [
+        (":method", "GET"),
+        (":scheme", "https"),
+        (":path", "/index.html"),
+        (":authority", "www.example.com"),
+        ("custom-key", "custom-value"),
+    ]
+
+    static func hex(_ bytes: [UInt8]) -> String {
+        return bytes.map { String($0 >> 4, radix: 16) + String($0 & 0x0F, radix: 16) }.joined()
+    }
+
+    static func encode(
+        _ fields: [(String, String)],
+        with encoder: HpackEncoder,
+        indexing: HpackEncoder.Indexing = .incremental
+    ) -> String {
+        var block: [UInt8] = []
+        for (name, value) in fields {
+            encoder.encode(name: name, value: value, indexing: indexing, into: &block)
+        }
+
+        return HpackEncoderTests.hex(block)
+    }
+
+    /// RFC7541 Appendix C.3.
+    func testRequestsWithoutHuffman() {
+        let encoder = HpackEncoder(isHuffmanEnabled: false)
+
+        XCTAssertEqual(
+            HpackEncoderTests.encode(HpackEncoderTests.firstRequest, with: encoder),
+            "828684410f7777772e6578616d706c652e636f6d"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode(HpackEncoderTests.secondRequest, with: encoder),
+            "828684be58086e6f2d6361636865"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode(HpackEncoderTests.thirdRequest, with: encoder),
+            "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565"
+        )
+    }
+
+    /// RFC7541 Appendix C.4.
+    func testRequestsWithHuffman() {
+        let encoder = HpackEncoder()
+
+        XCTAssertEqual(
+            HpackEncoderTests.encode(HpackEncoderTests.firstRequest, with: encoder),
+            "828684418cf1e3c2e5f23a6ba0ab90f4ff"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode(HpackEncoderTests.secondRequest, with: encoder),
+            "828684be5886a8eb10649cbf"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode(HpackEncoderTests.thirdRequest, with: encoder),
+            "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"
+        )
+    }
+
+    /// RFC7541 Appendix C.6, except that strings that are not shorter with the Huffman code
+    /// are written as is.
+    func testResponsesWithEviction() {
+        let encoder = HpackEncoder(tableSizeLimit: 256)
+        let date = "Mon, 21 Oct 2013 20:13:21 GMT"
+        let location = "https://www.example.com"
+
+        XCTAssertEqual(
+            HpackEncoderTests.encode(
+                [(":status", "302"), ("cache-control", "private"), ("date", date), ("location", location)],
+                with: encoder
+            ),
+            "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff"
+                + "6e919d29ad171863c78f0b97c8e9ae82ae43d3"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode(
+                [(":status", "307"), ("cache-control", "private"), ("date", date), ("location", location)],
+                with: encoder
+            ),
+            "4803333037c1c0bf"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode(
+                [
+                    (":status", "200"),
+                    ("cache-control", "private"),
+                    ("date", "Mon, 21 Oct 2013 20:13:22 GMT"),
+                    ("location", location),
+                    ("content-encoding", "gzip"),
+                    ("set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"),
+                ],
+                with: encoder
+            ),
+            "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b"
+                + "3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007"
+        )
+    }
+
+    /// RFC7541 Appendix C.2.
+    func testIndexing() {
+        let encoder = HpackEncoder(isHuffmanEnabled: false)
+
+        XCTAssertEqual(
+            HpackEncoderTests.encode([("custom-key", "custom-header")], with: encoder),
+            "400a637573746f6d2d6b65790d637573746f6d2d686561646572"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode([(":path", "/sample/path")], with: encoder, indexing: .none),
+            "040c2f73616d706c652f70617468"
+        )
+        XCTAssertEqual(
+            HpackEncoderTests.encode([("password", "secret")], with: encoder, indexing: .never),
+            "100870617373776f726406736563726574"
+        )
+        XCTAssertEqual(HpackEncoderTests.encode([(":method", "GET")], with: encoder, indexing: .never), "1203474554")
+        XCTAssertEqual(HpackEncoderTests.encode([("custom-key", "custom-header")], with: encoder), "be")
+    }
+
+    func testSensitiveFieldIsNeverIndexed() {
+        let encoder = HpackEncoder()
+
+        XCTAssertEqual(HpackEncoderTests.encode([("authorization", "secret")], with: encoder), "578441496153")
+        XCTAssertEqual(HpackEncoderTests.encode([("authorization", "secret")], with: encoder), "be")
+        XCTAssertEqual(
+            HpackEncoderTests.encode([("authorization", "secret")], with: encoder, indexing: .never),
+            "1f088441496153"
+        )
+    }
+
+    func testTableSizeUpdate() {
+        let encoder = HpackEncoder()
+        XCTAssertEqual(
+            HpackEncoderTests.encode([("custom-key", "custom-value")], with: encoder),
+            "408825a849e95ba97d7f8925a849e95bb8e8b4bf"
+        )
+
+        // The smallest size is written before the final one.
+        encoder.setMaxTableSize(0)
+        encoder.setMaxTableSize(100)
+        XCTAssertEqual(encoder.maxTableSize, 100)
+        XCTAssertEqual(HpackEncoderTests.encode([(":method", "GET")], with: encoder), "203f4582")
+        XCTAssertEqual(HpackEncoderTests.encode([(":method", "GET")], with: encoder), "82")
+
+        // The entry is evicted by the update to 0.
+        XCTAssertEqual(
+            HpackEncoderTests.encode([("custom-key", "custom-value")], with: encoder),
+            "408825a849e95ba97d7f8925a849e95bb8e8b4bf"
+        )
+
+        encoder.setMaxTableSize(50)
+        XCTAssertEqual(HpackEncoderTests.encode([(":method", "GET")], with: encoder), "3f1382")
+    }
+
+    func testLongString() {
+        let encoder = HpackEncoder(isHuffmanEnabled: false)
+        let value = String(repeating: "a", count: 200)
+
+        var block: [UInt8] = []
+        let size = encoder.encode(name: "x-long", value: value, indexing: .none, into: &block)
+
+        XCTAssertEqual(HpackEncoderTests.hex(Array(block[0..<10])), "0006782d6c6f6e677f49")
+        XCTAssertEqual(Array(block[10...]), Array(value.utf8))
+        XCTAssertEqual(size.raw, 6 + 200 + 32)
+        XCTAssertEqual(size.compressed, UInt(block.count))
+    }
+
+    func testHeaderSize() {
+        let encoder = HpackEncoder()
+        var block: [UInt8] = []
+
+        var size = encoder.encode(name: ":method", value: "GET", into: &block)
+        XCTAssertEqual(size.raw, 42)
+        XCTAssertEqual(size.compressed, 1)
+
+        size = encoder.encode(name: ":authority", value: "www.example.com", into: &block)
+        XCTAssertEqual(size.raw, 57)
+        XCTAssertEqual(size.compressed, 14)
+        XCTAssertEqual(block.count, 15)
+    }
+}
@@ -0,0 +1,100 @@
+// This file is part of the Loobee package.
+//
+// (c) Andrey Savitsky <contact@qroc.pro>
+//
+// For the full copyright and license information, please view the LICENSE
+// file that was distributed with this source code.
+
+@testable import LoobeeHttp
+import XCTest
+
+internal class HpackHuffmanTests: XCTestCase {
+    /// Strings of RFC7541 Appendix C.4 and C.6.
+    static let vectors = [
+        ("www.example.com", "f1e3c2e5f23a6ba0ab90f4ff"),
+        ("no-cache", "a8eb10649cbf"),
+        ("custom-key", "25a849e95ba97d7f"),
+        ("custom-value", "25a849e95bb8e8b4bf"),
+        ("302", "6402"),
+        ("private", "aec3771a4b"),
+        ("Mon, 21 Oct 2013 20:13:21 GMT", "d07abe941054d444a8200595040b8166e082a62d1bff"),
+        ("https://www.example.com", "9d29ad171863c78f0b97c8e9ae82ae43d3"),
+    ]
+
+    static func bytes(_ hex: String) -> [UInt8] {
+        var result: [UInt8] = []
+        var index = hex.startIndex
+        while index < hex.endIndex {
+            let next = hex.index(index, offsetBy: 2)
+            result.append(UInt8(hex[index..<next], radix: 16)!)
+            index = next
+        }
+
+        return result
+    }
+
+    static func encode(_ data: [UInt8]) -> [UInt8] {
+        var output: [UInt8] = []
+        data.withUnsafeBytes { HpackHuffman.encode($0, into: &output) }
+
+        return output
+    }
+
+    static func decode(_ data: [UInt8]) -> [UInt8]? {
+        var output = [UInt8](repeating: 0, count: max(1, HpackHuffman.maxDecodedCount(data.count)))
+
+        let count = data.withUnsafeBytes { bytes in
+            output.withUnsafeMutableBufferPointer { HpackHuffman.decode(bytes, into: $0.baseAddress!) }
+        }
+
+        return count.map { Array(output[0..<$0]) }
+    }
+
+    func testEncode() {
+        for (string, hex) in HpackHuffmanTests.vectors {
+            let data = Array(string.utf8)
+
+            XCTAssertEqual(HpackHuffmanTests.encode(data), HpackHuffmanTests.bytes(hex), string)
+            XCTAssertEqual(data.withUnsafeBytes { HpackHuffman.encodedCount($0) }, hex.count / 2, string)
+        }
+
+        XCTAssertEqual(HpackHuffmanTests.encode([]), [])
+    }
+
+    func testDecode() {
+        for (string, hex) in HpackHuffmanTests.vectors {
+            XCTAssertEqual(HpackHuffmanTests.decode(HpackHuffmanTests.bytes(hex)), Array(string.utf8), string)
+        }
+
+        XCTAssertEqual(HpackHuffmanTests.decode([]), [])
+    }
+
+    func testRoundTrip() {
+        let allBytes = (0...255).map { UInt8($0) }
+        XCTAssertEqual(HpackHuffmanTests.decode(HpackHuffmanTests.encode(allBytes)), allBytes)
+
+        var state: UInt64 = 42
+        for count in 0..<300 {
+            let data = (0..<count).map { _ -> UInt8 in
+                state = state &* 6_364_136_223_846_793_005 &+ 1_442_695_040_888_963_407
+                return UInt8(truncatingIfNeeded: state >> 56)
+            }
+
+            XCTAssertEqual(HpackHuffmanTests.decode(HpackHuffmanTests.encode(data)), data)
+        }
+    }
+
+    func testInvalid() {
+        // "a" is 00011, padded by 111.
+        XCTAssertEqual(HpackHuffmanTests.decode([0x1F]), Array("a".utf8))
+        // Padding is not a prefix of EOS.
+        XCTAssertNil(HpackHuffmanTests.decode([0x18]))
+        XCTAssertNil(HpackHuffmanTests.decode([0xFE]))
+        // Padding is longer than 7 bits.
+        XCTAssertNil(HpackHuffmanTests.decode([0xFF]))
+        XCTAssertNil(HpackHuffmanTests.decode([0x1F, 0xFF]))
+        // EOS.
+        XCTAssertNil(HpackHuffmanTests.decode([0xFF, 0xFF, 0xFF, 0xFC]))
+        XCTAssertNil(HpackHuffmanTests.decode([0xFF, 0xFF, 0xFF, 0xFF]))
+    }
+}
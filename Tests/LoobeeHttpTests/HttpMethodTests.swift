@@ -41,6 +41,20 @@ internal class HttpMethodTests: XCTestCase {
         XCTAssertNil(HttpMethod("HEAT"))
     }
 
+    func testCreateFromBytes() {
+        func method(_ string: String) -> HttpMethod? {
+            return Array(string.utf8).withUnsafeBytes { HttpMethod(bytes: $0) }
+        }
+
+        XCTAssertEqual(method("GET"), HttpMethod.get)
+        XCTAssertEqual(method("pAtCh"), HttpMethod.patch)
+        XCTAssertEqual(method("OPTIONS"), HttpMethod.options)
+        XCTAssertNil(method("GETT"))
+        XCTAssertNil(method("OPTIONSS"))
+        XCTAssertNil(method("G@T"))
+        XCTAssertNil(method(""))
+    }
+
     func testTextOutputStream() {
         var result = ""
 
@@ -1,7 +1,44 @@
 import XCTest
 
+extension HpackDecoderTests {
+    static let __allTests = [
+        ("testErrors", testErrors),
+        ("testHeaderBomb", testHeaderBomb),
+        ("testHeaderSize", testHeaderSize),
+        ("testLimits", testLimits),
+        ("testLiterals", testLiterals),
+        ("testLiteralsReferToBlock", testLiteralsReferToBlock),
+        ("testRequests", testRequests),
+        ("testResponsesWithEviction", testResponsesWithEviction),
+        ("testRoundTrip", testRoundTrip),
+    ]
+}
+
+extension HpackEncoderTests {
+    static let __allTests = [
+        ("testHeaderSize", testHeaderSize),
+        ("testIndexing", testIndexing),
+        ("testLongString", testLongString),
+        ("testRequestsWithHuffman", testRequestsWithHuffman),
+        ("testRequestsWithoutHuffman", testRequestsWithoutHuffman),
+        ("testResponsesWithEviction", testResponsesWithEviction),
+        ("testSensitiveFieldIsNeverIndexed", testSensitiveFieldIsNeverIndexed),
+        ("testTableSizeUpdate", testTableSizeUpdate),
+    ]
+}
+
+extension HpackHuffmanTests {
+    static let __allTests = [
+        ("testDecode", testDecode),
+        ("testEncode", testEncode),
+        ("testInvalid", testInvalid),
+        ("testRoundTrip", testRoundTrip),
+    ]
+}
+
 extension HttpMethodTests {
     static let __allTests = [
+        ("testCreateFromBytes", testCreateFromBytes),
         ("testCreateFromNotValidString", testCreateFromNotValidString),
         ("testCreateFromValidString", testCreateFromValidString),
         ("testInsensitive", testInsensitive),
@@ -9,10 +46,25 @@ extension HttpMethodTests {
     ]
 }
 
+extension HttpRequestParserTests {
+    static let __allTests = [
+        ("testErrors", testErrors),
+        ("testFuzzAgainstReference", testFuzzAgainstReference),
+        ("testHeaderWhitespaces", testHeaderWhitespaces),
+        ("testLimits", testLimits),
+        ("testParse", testParse),
+        ("testPartialReads", testPartialReads),
+    ]
+}
+
 #if !os(macOS)
 public func __allTests() -> [XCTestCaseEntry] {
     return [
+        testCase(HpackDecoderTests.__allTests),
+        testCase(HpackEncoderTests.__allTests),
+        testCase(HpackHuffmanTests.__allTests),
         testCase(HttpMethodTests.__allTests),
+        testCase(HttpRequestParserTests.__allTests),
     ]
 }
 #endif